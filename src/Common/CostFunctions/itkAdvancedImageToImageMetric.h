@@ -27,12 +27,15 @@
 #include "itkAdvancedLinearInterpolateImageFunction.h"
 #include "itkLimiterFunctionBase.h"
 #include "itkFixedArray.h"
+#include "itkSimpleDataObjectDecorator.h"
+#include "itkComputationCache.h"
 #include "itkAdvancedTransform.h"
 #include "vnl/vnl_sparse_matrix.h"
 
 // Needed for checking for B-spline for faster implementation
 #include "itkAdvancedBSplineDeformableTransform.h"
 #include "itkAdvancedCombinationTransform.h"
+#include "itkStackTransform.h"
 
 #include "itkMultiThreader.h"
 
@@ -163,6 +166,9 @@ public:
   typedef typename BSplineOrder2TransformType::Pointer                             BSplineOrder2TransformPointer;
   typedef typename BSplineOrder3TransformType::Pointer                             BSplineOrder3TransformPointer;
 
+  /** Typedef for the stack transform, used by the groupwise metrics. */
+  typedef StackTransform< ScalarType, FixedImageDimension, MovingImageDimension > StackTransformType;
+
   /** Hessian type; for SelfHessian (experimental feature) */
   typedef typename DerivativeType::ValueType    HessianValueType;
   typedef vnl_sparse_matrix< HessianValueType > HessianType;
@@ -217,6 +223,14 @@ public:
   itkSetObjectMacro( FixedImageLimiter, FixedImageLimiterType );
   itkGetConstObjectMacro( FixedImageLimiter, FixedImageLimiterType );
 
+  /** Set/Get a cache for the extrema of the images, which are needed by the
+   * limiters. The extrema are stored per image buffer and region, so that they
+   * are reused for images that share their buffer. Extrema within a mask are
+   * not cached. Default: null, which means no caching.
+   */
+  itkSetObjectMacro( ComputationCache, ComputationCache );
+  itkGetConstObjectMacro( ComputationCache, ComputationCache );
+
   /** A percentage that defines how much the gray value range is extended
    * maxlimit = max + LimitRangeRatio * (max - min)
    * minlimit = min - LimitRangeRatio * (max - min)
@@ -365,6 +379,9 @@ protected:
   MovingImageLimiterOutputType m_MovingImageMinLimit;
   MovingImageLimiterOutputType m_MovingImageMaxLimit;
 
+  /** The extrema of an image, as stored in the computation cache. */
+  typedef SimpleDataObjectDecorator< FixedArray< double, 2 > > ImageExtremaObjectType;
+
   /** Multi-threaded metric computation. */
 
   /** Multi-threaded version of GetValue(). */
@@ -516,6 +533,21 @@ protected:
     const FixedImagePointType & fixedImagePoint,
     MovingImagePointType & mappedPoint ) const;
 
+  /** Transform a set of fixed image points that differ only in their last
+   * coordinate, as done by the groupwise metrics. If the transform is a
+   * StackTransform, the spatial part is mapped by all sub transforms at once,
+   * which shares the B-spline weights computation. Each mapped point equals
+   * the one of TransformPoint(), which always considers a sample valid.
+   */
+  virtual void TransformPointsOverLastDimension(
+    const std::vector< FixedImagePointType > & fixedImagePoints,
+    std::vector< MovingImagePointType > & mappedPoints ) const;
+
+  /** Get the StackTransform if the transform is one, possibly wrapped in a
+   * combination transform without initial transform. Returns NULL otherwise.
+   */
+  const StackTransformType * GetStackTransform( void ) const;
+
   /** This function returns a reference to the transform Jacobians.
    * This is either a reference to the full TransformJacobian or
    * a reference to a sparse Jacobians.
@@ -572,6 +604,8 @@ private:
 
   MovingImageDerivativeScalesType m_MovingImageDerivativeScales;
 
+  ComputationCache::Pointer m_ComputationCache;
+
 };
 
 } // end namespace itk
@@ -23,6 +23,7 @@
 #include "itkImageRegionConstIterator.h"          // used for extrema computation
 #include "itkImageRegionConstIteratorWithIndex.h" // used for extrema computation
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
+#include <sstream>
 
 #ifdef ELASTIX_USE_OPENMP
 #include <omp.h>
@@ -50,6 +51,7 @@ AdvancedImageToImageMetric< TFixedImage, TMovingImage >
   this->m_ImageSampler                = 0;
   this->m_UseImageSampler             = false;
   this->m_RequiredRatioOfValidSamples = 0.25;
+  this->m_ComputationCache            = 0;
 
   this->m_LinearInterpolator              = 0;
   this->m_BSplineInterpolator             = 0;
@@ -245,8 +247,26 @@ AdvancedImageToImageMetric< TFixedImage, TMovingImage >
   FixedImagePixelType trueMinTemp = NumericTraits< FixedImagePixelType >::max();
   FixedImagePixelType trueMaxTemp = NumericTraits< FixedImagePixelType >::NonpositiveMin();
 
+  /** Reuse the extrema of an image that shares the buffer, if possible. */
+  const bool         useCache = this->m_ComputationCache.IsNotNull()
+    && this->m_FixedImageMask.IsNull();
+  std::ostringstream operation;
+  Object::Pointer    cachedObject = 0;
+  if( useCache )
+  {
+    operation << "ImageExtrema index " << region.GetIndex() << " size " << region.GetSize();
+    cachedObject = this->m_ComputationCache->Find( image->GetPixelContainer(), operation.str() );
+  }
+  const ImageExtremaObjectType * cachedExtrema
+    = dynamic_cast< const ImageExtremaObjectType * >( cachedObject.GetPointer() );
+
+  if( cachedExtrema )
+  {
+    trueMinTemp = static_cast< FixedImagePixelType >( cachedExtrema->Get()[ 0 ] );
+    trueMaxTemp = static_cast< FixedImagePixelType >( cachedExtrema->Get()[ 1 ] );
+  }
   /** If no mask. */
-  if( this->m_FixedImageMask.IsNull() )
+  else if( this->m_FixedImageMask.IsNull() )
   {
     typedef ImageRegionConstIterator< FixedImageType > IteratorType;
     IteratorType it( image, region );
@@ -279,6 +299,17 @@ AdvancedImageToImageMetric< TFixedImage, TMovingImage >
     }
   }
 
+  /** Store the extrema for images that share the buffer. */
+  if( useCache && !cachedExtrema )
+  {
+    FixedArray< double, 2 > extrema;
+    extrema[ 0 ] = static_cast< double >( trueMinTemp );
+    extrema[ 1 ] = static_cast< double >( trueMaxTemp );
+    typename ImageExtremaObjectType::Pointer extremaObject = ImageExtremaObjectType::New();
+    extremaObject->Set( extrema );
+    this->m_ComputationCache->Add( image->GetPixelContainer(), operation.str(), extremaObject );
+  }
+
   /** Update member variables. */
   this->m_FixedImageTrueMin = trueMinTemp;
   this->m_FixedImageTrueMax = trueMaxTemp;
@@ -308,8 +339,26 @@ AdvancedImageToImageMetric< TFixedImage, TMovingImage >
   MovingImagePixelType trueMinTemp = NumericTraits< MovingImagePixelType >::max();
   MovingImagePixelType trueMaxTemp = NumericTraits< MovingImagePixelType >::NonpositiveMin();
 
+  /** Reuse the extrema of an image that shares the buffer, if possible. */
+  const bool         useCache = this->m_ComputationCache.IsNotNull()
+    && this->m_MovingImageMask.IsNull();
+  std::ostringstream operation;
+  Object::Pointer    cachedObject = 0;
+  if( useCache )
+  {
+    operation << "ImageExtrema index " << region.GetIndex() << " size " << region.GetSize();
+    cachedObject = this->m_ComputationCache->Find( image->GetPixelContainer(), operation.str() );
+  }
+  const ImageExtremaObjectType * cachedExtrema
+    = dynamic_cast< const ImageExtremaObjectType * >( cachedObject.GetPointer() );
+
+  if( cachedExtrema )
+  {
+    trueMinTemp = static_cast< MovingImagePixelType >( cachedExtrema->Get()[ 0 ] );
+    trueMaxTemp = static_cast< MovingImagePixelType >( cachedExtrema->Get()[ 1 ] );
+  }
   /** If no mask. */
-  if( this->m_MovingImageMask.IsNull() )
+  else if( this->m_MovingImageMask.IsNull() )
   {
     typedef ImageRegionConstIterator< MovingImageType > IteratorType;
     IteratorType iterator( image, region );
@@ -342,6 +391,17 @@ AdvancedImageToImageMetric< TFixedImage, TMovingImage >
     }
   }
 
+  /** Store the extrema for images that share the buffer. */
+  if( useCache && !cachedExtrema )
+  {
+    FixedArray< double, 2 > extrema;
+    extrema[ 0 ] = static_cast< double >( trueMinTemp );
+    extrema[ 1 ] = static_cast< double >( trueMaxTemp );
+    typename ImageExtremaObjectType::Pointer extremaObject = ImageExtremaObjectType::New();
+    extremaObject->Set( extrema );
+    this->m_ComputationCache->Add( image->GetPixelContainer(), operation.str(), extremaObject );
+  }
+
   /** Update member variables. */
   this->m_MovingImageTrueMin = trueMinTemp;
   this->m_MovingImageTrueMax = trueMaxTemp;
@@ -827,6 +887,104 @@ AdvancedImageToImageMetric< TFixedImage, TMovingImage >
 } // end TransformPoint()
 
 
+/**
+ * *************** GetStackTransform ****************
+ */
+
+template< class TFixedImage, class TMovingImage >
+const typename AdvancedImageToImageMetric< TFixedImage, TMovingImage >::StackTransformType
+* AdvancedImageToImageMetric< TFixedImage, TMovingImage >
+::GetStackTransform( void ) const
+{
+  const AdvancedTransformType * transform = this->m_AdvancedTransform.GetPointer();
+
+  /** Unwrap the combination transform, if it has no initial transform. */
+  const CombinationTransformType * testPtr_combo
+    = dynamic_cast< const CombinationTransformType * >( transform );
+  if( testPtr_combo )
+  {
+    if( testPtr_combo->GetInitialTransform() != NULL )
+    {
+      return NULL;
+    }
+    transform = testPtr_combo->GetCurrentTransform();
+  }
+
+  return dynamic_cast< const StackTransformType * >( transform );
+
+} // end GetStackTransform()
+
+
+/**
+ * *************** TransformPointsOverLastDimension ****************
+ */
+
+template< class TFixedImage, class TMovingImage >
+void
+AdvancedImageToImageMetric< TFixedImage, TMovingImage >
+::TransformPointsOverLastDimension(
+  const std::vector< FixedImagePointType > & fixedImagePoints,
+  std::vector< MovingImagePointType > & mappedPoints ) const
+{
+  const unsigned int numberOfPoints = fixedImagePoints.size();
+  const unsigned int lastDim        = FixedImageDimension - 1;
+  mappedPoints.resize( numberOfPoints );
+
+  /** Mapping the point by all sub transforms only pays off when
+   * a substantial part of them is actually used.
+   */
+  const StackTransformType * stack = this->GetStackTransform();
+  bool useStack = stack != NULL && numberOfPoints > 0
+    && 2 * numberOfPoints >= stack->GetNumberOfSubTransforms();
+
+  /** The spatial part of all points should be the same. This is not
+   * the case for a fixed image with an oblique last dimension.
+   */
+  typename StackTransformType::SubTransformInputPointType ippr;
+  if( useStack )
+  {
+    for( unsigned int d = 0; d < lastDim; ++d )
+    {
+      ippr[ d ] = fixedImagePoints[ 0 ][ d ];
+    }
+    for( unsigned int i = 1; i < numberOfPoints && useStack; ++i )
+    {
+      for( unsigned int d = 0; d < lastDim; ++d )
+      {
+        if( fixedImagePoints[ i ][ d ] != ippr[ d ] )
+        {
+          useStack = false;
+          break;
+        }
+      }
+    }
+  }
+
+  if( !useStack )
+  {
+    for( unsigned int i = 0; i < numberOfPoints; ++i )
+    {
+      this->TransformPoint( fixedImagePoints[ i ], mappedPoints[ i ] );
+    }
+    return;
+  }
+
+  /** Map the spatial part by all sub transforms, and select per point. */
+  std::vector< typename StackTransformType::SubTransformOutputPointType > opprs;
+  stack->TransformPointInAllSubTransforms( ippr, opprs );
+  for( unsigned int i = 0; i < numberOfPoints; ++i )
+  {
+    const unsigned int subt = stack->GetSubTransformIndex( fixedImagePoints[ i ] );
+    for( unsigned int d = 0; d < lastDim; ++d )
+    {
+      mappedPoints[ i ][ d ] = opprs[ subt ][ d ];
+    }
+    mappedPoints[ i ][ lastDim ] = fixedImagePoints[ i ][ lastDim ];
+  }
+
+} // end TransformPointsOverLastDimension()
+
+
 /**
  * *************** EvaluateTransformJacobian ****************
  */
@@ -36,6 +36,12 @@ ScaledSingleValuedCostFunction
   this->m_UseScales            = false;
   this->m_NegateCostFunction   = false;
 
+  this->m_UseEvaluationCache       = false;
+  this->m_EvaluationCacheSize      = 4;
+  this->m_EvaluationCacheMTime     = 0;
+  this->m_NumberOfEvaluations      = 0;
+  this->m_NumberOfSavedEvaluations = 0;
+
 } // end Constructor
 
 
@@ -46,6 +52,40 @@ ScaledSingleValuedCostFunction
 ScaledSingleValuedCostFunction::MeasureType
 ScaledSingleValuedCostFunction
 ::GetValue( const ParametersType & parameters ) const
+{
+  if( this->m_UseEvaluationCache )
+  {
+    this->m_EvaluationCacheMutex.Lock();
+    const EvaluationCacheEntry * entry = this->FindEvaluationCacheEntry(
+      parameters, HashParameters( parameters ) );
+    if( entry != 0 && entry->HasValue )
+    {
+      const MeasureType value = entry->Value;
+      ++this->m_NumberOfSavedEvaluations;
+      this->m_EvaluationCacheMutex.Unlock();
+      return value;
+    }
+    this->m_EvaluationCacheMutex.Unlock();
+  }
+
+  const MeasureType value = this->ComputeValue( parameters );
+
+  if( this->m_UseEvaluationCache )
+  {
+    this->StoreEvaluation( parameters, &value, 0 );
+  }
+  return value;
+
+} // end GetValue()
+
+
+/**
+ * ******************** ComputeValue *****************************
+ */
+
+ScaledSingleValuedCostFunction::MeasureType
+ScaledSingleValuedCostFunction
+::ComputeValue( const ParametersType & parameters ) const
 {
   /** F(y)= f(y/s) */
 
@@ -75,7 +115,7 @@ ScaledSingleValuedCostFunction
   }
   return returnvalue;
 
-} // end GetValue()
+} // end ComputeValue()
 
 
 /**
@@ -86,6 +126,40 @@ void
 ScaledSingleValuedCostFunction
 ::GetDerivative( const ParametersType & parameters,
   DerivativeType & derivative ) const
+{
+  if( this->m_UseEvaluationCache )
+  {
+    this->m_EvaluationCacheMutex.Lock();
+    const EvaluationCacheEntry * entry = this->FindEvaluationCacheEntry(
+      parameters, HashParameters( parameters ) );
+    if( entry != 0 && entry->HasDerivative )
+    {
+      derivative = entry->Derivative;
+      ++this->m_NumberOfSavedEvaluations;
+      this->m_EvaluationCacheMutex.Unlock();
+      return;
+    }
+    this->m_EvaluationCacheMutex.Unlock();
+  }
+
+  this->ComputeDerivative( parameters, derivative );
+
+  if( this->m_UseEvaluationCache )
+  {
+    this->StoreEvaluation( parameters, 0, &derivative );
+  }
+
+} // end GetDerivative()
+
+
+/**
+ * ******************** ComputeDerivative **************************
+ */
+
+void
+ScaledSingleValuedCostFunction
+::ComputeDerivative( const ParametersType & parameters,
+  DerivativeType & derivative ) const
 {
   /** dF/dy(y)= 1/s * df/dx(y/s) */
 
@@ -118,7 +192,7 @@ ScaledSingleValuedCostFunction
     derivative = -derivative;
   }
 
-} // end GetDerivative()
+} // end ComputeDerivative()
 
 
 /**
@@ -130,6 +204,42 @@ ScaledSingleValuedCostFunction
 ::GetValueAndDerivative( const ParametersType & parameters,
   MeasureType & value,
   DerivativeType & derivative ) const
+{
+  if( this->m_UseEvaluationCache )
+  {
+    this->m_EvaluationCacheMutex.Lock();
+    const EvaluationCacheEntry * entry = this->FindEvaluationCacheEntry(
+      parameters, HashParameters( parameters ) );
+    if( entry != 0 && entry->HasValue && entry->HasDerivative )
+    {
+      value      = entry->Value;
+      derivative = entry->Derivative;
+      ++this->m_NumberOfSavedEvaluations;
+      this->m_EvaluationCacheMutex.Unlock();
+      return;
+    }
+    this->m_EvaluationCacheMutex.Unlock();
+  }
+
+  this->ComputeValueAndDerivative( parameters, value, derivative );
+
+  if( this->m_UseEvaluationCache )
+  {
+    this->StoreEvaluation( parameters, &value, &derivative );
+  }
+
+} // end GetValueAndDerivative()
+
+
+/**
+ * **************** ComputeValueAndDerivative ************************
+ */
+
+void
+ScaledSingleValuedCostFunction
+::ComputeValueAndDerivative( const ParametersType & parameters,
+  MeasureType & value,
+  DerivativeType & derivative ) const
 {
   /** F(y)= f(y/s) */
   /** dF/dy(y)= 1/s * df/dx(y/s) */
@@ -165,7 +275,7 @@ ScaledSingleValuedCostFunction
     derivative = -derivative;
   }
 
-} // end GetValueAndDerivative()
+} // end ComputeValueAndDerivative()
 
 
 /**
@@ -185,6 +295,82 @@ ScaledSingleValuedCostFunction
 } // end GetNumberOfParameters()
 
 
+/**
+ * **************** SetUnscaledCostFunction ****************************
+ */
+
+void
+ScaledSingleValuedCostFunction
+::SetUnscaledCostFunction( Superclass * costFunction )
+{
+  itkDebugMacro( "setting UnscaledCostFunction to " << costFunction );
+  if( this->m_UnscaledCostFunction != costFunction )
+  {
+    this->m_UnscaledCostFunction = costFunction;
+    this->InvalidateEvaluationCache();
+    this->Modified();
+  }
+
+} // end SetUnscaledCostFunction()
+
+
+/**
+ * **************** SetUseScales **********************************
+ */
+
+void
+ScaledSingleValuedCostFunction
+::SetUseScales( bool arg )
+{
+  itkDebugMacro( "setting UseScales to " << arg );
+  if( this->m_UseScales != arg )
+  {
+    this->m_UseScales = arg;
+    this->InvalidateEvaluationCache();
+    this->Modified();
+  }
+
+} // end SetUseScales()
+
+
+/**
+ * **************** SetNegateCostFunction ****************************
+ */
+
+void
+ScaledSingleValuedCostFunction
+::SetNegateCostFunction( bool arg )
+{
+  itkDebugMacro( "setting NegateCostFunction to " << arg );
+  if( this->m_NegateCostFunction != arg )
+  {
+    this->m_NegateCostFunction = arg;
+    this->InvalidateEvaluationCache();
+    this->Modified();
+  }
+
+} // end SetNegateCostFunction()
+
+
+/**
+ * **************** SetUseEvaluationCache ****************************
+ */
+
+void
+ScaledSingleValuedCostFunction
+::SetUseEvaluationCache( bool arg )
+{
+  itkDebugMacro( "setting UseEvaluationCache to " << arg );
+  if( this->m_UseEvaluationCache != arg )
+  {
+    this->m_UseEvaluationCache = arg;
+    this->InvalidateEvaluationCache();
+    this->Modified();
+  }
+
+} // end SetUseEvaluationCache()
+
+
 /**
  * **************** SetScales **********************************
  */
@@ -200,6 +386,7 @@ ScaledSingleValuedCostFunction
   {
     this->m_SquaredScales[ i ] = vnl_math_sqr( scales[ i ] );
   }
+  this->InvalidateEvaluationCache();
   this->Modified();
 
 } // end SetScales()
@@ -220,6 +407,7 @@ ScaledSingleValuedCostFunction
   {
     this->m_Scales[ i ] = vcl_sqrt( squaredScales[ i ] );
   }
+  this->InvalidateEvaluationCache();
   this->Modified();
 
 } // end SetSquaredScales()
@@ -279,6 +467,139 @@ ScaledSingleValuedCostFunction
 } // end ConvertUnscaledToScaledParameters()
 
 
+/**
+ * *************** InvalidateEvaluationCache ********************
+ */
+
+void
+ScaledSingleValuedCostFunction
+::InvalidateEvaluationCache( void ) const
+{
+  this->m_EvaluationCacheMutex.Lock();
+  this->m_EvaluationCache.clear();
+  this->m_EvaluationCacheMutex.Unlock();
+
+} // end InvalidateEvaluationCache()
+
+
+/**
+ * *************** ResetEvaluationCache ********************
+ */
+
+void
+ScaledSingleValuedCostFunction
+::ResetEvaluationCache( void )
+{
+  this->InvalidateEvaluationCache();
+  this->m_NumberOfEvaluations      = 0;
+  this->m_NumberOfSavedEvaluations = 0;
+
+} // end ResetEvaluationCache()
+
+
+/**
+ * *************** HashParameters ********************
+ */
+
+std::size_t
+ScaledSingleValuedCostFunction
+::HashParameters( const ParametersType & parameters )
+{
+  /** FNV-1a hash of the bytes of the parameters. */
+  const unsigned char * bytes
+    = reinterpret_cast< const unsigned char * >( parameters.data_block() );
+  const std::size_t numberOfBytes = parameters.GetSize() * sizeof( double );
+  std::size_t       hash          = static_cast< std::size_t >( 2166136261u );
+  for( std::size_t i = 0; i < numberOfBytes; ++i )
+  {
+    hash ^= static_cast< std::size_t >( bytes[ i ] );
+    hash *= static_cast< std::size_t >( 16777619u );
+  }
+  return hash;
+
+} // end HashParameters()
+
+
+/**
+ * *************** FindEvaluationCacheEntry ********************
+ */
+
+ScaledSingleValuedCostFunction::EvaluationCacheEntry *
+ScaledSingleValuedCostFunction
+::FindEvaluationCacheEntry( const ParametersType & parameters,
+  const std::size_t hash ) const
+{
+  /** Results of a modified cost function can not be reused. */
+  if( this->m_UnscaledCostFunction.IsNull() )
+  {
+    return 0;
+  }
+  const unsigned long mtime = this->m_UnscaledCostFunction->GetMTime();
+  if( mtime != this->m_EvaluationCacheMTime )
+  {
+    this->m_EvaluationCache.clear();
+    this->m_EvaluationCacheMTime = mtime;
+    return 0;
+  }
+
+  for( EvaluationCacheType::iterator it = this->m_EvaluationCache.begin();
+    it != this->m_EvaluationCache.end(); ++it )
+  {
+    if( it->Hash == hash && it->Parameters == parameters )
+    {
+      return &( *it );
+    }
+  }
+  return 0;
+
+} // end FindEvaluationCacheEntry()
+
+
+/**
+ * *************** StoreEvaluation ********************
+ */
+
+void
+ScaledSingleValuedCostFunction
+::StoreEvaluation( const ParametersType & parameters,
+  const MeasureType * value, const DerivativeType * derivative ) const
+{
+  const std::size_t hash = HashParameters( parameters );
+
+  this->m_EvaluationCacheMutex.Lock();
+  ++this->m_NumberOfEvaluations;
+  EvaluationCacheEntry * entry = this->FindEvaluationCacheEntry( parameters, hash );
+  if( entry == 0 )
+  {
+    /** Drop the oldest evaluation if the cache is full. */
+    while( this->m_EvaluationCache.size() >= this->m_EvaluationCacheSize )
+    {
+      this->m_EvaluationCache.pop_front();
+    }
+    this->m_EvaluationCache.push_back( EvaluationCacheEntry() );
+    entry                = &this->m_EvaluationCache.back();
+    entry->Hash          = hash;
+    entry->Parameters    = parameters;
+    entry->HasValue      = false;
+    entry->HasDerivative = false;
+    entry->Value         = NumericTraits< MeasureType >::Zero;
+  }
+
+  if( value != 0 )
+  {
+    entry->Value    = *value;
+    entry->HasValue = true;
+  }
+  if( derivative != 0 )
+  {
+    entry->Derivative    = *derivative;
+    entry->HasDerivative = true;
+  }
+  this->m_EvaluationCacheMutex.Unlock();
+
+} // end StoreEvaluation()
+
+
 /**
  * *************** PrintSelf ********************
  */
@@ -296,6 +617,12 @@ ScaledSingleValuedCostFunction
   os << indent << "SquaredScales: " << this->m_SquaredScales << std::endl;
   os << indent << "NegateCostFunction: "
      << ( this->m_NegateCostFunction ? "true" : "false" ) << std::endl;
+  os << indent << "UseEvaluationCache: "
+     << ( this->m_UseEvaluationCache ? "true" : "false" ) << std::endl;
+  os << indent << "EvaluationCacheSize: " << this->m_EvaluationCacheSize << std::endl;
+  os << indent << "NumberOfEvaluations: " << this->m_NumberOfEvaluations << std::endl;
+  os << indent << "NumberOfSavedEvaluations: "
+     << this->m_NumberOfSavedEvaluations << std::endl;
   os << indent << "UnscaledCostFunction: "
      << this->m_UnscaledCostFunction.GetPointer() << std::endl;
 
@@ -21,6 +21,8 @@
 
 #include "itkSingleValuedCostFunction.h"
 #include "itkIntTypes.h" //temp, needed for IdentifierType
+#include "itkSimpleFastMutexLock.h"
+#include <deque>
 
 namespace itk
 {
@@ -33,6 +35,18 @@ namespace itk
  * By default it does not apply any scaling. Use the method SetUseScales(true)
  * to enable the use of scales.
  *
+ * Optionally, the results of the last few evaluations are cached, see
+ * SetUseEvaluationCache(). Line search optimizers sometimes evaluate the
+ * cost function at a position for which the value or derivative was
+ * computed before, for example at the accepted point of a line search.
+ * With the cache enabled such an evaluation is answered without calling
+ * the unscaled cost function. The cache is keyed by a hash of the scaled
+ * parameters, and a hit requires the parameters to be exactly equal.
+ * It is emptied when the scales, the unscaled cost function or its
+ * modification time change. The cache should only be enabled for
+ * deterministic cost functions; call InvalidateEvaluationCache() after
+ * for example selecting new samples.
+ *
  * \ingroup Numerics
  */
 
@@ -86,7 +100,7 @@ public:
   virtual NumberOfParametersType GetNumberOfParameters( void ) const;
 
   /** Set the cost function that needs scaling. */
-  itkSetObjectMacro( UnscaledCostFunction, Superclass );
+  virtual void SetUnscaledCostFunction( Superclass * costFunction );
   /** Get the cost function that needs scaling. */
   itkGetObjectMacro( UnscaledCostFunction, Superclass );
 
@@ -107,7 +121,7 @@ public:
   itkGetConstReferenceMacro( SquaredScales, ScalesType );
 
   /** Set the flag to use scales or not. */
-  itkSetMacro( UseScales, bool );
+  virtual void SetUseScales( bool arg );
 
   /** Get the flag to use scales or not. */
   itkGetConstMacro( UseScales, bool );
@@ -116,10 +130,37 @@ public:
   itkBooleanMacro( NegateCostFunction );
 
   /** Set the flag to negate the cost function or not. */
-  itkSetMacro( NegateCostFunction, bool );
+  virtual void SetNegateCostFunction( bool arg );
   /** Get the flag to negate the cost function or not. */
   itkGetConstMacro( NegateCostFunction, bool );
 
+  /** Set/Get whether the results of previous evaluations are reused.
+   * Default: false.
+   */
+  virtual void SetUseEvaluationCache( bool arg );
+
+  itkGetConstMacro( UseEvaluationCache, bool );
+
+  /** Set/Get the number of evaluations that are kept in the cache.
+   * Default: 4.
+   */
+  itkSetClampMacro( EvaluationCacheSize, unsigned int,
+    1, NumericTraits< unsigned int >::max() );
+  itkGetConstMacro( EvaluationCacheSize, unsigned int );
+
+  /** Get the number of evaluations of the unscaled cost function, and the
+   * number of evaluations that were answered by the cache, while the cache
+   * was enabled, since the last call to ResetEvaluationCache().
+   */
+  itkGetConstMacro( NumberOfEvaluations, SizeValueType );
+  itkGetConstMacro( NumberOfSavedEvaluations, SizeValueType );
+
+  /** Empty the cache. */
+  virtual void InvalidateEvaluationCache( void ) const;
+
+  /** Empty the cache and set the evaluation counters to zero. */
+  virtual void ResetEvaluationCache( void );
+
   /** Convert the parameters from scaled to unscaled: x = y/s. */
   virtual void ConvertScaledToUnscaledParameters( ParametersType & parameters ) const;
 
@@ -138,6 +179,44 @@ protected:
 
 private:
 
+  /** Compute the (scaled) value and/or derivative, bypassing the cache. */
+  MeasureType ComputeValue( const ParametersType & parameters ) const;
+
+  void ComputeDerivative(
+    const ParametersType & parameters,
+    DerivativeType & derivative ) const;
+
+  void ComputeValueAndDerivative(
+    const ParametersType & parameters,
+    MeasureType & value,
+    DerivativeType & derivative ) const;
+
+  /** An evaluation in the cache. */
+  struct EvaluationCacheEntry
+  {
+    std::size_t    Hash;
+    ParametersType Parameters;
+    bool           HasValue;
+    bool           HasDerivative;
+    MeasureType    Value;
+    DerivativeType Derivative;
+  };
+
+  typedef std::deque< EvaluationCacheEntry > EvaluationCacheType;
+
+  /** Compute the hash of the parameters. */
+  static std::size_t HashParameters( const ParametersType & parameters );
+
+  /** Find the cache entry of the parameters. Returns 0 if there is none.
+   * Should be called with the mutex locked.
+   */
+  EvaluationCacheEntry * FindEvaluationCacheEntry(
+    const ParametersType & parameters, const std::size_t hash ) const;
+
+  /** Store a value and/or derivative in the cache. */
+  void StoreEvaluation( const ParametersType & parameters,
+    const MeasureType * value, const DerivativeType * derivative ) const;
+
   /** The private constructor. */
   ScaledSingleValuedCostFunction( const Self & );   // purposely not implemented
   /** The private copy constructor. */
@@ -150,6 +229,14 @@ private:
   bool                            m_UseScales;
   bool                            m_NegateCostFunction;
 
+  bool                        m_UseEvaluationCache;
+  unsigned int                m_EvaluationCacheSize;
+  mutable EvaluationCacheType m_EvaluationCache;
+  mutable unsigned long       m_EvaluationCacheMTime;
+  mutable SizeValueType       m_NumberOfEvaluations;
+  mutable SizeValueType       m_NumberOfSavedEvaluations;
+  mutable SimpleFastMutexLock m_EvaluationCacheMutex;
+
 };
 
 } //end namespace itk
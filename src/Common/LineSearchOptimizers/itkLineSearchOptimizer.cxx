@@ -21,6 +21,7 @@
 
 #include "itkLineSearchOptimizer.h"
 #include "itkNumericTraits.h"
+#include "itkParallelVectorOperations.h"
 
 namespace itk
 {
@@ -57,14 +58,9 @@ LineSearchOptimizer
 
   this->m_CurrentStepLength = step;
 
-  ParametersType         newPosition        =  this->GetInitialPosition();
-  const unsigned int     numberOfParameters = newPosition.GetSize();
-  const ParametersType & LSD                = this->GetLineSearchDirection();
-
-  for( unsigned int i = 0; i < numberOfParameters; ++i )
-  {
-    newPosition[ i ] += ( step * LSD[ i ] );
-  }
+  ParametersType newPosition;
+  ParallelVectorOperations::AddScaled( newPosition,
+    this->GetInitialPosition(), step, this->GetLineSearchDirection() );
 
   this->SetCurrentPosition( newPosition );
 
@@ -81,8 +77,9 @@ double
 LineSearchOptimizer
 ::DirectionalDerivative( const DerivativeType & derivative ) const
 {
-  /** Easy, thanks to the functions defined in vnl_vector.h */
-  return inner_product( derivative, this->GetLineSearchDirection() );
+  /** Multi-threaded for large numbers of parameters. */
+  return ParallelVectorOperations::InnerProduct(
+    derivative, this->GetLineSearchDirection() );
 
 } // end DirectionalDerivative()
 
@@ -240,6 +240,22 @@ public:
     ParameterIndexArrayType & indices,
     bool & inside ) const;
 
+  /** Interpolation weights can be shared between transforms with the same grid. */
+  virtual bool GetSupportsSharedWeights( void ) const
+  { return true; }
+
+  /** Compute the interpolation weights and support index of a point. */
+  virtual bool ComputeWeightsAndSupportIndex(
+    const InputPointType & point,
+    WeightsType & weights,
+    IndexType & supportIndex ) const;
+
+  /** Transform a point using precomputed weights and support index. */
+  virtual OutputPointType TransformPointUsingWeights(
+    const InputPointType & point,
+    const WeightsType & weights,
+    const IndexType & supportIndex ) const;
+
   /** Get number of weights. */
   unsigned long GetNumberOfWeights( void ) const
   {
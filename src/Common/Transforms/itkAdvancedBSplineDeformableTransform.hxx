@@ -337,6 +337,94 @@ AdvancedBSplineDeformableTransform< TScalarType, NDimensions, VSplineOrder >
 }
 
 
+/**
+ * ********************* ComputeWeightsAndSupportIndex ****************************
+ */
+
+template< class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder >
+bool
+AdvancedBSplineDeformableTransform< TScalarType, NDimensions, VSplineOrder >
+::ComputeWeightsAndSupportIndex(
+  const InputPointType & point,
+  WeightsType & weights,
+  IndexType & supportIndex ) const
+{
+  ContinuousIndexType cindex;
+  this->TransformPointToContinuousGridIndex( point, cindex );
+
+  /** Outside the valid region the displacement is zero. */
+  if( !this->InsideValidRegion( cindex ) )
+  {
+    return false;
+  }
+
+  this->m_WeightsFunction->ComputeStartIndex( cindex, supportIndex );
+  this->m_WeightsFunction->Evaluate( cindex, supportIndex, weights );
+  return true;
+
+} // end ComputeWeightsAndSupportIndex()
+
+
+/**
+ * ********************* TransformPointUsingWeights ****************************
+ */
+
+template< class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder >
+typename AdvancedBSplineDeformableTransform< TScalarType, NDimensions, VSplineOrder >
+::OutputPointType
+AdvancedBSplineDeformableTransform< TScalarType, NDimensions, VSplineOrder >
+::TransformPointUsingWeights(
+  const InputPointType & point,
+  const WeightsType & weights,
+  const IndexType & supportIndex ) const
+{
+  OutputPointType outputPoint = point;
+
+  /** Check if the coefficient image has been set. */
+  if( !this->m_CoefficientImages[ 0 ] )
+  {
+    itkWarningMacro( << "B-spline coefficients have not been set" );
+    return outputPoint;
+  }
+
+  RegionType supportRegion;
+  supportRegion.SetSize( this->m_SupportSize );
+  supportRegion.SetIndex( supportIndex );
+
+  /** Create iterators over the coefficient images. */
+  typedef ImageScanlineConstIterator< ImageType > IteratorType;
+  IteratorType  iterator[ SpaceDimension ];
+  unsigned long counter = 0;
+  for( unsigned int j = 0; j < SpaceDimension; j++ )
+  {
+    iterator[ j ] = IteratorType( this->m_CoefficientImages[ j ], supportRegion );
+  }
+
+  /** Loop over the support region and add the displacement. */
+  while( !iterator[ 0 ].IsAtEnd() )
+  {
+    while( !iterator[ 0 ].IsAtEndOfLine() )
+    {
+      for( unsigned int j = 0; j < SpaceDimension; j++ )
+      {
+        outputPoint[ j ] += static_cast< ScalarType >(
+          weights[ counter ] * iterator[ j ].Value() );
+        ++iterator[ j ];
+      }
+      ++counter;
+    }
+
+    for( unsigned int j = 0; j < SpaceDimension; j++ )
+    {
+      iterator[ j ].NextLine();
+    }
+  }
+
+  return outputPoint;
+
+} // end TransformPointUsingWeights()
+
+
 /**
  * ********************* GetNumberOfAffectedWeights ****************************
  */
@@ -285,6 +285,45 @@ public:
    */
   typedef ContinuousIndex< ScalarType, SpaceDimension > ContinuousIndexType;
 
+  /** Interpolation weights type, equal to the one of the weights functions. */
+  typedef Array< double > WeightsType;
+
+  /** Whether ComputeWeightsAndSupportIndex() and TransformPointUsingWeights()
+   * are implemented. Only then the interpolation weights computed for one
+   * transform may be reused for another transform that has the same grid,
+   * as done by the StackTransform.
+   */
+  virtual bool GetSupportsSharedWeights( void ) const
+  { return false; }
+
+  /** Compute the interpolation weights and the start index of the support
+   * region of a point. Returns false if the point lies outside the valid
+   * region, in which case the transform maps the point onto itself.
+   * The weights array should have GetNumberOfAffectedWeights() elements.
+   */
+  virtual bool ComputeWeightsAndSupportIndex(
+    const InputPointType & point,
+    WeightsType & weights,
+    IndexType & supportIndex ) const
+  {
+    itkExceptionMacro( << "ComputeWeightsAndSupportIndex() is not implemented for this transform." );
+    return false;
+  }
+
+
+  /** Transform a point, given the weights and support index computed by
+   * ComputeWeightsAndSupportIndex() of a transform with the same grid.
+   */
+  virtual OutputPointType TransformPointUsingWeights(
+    const InputPointType & point,
+    const WeightsType & weights,
+    const IndexType & supportIndex ) const
+  {
+    itkExceptionMacro( << "TransformPointUsingWeights() is not implemented for this transform." );
+    return point;
+  }
+
+
 protected:
 
   /** Print contents of an AdvancedBSplineDeformableTransformBase. */
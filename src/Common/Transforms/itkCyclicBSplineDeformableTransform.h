@@ -129,6 +129,12 @@ public:
     ParameterIndexArrayType & indices,
     bool & inside ) const;
 
+  /** The cyclic support region is split, so the weights of the superclass
+   * cannot be shared.
+   */
+  virtual bool GetSupportsSharedWeights( void ) const
+  { return false; }
+
   /** Compute the Jacobian of the transformation. */
   virtual void GetJacobian(
     const InputPointType & ipp,
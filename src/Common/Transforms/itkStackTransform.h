@@ -19,6 +19,7 @@
 #define __itkStackTransform_h
 
 #include "itkAdvancedTransform.h"
+#include "itkAdvancedBSplineDeformableTransformBase.h"
 #include "itkIndex.h"
 
 namespace itk
@@ -105,9 +106,31 @@ public:
   /** Array type for parameter vector instantiation. */
   typedef typename ParametersType::ArrayType ParametersArrayType;
 
+  /** Sub transform B-spline type, used to share interpolation weights. */
+  typedef AdvancedBSplineDeformableTransformBase< TScalarType,
+    itkGetStaticConstMacro( ReducedInputSpaceDimension ) > SubTransformBSplineType;
+
   /**  Method to transform a point. */
   virtual OutputPointType TransformPoint( const InputPointType & ipp ) const;
 
+  /** Transform a (reduced dimension) point by all sub transforms at once.
+   * On return, opprs[ t ] contains the point mapped by sub transform t.
+   * When all sub transforms are B-splines on the same grid, the
+   * interpolation weights are computed only once.
+   */
+  virtual void TransformPointInAllSubTransforms(
+    const SubTransformInputPointType & ippr,
+    std::vector< SubTransformOutputPointType > & opprs ) const;
+
+  /** Get the index of the sub transform that is used for a point. */
+  unsigned int GetSubTransformIndex( const InputPointType & ipp ) const
+  {
+    return vnl_math_min( this->m_NumberOfSubTransforms - 1, static_cast< unsigned int >(
+      vnl_math_max( 0,
+      vnl_math_rnd( ( ipp[ ReducedInputSpaceDimension ] - m_StackOrigin ) / m_StackSpacing ) ) ) );
+  }
+
+
   /** These vector transforms are not implemented for this transform. */
   virtual OutputVectorType TransformVector( const InputVectorType & ) const
   {
@@ -288,6 +311,11 @@ protected:
   StackTransform();
   virtual ~StackTransform() {}
 
+  /** Check if all sub transforms are B-splines on the grid of the first one,
+   * supporting shared weights. Returns the first one in that case, or NULL.
+   */
+  const SubTransformBSplineType * GetSharedWeightsBSpline( void ) const;
+
 private:
 
   StackTransform( const Self & );  // purposely not implemented
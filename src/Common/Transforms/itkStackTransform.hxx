@@ -19,6 +19,7 @@
 #define _itkStackTransform_hxx
 
 #include "itkStackTransform.h"
+#include <typeinfo>
 
 namespace itk
 {
@@ -114,10 +115,7 @@ StackTransform< TScalarType, NInputDimensions, NOutputDimensions >
 
   /** Transform point using right subtransform. */
   SubTransformOutputPointType oppr;
-  const unsigned int          subt
-    = vnl_math_min( this->m_NumberOfSubTransforms - 1, static_cast< unsigned int >(
-      vnl_math_max( 0,
-      vnl_math_rnd( ( ipp[ ReducedInputSpaceDimension ] - m_StackOrigin ) / m_StackSpacing ) ) ) );
+  const unsigned int          subt = this->GetSubTransformIndex( ipp );
   oppr = this->m_SubTransformContainer[ subt ]->TransformPoint( ippr );
 
   /** Increase dimension of input point. */
@@ -133,6 +131,98 @@ StackTransform< TScalarType, NInputDimensions, NOutputDimensions >
 } // end TransformPoint()
 
 
+/**
+ * ********************* GetSharedWeightsBSpline ****************************
+ */
+
+template< class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions >
+const typename StackTransform< TScalarType, NInputDimensions, NOutputDimensions >
+::SubTransformBSplineType
+* StackTransform< TScalarType, NInputDimensions, NOutputDimensions >
+::GetSharedWeightsBSpline( void ) const
+{
+  if( this->m_NumberOfSubTransforms == 0 )
+  {
+    return NULL;
+  }
+
+  const SubTransformBSplineType * first
+    = dynamic_cast< const SubTransformBSplineType * >( this->m_SubTransformContainer[ 0 ].GetPointer() );
+  if( first == NULL || !first->GetSupportsSharedWeights() )
+  {
+    return NULL;
+  }
+
+  /** The weights only apply to transforms of the same type and grid. */
+  for( unsigned int t = 1; t < this->m_NumberOfSubTransforms; ++t )
+  {
+    const SubTransformBSplineType * other
+      = dynamic_cast< const SubTransformBSplineType * >( this->m_SubTransformContainer[ t ].GetPointer() );
+    if( other == NULL
+      || typeid( *other ) != typeid( *first )
+      || other->GetGridRegion() != first->GetGridRegion()
+      || other->GetGridSpacing() != first->GetGridSpacing()
+      || other->GetGridOrigin() != first->GetGridOrigin()
+      || other->GetGridDirection() != first->GetGridDirection() )
+    {
+      return NULL;
+    }
+  }
+
+  return first;
+
+} // end GetSharedWeightsBSpline()
+
+
+/**
+ * ********************* TransformPointInAllSubTransforms ****************************
+ */
+
+template< class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions >
+void
+StackTransform< TScalarType, NInputDimensions, NOutputDimensions >
+::TransformPointInAllSubTransforms(
+  const SubTransformInputPointType & ippr,
+  std::vector< SubTransformOutputPointType > & opprs ) const
+{
+  opprs.resize( this->m_NumberOfSubTransforms );
+
+  const SubTransformBSplineType * bspline = this->GetSharedWeightsBSpline();
+  if( bspline == NULL )
+  {
+    /** General case: transform by each sub transform separately. */
+    for( unsigned int t = 0; t < this->m_NumberOfSubTransforms; ++t )
+    {
+      opprs[ t ] = this->m_SubTransformContainer[ t ]->TransformPoint( ippr );
+    }
+    return;
+  }
+
+  /** Compute the interpolation weights once, and reuse them for all sub transforms. */
+  typename SubTransformBSplineType::WeightsType weights( bspline->GetNumberOfAffectedWeights() );
+  typename SubTransformBSplineType::IndexType   supportIndex;
+  const bool inside = bspline->ComputeWeightsAndSupportIndex( ippr, weights, supportIndex );
+
+  for( unsigned int t = 0; t < this->m_NumberOfSubTransforms; ++t )
+  {
+    if( !inside )
+    {
+      /** Outside the valid region the displacement is zero. */
+      for( unsigned int d = 0; d < ReducedOutputSpaceDimension; ++d )
+      {
+        opprs[ t ][ d ] = ippr[ d ];
+      }
+      continue;
+    }
+
+    const SubTransformBSplineType * subBSpline
+      = dynamic_cast< const SubTransformBSplineType * >( this->m_SubTransformContainer[ t ].GetPointer() );
+    opprs[ t ] = subBSpline->TransformPointUsingWeights( ippr, weights, supportIndex );
+  }
+
+} // end TransformPointInAllSubTransforms()
+
+
 /**
  * ********************* GetJacobian ****************************
  */
@@ -153,10 +243,7 @@ StackTransform< TScalarType, NInputDimensions, NOutputDimensions >
   }
 
   /** Get Jacobian from right subtransform. */
-  const unsigned int subt
-    = vnl_math_min( this->m_NumberOfSubTransforms - 1, static_cast< unsigned int >(
-      vnl_math_max( 0,
-      vnl_math_rnd( ( ipp[ ReducedInputSpaceDimension ] - m_StackOrigin ) / m_StackSpacing ) ) ) );
+  const unsigned int       subt = this->GetSubTransformIndex( ipp );
   SubTransformJacobianType subjac;
   this->m_SubTransformContainer[ subt ]->GetJacobian( ippr, subjac, nzji );
 
@@ -60,7 +60,9 @@ namespace itk
  * ProcessObject::GenerateOutputInformation().
  *
  * This filter is implemented as a multithreaded filter.  It provides a
- * ThreadedGenerateData() method for its implementation.
+ * ThreadedGenerateData() method for its implementation. Only the requested
+ * region is generated, so the output can be streamed, for example by
+ * ImageFileWriter::SetNumberOfStreamDivisions().
  *
  * \author Marius Staring, Leiden University Medical Center, The Netherlands.
  *
@@ -38,7 +38,7 @@
 
 #include "itkAdvancedIdentityTransform.h"
 #include "itkProgressReporter.h"
-#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
 #include "vnl/vnl_det.h"
 
 namespace itk
@@ -244,13 +244,25 @@ TransformToDeterminantOfSpatialJacobianSource< TOutputImage, TTransformPrecision
   // Get the output pointer
   OutputImagePointer outputPtr = this->GetOutput();
 
-  // Create an iterator that will walk the output region for this thread.
-  typedef ImageRegionIteratorWithIndex< TOutputImage > OutputIteratorType;
+  // Create an iterator that will walk the output region for this thread
+  // line by line.
+  typedef ImageScanlineIterator< TOutputImage > OutputIteratorType;
   OutputIteratorType it( outputPtr, outputRegionForThread );
   it.GoToBegin();
 
   // pixel coordinates
-  PointType point;
+  PointType lineStart, point;
+
+  // The physical step between two neighbouring voxels along a scan line,
+  // so that only the first point of each line needs the full index to
+  // point computation. The other points are computed from the start of
+  // the line, rather than accumulated, to avoid the growth of rounding errors.
+  // Note that the B-spline weights are still computed for every voxel.
+  typename PointType::VectorType lineStep;
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+  {
+    lineStep[ i ] = outputPtr->GetDirection()[ i ][ 0 ] * outputPtr->GetSpacing()[ 0 ];
+  }
 
   // Support for progress methods/callbacks
   ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
@@ -258,19 +270,25 @@ TransformToDeterminantOfSpatialJacobianSource< TOutputImage, TTransformPrecision
   // Walk the output region
   while( !it.IsAtEnd() )
   {
-    // Determine the coordinates of the current voxel
-    outputPtr->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+    // Determine the coordinates of the first voxel of this line
+    outputPtr->TransformIndexToPhysicalPoint( it.GetIndex(), lineStart );
 
-    SpatialJacobianType sj;
-    this->m_Transform->GetSpatialJacobian( point, sj );
-    const PixelType detjac = static_cast< PixelType >( vnl_det( sj.GetVnlMatrix() ) );
+    for( unsigned long i = 0; !it.IsAtEndOfLine(); ++i )
+    {
+      point = lineStart + lineStep * static_cast< double >( i );
+      SpatialJacobianType sj;
+      this->m_Transform->GetSpatialJacobian( point, sj );
+      const PixelType detjac = static_cast< PixelType >( vnl_det( sj.GetVnlMatrix() ) );
 
-    // Set it
-    it.Set( detjac );
+      // Set it
+      it.Set( detjac );
 
-    // Update progress and iterator
-    progress.CompletedPixel();
-    ++it;
+      // Update progress and iterator
+      progress.CompletedPixel();
+      ++it;
+    }
+
+    it.NextLine();
   }
 
 } // end NonlinearThreadedGenerateData()
@@ -323,7 +341,9 @@ TransformToDeterminantOfSpatialJacobianSource< TOutputImage, TTransformPrecision
   outputPtr->SetSpacing( m_OutputSpacing );
   outputPtr->SetOrigin( m_OutputOrigin );
   outputPtr->SetDirection( m_OutputDirection );
-  outputPtr->Allocate();
+
+  // Note that the output is not allocated here, but in GenerateData()
+  // for the requested region only, so that it can be streamed.
 
 } // end GenerateOutputInformation()
 
@@ -0,0 +1,264 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkTransformToInverseDisplacementFieldSource_h
+#define __itkTransformToInverseDisplacementFieldSource_h
+
+#include "itkAdvancedTransform.h"
+#include "itkImageSource.h"
+#include "itkVectorLinearInterpolateImageFunction.h"
+#include <vector>
+
+namespace itk
+{
+
+/** \class TransformToInverseDisplacementFieldSource
+ * \brief Generate the displacement field of the inverse of a coordinate transform.
+ *
+ * For every output voxel y the point x with T(x) = y is found by the
+ * fixed-point iteration x_{k+1} = x_k - ( T(x_k) - y ), which converges
+ * when the spatial derivative of the displacement of T has a norm smaller
+ * than one, as is the case for invertible B-spline transforms of moderate
+ * magnitude. The output pixel is the displacement x - y, so that the output
+ * can be used as the inverse transform, defined on the output grid.
+ *
+ * The iteration is seeded by the inverse computed on a grid that is
+ * CoarseGridFactor times coarser than the output. Where that is not
+ * available, the solution of the previous voxel on the scan line is used,
+ * or the negated forward displacement for the first voxel of a line.
+ * Points that do not converge within MaximumNumberOfIterations get the
+ * best iterate, and are counted in GetNumberOfNonConvergedPoints().
+ *
+ * Output information (spacing, size and direction) for the output
+ * image should be set, similar to the TransformToDeterminantOfSpatialJacobianSource.
+ *
+ * This filter is implemented as a multithreaded filter. Only the requested
+ * region is generated, so the output can be streamed, for example by
+ * ImageFileWriter::SetNumberOfStreamDivisions(). The coarse seed is computed
+ * once for the whole output and reused by all stream divisions.
+ *
+ * Additionally, ComputeInverseBSplineParameters() fits the inverse with a
+ * B-spline, which interpolates the inverse at the grid nodes.
+ *
+ * \ingroup GeometricTransforms
+ */
+template< class TOutputImage,
+class TTransformPrecisionType = double >
+class TransformToInverseDisplacementFieldSource :
+  public ImageSource< TOutputImage >
+{
+public:
+
+  /** Standard class typedefs. */
+  typedef TransformToInverseDisplacementFieldSource Self;
+  typedef ImageSource< TOutputImage >               Superclass;
+  typedef SmartPointer< Self >                      Pointer;
+  typedef SmartPointer< const Self >                ConstPointer;
+
+  typedef TOutputImage                           OutputImageType;
+  typedef typename OutputImageType::Pointer      OutputImagePointer;
+  typedef typename OutputImageType::ConstPointer OutputImageConstPointer;
+  typedef typename OutputImageType::RegionType   OutputImageRegionType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( TransformToInverseDisplacementFieldSource, ImageSource );
+
+  /** Number of dimensions. */
+  itkStaticConstMacro( ImageDimension, unsigned int,
+    TOutputImage::ImageDimension );
+
+  /** Typedefs for transform. */
+  typedef AdvancedTransform< TTransformPrecisionType,
+    itkGetStaticConstMacro( ImageDimension ),
+    itkGetStaticConstMacro( ImageDimension ) >     TransformType;
+  typedef typename TransformType::ConstPointer   TransformPointerType;
+  typedef typename TransformType::InputPointType InputPointType;
+  typedef typename TransformType::ParametersType ParametersType;
+
+  /** Typedefs for output image. */
+  typedef typename OutputImageType::PixelType     PixelType;
+  typedef typename PixelType::ValueType           PixelValueType;
+  typedef typename OutputImageType::RegionType    RegionType;
+  typedef typename RegionType::SizeType           SizeType;
+  typedef typename OutputImageType::IndexType     IndexType;
+  typedef typename OutputImageType::PointType     PointType;
+  typedef typename OutputImageType::SpacingType   SpacingType;
+  typedef typename OutputImageType::PointType     OriginType;
+  typedef typename OutputImageType::DirectionType DirectionType;
+
+  /** Typedefs for base image. */
+  typedef ImageBase< itkGetStaticConstMacro( ImageDimension ) > ImageBaseType;
+
+  /** Set the coordinate transformation to invert. */
+  itkSetConstObjectMacro( Transform, TransformType );
+
+  /** Get a pointer to the coordinate transform. */
+  itkGetConstObjectMacro( Transform, TransformType );
+
+  /** Set the size of the output image. */
+  virtual void SetOutputSize( const SizeType & size );
+
+  /** Get the size of the output image. */
+  virtual const SizeType & GetOutputSize();
+
+  /** Set the start index of the output largest possible region.
+  * The default is an index of all zeros. */
+  virtual void SetOutputIndex( const IndexType & index );
+
+  /** Get the start index of the output largest possible region. */
+  virtual const IndexType & GetOutputIndex();
+
+  /** Set the region of the output image. */
+  itkSetMacro( OutputRegion, OutputImageRegionType );
+
+  /** Get the region of the output image. */
+  itkGetConstReferenceMacro( OutputRegion, OutputImageRegionType );
+
+  /** Set the output image spacing. */
+  itkSetMacro( OutputSpacing, SpacingType );
+  virtual void SetOutputSpacing( const double * values );
+
+  /** Get the output image spacing. */
+  itkGetConstReferenceMacro( OutputSpacing, SpacingType );
+
+  /** Set the output image origin. */
+  itkSetMacro( OutputOrigin, OriginType );
+  virtual void SetOutputOrigin( const double * values );
+
+  /** Get the output image origin. */
+  itkGetConstReferenceMacro( OutputOrigin, OriginType );
+
+  /** Set the output direction cosine matrix. */
+  itkSetMacro( OutputDirection, DirectionType );
+  itkGetConstReferenceMacro( OutputDirection, DirectionType );
+
+  /** Helper method to set the output parameters based on this image */
+  void SetOutputParametersFromImage( const ImageBaseType * image );
+
+  /** Set/Get the maximum number of fixed-point iterations per point. Default: 50. */
+  itkSetMacro( MaximumNumberOfIterations, unsigned int );
+  itkGetConstMacro( MaximumNumberOfIterations, unsigned int );
+
+  /** Set/Get the tolerance on || T(x) - y ||, in physical units. Default: 1e-3. */
+  itkSetMacro( Tolerance, double );
+  itkGetConstMacro( Tolerance, double );
+
+  /** Set/Get the factor by which the seeding grid is coarser than the
+   * output grid. A factor of 1 disables the coarse seed. Default: 4.
+   */
+  itkSetMacro( CoarseGridFactor, unsigned int );
+  itkGetConstMacro( CoarseGridFactor, unsigned int );
+
+  /** Get the number of points that did not converge, and the largest
+   * residual || T(x) - y ||, accumulated over all stream divisions.
+   */
+  itkGetConstMacro( NumberOfNonConvergedPoints, SizeValueType );
+  itkGetConstMacro( MaximumResidual, double );
+
+  /** Solve T(x) = point by fixed-point iteration. On input, inversePoint
+   * contains the initial guess. On output it contains the best iterate, and
+   * residual the corresponding || T(x) - point ||. Returns true if the
+   * tolerance was reached. This function is thread-safe.
+   */
+  bool EvaluateInverse(
+    const InputPointType & point,
+    InputPointType & inversePoint,
+    double & residual ) const;
+
+  /** Fit the inverse with a B-spline on the given grid. The inverse is
+   * computed at the grid nodes with the threads of this filter, and the
+   * B-spline coefficients are obtained by B-spline decomposition, so that
+   * the B-spline interpolates the inverse displacement at the nodes. The
+   * parameters are ordered as for the AdvancedBSplineDeformableTransform.
+   */
+  virtual void ComputeInverseBSplineParameters(
+    const RegionType & gridRegion,
+    const SpacingType & gridSpacing,
+    const OriginType & gridOrigin,
+    const DirectionType & gridDirection,
+    const unsigned int splineOrder,
+    ParametersType & parameters ) const;
+
+  /** Set the output information. The output is only allocated for the requested region. */
+  virtual void GenerateOutputInformation( void );
+
+  /** Check if the transform is set, and compute the coarse seed if needed. */
+  virtual void BeforeThreadedGenerateData( void );
+
+  /** Accumulate the convergence statistics of the threads. */
+  virtual void AfterThreadedGenerateData( void );
+
+  /** Compute the Modified Time based on changes to the components. */
+  unsigned long GetMTime( void ) const;
+
+protected:
+
+  TransformToInverseDisplacementFieldSource();
+  ~TransformToInverseDisplacementFieldSource() {}
+
+  void PrintSelf( std::ostream & os, Indent indent ) const;
+
+  /** Compute the inverse for the region of a thread. */
+  void ThreadedGenerateData(
+    const OutputImageRegionType & outputRegionForThread,
+    ThreadIdType threadId );
+
+  /** Compute the inverse on a coarse grid, to seed the iteration. */
+  virtual void ComputeCoarseDisplacementField( void );
+
+private:
+
+  TransformToInverseDisplacementFieldSource( const Self & ); // purposely not implemented
+  void operator=( const Self & );                            // purposely not implemented
+
+  typedef VectorLinearInterpolateImageFunction<
+    OutputImageType, double >                         CoarseInterpolatorType;
+  typedef typename CoarseInterpolatorType::Pointer CoarseInterpolatorPointer;
+
+  /** Member variables. */
+  RegionType           m_OutputRegion;         // region of the output image
+  TransformPointerType m_Transform;            // Coordinate transform to invert
+  SpacingType          m_OutputSpacing;        // output image spacing
+  OriginType           m_OutputOrigin;         // output image origin
+  DirectionType        m_OutputDirection;      // output image direction cosines
+
+  unsigned int m_MaximumNumberOfIterations;
+  double       m_Tolerance;
+  unsigned int m_CoarseGridFactor;
+
+  SizeValueType m_NumberOfNonConvergedPoints;
+  double        m_MaximumResidual;
+
+  std::vector< SizeValueType > m_NumberOfNonConvergedPointsPerThread;
+  std::vector< double >        m_MaximumResidualPerThread;
+
+  OutputImagePointer        m_CoarseDisplacementField;
+  CoarseInterpolatorPointer m_CoarseInterpolator;
+  TimeStamp                 m_CoarseDisplacementFieldTime;
+
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkTransformToInverseDisplacementFieldSource.hxx"
+#endif
+
+#endif // end #ifndef __itkTransformToInverseDisplacementFieldSource_h
@@ -0,0 +1,580 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkTransformToInverseDisplacementFieldSource_hxx
+#define __itkTransformToInverseDisplacementFieldSource_hxx
+
+#include "itkTransformToInverseDisplacementFieldSource.h"
+
+#include "itkAdvancedIdentityTransform.h"
+#include "itkProgressReporter.h"
+#include "itkImageScanlineIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkBSplineDecompositionImageFilter.h"
+#include "vnl/vnl_math.h"
+
+namespace itk
+{
+
+/**
+ * Constructor
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::TransformToInverseDisplacementFieldSource()
+{
+  this->m_OutputSpacing.Fill( 1.0 );
+  this->m_OutputOrigin.Fill( 0.0 );
+  this->m_OutputDirection.SetIdentity();
+
+  SizeType size;
+  size.Fill( 0 );
+  this->m_OutputRegion.SetSize( size );
+
+  IndexType index;
+  index.Fill( 0 );
+  this->m_OutputRegion.SetIndex( index );
+
+  this->m_Transform = AdvancedIdentityTransform< TTransformPrecisionType, ImageDimension >::New();
+
+  this->m_MaximumNumberOfIterations  = 50;
+  this->m_Tolerance                  = 1e-3;
+  this->m_CoarseGridFactor           = 4;
+  this->m_NumberOfNonConvergedPoints = 0;
+  this->m_MaximumResidual            = 0.0;
+
+} // end Constructor
+
+
+/**
+ * Print out a description of self
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "OutputRegion: " << this->m_OutputRegion << std::endl;
+  os << indent << "OutputSpacing: " << this->m_OutputSpacing << std::endl;
+  os << indent << "OutputOrigin: " << this->m_OutputOrigin << std::endl;
+  os << indent << "OutputDirection: " << this->m_OutputDirection << std::endl;
+  os << indent << "Transform: " << this->m_Transform.GetPointer() << std::endl;
+  os << indent << "MaximumNumberOfIterations: " << this->m_MaximumNumberOfIterations << std::endl;
+  os << indent << "Tolerance: " << this->m_Tolerance << std::endl;
+  os << indent << "CoarseGridFactor: " << this->m_CoarseGridFactor << std::endl;
+  os << indent << "NumberOfNonConvergedPoints: " << this->m_NumberOfNonConvergedPoints << std::endl;
+  os << indent << "MaximumResidual: " << this->m_MaximumResidual << std::endl;
+
+} // end PrintSelf()
+
+
+/**
+ * Set the output image size.
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::SetOutputSize( const SizeType & size )
+{
+  this->m_OutputRegion.SetSize( size );
+}
+
+
+/**
+ * Get the output image size.
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+const typename TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::SizeType
+& TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::GetOutputSize()
+{
+  return this->m_OutputRegion.GetSize();
+}
+
+
+/**
+ * Set the output image index.
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::SetOutputIndex( const IndexType & index )
+{
+  this->m_OutputRegion.SetIndex( index );
+}
+
+
+/**
+ * Get the output image index.
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+const typename TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::IndexType
+& TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::GetOutputIndex()
+{
+  return this->m_OutputRegion.GetIndex();
+}
+
+
+/**
+ * Set the output image spacing.
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::SetOutputSpacing( const double * spacing )
+{
+  SpacingType s( spacing );
+  this->SetOutputSpacing( s );
+
+} // end SetOutputSpacing()
+
+
+/**
+ * Set the output image origin.
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::SetOutputOrigin( const double * origin )
+{
+  OriginType p( origin );
+  this->SetOutputOrigin( p );
+
+} // end SetOutputOrigin()
+
+
+/** Helper method to set the output parameters based on this image */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::SetOutputParametersFromImage( const ImageBaseType * image )
+{
+  if( !image )
+  {
+    itkExceptionMacro( << "Cannot use a null image reference" );
+  }
+
+  this->SetOutputOrigin( image->GetOrigin() );
+  this->SetOutputSpacing( image->GetSpacing() );
+  this->SetOutputDirection( image->GetDirection() );
+  this->SetOutputRegion( image->GetLargestPossibleRegion() );
+
+} // end SetOutputParametersFromImage()
+
+
+/**
+ * EvaluateInverse
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+bool
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::EvaluateInverse(
+  const InputPointType & point,
+  InputPointType & inversePoint,
+  double & residual ) const
+{
+  InputPointType bestPoint    = inversePoint;
+  double         bestResidual = NumericTraits< double >::max();
+
+  for( unsigned int iter = 0; iter <= this->m_MaximumNumberOfIterations; ++iter )
+  {
+    /** Compute the residual T(x_k) - y. */
+    const typename TransformType::OutputPointType mappedPoint
+      = this->m_Transform->TransformPoint( inversePoint );
+    typename InputPointType::VectorType difference;
+    double residual2 = 0.0;
+    for( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+      difference[ i ] = mappedPoint[ i ] - point[ i ];
+      residual2      += difference[ i ] * difference[ i ];
+    }
+
+    /** Remember the best iterate, in case the iteration does not converge. */
+    const double currentResidual = vcl_sqrt( residual2 );
+    if( currentResidual < bestResidual )
+    {
+      bestResidual = currentResidual;
+      bestPoint    = inversePoint;
+    }
+    if( currentResidual <= this->m_Tolerance )
+    {
+      break;
+    }
+
+    /** x_{k+1} = x_k - ( T(x_k) - y ). */
+    inversePoint -= difference;
+  }
+
+  inversePoint = bestPoint;
+  residual     = bestResidual;
+  return bestResidual <= this->m_Tolerance;
+
+} // end EvaluateInverse()
+
+
+/**
+ * ComputeCoarseDisplacementField
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::ComputeCoarseDisplacementField( void )
+{
+  /** The coarse grid starts at the first output voxel and covers the last one. */
+  const unsigned int factor = this->m_CoarseGridFactor;
+  const SizeType     size   = this->m_OutputRegion.GetSize();
+  const IndexType    index  = this->m_OutputRegion.GetIndex();
+  SizeType           coarseSize;
+  SpacingType        coarseSpacing;
+  OriginType         coarseOrigin = this->m_OutputOrigin;
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+  {
+    coarseSize[ i ]    = ( size[ i ] > 0 ? ( size[ i ] - 1 ) / factor + 2 : 0 );
+    coarseSpacing[ i ] = this->m_OutputSpacing[ i ] * factor;
+    for( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+      coarseOrigin[ i ] += this->m_OutputDirection[ i ][ j ]
+        * this->m_OutputSpacing[ j ] * index[ j ];
+    }
+  }
+
+  /** Use an instance of this class, without coarse seed. */
+  Pointer coarseSource = Self::New();
+  coarseSource->SetTransform( this->m_Transform );
+  coarseSource->SetOutputSize( coarseSize );
+  coarseSource->SetOutputSpacing( coarseSpacing );
+  coarseSource->SetOutputOrigin( coarseOrigin );
+  coarseSource->SetOutputDirection( this->m_OutputDirection );
+  coarseSource->SetMaximumNumberOfIterations( this->m_MaximumNumberOfIterations );
+  coarseSource->SetTolerance( this->m_Tolerance );
+  coarseSource->SetCoarseGridFactor( 1 );
+  coarseSource->SetNumberOfThreads( this->GetNumberOfThreads() );
+  coarseSource->Update();
+
+  this->m_CoarseDisplacementField = coarseSource->GetOutput();
+  this->m_CoarseDisplacementField->DisconnectPipeline();
+
+  this->m_CoarseInterpolator = CoarseInterpolatorType::New();
+  this->m_CoarseInterpolator->SetInputImage( this->m_CoarseDisplacementField );
+  this->m_CoarseDisplacementFieldTime.Modified();
+
+} // end ComputeCoarseDisplacementField()
+
+
+/**
+ * Set up state of filter before multi-threading.
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::BeforeThreadedGenerateData( void )
+{
+  if( !this->m_Transform )
+  {
+    itkExceptionMacro( << "Transform not set" );
+  }
+
+  /** Compute the coarse seed only once for all stream divisions. */
+  if( this->m_CoarseGridFactor > 1 )
+  {
+    if( this->m_CoarseDisplacementField.IsNull()
+      || this->m_CoarseDisplacementFieldTime.GetMTime() < this->GetMTime() )
+    {
+      this->ComputeCoarseDisplacementField();
+    }
+  }
+  else
+  {
+    this->m_CoarseDisplacementField = 0;
+    this->m_CoarseInterpolator      = 0;
+  }
+
+  /** Initialize the convergence statistics per thread. */
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+  this->m_NumberOfNonConvergedPointsPerThread.assign( numberOfThreads, 0 );
+  this->m_MaximumResidualPerThread.assign( numberOfThreads, 0.0 );
+
+} // end BeforeThreadedGenerateData()
+
+
+/**
+ * ThreadedGenerateData
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::ThreadedGenerateData(
+  const OutputImageRegionType & outputRegionForThread,
+  ThreadIdType threadId )
+{
+  // Get the output pointer
+  OutputImagePointer outputPtr = this->GetOutput();
+
+  // Create an iterator that will walk the output region for this thread
+  // line by line.
+  typedef ImageScanlineIterator< TOutputImage > OutputIteratorType;
+  OutputIteratorType it( outputPtr, outputRegionForThread );
+  it.GoToBegin();
+
+  // The physical step between two neighbouring voxels along a scan line.
+  PointType                      point;
+  typename PointType::VectorType lineStep;
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+  {
+    lineStep[ i ] = outputPtr->GetDirection()[ i ][ 0 ] * outputPtr->GetSpacing()[ 0 ];
+  }
+
+  const bool    useCoarseSeed = this->m_CoarseInterpolator.IsNotNull();
+  SizeValueType numberOfNonConvergedPoints = 0;
+  double        maximumResidual            = 0.0;
+
+  // Support for progress methods/callbacks
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  // Walk the output region
+  while( !it.IsAtEnd() )
+  {
+    // Determine the coordinates of the first voxel of this line
+    outputPtr->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+    bool      previousAvailable = false;
+    PixelType previousDisplacement;
+
+    while( !it.IsAtEndOfLine() )
+    {
+      InputPointType inputPoint;
+      InputPointType inversePoint;
+      for( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+        inputPoint[ i ] = point[ i ];
+      }
+
+      // Seed the iteration
+      if( useCoarseSeed && this->m_CoarseInterpolator->IsInsideBuffer( point ) )
+      {
+        const typename CoarseInterpolatorType::OutputType seed
+          = this->m_CoarseInterpolator->Evaluate( point );
+        for( unsigned int i = 0; i < ImageDimension; ++i )
+        {
+          inversePoint[ i ] = inputPoint[ i ] + seed[ i ];
+        }
+      }
+      else if( previousAvailable )
+      {
+        for( unsigned int i = 0; i < ImageDimension; ++i )
+        {
+          inversePoint[ i ] = inputPoint[ i ] + previousDisplacement[ i ];
+        }
+      }
+      else
+      {
+        const typename TransformType::OutputPointType mappedPoint
+          = this->m_Transform->TransformPoint( inputPoint );
+        for( unsigned int i = 0; i < ImageDimension; ++i )
+        {
+          inversePoint[ i ] = 2.0 * inputPoint[ i ] - mappedPoint[ i ];
+        }
+      }
+
+      // Solve T(x) = y
+      double residual = 0.0;
+      if( !this->EvaluateInverse( inputPoint, inversePoint, residual ) )
+      {
+        ++numberOfNonConvergedPoints;
+      }
+      maximumResidual = vnl_math_max( maximumResidual, residual );
+
+      // Set the displacement x - y
+      PixelType displacement;
+      for( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+        displacement[ i ] = static_cast< PixelValueType >( inversePoint[ i ] - inputPoint[ i ] );
+      }
+      it.Set( displacement );
+      previousDisplacement = displacement;
+      previousAvailable    = true;
+
+      // Update progress, iterator and point
+      progress.CompletedPixel();
+      point += lineStep;
+      ++it;
+    }
+
+    it.NextLine();
+  }
+
+  this->m_NumberOfNonConvergedPointsPerThread[ threadId ] = numberOfNonConvergedPoints;
+  this->m_MaximumResidualPerThread[ threadId ]            = maximumResidual;
+
+} // end ThreadedGenerateData()
+
+
+/**
+ * AfterThreadedGenerateData
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::AfterThreadedGenerateData( void )
+{
+  /** Accumulate over the threads, and over the stream divisions. */
+  for( unsigned int t = 0; t < this->m_NumberOfNonConvergedPointsPerThread.size(); ++t )
+  {
+    this->m_NumberOfNonConvergedPoints += this->m_NumberOfNonConvergedPointsPerThread[ t ];
+    this->m_MaximumResidual = vnl_math_max( this->m_MaximumResidual, this->m_MaximumResidualPerThread[ t ] );
+  }
+
+} // end AfterThreadedGenerateData()
+
+
+/**
+ * ComputeInverseBSplineParameters
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::ComputeInverseBSplineParameters(
+  const RegionType & gridRegion,
+  const SpacingType & gridSpacing,
+  const OriginType & gridOrigin,
+  const DirectionType & gridDirection,
+  const unsigned int splineOrder,
+  ParametersType & parameters ) const
+{
+  typedef Image< double, ImageDimension >                               CoefficientImageType;
+  typedef ImageRegionConstIterator< OutputImageType >                   NodeIteratorType;
+  typedef ImageRegionIterator< CoefficientImageType >                   NodeImageIteratorType;
+  typedef ImageRegionConstIterator< CoefficientImageType >              CoefficientIteratorType;
+  typedef BSplineDecompositionImageFilter<
+    CoefficientImageType, CoefficientImageType >                        DecompositionFilterType;
+
+  /** Compute the inverse at the grid nodes, multi-threaded, with an
+   * instance of this class that has the grid as output.
+   */
+  Pointer nodeSource = Self::New();
+  nodeSource->SetTransform( this->m_Transform );
+  nodeSource->SetOutputSize( gridRegion.GetSize() );
+  nodeSource->SetOutputIndex( gridRegion.GetIndex() );
+  nodeSource->SetOutputSpacing( gridSpacing );
+  nodeSource->SetOutputOrigin( gridOrigin );
+  nodeSource->SetOutputDirection( gridDirection );
+  nodeSource->SetMaximumNumberOfIterations( this->m_MaximumNumberOfIterations );
+  nodeSource->SetTolerance( this->m_Tolerance );
+  nodeSource->SetCoarseGridFactor( 1 );
+  nodeSource->SetNumberOfThreads( this->GetNumberOfThreads() );
+  nodeSource->Update();
+
+  /** Images with the inverse displacement at the grid nodes. */
+  typename CoefficientImageType::Pointer nodeImages[ ImageDimension ];
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+  {
+    nodeImages[ i ] = CoefficientImageType::New();
+    nodeImages[ i ]->SetRegions( gridRegion );
+    nodeImages[ i ]->SetSpacing( gridSpacing );
+    nodeImages[ i ]->SetOrigin( gridOrigin );
+    nodeImages[ i ]->SetDirection( gridDirection );
+    nodeImages[ i ]->Allocate();
+
+    NodeIteratorType      nodeIt( nodeSource->GetOutput(), gridRegion );
+    NodeImageIteratorType nodeImageIt( nodeImages[ i ], gridRegion );
+    for( nodeIt.GoToBegin(), nodeImageIt.GoToBegin(); !nodeIt.IsAtEnd(); ++nodeIt, ++nodeImageIt )
+    {
+      nodeImageIt.Set( nodeIt.Get()[ i ] );
+    }
+  }
+
+  /** Convert the node values to B-spline coefficients. */
+  const unsigned int numberOfNodes = gridRegion.GetNumberOfPixels();
+  parameters.SetSize( ImageDimension * numberOfNodes );
+  for( unsigned int i = 0; i < ImageDimension; ++i )
+  {
+    typename DecompositionFilterType::Pointer decomposition = DecompositionFilterType::New();
+    decomposition->SetSplineOrder( splineOrder );
+    decomposition->SetInput( nodeImages[ i ] );
+    decomposition->Update();
+
+    CoefficientIteratorType coefIt( decomposition->GetOutput(), gridRegion );
+    unsigned int            k = i * numberOfNodes;
+    for( coefIt.GoToBegin(); !coefIt.IsAtEnd(); ++coefIt, ++k )
+    {
+      parameters[ k ] = coefIt.Get();
+    }
+  }
+
+} // end ComputeInverseBSplineParameters()
+
+
+/**
+ * Inform pipeline of required output region
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+void
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::GenerateOutputInformation( void )
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateOutputInformation();
+
+  // get pointer to the output
+  OutputImagePointer outputPtr = this->GetOutput();
+  if( !outputPtr )
+  {
+    return;
+  }
+
+  outputPtr->SetLargestPossibleRegion( m_OutputRegion );
+  outputPtr->SetSpacing( m_OutputSpacing );
+  outputPtr->SetOrigin( m_OutputOrigin );
+  outputPtr->SetDirection( m_OutputDirection );
+
+  // A new pass over the output starts, possibly in several stream divisions.
+  this->m_NumberOfNonConvergedPoints = 0;
+  this->m_MaximumResidual            = 0.0;
+
+} // end GenerateOutputInformation()
+
+
+/**
+ * Verify if any of the components has been modified.
+ */
+template< class TOutputImage, class TTransformPrecisionType >
+unsigned long
+TransformToInverseDisplacementFieldSource< TOutputImage, TTransformPrecisionType >
+::GetMTime( void ) const
+{
+  unsigned long latestTime = Object::GetMTime();
+
+  if( this->m_Transform )
+  {
+    if( latestTime < this->m_Transform->GetMTime() )
+    {
+      latestTime = this->m_Transform->GetMTime();
+    }
+  }
+
+  return latestTime;
+} // end GetMTime()
+
+
+} // end namespace itk
+
+#endif // end #ifndef __itkTransformToInverseDisplacementFieldSource_hxx
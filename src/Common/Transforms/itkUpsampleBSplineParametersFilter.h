@@ -20,6 +20,9 @@
 
 #include "itkObject.h"
 #include "itkArray.h"
+#include "itkMultiThreader.h"
+
+#include <vector>
 
 namespace itk
 {
@@ -33,6 +36,20 @@ namespace itk
  * on a denser grid. Therefore, the user needs to supply the old B-spline grid
  * (region, spacing, origin, direction), and the required B-spline grid.
  *
+ * The coefficient images of the different dimensions are upsampled
+ * concurrently, with the threads set by SetNumberOfThreads().
+ *
+ * Optionally, with SetUseDyadicRefinement( true ), the new coefficients are
+ * computed directly with the B-spline two-scale relation when the required
+ * grid is an exact dyadic refinement of the current grid (same direction,
+ * half the spacing, and control points that coincide with the current ones),
+ * and the B-spline order is odd. This is separable and multi-threaded over
+ * the image lines, and avoids the generic resample plus decomposition path.
+ * It treats the coefficients outside the current grid as zero, whereas the
+ * resample and decomposition filters mirror the image at its border. So both
+ * paths give the same coefficients in the interior of the grid, but not
+ * near its border.
+ *
  */
 
 template< class TArray, class TImage >
@@ -94,6 +111,22 @@ public:
   /** Set the B-spline order. */
   itkSetMacro( BSplineOrder, unsigned int );
 
+  /** Use the exact two-scale relation when the grid is refined dyadically.
+   * Default: false.
+   */
+  itkSetMacro( UseDyadicRefinement, bool );
+  itkGetConstMacro( UseDyadicRefinement, bool );
+  itkBooleanMacro( UseDyadicRefinement );
+
+  /** Get whether the last call to UpsampleParameters() used the dyadic path. */
+  itkGetConstMacro( UsedDyadicRefinement, bool );
+
+  /** Set the number of threads. */
+  void SetNumberOfThreads( ThreadIdType numberOfThreads )
+  {
+    this->m_Threader->SetNumberOfThreads( numberOfThreads );
+  }
+
   /** Compute the output parameter array. */
   virtual void UpsampleParameters( const ArrayType & param_in,
     ArrayType & param_out );
@@ -112,6 +145,26 @@ protected:
   /** Function that checks if upsampling is required. */
   virtual bool DoUpsampling( void );
 
+  /** Function that checks if the required grid is a dyadic refinement of the
+   * current grid. If so, the integer shift between the fine grid buffer
+   * index and twice the coarse grid buffer index is returned per dimension.
+   */
+  virtual bool IsDyadicRefinement( OffsetValueType shift[] ) const;
+
+  /** Upsample by the B-spline two-scale relation. */
+  virtual void DyadicUpsampleParameters( const ArrayType & param_in,
+    ArrayType & param_out, const OffsetValueType shift[] );
+
+  /** Upsample by resampling and B-spline decomposition. */
+  virtual void ResampleParameters( const ArrayType & param_in,
+    ArrayType & param_out );
+
+  /** Typedefs for multi-threading. */
+  typedef itk::MultiThreader             ThreaderType;
+  typedef ThreaderType::ThreadInfoStruct ThreadInfoType;
+
+  ThreaderType::Pointer m_Threader;
+
 private:
 
   UpsampleBSplineParametersFilter( const Self & ); // purposely not implemented
@@ -127,6 +180,42 @@ private:
   DirectionType m_RequiredGridDirection;
   RegionType    m_RequiredGridRegion;
   unsigned int  m_BSplineOrder;
+  bool          m_UseDyadicRefinement;
+  bool          m_UsedDyadicRefinement;
+
+  /** Struct for passing a 1D refinement pass to the threads. */
+  struct MultiThreaderRefineType
+  {
+    const ValueType *         st_InputBuffer;
+    ValueType *               st_OutputBuffer;
+    const ValueType *         st_Weights;
+    unsigned int              st_NumberOfWeights;
+    OffsetValueType           st_Shift;
+    SizeValueType             st_InputLength;
+    SizeValueType             st_OutputLength;
+    SizeValueType             st_Stride;
+    SizeValueType             st_NumberOfLines;
+  };
+
+  /** Struct for passing the generic upsampling to the threads. */
+  struct MultiThreaderResampleType
+  {
+    Self *                          st_Self;
+    ThreadIdType                    st_TotalNumberOfThreads;
+    const ArrayType *               st_ParametersIn;
+    ArrayType *                     st_ParametersOut;
+    std::vector< ExceptionObject > *st_Exceptions;
+    std::vector< int > *            st_Failed;
+  };
+
+  /** The callback functions. */
+  static ITK_THREAD_RETURN_TYPE RefineThreaderCallback( void * arg );
+
+  static ITK_THREAD_RETURN_TYPE ResampleThreaderCallback( void * arg );
+
+  /** Upsample a single coefficient image with the generic path. */
+  void ResampleCoefficientImage( const ArrayType & param_in,
+    ArrayType & param_out, unsigned int dim, ThreadIdType numberOfThreads );
 
 };
 
@@ -24,6 +24,8 @@
 #include "itkBSplineDecompositionImageFilter.h"
 #include "itkResampleImageFilter.h"
 
+#include "vnl/vnl_math.h"
+
 namespace itk
 {
 
@@ -35,7 +37,10 @@ template< class TArray, class TImage >
 UpsampleBSplineParametersFilter< TArray, TImage >
 ::UpsampleBSplineParametersFilter()
 {
-  this->m_BSplineOrder = 3;
+  this->m_BSplineOrder         = 3;
+  this->m_UseDyadicRefinement  = false;
+  this->m_UsedDyadicRefinement = false;
+  this->m_Threader             = ThreaderType::New();
 
   // Initialize grid settings.
   this->m_CurrentGridOrigin.Fill( 0.0 );
@@ -64,6 +69,333 @@ UpsampleBSplineParametersFilter< TArray, TImage >
     return;
   }
 
+  /** Use the exact two-scale relation if possible. */
+  this->m_UsedDyadicRefinement = false;
+  OffsetValueType shift[ Dimension ];
+  if( this->m_UseDyadicRefinement && this->IsDyadicRefinement( shift ) )
+  {
+    this->m_UsedDyadicRefinement = true;
+    this->DyadicUpsampleParameters( parameters_in, parameters_out, shift );
+    return;
+  }
+
+  /** Otherwise resample and decompose. */
+  this->ResampleParameters( parameters_in, parameters_out );
+
+} // end UpsampleParameters()
+
+
+/**
+ * ******************* IsDyadicRefinement *******************
+ */
+
+template< class TArray, class TImage >
+bool
+UpsampleBSplineParametersFilter< TArray, TImage >
+::IsDyadicRefinement( OffsetValueType shift[] ) const
+{
+  /** The two-scale relation maps control points onto control points
+   * only for odd spline orders.
+   */
+  if( this->m_BSplineOrder % 2 == 0 )
+  {
+    return false;
+  }
+
+  /** The grids should have the same orientation. */
+  if( this->m_CurrentGridDirection != this->m_RequiredGridDirection )
+  {
+    return false;
+  }
+
+  /** The spacing should be exactly halved. */
+  const double tolerance = 1e-4;
+  for( unsigned int i = 0; i < Dimension; ++i )
+  {
+    const double requiredSpacing = this->m_RequiredGridSpacing[ i ];
+    const double currentSpacing  = this->m_CurrentGridSpacing[ i ];
+    if( vnl_math_abs( 2.0 * requiredSpacing - currentSpacing )
+      > tolerance * currentSpacing )
+    {
+      return false;
+    }
+  }
+
+  /** The control points of the current grid should coincide with control
+   * points of the required grid. The physical point of the current grid
+   * index I equals the required grid index 2 * I + d, with d:
+   *   d = Direction^{-1} ( currentOrigin - requiredOrigin ) / requiredSpacing.
+   */
+  const typename DirectionType::InternalMatrixType inverseDirection
+    = this->m_CurrentGridDirection.GetInverse();
+  for( unsigned int i = 0; i < Dimension; ++i )
+  {
+    double d = 0.0;
+    for( unsigned int j = 0; j < Dimension; ++j )
+    {
+      d += inverseDirection( i, j )
+        * ( this->m_CurrentGridOrigin[ j ] - this->m_RequiredGridOrigin[ j ] );
+    }
+    d /= this->m_RequiredGridSpacing[ i ];
+
+    const OffsetValueType dRounded = static_cast< OffsetValueType >( vnl_math_rnd( d ) );
+    if( vnl_math_abs( d - static_cast< double >( dRounded ) ) > tolerance )
+    {
+      return false;
+    }
+
+    /** Convert to a shift between buffer indices. */
+    shift[ i ] = 2 * this->m_CurrentGridRegion.GetIndex()[ i ] + dRounded
+      - this->m_RequiredGridRegion.GetIndex()[ i ];
+  }
+
+  return true;
+
+} // end IsDyadicRefinement()
+
+
+/**
+ * ******************* DyadicUpsampleParameters *******************
+ */
+
+template< class TArray, class TImage >
+void
+UpsampleBSplineParametersFilter< TArray, TImage >
+::DyadicUpsampleParameters( const ArrayType & parameters_in,
+  ArrayType & parameters_out, const OffsetValueType shift[] )
+{
+  /** The two-scale relation of a centered B-spline of odd order n:
+   *   beta( x ) = sum_k 2^{-n} binom( n + 1, k + (n+1)/2 ) beta( 2x - k ),
+   * with k = -(n+1)/2 .. (n+1)/2. A coefficient c_l of the current grid
+   * therefore contributes w_k c_l to the required coefficient 2 l + shift + k.
+   * The relation is separable, so the dimensions are refined one by one.
+   */
+  const unsigned int       numberOfWeights = this->m_BSplineOrder + 2;
+  std::vector< ValueType > weights( numberOfWeights );
+  const double             scale    = 1.0 / static_cast< double >( 1u << this->m_BSplineOrder );
+  double                   binomial = 1.0;
+  for( unsigned int k = 0; k < numberOfWeights; ++k )
+  {
+    weights[ k ] = static_cast< ValueType >( scale * binomial );
+    binomial    *= static_cast< double >( numberOfWeights - 1 - k )
+      / static_cast< double >( k + 1 );
+  }
+
+  /** Create the new vector of output parameters, with the correct size. */
+  const SizeValueType requiredNumberOfPixels
+    = this->m_RequiredGridRegion.GetNumberOfPixels();
+  parameters_out.SetSize( requiredNumberOfPixels * Dimension );
+
+  /** The sizes of the intermediate buffers change from the current to the
+   * required size, one dimension at a time.
+   */
+  SizeValueType sizes[ Dimension ];
+  for( unsigned int i = 0; i < Dimension; ++i )
+  {
+    sizes[ i ] = this->m_CurrentGridRegion.GetSize()[ i ];
+  }
+
+  std::vector< ValueType > bufferA;
+  std::vector< ValueType > bufferB;
+  const ValueType *        inputBuffer = parameters_in.data_block();
+
+  MultiThreaderRefineType temp;
+  temp.st_Weights         = &weights[ 0 ];
+  temp.st_NumberOfWeights = numberOfWeights;
+
+  for( unsigned int i = 0; i < Dimension; ++i )
+  {
+    /** Lines along dimension i: stride is the product of the lower sizes,
+     * the number of lines includes all coefficient images.
+     */
+    SizeValueType stride = 1;
+    for( unsigned int j = 0; j < i; ++j ) { stride *= sizes[ j ]; }
+    SizeValueType outer = Dimension;
+    for( unsigned int j = i + 1; j < Dimension; ++j ) { outer *= sizes[ j ]; }
+
+    const SizeValueType outputLength = this->m_RequiredGridRegion.GetSize()[ i ];
+
+    /** The last pass writes directly into the output parameters. */
+    ValueType * outputBuffer = parameters_out.data_block();
+    if( i + 1 < Dimension )
+    {
+      std::vector< ValueType > & buffer = ( i % 2 == 0 ) ? bufferA : bufferB;
+      buffer.resize( outer * outputLength * stride );
+      outputBuffer = &buffer[ 0 ];
+    }
+
+    temp.st_InputBuffer    = inputBuffer;
+    temp.st_OutputBuffer   = outputBuffer;
+    temp.st_Shift          = shift[ i ];
+    temp.st_InputLength    = sizes[ i ];
+    temp.st_OutputLength   = outputLength;
+    temp.st_Stride         = stride;
+    temp.st_NumberOfLines  = outer * stride;
+
+    this->m_Threader->SetSingleMethod( RefineThreaderCallback, (void *)( &temp ) );
+    this->m_Threader->SingleMethodExecute();
+
+    sizes[ i ]  = outputLength;
+    inputBuffer = outputBuffer;
+  }
+
+} // end DyadicUpsampleParameters()
+
+
+/**
+ * ******************* RefineThreaderCallback *******************
+ */
+
+template< class TArray, class TImage >
+ITK_THREAD_RETURN_TYPE
+UpsampleBSplineParametersFilter< TArray, TImage >
+::RefineThreaderCallback( void * arg )
+{
+  /** Get the current thread id and user data. */
+  ThreadInfoType *          infoStruct = static_cast< ThreadInfoType * >( arg );
+  const ThreadIdType        threadID   = infoStruct->ThreadID;
+  const ThreadIdType        nrOfThreads = infoStruct->NumberOfThreads;
+  MultiThreaderRefineType * temp
+    = static_cast< MultiThreaderRefineType * >( infoStruct->UserData );
+
+  /** Compute the range of lines for this thread. */
+  const SizeValueType numberOfLines = temp->st_NumberOfLines;
+  const SizeValueType subSize = ( numberOfLines + nrOfThreads - 1 ) / nrOfThreads;
+  const SizeValueType lmin    = threadID * subSize;
+  SizeValueType       lmax    = ( threadID + 1 ) * subSize;
+  lmax = ( lmax > numberOfLines ) ? numberOfLines : lmax;
+
+  const SizeValueType   stride      = temp->st_Stride;
+  const SizeValueType   inLength    = temp->st_InputLength;
+  const SizeValueType   outLength   = temp->st_OutputLength;
+  const OffsetValueType halfSupport = ( temp->st_NumberOfWeights - 1 ) / 2;
+  const OffsetValueType shift       = temp->st_Shift;
+  const ValueType *     weights     = temp->st_Weights;
+
+  for( SizeValueType l = lmin; l < lmax; ++l )
+  {
+    const SizeValueType o = l / stride;
+    const SizeValueType s = l % stride;
+    const ValueType *   in  = temp->st_InputBuffer + o * inLength * stride + s;
+    ValueType *         out = temp->st_OutputBuffer + o * outLength * stride + s;
+
+    for( SizeValueType m = 0; m < outLength; ++m )
+    {
+      /** Sum the contributions w_k c_j with 2 j + shift + k = m. */
+      ValueType value = NumericTraits< ValueType >::Zero;
+      for( OffsetValueType k = -halfSupport; k <= halfSupport; ++k )
+      {
+        const OffsetValueType t = static_cast< OffsetValueType >( m ) - shift - k;
+        if( t % 2 != 0 ) { continue; }
+        const OffsetValueType j = t / 2;
+        if( j < 0 || j >= static_cast< OffsetValueType >( inLength ) ) { continue; }
+        value += weights[ k + halfSupport ] * in[ j * stride ];
+      }
+      out[ m * stride ] = value;
+    }
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end RefineThreaderCallback()
+
+
+/**
+ * ******************* ResampleParameters *******************
+ */
+
+template< class TArray, class TImage >
+void
+UpsampleBSplineParametersFilter< TArray, TImage >
+::ResampleParameters( const ArrayType & parameters_in,
+  ArrayType & parameters_out )
+{
+  /** Create the new vector of output parameters, with the correct size. */
+  const unsigned int requiredNumberOfPixels
+    = this->m_RequiredGridRegion.GetNumberOfPixels();
+  parameters_out.SetSize( requiredNumberOfPixels * Dimension );
+
+  /** Each direction is upsampled separately, so process them concurrently.
+   * Exceptions are caught in the threads and passed on afterwards.
+   */
+  std::vector< ExceptionObject > exceptions( Dimension );
+  std::vector< int >             failed( Dimension, 0 );
+
+  MultiThreaderResampleType temp;
+  temp.st_Self                 = this;
+  temp.st_TotalNumberOfThreads = this->m_Threader->GetNumberOfThreads();
+  temp.st_ParametersIn         = &parameters_in;
+  temp.st_ParametersOut        = &parameters_out;
+  temp.st_Exceptions           = &exceptions;
+  temp.st_Failed               = &failed;
+
+  const ThreadIdType nrOfThreads = this->m_Threader->GetNumberOfThreads();
+  this->m_Threader->SetNumberOfThreads( vnl_math_min(
+    nrOfThreads, static_cast< ThreadIdType >( Dimension ) ) );
+  this->m_Threader->SetSingleMethod( ResampleThreaderCallback, (void *)( &temp ) );
+  this->m_Threader->SingleMethodExecute();
+  this->m_Threader->SetNumberOfThreads( nrOfThreads );
+
+  for( unsigned int j = 0; j < Dimension; ++j )
+  {
+    if( failed[ j ] )
+    {
+      throw exceptions[ j ];
+    }
+  }
+
+} // end ResampleParameters()
+
+
+/**
+ * ******************* ResampleThreaderCallback *******************
+ */
+
+template< class TArray, class TImage >
+ITK_THREAD_RETURN_TYPE
+UpsampleBSplineParametersFilter< TArray, TImage >
+::ResampleThreaderCallback( void * arg )
+{
+  /** Get the current thread id and user data. */
+  ThreadInfoType *            infoStruct  = static_cast< ThreadInfoType * >( arg );
+  const ThreadIdType          threadID    = infoStruct->ThreadID;
+  const ThreadIdType          nrOfThreads = infoStruct->NumberOfThreads;
+  MultiThreaderResampleType * temp
+    = static_cast< MultiThreaderResampleType * >( infoStruct->UserData );
+
+  /** Divide the threads of the filter over the filters of this thread. */
+  const ThreadIdType innerThreads = vnl_math_max( static_cast< ThreadIdType >( 1 ),
+    static_cast< ThreadIdType >( temp->st_TotalNumberOfThreads / nrOfThreads ) );
+
+  for( unsigned int j = threadID; j < Dimension; j += nrOfThreads )
+  {
+    try
+    {
+      temp->st_Self->ResampleCoefficientImage( *temp->st_ParametersIn,
+        *temp->st_ParametersOut, j, innerThreads );
+    }
+    catch( ExceptionObject & excp )
+    {
+      ( *temp->st_Exceptions )[ j ] = excp;
+      ( *temp->st_Failed )[ j ]     = 1;
+    }
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end ResampleThreaderCallback()
+
+
+/**
+ * ******************* ResampleCoefficientImage *******************
+ */
+
+template< class TArray, class TImage >
+void
+UpsampleBSplineParametersFilter< TArray, TImage >
+::ResampleCoefficientImage( const ArrayType & parameters_in,
+  ArrayType & parameters_out, unsigned int j, ThreadIdType numberOfThreads )
+{
   /** Typedefs. */
   typedef itk::ResampleImageFilter<
     ImageType, ImageType >                        UpsampleFilterType;
@@ -78,14 +410,11 @@ UpsampleBSplineParametersFilter< TArray, TImage >
   const unsigned int requiredNumberOfPixels
     = this->m_RequiredGridRegion.GetNumberOfPixels();
 
-  /** Create the new vector of output parameters, with the correct size. */
-  parameters_out.SetSize( requiredNumberOfPixels * Dimension );
-
-  /** Get the pointer to the data of the input parameters. */
+  /** Get the pointer to the data of the input parameters of dimension j. */
   PixelType * inputDataPointer
-    = const_cast< PixelType * >( parameters_in.data_block() );
-  PixelType * outputDataPointer
-    = const_cast< PixelType * >( parameters_out.data_block() );
+    = const_cast< PixelType * >( parameters_in.data_block() )
+    + currentNumberOfPixels * j;
+  PixelType * outputDataPointer = parameters_out.data_block();
 
   /** The input parameters are represented as a coefficient image. */
   ImagePointer coeffs_in = ImageType::New();
@@ -94,74 +423,70 @@ UpsampleBSplineParametersFilter< TArray, TImage >
   coeffs_in->SetDirection( this->m_CurrentGridDirection );
   coeffs_in->SetRegions( this->m_CurrentGridRegion );
 
-  /** Loop over dimension: each direction is upsampled separately. */
-  for( unsigned int j = 0; j < Dimension; j++ )
+  /** Fill the coefficient image with parameter data. */
+  coeffs_in->GetPixelContainer()->SetImportPointer(
+    inputDataPointer, currentNumberOfPixels );
+
+  /** Set the coefficient image as the input of the upsampler filter.
+   * The upsampler samples the deformation field at the locations
+   * of the new control points, given the current coefficients
+   * (note: it does not just interpolate the coefficient image,
+   * which would be wrong). The B-spline coefficients that
+   * describe the resulting image are computed by the
+   * decomposition filter.
+   *
+   * This code is derived from the itk-example DeformableRegistration6.cxx.
+   */
+  typename UpsampleFilterType::Pointer upsampler
+    = UpsampleFilterType::New();
+  typename CoefficientUpsampleFunctionType::Pointer coeffUpsampleFunction
+    = CoefficientUpsampleFunctionType::New();
+  typename DecompositionFilterType::Pointer decompositionFilter
+    = DecompositionFilterType::New();
+
+  /** Setup the upsampler. */
+  upsampler->SetInterpolator( coeffUpsampleFunction );
+  upsampler->SetSize( this->m_RequiredGridRegion.GetSize() );
+  upsampler->SetOutputStartIndex( this->m_RequiredGridRegion.GetIndex() );
+  upsampler->SetOutputSpacing( this->m_RequiredGridSpacing );
+  upsampler->SetOutputOrigin( this->m_RequiredGridOrigin );
+  upsampler->SetOutputDirection( this->m_RequiredGridDirection );
+  upsampler->SetInput( coeffs_in );
+  upsampler->SetNumberOfThreads( numberOfThreads );
+
+  /** Setup the decomposition filter. */
+  decompositionFilter->SetSplineOrder( this->m_BSplineOrder );
+  decompositionFilter->SetInput( upsampler->GetOutput() );
+  decompositionFilter->SetNumberOfThreads( numberOfThreads );
+
+  /** Do the upsampling. */
+  try
   {
-    /** Fill the coefficient image with parameter data. */
-    coeffs_in->GetPixelContainer()->SetImportPointer(
-      inputDataPointer, currentNumberOfPixels );
-    inputDataPointer += currentNumberOfPixels;
-
-    /** Set the coefficient image as the input of the upsampler filter.
-     * The upsampler samples the deformation field at the locations
-     * of the new control points, given the current coefficients
-     * (note: it does not just interpolate the coefficient image,
-     * which would be wrong). The B-spline coefficients that
-     * describe the resulting image are computed by the
-     * decomposition filter.
-     *
-     * This code is derived from the itk-example DeformableRegistration6.cxx.
-     */
-    typename UpsampleFilterType::Pointer upsampler
-      = UpsampleFilterType::New();
-    typename CoefficientUpsampleFunctionType::Pointer coeffUpsampleFunction
-      = CoefficientUpsampleFunctionType::New();
-    typename DecompositionFilterType::Pointer decompositionFilter
-      = DecompositionFilterType::New();
-
-    /** Setup the upsampler. */
-    upsampler->SetInterpolator( coeffUpsampleFunction );
-    upsampler->SetSize( this->m_RequiredGridRegion.GetSize() );
-    upsampler->SetOutputStartIndex( this->m_RequiredGridRegion.GetIndex() );
-    upsampler->SetOutputSpacing( this->m_RequiredGridSpacing );
-    upsampler->SetOutputOrigin( this->m_RequiredGridOrigin );
-    upsampler->SetOutputDirection( this->m_RequiredGridDirection );
-    upsampler->SetInput( coeffs_in );
-
-    /** Setup the decomposition filter. */
-    decompositionFilter->SetSplineOrder( this->m_BSplineOrder );
-    decompositionFilter->SetInput( upsampler->GetOutput() );
-
-    /** Do the upsampling. */
-    try
-    {
-      decompositionFilter->UpdateLargestPossibleRegion();
-      // \todo: the decomposition filter could be multi-threaded
-      // by deriving it from the RecursiveSeparableImageFilter,
-      // similar to the SmoothingRecursiveGaussianImageFilter.
-    }
-    catch( itk::ExceptionObject & excp )
-    {
-      /** Add information to the exception. */
-      excp.SetLocation( "UpsampleBSplineParametersFilter - UpsampleParameters()" );
-      std::string err_str = excp.GetDescription();
-      err_str += "\nError occurred while using decompositionFilter.\n";
-      excp.SetDescription( err_str );
-
-      /** Pass the exception to an higher level. */
-      throw excp;
-    }
-
-    /** Get a pointer to the upsampled coefficient image. */
-    const PixelType * coeffs_out = decompositionFilter->GetOutput()->GetBufferPointer();
+    decompositionFilter->UpdateLargestPossibleRegion();
+    // \todo: the decomposition filter could be multi-threaded
+    // by deriving it from the RecursiveSeparableImageFilter,
+    // similar to the SmoothingRecursiveGaussianImageFilter.
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    /** Add information to the exception. */
+    excp.SetLocation( "UpsampleBSplineParametersFilter - UpsampleParameters()" );
+    std::string err_str = excp.GetDescription();
+    err_str += "\nError occurred while using decompositionFilter.\n";
+    excp.SetDescription( err_str );
+
+    /** Pass the exception to an higher level. */
+    throw excp;
+  }
 
-    /** Copy the contents of coeffs_out in a ParametersType array. */
-    std::copy( coeffs_out, coeffs_out + requiredNumberOfPixels,
-      outputDataPointer + requiredNumberOfPixels * j );
+  /** Get a pointer to the upsampled coefficient image. */
+  const PixelType * coeffs_out = decompositionFilter->GetOutput()->GetBufferPointer();
 
-  } // end for dimension loop
+  /** Copy the contents of coeffs_out in a ParametersType array. */
+  std::copy( coeffs_out, coeffs_out + requiredNumberOfPixels,
+    outputDataPointer + requiredNumberOfPixels * j );
 
-} // end UpsampleParameters()
+} // end ResampleCoefficientImage()
 
 
 /**
@@ -205,6 +530,8 @@ UpsampleBSplineParametersFilter< TArray, TImage >
   os << indent << "RequiredGridRegion: "  << this->m_RequiredGridRegion << std::endl;
 
   os << indent << "BSplineOrder: " << this->m_BSplineOrder << std::endl;
+  os << indent << "UseDyadicRefinement: " << this->m_UseDyadicRefinement << std::endl;
+  os << indent << "Threader: " << this->m_Threader << std::endl;
 
 } // end PrintSelf()
 
@@ -0,0 +1,305 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkAsynchronousWriteQueue_cxx
+#define __itkAsynchronousWriteQueue_cxx
+
+#include "itkAsynchronousWriteQueue.h"
+#include "itkThreadBudget.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace itk
+{
+
+/**
+ * ********************* Constructor ****************************
+ */
+
+AsynchronousWriteQueue::AsynchronousWriteQueue()
+{
+  this->m_MemoryBudget           = 0;
+  this->m_MemorySize             = 0;
+  this->m_PeakMemorySize         = 0;
+  this->m_NumberOfUnfinishedJobs = 0;
+  this->m_NumberOfExecutedJobs   = 0;
+  this->m_Stop                   = false;
+
+  this->m_Threader        = MultiThreader::New();
+  this->m_WorkerThreadId  = 0;
+  this->m_WorkerIsRunning = false;
+  this->m_JobPushed       = ConditionVariable::New();
+  this->m_JobFinished     = ConditionVariable::New();
+
+} // end Constructor
+
+
+/**
+ * ********************* Destructor ****************************
+ */
+
+AsynchronousWriteQueue::~AsynchronousWriteQueue()
+{
+  /** The worker executes the remaining jobs before it stops. */
+  this->m_Mutex.Lock();
+  this->m_Stop = true;
+  this->m_JobPushed->Signal();
+  const bool workerIsRunning = this->m_WorkerIsRunning;
+  this->m_Mutex.Unlock();
+
+  if( workerIsRunning )
+  {
+    this->m_Threader->TerminateThread( this->m_WorkerThreadId );
+    ThreadBudget::GetInstance()->Unregister( this );
+  }
+
+} // end Destructor
+
+
+/**
+ * ********************* SetMemoryBudget ****************************
+ */
+
+void
+AsynchronousWriteQueue
+::SetMemoryBudget( const SizeValueType memoryBudget )
+{
+  this->m_Mutex.Lock();
+  this->m_MemoryBudget = memoryBudget;
+  this->m_Mutex.Unlock();
+
+} // end SetMemoryBudget()
+
+
+/**
+ * ********************* GetMemoryBudget ****************************
+ */
+
+SizeValueType
+AsynchronousWriteQueue
+::GetMemoryBudget( void ) const
+{
+  this->m_Mutex.Lock();
+  const SizeValueType memoryBudget = this->m_MemoryBudget;
+  this->m_Mutex.Unlock();
+  return memoryBudget;
+
+} // end GetMemoryBudget()
+
+
+/**
+ * ********************* Push ****************************
+ */
+
+void
+AsynchronousWriteQueue
+::Push( JobType * job )
+{
+  if( !job ) { return; }
+
+  const SizeValueType memorySize = job->GetMemorySize();
+
+  this->m_Mutex.Lock();
+
+  /** Start the worker at the first job, and count it in the thread budget. */
+  if( !this->m_WorkerIsRunning )
+  {
+    ThreadBudget::GetInstance()->Register( this, 1 );
+    this->m_WorkerThreadId  = this->m_Threader->SpawnThread(
+      AsynchronousWriteQueue::WorkerThreaderCallback, this );
+    this->m_WorkerIsRunning = true;
+  }
+
+  /** Wait until the memory of the other jobs leaves room for this one. */
+  while( this->m_MemoryBudget > 0 && this->m_NumberOfUnfinishedJobs > 0
+    && this->m_MemorySize + memorySize > this->m_MemoryBudget )
+  {
+    this->m_JobFinished->Wait( &this->m_Mutex );
+  }
+
+  this->m_Jobs.push_back( job );
+  this->m_MemorySize    += memorySize;
+  this->m_PeakMemorySize = std::max( this->m_PeakMemorySize, this->m_MemorySize );
+  ++this->m_NumberOfUnfinishedJobs;
+  this->m_JobPushed->Signal();
+
+  this->m_Mutex.Unlock();
+
+} // end Push()
+
+
+/**
+ * ********************* Flush ****************************
+ */
+
+void
+AsynchronousWriteQueue
+::Flush( void )
+{
+  std::vector< std::string > errors;
+
+  this->m_Mutex.Lock();
+  while( this->m_NumberOfUnfinishedJobs > 0 )
+  {
+    this->m_JobFinished->Wait( &this->m_Mutex );
+  }
+  errors.swap( this->m_Errors );
+  this->m_Mutex.Unlock();
+
+  if( !errors.empty() )
+  {
+    std::ostringstream message( "" );
+    for( std::size_t i = 0; i < errors.size(); ++i )
+    {
+      message << errors[ i ] << "\n";
+    }
+    itkExceptionMacro( << errors.size() << " of the jobs that were written "
+                       << "in the background failed:\n" << message.str() );
+  }
+
+} // end Flush()
+
+
+/**
+ * ********************* GetNumberOfExecutedJobs ****************************
+ */
+
+SizeValueType
+AsynchronousWriteQueue
+::GetNumberOfExecutedJobs( void ) const
+{
+  this->m_Mutex.Lock();
+  const SizeValueType numberOfExecutedJobs = this->m_NumberOfExecutedJobs;
+  this->m_Mutex.Unlock();
+  return numberOfExecutedJobs;
+
+} // end GetNumberOfExecutedJobs()
+
+
+/**
+ * ********************* GetPeakMemorySize ****************************
+ */
+
+SizeValueType
+AsynchronousWriteQueue
+::GetPeakMemorySize( void ) const
+{
+  this->m_Mutex.Lock();
+  const SizeValueType peakMemorySize = this->m_PeakMemorySize;
+  this->m_Mutex.Unlock();
+  return peakMemorySize;
+
+} // end GetPeakMemorySize()
+
+
+/**
+ * ********************* WorkerThreaderCallback ****************************
+ */
+
+ITK_THREAD_RETURN_TYPE
+AsynchronousWriteQueue
+::WorkerThreaderCallback( void * arg )
+{
+  MultiThreader::ThreadInfoStruct * infoStruct
+    = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self * queue = static_cast< Self * >( infoStruct->UserData );
+
+  queue->ExecuteJobs();
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end WorkerThreaderCallback()
+
+
+/**
+ * ********************* ExecuteJobs ****************************
+ */
+
+void
+AsynchronousWriteQueue
+::ExecuteJobs( void )
+{
+  this->m_Mutex.Lock();
+  while( true )
+  {
+    while( this->m_Jobs.empty() && !this->m_Stop )
+    {
+      this->m_JobPushed->Wait( &this->m_Mutex );
+    }
+    if( this->m_Jobs.empty() ) { break; }
+
+    JobPointer job = this->m_Jobs.front();
+    this->m_Jobs.pop_front();
+    this->m_Mutex.Unlock();
+
+    /** Execute the job outside the lock, so that new jobs can be pushed. */
+    std::string error = "";
+    try
+    {
+      job->Execute();
+    }
+    catch( ExceptionObject & excp )
+    {
+      std::ostringstream message( "" );
+      message << excp;
+      error = message.str();
+    }
+    catch( std::exception & excp )
+    {
+      error = excp.what();
+    }
+
+    /** Release the data of the job outside the lock. */
+    const SizeValueType memorySize = job->GetMemorySize();
+    job = 0;
+
+    this->m_Mutex.Lock();
+    if( !error.empty() )
+    {
+      this->m_Errors.push_back( error );
+    }
+    this->m_MemorySize -= memorySize;
+    --this->m_NumberOfUnfinishedJobs;
+    ++this->m_NumberOfExecutedJobs;
+    this->m_JobFinished->Broadcast();
+  }
+  this->m_Mutex.Unlock();
+
+} // end ExecuteJobs()
+
+
+/**
+ * ********************* PrintSelf ****************************
+ */
+
+void
+AsynchronousWriteQueue
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "MemoryBudget: " << this->GetMemoryBudget() << std::endl;
+  os << indent << "NumberOfExecutedJobs: " << this->GetNumberOfExecutedJobs() << std::endl;
+  os << indent << "PeakMemorySize: " << this->GetPeakMemorySize() << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef __itkAsynchronousWriteQueue_cxx
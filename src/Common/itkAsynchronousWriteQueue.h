@@ -0,0 +1,165 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkAsynchronousWriteQueue_h
+#define __itkAsynchronousWriteQueue_h
+
+#include "itkObject.h"
+#include "itkIntTypes.h"
+#include "itkMultiThreader.h"
+#include "itkSimpleMutexLock.h"
+#include "itkConditionVariable.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+
+/** \class AsynchronousWriteQueue
+ * \brief Writes output in a background thread, so that the caller does not
+ * wait for the compression and the disk.
+ *
+ * A job holds a snapshot of the data to write, which nobody else changes,
+ * and writes it when the worker thread executes it. The jobs are executed
+ * one by one, in the order in which they were pushed. With a memory budget,
+ * Push() waits until the memory of the queued jobs leaves room for the new
+ * job, so the queue does not grow when the disk is slower than the caller.
+ *
+ * The worker thread is started at the first job, and stopped when the queue
+ * is destroyed, after it executed the remaining jobs. While it runs, the
+ * worker is a client of the itk::ThreadBudget with one thread, so the
+ * registrations of the process get one thread less at their next request.
+ * Flush() waits until all jobs are executed, and reports the jobs that failed.
+ *
+ * All functions are thread-safe.
+ *
+ * \ingroup Common
+ */
+
+class AsynchronousWriteQueue : public Object
+{
+public:
+
+  /** Standard ITK-stuff. */
+  typedef AsynchronousWriteQueue     Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( AsynchronousWriteQueue, Object );
+
+  /** \class Job
+   * \brief Base class of the jobs of the queue.
+   */
+  class Job : public Object
+  {
+public:
+
+    typedef Job                        Self;
+    typedef Object                     Superclass;
+    typedef SmartPointer< Self >       Pointer;
+    typedef SmartPointer< const Self > ConstPointer;
+
+    itkTypeMacro( Job, Object );
+
+    /** Write the data. Called by the worker thread. */
+    virtual void Execute( void ) = 0;
+
+    /** The memory of the data that the job holds, in bytes. */
+    virtual SizeValueType GetMemorySize( void ) const = 0;
+
+protected:
+
+    Job() {}
+    virtual ~Job() {}
+
+private:
+
+    Job( const Self & );            // purposely not implemented
+    void operator=( const Self & ); // purposely not implemented
+
+  };
+
+  typedef Job              JobType;
+  typedef JobType::Pointer JobPointer;
+
+  /** Set/Get the maximum memory of the jobs that are queued or executed,
+   * in bytes, or 0 for no maximum. A job that exceeds the maximum on its
+   * own waits until the queue is empty.
+   */
+  void SetMemoryBudget( const SizeValueType memoryBudget );
+
+  SizeValueType GetMemoryBudget( void ) const;
+
+  /** Queue a job, after waiting for enough room in the memory budget. */
+  void Push( JobType * job );
+
+  /** Wait until all jobs are executed. Throws an exception with the errors
+   * of the jobs that failed since the previous Flush().
+   */
+  void Flush( void );
+
+  /** The number of jobs that were executed. */
+  SizeValueType GetNumberOfExecutedJobs( void ) const;
+
+  /** The largest memory of the jobs that were queued at the same time. */
+  SizeValueType GetPeakMemorySize( void ) const;
+
+protected:
+
+  AsynchronousWriteQueue();
+  virtual ~AsynchronousWriteQueue();
+
+  void PrintSelf( std::ostream & os, Indent indent ) const;
+
+private:
+
+  AsynchronousWriteQueue( const Self & ); // purposely not implemented
+  void operator=( const Self & );         // purposely not implemented
+
+  /** The worker thread executes the jobs until the queue is stopped. */
+  static ITK_THREAD_RETURN_TYPE WorkerThreaderCallback( void * arg );
+
+  void ExecuteJobs( void );
+
+  std::deque< JobPointer >   m_Jobs;
+  std::vector< std::string > m_Errors;
+  SizeValueType              m_MemoryBudget;
+  SizeValueType              m_MemorySize;
+  SizeValueType              m_PeakMemorySize;
+  SizeValueType              m_NumberOfUnfinishedJobs;
+  SizeValueType              m_NumberOfExecutedJobs;
+  bool                       m_Stop;
+
+  MultiThreader::Pointer     m_Threader;
+  ThreadIdType               m_WorkerThreadId;
+  bool                       m_WorkerIsRunning;
+  mutable SimpleMutexLock    m_Mutex;
+  ConditionVariable::Pointer m_JobPushed;
+  ConditionVariable::Pointer m_JobFinished;
+
+};
+
+} // end namespace itk
+
+#endif // end #ifndef __itkAsynchronousWriteQueue_h
@@ -0,0 +1,229 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkComputationCache_cxx
+#define __itkComputationCache_cxx
+
+#include "itkComputationCache.h"
+
+namespace itk
+{
+
+/**
+ * ********************* Constructor ****************************
+ */
+
+ComputationCache::ComputationCache()
+{
+  this->m_NumberOfHits   = 0;
+  this->m_NumberOfMisses = 0;
+
+} // end Constructor
+
+
+/**
+ * ********************* Find ****************************
+ */
+
+Object::Pointer
+ComputationCache
+::Find( const Object * object, const std::string & operation,
+  const Object * secondObject ) const
+{
+  if( !object ) { return 0; }
+
+  Object::Pointer result = 0;
+  this->m_Mutex.Lock();
+  MapType::const_iterator it = this->m_Entries.find(
+    KeyType( ObjectPairType( object, secondObject ), operation ) );
+  if( it != this->m_Entries.end()
+    && it->second.SourceMTime == object->GetMTime()
+    && ( !secondObject || it->second.SecondSourceMTime == secondObject->GetMTime() ) )
+  {
+    result = it->second.Result;
+    ++this->m_NumberOfHits;
+  }
+  else
+  {
+    ++this->m_NumberOfMisses;
+  }
+  this->m_Mutex.Unlock();
+
+  return result;
+
+} // end Find()
+
+
+/**
+ * ********************* Add ****************************
+ */
+
+void
+ComputationCache
+::Add( const Object * object, const std::string & operation, Object * result,
+  const Object * secondObject )
+{
+  if( !object || !result ) { return; }
+
+  EntryType entry;
+  entry.SourceObject       = object;
+  entry.SourceMTime        = object->GetMTime();
+  entry.SecondSourceObject = secondObject;
+  entry.SecondSourceMTime  = secondObject ? secondObject->GetMTime() : 0;
+  entry.Result             = result;
+
+  this->m_Mutex.Lock();
+  this->m_Entries[ KeyType( ObjectPairType( object, secondObject ), operation ) ] = entry;
+  this->m_Mutex.Unlock();
+
+} // end Add()
+
+
+/**
+ * ********************* Clear ****************************
+ */
+
+void
+ComputationCache
+::Clear( void )
+{
+  /** Release the results outside the lock, since that may free much memory. */
+  MapType entries;
+  this->m_Mutex.Lock();
+  entries.swap( this->m_Entries );
+  this->m_Mutex.Unlock();
+
+} // end Clear()
+
+
+/**
+ * ********************* RemoveUnusedEntries ****************************
+ */
+
+SizeValueType
+ComputationCache
+::RemoveUnusedEntries( void )
+{
+  /** Results may reference the source objects of other results, for example
+   * a cached pyramid image references the pixel container that is the source
+   * of its B-spline coefficients. So repeat until nothing is removed.
+   */
+  MapType       removedEntries;
+  SizeValueType numberOfRemovedEntries = 0;
+  bool          removed                = true;
+  while( removed )
+  {
+    removed = false;
+    this->m_Mutex.Lock();
+    MapType::iterator it = this->m_Entries.begin();
+    while( it != this->m_Entries.end() )
+    {
+      /** The reference of the entry itself is the only one. */
+      const EntryType & entry = it->second;
+      if( entry.SourceObject->GetReferenceCount() == 1
+        || ( entry.SecondSourceObject.IsNotNull()
+        && entry.SecondSourceObject->GetReferenceCount() == 1 ) )
+      {
+        removedEntries.insert( *it );
+        this->m_Entries.erase( it++ );
+        ++numberOfRemovedEntries;
+        removed = true;
+      }
+      else
+      {
+        ++it;
+      }
+    }
+    this->m_Mutex.Unlock();
+
+    /** Release the results outside the lock. */
+    removedEntries.clear();
+  }
+
+  return numberOfRemovedEntries;
+
+} // end RemoveUnusedEntries()
+
+
+/**
+ * ********************* GetNumberOfEntries ****************************
+ */
+
+SizeValueType
+ComputationCache
+::GetNumberOfEntries( void ) const
+{
+  this->m_Mutex.Lock();
+  const SizeValueType numberOfEntries = this->m_Entries.size();
+  this->m_Mutex.Unlock();
+  return numberOfEntries;
+
+} // end GetNumberOfEntries()
+
+
+/**
+ * ********************* GetNumberOfHits ****************************
+ */
+
+SizeValueType
+ComputationCache
+::GetNumberOfHits( void ) const
+{
+  this->m_Mutex.Lock();
+  const SizeValueType numberOfHits = this->m_NumberOfHits;
+  this->m_Mutex.Unlock();
+  return numberOfHits;
+
+} // end GetNumberOfHits()
+
+
+/**
+ * ********************* GetNumberOfMisses ****************************
+ */
+
+SizeValueType
+ComputationCache
+::GetNumberOfMisses( void ) const
+{
+  this->m_Mutex.Lock();
+  const SizeValueType numberOfMisses = this->m_NumberOfMisses;
+  this->m_Mutex.Unlock();
+  return numberOfMisses;
+
+} // end GetNumberOfMisses()
+
+
+/**
+ * ********************* PrintSelf ****************************
+ */
+
+void
+ComputationCache
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "NumberOfEntries: " << this->GetNumberOfEntries() << std::endl;
+  os << indent << "NumberOfHits: " << this->GetNumberOfHits() << std::endl;
+  os << indent << "NumberOfMisses: " << this->GetNumberOfMisses() << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef __itkComputationCache_cxx
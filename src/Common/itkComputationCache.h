@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkComputationCache_h
+#define __itkComputationCache_h
+
+#include "itkObject.h"
+#include "itkSimpleFastMutexLock.h"
+
+#include <map>
+#include <string>
+#include <utility>
+
+namespace itk
+{
+
+/** \class ComputationCache
+ * \brief Stores the results of expensive operations on images, so that
+ * they can be reused by later registrations.
+ *
+ * A result is stored under a key, which consists of the object that the
+ * operation was applied to, and a string that describes the operation and
+ * its settings, for example "GenericPyramid level 2 schedule 2 2 sigma 1 1".
+ * Results that depend on two objects, such as an image and a mask, use a
+ * second object in the key.
+ * Usually the object is the pixel container of the input image, so that
+ * images that share their buffer, such as grafted pyramid outputs, share
+ * their results too.
+ *
+ * The cache keeps a reference to the objects and to the result. A result is
+ * not returned anymore when one of the objects was modified after the result
+ * was added. Callers should not modify a result that they got from the cache.
+ * Results of objects that are not used anymore by anybody else, for example
+ * the moving images of earlier registrations, are released by
+ * RemoveUnusedEntries().
+ *
+ * All functions are thread-safe.
+ *
+ * \ingroup Common
+ */
+
+class ComputationCache : public Object
+{
+public:
+
+  /** Standard ITK-stuff. */
+  typedef ComputationCache           Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( ComputationCache, Object );
+
+  /** Return the result of an operation on an object, or null if it is not
+   * in the cache. The number of hits and misses is counted.
+   */
+  Object::Pointer Find( const Object * object, const std::string & operation,
+    const Object * secondObject = 0 ) const;
+
+  /** Store the result of an operation on an object. An existing result is
+   * replaced. Null objects and results are ignored.
+   */
+  void Add( const Object * object, const std::string & operation, Object * result,
+    const Object * secondObject = 0 );
+
+  /** Remove all results. */
+  void Clear( void );
+
+  /** Remove the results of objects that are only referenced by the cache,
+   * since these results cannot be found anymore. Returns the number of
+   * removed results.
+   */
+  SizeValueType RemoveUnusedEntries( void );
+
+  /** The number of results in the cache. */
+  SizeValueType GetNumberOfEntries( void ) const;
+
+  /** The number of times that Find() did and did not return a result. */
+  SizeValueType GetNumberOfHits( void ) const;
+
+  SizeValueType GetNumberOfMisses( void ) const;
+
+protected:
+
+  ComputationCache();
+  virtual ~ComputationCache() {}
+
+  void PrintSelf( std::ostream & os, Indent indent ) const;
+
+private:
+
+  ComputationCache( const Self & ); // purposely not implemented
+  void operator=( const Self & );   // purposely not implemented
+
+  struct EntryType
+  {
+    Object::ConstPointer SourceObject;
+    unsigned long        SourceMTime;
+    Object::ConstPointer SecondSourceObject;
+    unsigned long        SecondSourceMTime;
+    Object::Pointer      Result;
+  };
+
+  typedef std::pair< const Object *, const Object * > ObjectPairType;
+  typedef std::pair< ObjectPairType, std::string >    KeyType;
+  typedef std::map< KeyType, EntryType >              MapType;
+
+  MapType                     m_Entries;
+  mutable SizeValueType       m_NumberOfHits;
+  mutable SizeValueType       m_NumberOfMisses;
+  mutable SimpleFastMutexLock m_Mutex;
+
+};
+
+} // end namespace itk
+
+#endif // end #ifndef __itkComputationCache_h
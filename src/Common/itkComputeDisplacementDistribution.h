@@ -26,6 +26,8 @@
 #include "itkImageFullSampler.h"
 #include "itkMultiThreader.h"
 
+#include <vector>
+
 namespace itk
 {
 /**\class ComputeDisplacementDistribution
@@ -223,6 +225,15 @@ protected:
   ScalesType                  m_Scales;
   ImageSampleContainerPointer m_SampleContainer;
 
+  /** The displacement magnitude of every sample, only stored by the
+   * threads when the 95percentile method is used.
+   */
+  std::vector< double > m_Displacements;
+  bool                  m_StoreDisplacements;
+
+  /** Compute the 95% percentile of the stored displacements. */
+  double ComputeDisplacementPercentile( void );
+
 private:
 
   ComputeDisplacementDistribution( const Self & ); // purposely not implemented
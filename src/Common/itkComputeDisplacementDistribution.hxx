@@ -21,6 +21,7 @@
 #include "itkComputeDisplacementDistribution.h"
 
 #include <string>
+#include <algorithm>
 #include "vnl/vnl_math.h"
 #include "vnl/vnl_fastops.h"
 #include "vnl/vnl_diag_matrix.h"
@@ -49,6 +50,7 @@ ComputeDisplacementDistribution< TFixedImage, TTransform >
   this->m_FixedImageMask               = NULL;
   this->m_NumberOfJacobianMeasurements = 0;
   this->m_SampleContainer              = 0;
+  this->m_StoreDisplacements           = false;
 
   /** Threading related variables. */
   this->m_UseMultiThread = true;
@@ -264,10 +266,10 @@ ComputeDisplacementDistribution< TFixedImage, TTransform >
   {
     return this->ComputeSingleThreaded( mu, jacg, maxJJ, methods );
   }
-  // The multi-threaded route only supports methods == 2sigma for now
 
   /** Launch multi-threading */
   this->InitializeThreadingParameters();
+  this->m_StoreDisplacements = ( methods == "95percentile" );
 
   /** Tackle stuff needed before multi-threading. */
   this->BeforeThreadedCompute( mu );
@@ -278,9 +280,48 @@ ComputeDisplacementDistribution< TFixedImage, TTransform >
   /** Gather the jacg, maxJJ values from all threads. */
   this->AfterThreadedCompute( jacg, maxJJ );
 
+  /** The threads computed jacg with the 2sigma method. */
+  if( this->m_StoreDisplacements )
+  {
+    jacg = this->ComputeDisplacementPercentile();
+  }
+
 } // end Compute()
 
 
+/**
+ * ************************* ComputeDisplacementPercentile ************************
+ */
+
+template< class TFixedImage, class TTransform >
+double
+ComputeDisplacementDistribution< TFixedImage, TTransform >
+::ComputeDisplacementPercentile( void )
+{
+  /** Compute the 95% percentile of the distribution of the displacements,
+   * averaged over three neighbouring order statistics.
+   */
+  const SizeValueType nrofsamples = this->m_Displacements.size();
+  if( nrofsamples < 3 )
+  {
+    return nrofsamples == 0 ? 0.0 : *std::max_element(
+      this->m_Displacements.begin(), this->m_Displacements.end() );
+  }
+  const SizeValueType d = vnl_math_min( vnl_math_max(
+    static_cast< SizeValueType >( nrofsamples * 0.95 ),
+    static_cast< SizeValueType >( 1 ) ), nrofsamples - 2 );
+  std::sort( this->m_Displacements.begin(), this->m_Displacements.end() );
+  const double percentile = ( this->m_Displacements[ d - 1 ]
+    + this->m_Displacements[ d ] + this->m_Displacements[ d + 1 ] ) / 3.0;
+
+  /** Release the memory. */
+  std::vector< double >().swap( this->m_Displacements );
+
+  return percentile;
+
+} // end ComputeDisplacementPercentile()
+
+
 /**
  * *********************** BeforeThreadedCompute***************
  */
@@ -313,6 +354,12 @@ ComputeDisplacementDistribution< TFixedImage, TTransform >
   /** Get samples. */
   this->SampleFixedImageForJacobianTerms( this->m_SampleContainer );
 
+  /** Allocate the storage for the displacements of all samples, if needed. */
+  if( this->m_StoreDisplacements )
+  {
+    this->m_Displacements.assign( this->m_SampleContainer->Size(), 0.0 );
+  }
+
 } // end BeforeThreadedCompute()
 
 
@@ -395,8 +442,8 @@ ComputeDisplacementDistribution< TFixedImage, TTransform >
   if( sizejacind > 1 ) { jacind[ 1 ] = 0; }
 
   /** Temporaries. */
-  //std::vector< double > JGG_k; not here so only mean + 2 sigma is supported
   DerivativeType Jgg( outdim ); Jgg.Fill( 0.0 );
+  DerivativeType gradientj( sizejacind ); gradientj.Fill( 0.0 );
   const double   sqrt2 = vcl_sqrt( static_cast< double >( 2.0 ) );
   JacobianType   jacjjacj( outdim, outdim );
   double         maxJJ                 = 0.0;
@@ -440,14 +487,22 @@ ComputeDisplacementDistribution< TFixedImage, TTransform >
     /** Max_j [JJ_j]. */
     maxJJ = vnl_math_max( maxJJ, JJ_j );
 
-    /** Compute the displacement  jac * gradient. */
+    /** Compute the displacement  jac * gradient. The nonzero elements of
+     * the gradient are gathered first, so that the inner products run over
+     * contiguous memory and can be vectorized.
+     */
+    for( unsigned int j = 0; j < sizejacind; ++j )
+    {
+      gradientj[ j ] = this->m_ExactGradient[ jacind[ j ] ];
+    }
+    const double * gradientjPtr = gradientj.data_block();
     for( unsigned int i = 0; i < outdim; ++i )
     {
-      double temp = 0.0;
+      const JacobianValueType * jacjrow = jacj[ i ];
+      double                    temp    = 0.0;
       for( unsigned int j = 0; j < sizejacind; ++j )
       {
-        int pj = jacind[ j ];
-        temp += jacj( i, j ) * this->m_ExactGradient( pj );
+        temp += jacjrow[ j ] * gradientjPtr[ j ];
       }
       Jgg( i ) = temp;
     }
@@ -456,6 +511,10 @@ ComputeDisplacementDistribution< TFixedImage, TTransform >
     jggMagnitude         = Jgg.magnitude();
     displacement        += jggMagnitude;
     displacementSquared += vnl_math_sqr( jggMagnitude );
+    if( this->m_StoreDisplacements )
+    {
+      this->m_Displacements[ pos_begin + numberOfPixelsCounted ] = jggMagnitude;
+    }
     numberOfPixelsCounted++;
   }
 
@@ -528,6 +587,31 @@ ComputeDisplacementDistribution< TFixedImage, TTransform >
   /** Initialize. */
   maxJJ = jacg = 0.0;
 
+  /** Use the threads of Compute(), with the search direction mu in place
+   * of the exact gradient. In this case maxJJ is computed as well.
+   */
+  if( this->m_UseMultiThread )
+  {
+    this->InitializeThreadingParameters();
+    this->m_StoreDisplacements = ( methods == "95percentile" );
+    this->m_NumberOfParameters = this->m_Transform->GetNumberOfParameters();
+    this->m_ScaledCostFunction->SetScales( this->GetScales() );
+    this->m_ExactGradient = mu;
+    this->SampleFixedImageForJacobianTerms( this->m_SampleContainer );
+    if( this->m_StoreDisplacements )
+    {
+      this->m_Displacements.assign( this->m_SampleContainer->Size(), 0.0 );
+    }
+
+    this->LaunchComputeThreaderCallback();
+    this->AfterThreadedCompute( jacg, maxJJ );
+    if( this->m_StoreDisplacements )
+    {
+      jacg = this->ComputeDisplacementPercentile();
+    }
+    return;
+  }
+
   /** Get samples. */
   ImageSampleContainerPointer sampleContainer = 0;
   this->SampleFixedImageForJacobianTerms( sampleContainer );
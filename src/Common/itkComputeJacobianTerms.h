@@ -22,6 +22,12 @@
 #include "itkImageRandomSamplerBase.h"
 #include "itkImageRandomCoordinateSampler.h"
 #include "itkScaledSingleValuedNonLinearOptimizer.h"
+#include "itkMultiThreader.h"
+#include "itkArray2D.h"
+
+#include "vnl/vnl_sparse_matrix.h"
+#include "vnl/vnl_diag_matrix.h"
+#include <vector>
 
 namespace itk
 {
@@ -31,6 +37,15 @@ namespace itk
  * More specifically this class computes the Jacobian terms related to the automatic
  * parameter estimation for the adaptive stochastic gradient descent optimizer.
  * Details can be found in the paper.
+ *
+ * The computation is multi-threaded. The samples are divided over the threads,
+ * and each thread accumulates the outer products J_j^T J_j of its samples in its
+ * own band and sparse matrices, so that every Jacobian is computed only once.
+ * The rows of these matrices are then divided over the threads, which sum them
+ * into the covariance matrix. Since the per-thread band matrices can be large,
+ * fewer threads accumulate when they would take more than 256 MB in total.
+ * The traces and the maxima over the samples are computed per thread, and
+ * reduced afterwards.
  */
 
 template< class TFixedImage, class TTransform >
@@ -107,10 +122,27 @@ public:
   virtual void Compute( double & TrC, double & TrCC,
     double & maxJJ, double & maxJCJ );
 
+  /** Typedef for the diagonal of the covariance matrix. */
+  typedef Array< double > DiagonalCovarianceType;
+
+  /** Compute the diagonal of the covariance matrix
+   * C = 1/n \sum_{i=1}^n J_i^T J_i, on the same samples as Compute().
+   * The scales are not applied. This is used to estimate a diagonal
+   * preconditioner, see PreconditionedStochasticGradientDescent.
+   */
+  virtual void ComputeDiagonalCovariance( DiagonalCovarianceType & diagonal );
+
+  /** Set the number of threads. */
+  void SetNumberOfThreads( ThreadIdType numberOfThreads )
+  {
+    this->m_Threader->SetNumberOfThreads( numberOfThreads );
+  }
+
+
 protected:
 
   ComputeJacobianTerms();
-  virtual ~ComputeJacobianTerms() {}
+  virtual ~ComputeJacobianTerms();
 
   typename FixedImageType::ConstPointer m_FixedImage;
   FixedImageRegionType       m_FixedImageRegion;
@@ -151,6 +183,83 @@ protected:
   virtual void SampleFixedImageForJacobianTerms(
     ImageSampleContainerPointer & sampleContainer );
 
+  /** Typedefs for the covariance matrix. */
+  typedef double                                   CovarianceValueType;
+  typedef Array2D< CovarianceValueType >           CovarianceMatrixType;
+  typedef vnl_sparse_matrix< CovarianceValueType > SparseCovarianceMatrixType;
+  typedef SparseCovarianceMatrixType::row          SparseRowType;
+  typedef vnl_diag_matrix< CovarianceValueType >   DiagCovarianceMatrixType;
+
+  /** Typedefs for multi-threading. */
+  typedef itk::MultiThreader             ThreaderType;
+  typedef ThreaderType::ThreadInfoStruct ThreadInfoType;
+
+  /** Launch a threaded computation. */
+  void LaunchThreaderCallback( ThreadFunctionType callback ) const;
+
+  /** Threader callback for the computation of the covariance matrix. */
+  static ITK_THREAD_RETURN_TYPE ComputeCovarianceThreaderCallback( void * arg );
+
+  /** Threader callback for the reduction of the covariance matrix. */
+  static ITK_THREAD_RETURN_TYPE ReduceCovarianceThreaderCallback( void * arg );
+
+  /** Threader callback for the computation of maxJJ and maxJCJ. */
+  static ITK_THREAD_RETURN_TYPE ComputeMaxJCJThreaderCallback( void * arg );
+
+  /** Accumulate the outer products of the Jacobians of the samples of this
+   * thread in the band and sparse matrices of this thread.
+   */
+  virtual void ThreadedComputeCovariance( ThreadIdType threadId );
+
+  /** Sum the rows owned by this thread of the per-thread matrices into the
+   * covariance matrix, and compute the contribution of these rows to TrC and TrCC.
+   */
+  virtual void ThreadedReduceCovariance( ThreadIdType threadId );
+
+  /** Compute maxJJ and maxJCJ for the samples of this thread. */
+  virtual void ThreadedComputeMaxJCJ( ThreadIdType threadId );
+
+  /** Add the upper triangular part of the accumulated J^T J to the band
+   * and sparse matrices of a thread.
+   */
+  void UpdateCovariance(
+    const NonZeroJacobianIndicesType & jacind,
+    const CovarianceMatrixType & jactjac,
+    CovarianceMatrixType & bandCovariance,
+    SparseCovarianceMatrixType & covariance ) const;
+
+  /** Helper struct to give the threads access to all member variables. */
+  struct MultiThreaderParameterType
+  {
+    Self * st_Self;
+  };
+  mutable MultiThreaderParameterType m_ThreaderParameters;
+
+  /** Per-thread partial results. */
+  struct ComputePerThreadStruct
+  {
+    double st_TrC;
+    double st_TrCC;
+    double st_MaxJJ;
+    double st_MaxJCJ;
+  };
+  itkPadStruct( ITK_CACHE_LINE_ALIGNMENT, ComputePerThreadStruct,
+    PaddedComputePerThreadStruct );
+  itkAlignedTypedef( ITK_CACHE_LINE_ALIGNMENT, PaddedComputePerThreadStruct,
+    AlignedComputePerThreadStruct );
+  AlignedComputePerThreadStruct * m_ComputePerThreadVariables;
+  ThreadIdType                    m_ComputePerThreadVariablesSize;
+
+  /** Data shared by the threads. */
+  ThreaderType::Pointer                     m_Threader;
+  ImageSampleContainerPointer               m_SampleContainer;
+  SparseCovarianceMatrixType                m_Covariance;
+  DiagCovarianceMatrixType                  m_DiagonalCovariance;
+  std::vector< unsigned int >               m_BandCovarianceMap;
+  std::vector< unsigned int >               m_BandCovarianceMap2;
+  std::vector< CovarianceMatrixType >       m_ThreadBandCovariances;
+  std::vector< SparseCovarianceMatrixType > m_ThreadCovariances;
+
 private:
 
   ComputeJacobianTerms( const Self & ); // purposely not implemented
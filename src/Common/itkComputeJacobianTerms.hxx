@@ -22,8 +22,7 @@
 
 #include "vnl/vnl_math.h"
 #include "vnl/vnl_fastops.h"
-#include "vnl/vnl_diag_matrix.h"
-#include "vnl/vnl_sparse_matrix.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -45,9 +44,29 @@ ComputeJacobianTerms< TFixedImage, TTransform >
   this->m_NumberOfBandStructureSamples = 0;
   this->m_NumberOfJacobianMeasurements = 0;
 
+  /** Threading related variables. */
+  this->m_Threader = ThreaderType::New();
+  this->m_Threader->SetUseThreadPool( false );
+  this->m_ThreaderParameters.st_Self      = this;
+  this->m_ComputePerThreadVariables     = NULL;
+  this->m_ComputePerThreadVariablesSize = 0;
+  this->m_SampleContainer               = 0;
+
 } // end Constructor
 
 
+/**
+ * ************************* Destructor ************************
+ */
+
+template< class TFixedImage, class TTransform >
+ComputeJacobianTerms< TFixedImage, TTransform >
+::~ComputeJacobianTerms()
+{
+  delete[] this->m_ComputePerThreadVariables;
+} // end Destructor
+
+
 /**
  * ************************* Compute ************************
  */
@@ -73,41 +92,19 @@ ComputeJacobianTerms< TFixedImage, TTransform >
    * Term 4: maxJCJ, see (54)
    */
 
-  typedef double                                   CovarianceValueType;
-  typedef itk::Array2D< CovarianceValueType >      CovarianceMatrixType;
-  typedef vnl_sparse_matrix< CovarianceValueType > SparseCovarianceMatrixType;
-  typedef SparseCovarianceMatrixType::row          SparseRowType;
-  typedef itk::Array< SizeValueType >              NonZeroJacobianIndicesExpandedType;
-  typedef vnl_diag_matrix< CovarianceValueType >   DiagCovarianceMatrixType;
-
   /** Initialize. */
   TrC = TrCC = maxJJ = maxJCJ = 0.0;
 
   /** Get samples. */
-  ImageSampleContainerPointer sampleContainer = 0;
-  SampleFixedImageForJacobianTerms( sampleContainer );
-  const SizeValueType nrofsamples = sampleContainer->Size();
-  const double        n           = static_cast< double >( nrofsamples );
+  this->SampleFixedImageForJacobianTerms( this->m_SampleContainer );
+  const SizeValueType nrofsamples = this->m_SampleContainer->Size();
 
   /** Get the number of parameters. */
   const unsigned int P = static_cast< unsigned int >(
     this->m_Transform->GetNumberOfParameters() );
 
-  /** Get transform and set current position. */
-  typename TransformType::Pointer transform
-    = this->m_Transform;
-  const unsigned int outdim = this->m_Transform->GetOutputSpaceDimension();
-
-  /** Get scales vector */
-  const ScalesType & scales = this->m_Scales;
-
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator iter;
-  typename ImageSampleContainerType::ConstIterator begin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator end   = sampleContainer->End();
-  unsigned int samplenr = 0;
-
   /** Variables for nonzerojacobian indices and the Jacobian. */
+  const unsigned int     outdim = this->m_Transform->GetOutputSpaceDimension();
   NumberOfParametersType sizejacind
     = this->m_Transform->GetNumberOfNonZeroJacobianIndices();
   JacobianType jacj( outdim, sizejacind );
@@ -115,16 +112,6 @@ ComputeJacobianTerms< TFixedImage, TTransform >
   NonZeroJacobianIndicesType jacind( sizejacind );
   jacind[ 0 ] = 0;
   if( sizejacind > 1 ) { jacind[ 1 ] = 0; }
-  NonZeroJacobianIndicesType prevjacind = jacind;
-
-  /** Initialize covariance matrix. Sparse, diagonal, and band form. */
-  SparseCovarianceMatrixType cov( P, P );
-  DiagCovarianceMatrixType   diagcov( P, 0.0 );
-  CovarianceMatrixType       bandcov;
-
-  /** For temporary storage of J'J. */
-  CovarianceMatrixType jactjac( sizejacind, sizejacind );
-  jactjac.Fill( 0.0 );
 
   typedef std::vector< unsigned int >             DifHistType;
   typedef std::pair< unsigned int, unsigned int > FreqPairType;
@@ -163,7 +150,7 @@ ComputeJacobianTerms< TFixedImage, TTransform >
 
     /** Read fixed coordinates and get Jacobian J_j. */
     const FixedImagePointType & point
-      = sampleContainer->GetElement( samplenr ).m_ImageCoordinates;
+      = this->m_SampleContainer->GetElement( samplenr ).m_ImageCoordinates;
     this->m_Transform->GetJacobian( point, jacj, jacind );
 
     /** Skip invalid Jacobians in the beginning, if any. */
@@ -200,9 +187,9 @@ ComputeJacobianTerms< TFixedImage, TTransform >
     static_cast< unsigned int >( difHist2.size() ) );
 
   /** Maps parameterNrDifference (q-p) to colnr in bandcov. */
-  std::vector< unsigned int > bandcovMap( P, bandcovsize );
+  this->m_BandCovarianceMap.assign( P, bandcovsize );
   /** Maps colnr in bandcov to parameterNrDifference (q-p). */
-  std::vector< unsigned int > bandcovMap2( bandcovsize, P );
+  this->m_BandCovarianceMap2.assign( bandcovsize, P );
 
   /** Sort the difHist2 based on the frequencies. */
   std::sort( difHist2.begin(), difHist2.end() );
@@ -212,202 +199,469 @@ ComputeJacobianTerms< TFixedImage, TTransform >
   for( unsigned int b = 0; b < bandcovsize; ++b )
   {
     --difHist2It;
-    bandcovMap[ difHist2It->second ] = b;
-    bandcovMap2[ b ]                 = difHist2It->second;
+    this->m_BandCovarianceMap[ difHist2It->second ] = b;
+    this->m_BandCovarianceMap2[ b ]                 = difHist2It->second;
   }
 
-  /** Initialize band matrix. */
-  bandcov = CovarianceMatrixType( P, bandcovsize );
-  bandcov.Fill( 0.0 );
+  /** Initialize the per-thread variables. */
+  const ThreadIdType numberOfThreads = this->m_Threader->GetNumberOfThreads();
+  if( this->m_ComputePerThreadVariablesSize != numberOfThreads )
+  {
+    delete[] this->m_ComputePerThreadVariables;
+    this->m_ComputePerThreadVariables     = new AlignedComputePerThreadStruct[ numberOfThreads ];
+    this->m_ComputePerThreadVariablesSize = numberOfThreads;
+  }
+  for( ThreadIdType i = 0; i < numberOfThreads; ++i )
+  {
+    this->m_ComputePerThreadVariables[ i ].st_TrC    = 0.0;
+    this->m_ComputePerThreadVariables[ i ].st_TrCC   = 0.0;
+    this->m_ComputePerThreadVariables[ i ].st_MaxJJ  = 0.0;
+    this->m_ComputePerThreadVariables[ i ].st_MaxJCJ = 0.0;
+  }
+
+  /** Initialize covariance matrix, in sparse and diagonal form, and the band
+   * and sparse matrices of the threads that accumulate the samples. Limit the
+   * number of these threads, such that the additional band matrices take at
+   * most 256 MB.
+   */
+  const double       maxBandMemory = 256.0 * 1024.0 * 1024.0;
+  const double       bandMemory    = static_cast< double >( P ) * bandcovsize * sizeof( CovarianceValueType );
+  const ThreadIdType numberOfAccumulatingThreads = bandMemory > 0.0
+    ? static_cast< ThreadIdType >( vnl_math_min( static_cast< double >( numberOfThreads ),
+    1.0 + vcl_floor( maxBandMemory / bandMemory ) ) )
+    : numberOfThreads;
+  this->m_Covariance         = SparseCovarianceMatrixType( P, P );
+  this->m_DiagonalCovariance = DiagCovarianceMatrixType( P, 0.0 );
+  this->m_ThreadBandCovariances.assign( numberOfAccumulatingThreads,
+    CovarianceMatrixType( P, bandcovsize ) );
+  this->m_ThreadCovariances.assign( numberOfAccumulatingThreads,
+    SparseCovarianceMatrixType( P, P ) );
+  for( ThreadIdType i = 0; i < numberOfAccumulatingThreads; ++i )
+  {
+    this->m_ThreadBandCovariances[ i ].Fill( 0.0 );
+  }
 
   /**
-   *    TERM 1
+   *    TERM 1 and 2
    *
-   * Loop over image and compute Jacobian.
-   * Compute C = 1/n \sum_i J_i^T J_i
-   * Possibly apply scaling afterwards.
+   * Compute C = 1/n \sum_i J_i^T J_i, possibly apply scaling afterwards,
+   * and compute TrC = trace(C) and TrCC = ||C||_F^2.
    */
+  this->LaunchThreaderCallback( this->ComputeCovarianceThreaderCallback );
+  this->LaunchThreaderCallback( this->ReduceCovarianceThreaderCallback );
+
+  /** The per-thread matrices have been summed into the sparse matrix. */
+  this->m_ThreadBandCovariances.clear();
+  this->m_ThreadCovariances.clear();
+
+  /**
+   *    TERM 3 and 4
+   *
+   * Compute maxJJ and maxJCJ
+   * \li maxJJ = max_j [ ||J_j||_F^2 + 2\sqrt{2} || J_j J_j^T ||_F ]
+   * \li maxJCJ = max_j [ Tr( J_j C J_j^T ) + 2\sqrt{2} || J_j C J_j^T ||_F ]
+   */
+  this->LaunchThreaderCallback( this->ComputeMaxJCJThreaderCallback );
+
+  /** Reduce the results of the threads. */
+  for( ThreadIdType i = 0; i < numberOfThreads; ++i )
+  {
+    TrC   += this->m_ComputePerThreadVariables[ i ].st_TrC;
+    TrCC  += this->m_ComputePerThreadVariables[ i ].st_TrCC;
+    maxJJ  = vnl_math_max( maxJJ, this->m_ComputePerThreadVariables[ i ].st_MaxJJ );
+    maxJCJ = vnl_math_max( maxJCJ, this->m_ComputePerThreadVariables[ i ].st_MaxJCJ );
+  }
+
+  /** Release the memory. */
+  this->m_Covariance         = SparseCovarianceMatrixType();
+  this->m_DiagonalCovariance = DiagCovarianceMatrixType();
+  this->m_SampleContainer    = 0;
+
+} // end Compute()
+
+
+/**
+ * *********************** LaunchThreaderCallback ***************
+ */
+
+template< class TFixedImage, class TTransform >
+void
+ComputeJacobianTerms< TFixedImage, TTransform >
+::LaunchThreaderCallback( ThreadFunctionType callback ) const
+{
+  /** Setup threader. */
+  this->m_Threader->SetSingleMethod( callback,
+    const_cast< void * >( static_cast< const void * >( &this->m_ThreaderParameters ) ) );
+
+  /** Launch. */
+  this->m_Threader->SingleMethodExecute();
+
+} // end LaunchThreaderCallback()
+
+
+/**
+ * ************ ComputeCovarianceThreaderCallback ****************************
+ */
+
+template< class TFixedImage, class TTransform >
+ITK_THREAD_RETURN_TYPE
+ComputeJacobianTerms< TFixedImage, TTransform >
+::ComputeCovarianceThreaderCallback( void * arg )
+{
+  /** Get the current thread id and user data. */
+  ThreadInfoType *             infoStruct = static_cast< ThreadInfoType * >( arg );
+  ThreadIdType                 threadID   = infoStruct->ThreadID;
+  MultiThreaderParameterType * temp
+    = static_cast< MultiThreaderParameterType * >( infoStruct->UserData );
+
+  /** Call the real implementation. */
+  temp->st_Self->ThreadedComputeCovariance( threadID );
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end ComputeCovarianceThreaderCallback()
+
+
+/**
+ * ************ ReduceCovarianceThreaderCallback ****************************
+ */
+
+template< class TFixedImage, class TTransform >
+ITK_THREAD_RETURN_TYPE
+ComputeJacobianTerms< TFixedImage, TTransform >
+::ReduceCovarianceThreaderCallback( void * arg )
+{
+  /** Get the current thread id and user data. */
+  ThreadInfoType *             infoStruct = static_cast< ThreadInfoType * >( arg );
+  ThreadIdType                 threadID   = infoStruct->ThreadID;
+  MultiThreaderParameterType * temp
+    = static_cast< MultiThreaderParameterType * >( infoStruct->UserData );
+
+  /** Call the real implementation. */
+  temp->st_Self->ThreadedReduceCovariance( threadID );
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end ReduceCovarianceThreaderCallback()
+
+
+/**
+ * ************ ComputeMaxJCJThreaderCallback ****************************
+ */
+
+template< class TFixedImage, class TTransform >
+ITK_THREAD_RETURN_TYPE
+ComputeJacobianTerms< TFixedImage, TTransform >
+::ComputeMaxJCJThreaderCallback( void * arg )
+{
+  /** Get the current thread id and user data. */
+  ThreadInfoType *             infoStruct = static_cast< ThreadInfoType * >( arg );
+  ThreadIdType                 threadID   = infoStruct->ThreadID;
+  MultiThreaderParameterType * temp
+    = static_cast< MultiThreaderParameterType * >( infoStruct->UserData );
+
+  /** Call the real implementation. */
+  temp->st_Self->ThreadedComputeMaxJCJ( threadID );
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end ComputeMaxJCJThreaderCallback()
+
+
+/**
+ * ************************* ThreadedComputeCovariance ************************
+ */
+
+template< class TFixedImage, class TTransform >
+void
+ComputeJacobianTerms< TFixedImage, TTransform >
+::ThreadedComputeCovariance( ThreadIdType threadId )
+{
+  /** Determine the samples of this thread. Threads without
+   * own band matrix do not accumulate.
+   */
+  const ThreadIdType numberOfAccumulatingThreads = this->m_ThreadBandCovariances.size();
+  if( threadId >= numberOfAccumulatingThreads ) { return; }
+  const SizeValueType nrofsamples = this->m_SampleContainer->Size();
+  const SizeValueType pos_begin   = nrofsamples * threadId / numberOfAccumulatingThreads;
+  const SizeValueType pos_end     = nrofsamples * ( threadId + 1 ) / numberOfAccumulatingThreads;
+
+  CovarianceMatrixType &       bandCovariance = this->m_ThreadBandCovariances[ threadId ];
+  SparseCovarianceMatrixType & covariance     = this->m_ThreadCovariances[ threadId ];
+
+  /** Variables for nonzerojacobian indices and the Jacobian. */
+  const unsigned int           outdim = this->m_Transform->GetOutputSpaceDimension();
+  const NumberOfParametersType sizejacind
+    = this->m_Transform->GetNumberOfNonZeroJacobianIndices();
+  JacobianType jacj( outdim, sizejacind );
+  jacj.Fill( 0.0 );
+  NonZeroJacobianIndicesType jacind( sizejacind );
   jacind[ 0 ] = 0;
   if( sizejacind > 1 ) { jacind[ 1 ] = 0; }
+  NonZeroJacobianIndicesType prevjacind = jacind;
+
+  /** For temporary storage of J'J. */
+  CovarianceMatrixType jactjac( sizejacind, sizejacind );
+  jactjac.Fill( 0.0 );
+  bool first = true;
+
+  /** Loop over the samples of this thread and accumulate J^T J. Consecutive
+   * samples with the same nonzero Jacobian indices are summed in jactjac first.
+   */
+  typename ImageSampleContainerType::ConstIterator iter;
+  typename ImageSampleContainerType::ConstIterator begin = this->m_SampleContainer->Begin();
+  typename ImageSampleContainerType::ConstIterator end   = this->m_SampleContainer->Begin();
+  begin += (int)pos_begin;
+  end   += (int)pos_end;
   for( iter = begin; iter != end; ++iter )
   {
-    /** Print progress 0-50%.
-     *progressObserver->UpdateAndPrintProgress( samplenr );*/
-    ++samplenr;
-
     /** Read fixed coordinates and get Jacobian J_j. */
     const FixedImagePointType & point = ( *iter ).Value().m_ImageCoordinates;
-    this->m_Transform->GetJacobian( point, jacj, jacind  );
+    this->m_Transform->GetJacobian( point, jacj, jacind );
 
-    /** Skip invalid Jacobians in the beginning, if any. */
+    /** Skip invalid Jacobians, if any. */
     if( sizejacind > 1 )
     {
       if( jacind[ 0 ] == jacind[ 1 ] ) { continue; }
     }
 
-    if( jacind == prevjacind )
+    if( first || jacind != prevjacind )
     {
-      /** Update sum of J_j^T J_j. */
-      vnl_fastops::inc_X_by_AtA( jactjac, jacj );
+      /** Update the matrices of this thread with the previous J^T J. */
+      if( !first )
+      {
+        this->UpdateCovariance( prevjacind, jactjac, bandCovariance, covariance );
+      }
+      first      = false;
+      prevjacind = jacind;
+      jactjac.Fill( 0.0 );
     }
-    else
+
+    /** Update the sum of J_j^T J_j. The inner loop runs over
+     * contiguous memory, such that it can be vectorized.
+     */
+    for( unsigned int pi = 0; pi < sizejacind; ++pi )
     {
-      /** The following should only be done after the first sample. */
-      if( iter != begin )
+      CovarianceValueType * jtjrow = jactjac[ pi ];
+      for( unsigned int d = 0; d < outdim; ++d )
       {
-        /** Update covariance matrix. */
-        for( unsigned int pi = 0; pi < sizejacind; ++pi )
+        const JacobianValueType   jdpi = jacj[ d ][ pi ];
+        const JacobianValueType * jrow = jacj[ d ];
+        for( unsigned int qi = 0; qi < sizejacind; ++qi )
         {
-          const unsigned int p = prevjacind[ pi ];
-          for( unsigned int qi = 0; qi < sizejacind; ++qi )
-          {
-            const unsigned int q = prevjacind[ qi ];
-            if( q >= p )
-            {
-              const double tempval = jactjac( pi, qi ) / n;
-              if( vcl_abs( tempval ) > 1e-14 )
-              {
-                const unsigned int bandindex = bandcovMap[ q - p ];
-                if( bandindex < bandcovsize )
-                {
-                  bandcov( p, bandindex ) += tempval;
-                }
-                else
-                {
-                  cov( p, q ) += tempval;
-                }
-              }
-            }
-          } // qi
-        }   // pi
-      }     // end if
-
-      /** Initialize jactjac by J_j^T J_j. */
-      vnl_fastops::AtA( jactjac, jacj );
-
-      /** Remember nonzerojacobian indices. */
-      prevjacind = jacind;
-    } // end else
+          jtjrow[ qi ] += jdpi * jrow[ qi ];
+        }
+      }
+    }
 
   } // end iter loop: end computation of covariance matrix
 
-  /** Update covariance matrix once again to include last jactjac updates
-   * \todo: a bit ugly that this loop is copied from above.
-   */
+  /** Update the matrices once again to include last jactjac updates. */
+  if( !first )
+  {
+    this->UpdateCovariance( prevjacind, jactjac, bandCovariance, covariance );
+  }
+
+} // end ThreadedComputeCovariance()
+
+
+/**
+ * ************************* UpdateCovariance ************************
+ */
+
+template< class TFixedImage, class TTransform >
+void
+ComputeJacobianTerms< TFixedImage, TTransform >
+::UpdateCovariance(
+  const NonZeroJacobianIndicesType & jacind,
+  const CovarianceMatrixType & jactjac,
+  CovarianceMatrixType & bandCovariance,
+  SparseCovarianceMatrixType & covariance ) const
+{
+  const double       n           = static_cast< double >( this->m_SampleContainer->Size() );
+  const unsigned int sizejacind  = jacind.size();
+  const unsigned int bandcovsize = bandCovariance.cols();
+
   for( unsigned int pi = 0; pi < sizejacind; ++pi )
   {
-    const unsigned int p = prevjacind[ pi ];
+    const unsigned int p = jacind[ pi ];
     for( unsigned int qi = 0; qi < sizejacind; ++qi )
     {
-      const unsigned int q = prevjacind[ qi ];
+      const unsigned int q = jacind[ qi ];
       if( q >= p )
       {
         const double tempval = jactjac( pi, qi ) / n;
         if( vcl_abs( tempval ) > 1e-14 )
         {
-          const unsigned int bandindex = bandcovMap[ q - p ];
+          const unsigned int bandindex = this->m_BandCovarianceMap[ q - p ];
           if( bandindex < bandcovsize )
           {
-            bandcov( p, bandindex ) += tempval;
+            bandCovariance( p, bandindex ) += tempval;
           }
           else
           {
-            cov( p, q ) += tempval;
+            covariance( p, q ) += tempval;
           }
         }
       }
     } // qi
   }   // pi
 
-  /** Copy the bandmatrix into the sparse matrix and empty the bandcov matrix.
-   * \todo: perhaps work further with this bandmatrix instead.
+} // end UpdateCovariance()
+
+
+/**
+ * ************************* ThreadedReduceCovariance ************************
+ */
+
+template< class TFixedImage, class TTransform >
+void
+ComputeJacobianTerms< TFixedImage, TTransform >
+::ThreadedReduceCovariance( ThreadIdType threadId )
+{
+  /** Determine the rows of the covariance matrix owned by this thread. */
+  const ThreadIdType  numberOfThreads = this->m_Threader->GetNumberOfThreads();
+  const SizeValueType P               = this->m_Transform->GetNumberOfParameters();
+  const unsigned int  rowBegin        = static_cast< unsigned int >( P * threadId / numberOfThreads );
+  const unsigned int  rowEnd          = static_cast< unsigned int >( P * ( threadId + 1 ) / numberOfThreads );
+
+  /** Sum the owned rows of the band and sparse matrices of all threads
+   * into the sparse matrix.
    */
-  for( unsigned int p = 0; p < P; ++p )
+  const ThreadIdType numberOfAccumulatingThreads = this->m_ThreadBandCovariances.size();
+  const unsigned int bandcovsize                 = this->m_BandCovarianceMap2.size();
+  for( unsigned int p = rowBegin; p < rowEnd; ++p )
   {
     for( unsigned int b = 0; b < bandcovsize; ++b )
     {
-      const double tempval = bandcov( p, b );
+      double tempval = 0.0;
+      for( ThreadIdType t = 0; t < numberOfAccumulatingThreads; ++t )
+      {
+        tempval += this->m_ThreadBandCovariances[ t ]( p, b );
+      }
       if( vcl_abs( tempval ) > 1e-14 )
       {
-        const unsigned int q = p + bandcovMap2[ b ];
-        cov( p, q ) = tempval;
+        const unsigned int q = p + this->m_BandCovarianceMap2[ b ];
+        this->m_Covariance( p, q ) = tempval;
       }
     }
-  }
-  bandcov.set_size( 0, 0 );
 
-  /** Apply scales. the use of m_Scales maybe something wrong. */
-  if( this->m_UseScales )
-  {
-    for( unsigned int p = 0; p < P; ++p )
-    {
-      cov.scale_row( p, 1.0 / this->m_Scales[ p ] );
-    }
-    /**  \todo: this might be faster with get_row instead of the iterator */
-    cov.reset();
-    bool notfinished = cov.next();
-    while( notfinished )
+    for( ThreadIdType t = 0; t < numberOfAccumulatingThreads; ++t )
     {
-      const int col = cov.getcolumn();
-      cov( cov.getrow(), col ) /= scales[ col ];
-      notfinished               = cov.next();
+      if( this->m_ThreadCovariances[ t ].empty_row( p ) ) { continue; }
+      const SparseRowType & covrowp = this->m_ThreadCovariances[ t ].get_row( p );
+      for( typename SparseRowType::const_iterator it = covrowp.begin(); it != covrowp.end(); ++it )
+      {
+        this->m_Covariance( p, ( *it ).first ) += ( *it ).second;
+      }
     }
   }
 
-  /** Compute TrC = trace(C), and diagcov. */
-  for( unsigned int p = 0; p < P; ++p )
+  /** Apply scales, row- and column-wise. */
+  if( this->m_UseScales )
   {
-    if( !cov.empty_row( p ) )
+    const ScalesType & scales = this->m_Scales;
+    for( unsigned int p = rowBegin; p < rowEnd; ++p )
     {
-      //avoid creation of element if the row is empty
-      CovarianceValueType & covpp = cov( p, p );
-      TrC         += covpp;
-      diagcov[ p ] = covpp;
+      if( this->m_Covariance.empty_row( p ) ) { continue; }
+      const double    rowscale = 1.0 / scales[ p ];
+      SparseRowType & covrowp  = this->m_Covariance.get_row( p );
+      for( typename SparseRowType::iterator it = covrowp.begin(); it != covrowp.end(); ++it )
+      {
+        ( *it ).second *= rowscale;
+        ( *it ).second /= scales[ ( *it ).first ];
+      }
     }
   }
 
-  /**
-   *    TERM 2
-   *
-   * Compute TrCC = ||C||_F^2.
+  /** Compute the contribution of the owned rows to TrC = trace(C) and
+   * TrCC = ||C||_F^2, and store the diagonal. Since only the upper triangular
+   * part of C is stored, the off-diagonal elements are counted twice.
    */
-  cov.reset();
-  bool notfinished2 = cov.next();
-  while( notfinished2 )
+  double trC  = 0.0;
+  double trCC = 0.0;
+  for( unsigned int p = rowBegin; p < rowEnd; ++p )
   {
-    TrCC        += vnl_math_sqr( cov.value() );
-    notfinished2 = cov.next();
+    if( this->m_Covariance.empty_row( p ) ) { continue; }
+
+    //avoid creation of element if the row is empty
+    const CovarianceValueType covpp = this->m_Covariance( p, p );
+    trC                            += covpp;
+    this->m_DiagonalCovariance[ p ] = covpp;
+
+    const SparseRowType & covrowp = this->m_Covariance.get_row( p );
+    for( typename SparseRowType::const_iterator it = covrowp.begin(); it != covrowp.end(); ++it )
+    {
+      trCC += 2.0 * vnl_math_sqr( ( *it ).second );
+    }
+    trCC -= vnl_math_sqr( covpp );
   }
 
-  /** Symmetry: multiply by 2 and subtract sumsqr(diagcov). */
-  TrCC *= 2.0;
-  TrCC -= diagcov.diagonal().squared_magnitude();
+  this->m_ComputePerThreadVariables[ threadId ].st_TrC  = trC;
+  this->m_ComputePerThreadVariables[ threadId ].st_TrCC = trCC;
 
-  /**
-   *    TERM 3 and 4
-   *
-   * Compute maxJJ and maxJCJ
-   * \li maxJJ = max_j [ ||J_j||_F^2 + 2\sqrt{2} || J_j J_j^T ||_F ]
-   * \li maxJCJ = max_j [ Tr( J_j C J_j^T ) + 2\sqrt{2} || J_j C J_j^T ||_F ]
+} // end ThreadedReduceCovariance()
+
+
+/**
+ * ************************* ThreadedComputeMaxJCJ ************************
+ */
+
+template< class TFixedImage, class TTransform >
+void
+ComputeJacobianTerms< TFixedImage, TTransform >
+::ThreadedComputeMaxJCJ( ThreadIdType threadId )
+{
+  /** Get the samples for this thread. */
+  const SizeValueType sampleContainerSize = this->m_SampleContainer->Size();
+  const ThreadIdType  numberOfThreads     = this->m_Threader->GetNumberOfThreads();
+  const unsigned long nrOfSamplesPerThreads
+    = static_cast< unsigned long >( vcl_ceil( static_cast< double >( sampleContainerSize )
+    / static_cast< double >( numberOfThreads ) ) );
+
+  unsigned long pos_begin = nrOfSamplesPerThreads * threadId;
+  unsigned long pos_end   = nrOfSamplesPerThreads * ( threadId + 1 );
+  pos_begin = ( pos_begin > sampleContainerSize ) ? sampleContainerSize : pos_begin;
+  pos_end   = ( pos_end > sampleContainerSize ) ? sampleContainerSize : pos_end;
+
+  /** Variables for nonzerojacobian indices and the Jacobian. */
+  const unsigned int           P      = this->m_Transform->GetNumberOfParameters();
+  const unsigned int           outdim = this->m_Transform->GetOutputSpaceDimension();
+  const NumberOfParametersType sizejacind
+    = this->m_Transform->GetNumberOfNonZeroJacobianIndices();
+  JacobianType jacj( outdim, sizejacind );
+  jacj.Fill( 0.0 );
+  NonZeroJacobianIndicesType jacind( sizejacind );
+  const ScalesType &         scales = this->m_Scales;
+  const double               sqrt2  = vcl_sqrt( static_cast< double >( 2.0 ) );
+
+  JacobianType             jacjjacj( outdim, outdim );
+  JacobianType             jacjcov( outdim, sizejacind );
+  DiagCovarianceMatrixType diagcovsparse( sizejacind );
+  JacobianType             jacjdiagcov( outdim, sizejacind );
+  JacobianType             jacjdiagcovjacj( outdim, outdim );
+  JacobianType             jacjcovjacj( outdim, outdim );
+
+  /** Maps a parameter number to its position in the nonzero Jacobian indices.
+   * Only the entries of the current sample are set, and reset afterwards.
    */
-  maxJJ  = 0.0;
-  maxJCJ = 0.0;
-  const double sqrt2 = vcl_sqrt( static_cast< double >( 2.0 ) );
-
-  JacobianType                       jacjjacj( outdim, outdim );
-  JacobianType                       jacjcov( outdim, sizejacind );
-  DiagCovarianceMatrixType           diagcovsparse( sizejacind );
-  JacobianType                       jacjdiagcov( outdim, sizejacind );
-  JacobianType                       jacjdiagcovjacj( outdim, outdim );
-  JacobianType                       jacjcovjacj( outdim, outdim );
-  NonZeroJacobianIndicesExpandedType jacindExpanded( P );
-
-  samplenr = 0;
-  for( iter = begin; iter != end; ++iter )
+  std::vector< unsigned int > jacindExpanded( P, sizejacind );
+
+  double maxJJ  = 0.0;
+  double maxJCJ = 0.0;
+
+  /** Create iterator over the sample container. */
+  typename ImageSampleContainerType::ConstIterator threader_fiter;
+  typename ImageSampleContainerType::ConstIterator threader_fbegin = this->m_SampleContainer->Begin();
+  typename ImageSampleContainerType::ConstIterator threader_fend   = this->m_SampleContainer->Begin();
+  threader_fbegin += (int)pos_begin;
+  threader_fend   += (int)pos_end;
+
+  for( threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter )
   {
     /** Read fixed coordinates and get Jacobian. */
-    const FixedImagePointType & point = ( *iter ).Value().m_ImageCoordinates;
-    this->m_Transform->GetJacobian( point, jacj, jacind  );
+    const FixedImagePointType & point = ( *threader_fiter ).Value().m_ImageCoordinates;
+    this->m_Transform->GetJacobian( point, jacj, jacind );
 
     /** Apply scales, if necessary. */
     if( this->m_UseScales )
@@ -438,12 +692,11 @@ ComputeJacobianTerms< TFixedImage, TTransform >
     /** Store the nonzero Jacobian indices in a different format
      * and create the sparse diagcov.
      */
-    jacindExpanded.Fill( sizejacind );
     for( unsigned int pi = 0; pi < sizejacind; ++pi )
     {
       const unsigned int p = jacind[ pi ];
       jacindExpanded[ p ] = pi;
-      diagcovsparse[ pi ] = diagcov[ p ];
+      diagcovsparse[ pi ] = this->m_DiagonalCovariance[ p ];
     }
 
     /** We below calculate jacjC = J_j cov^T, but later we will correct
@@ -454,10 +707,10 @@ ComputeJacobianTerms< TFixedImage, TTransform >
     for( unsigned int pi = 0; pi < sizejacind; ++pi )
     {
       const unsigned int p = jacind[ pi ];
-      if( !cov.empty_row( p ) )
+      if( !this->m_Covariance.empty_row( p ) )
       {
-        SparseRowType & covrowp = cov.get_row( p );
-        typename SparseRowType::iterator covrowpit;
+        const SparseRowType & covrowp = this->m_Covariance.get_row( p );
+        typename SparseRowType::const_iterator covrowpit;
 
         /** Loop over row p of the sparse cov matrix. */
         for( covrowpit = covrowp.begin(); covrowpit != covrowp.end(); ++covrowpit )
@@ -479,6 +732,12 @@ ComputeJacobianTerms< TFixedImage, TTransform >
       } // if not empty row
     }   // pi
 
+    /** Reset the entries of jacindExpanded that were set for this sample. */
+    for( unsigned int pi = 0; pi < sizejacind; ++pi )
+    {
+      jacindExpanded[ jacind[ pi ] ] = sizejacind;
+    }
+
     /** J_j C J_j^T  = jacjCjacj.
      * But note that we actually compute J_j cov' J_j^T
      */
@@ -502,16 +761,72 @@ ComputeJacobianTerms< TFixedImage, TTransform >
     /** Max_j [JCJ_j]. */
     maxJCJ = vnl_math_max( maxJCJ, JCJ_j );
 
-    /** Show progress 50-100%. */
-    //progressObserver->UpdateAndPrintProgress( samplenr + nrofsamples );
-    ++samplenr;
-
   } // end loop over sample container
 
-  /** Finalize progress information. */
-  //progressObserver->PrintProgress( 1.0 );
+  /** Update the thread struct once. */
+  this->m_ComputePerThreadVariables[ threadId ].st_MaxJJ  = maxJJ;
+  this->m_ComputePerThreadVariables[ threadId ].st_MaxJCJ = maxJCJ;
 
-} // end Compute()
+} // end ThreadedComputeMaxJCJ()
+
+
+/**
+ * ************************* ComputeDiagonalCovariance ************************
+ */
+
+template< class TFixedImage, class TTransform >
+void
+ComputeJacobianTerms< TFixedImage, TTransform >
+::ComputeDiagonalCovariance( DiagonalCovarianceType & diagonal )
+{
+  /** Get samples. */
+  ImageSampleContainerPointer sampleContainer;
+  this->SampleFixedImageForJacobianTerms( sampleContainer );
+  const SizeValueType nrofsamples = sampleContainer->Size();
+
+  /** Variables for nonzerojacobian indices and the Jacobian. */
+  const unsigned int           P      = static_cast< unsigned int >( this->m_Transform->GetNumberOfParameters() );
+  const unsigned int           outdim = this->m_Transform->GetOutputSpaceDimension();
+  const NumberOfParametersType sizejacind
+    = this->m_Transform->GetNumberOfNonZeroJacobianIndices();
+  JacobianType jacj( outdim, sizejacind );
+  jacj.Fill( 0.0 );
+  NonZeroJacobianIndicesType jacind( sizejacind );
+  jacind[ 0 ] = 0;
+  if( sizejacind > 1 ) { jacind[ 1 ] = 0; }
+
+  diagonal.SetSize( P );
+  diagonal.Fill( 0.0 );
+
+  /** Loop over all samples and accumulate the squared columns of J_j. */
+  typename ImageSampleContainerType::ConstIterator iter;
+  typename ImageSampleContainerType::ConstIterator begin = sampleContainer->Begin();
+  typename ImageSampleContainerType::ConstIterator end   = sampleContainer->End();
+  for( iter = begin; iter != end; ++iter )
+  {
+    const FixedImagePointType & point = ( *iter ).Value().m_ImageCoordinates;
+    this->m_Transform->GetJacobian( point, jacj, jacind );
+
+    /** Skip invalid Jacobians, if any. */
+    if( sizejacind > 1 )
+    {
+      if( jacind[ 0 ] == jacind[ 1 ] ) { continue; }
+    }
+
+    for( unsigned int pi = 0; pi < sizejacind; ++pi )
+    {
+      double sum = 0.0;
+      for( unsigned int d = 0; d < outdim; ++d )
+      {
+        sum += jacj[ d ][ pi ] * jacj[ d ][ pi ];
+      }
+      diagonal[ jacind[ pi ] ] += sum;
+    }
+  }
+
+  diagonal /= static_cast< double >( nrofsamples );
+
+} // end ComputeDiagonalCovariance()
 
 
 /**
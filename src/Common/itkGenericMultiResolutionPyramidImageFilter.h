@@ -96,7 +96,23 @@ namespace itk
  *
  * The GenericMultiResolutionPyramidImageFilter provides direct control to
  * compute only single level of the pyramid via SetCurrentLevel() and
- * SetComputeOnlyForCurrentLevel() methods.
+ * SetComputeOnlyForCurrentLevel() methods. The outputs of the other levels
+ * are then released, and they request an empty region, so that they do not
+ * trigger a new execution of the filter.
+ *
+ * When all levels are computed at once and SetDeriveFromFinerLevel() is
+ * switched on, the levels are computed from fine to coarse, and a level is
+ * derived from the next finer level when the schedules allow it: the shrink
+ * factors must be multiples of those of the finer level, and the sigmas may
+ * not be smaller. The finer level is then smoothed with
+ * sqrt( sigma^2 - sigma_finer^2 ) and shrunk by the ratio of the factors,
+ * which is cheaper than computing the level from the input. The result
+ * differs slightly from the direct computation, since the finer level has
+ * already been resampled.
+ *
+ * A level that needs neither smoothing nor rescaling shares the buffer of
+ * the input image, instead of holding a copy of it, when the input and output
+ * image types are equal.
  *
  * \author Denis P. Shamonin and Marius Staring. Division of Image Processing,
  * Department of Radiology, Leiden, The Netherlands
@@ -220,6 +236,14 @@ public:
   itkGetConstMacro( ComputeOnlyForCurrentLevel, bool );
   itkBooleanMacro( ComputeOnlyForCurrentLevel );
 
+  /** Set/Get whether the levels are derived from the next finer level when
+   * the schedules allow it. Only used when all levels are computed at once.
+   * Default: false.
+   */
+  itkSetMacro( DeriveFromFinerLevel, bool );
+  itkGetConstMacro( DeriveFromFinerLevel, bool );
+  itkBooleanMacro( DeriveFromFinerLevel );
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro( SameDimensionCheck,
@@ -262,10 +286,14 @@ protected:
   /** Release the output data when the current level is used. */
   void ReleaseOutputs( void );
 
+  /** Release the output of a level, and let it request an empty region. */
+  void ReleaseOutput( const unsigned int level );
+
   SmoothingScheduleType m_SmoothingSchedule;
   unsigned int          m_CurrentLevel;
   bool                  m_ComputeOnlyForCurrentLevel;
   bool                  m_SmoothingScheduleDefined;
+  bool                  m_DeriveFromFinerLevel;
 
 private:
 
@@ -284,6 +312,10 @@ private:
   typedef ImageToImageFilter< InputImageType, OutputImageType >
     ImageToImageFilterDifferentTypes;
 
+  /** Typedef for the smoother that derives a level from the finer level. */
+  typedef SmoothingRecursiveGaussianImageFilter<
+    OutputImageType, OutputImageType > FinerLevelSmootherType;
+
   /** Smooth image at current level. Returns true if performed.
    * This method does not perform execution.
    */
@@ -310,6 +342,20 @@ private:
     typename ImageToImageFilterSameTypes::Pointer & rescaleSameTypes,
     typename ImageToImageFilterDifferentTypes::Pointer & rescaleDifferentTypes );
 
+  /** Derive the output of a level from the output of the next finer level.
+   * Returns false if the schedules do not allow it. This method performs
+   * execution.
+   */
+  bool ComputeFromFinerLevel( const unsigned int level,
+    const OutputImagePointer & outputPtr,
+    typename ImageToImageFilterSameTypes::Pointer & rescaleSameTypes );
+
+  /** Let the output of a level share the buffer of the input if the image
+   * types are equal, or copy the input otherwise.
+   */
+  void GraftOrCopyInput( const unsigned int level,
+    const InputImageConstPointer & input );
+
   /** Initialize m_SmoothingSchedule to default values for backward compatibility. */
   void SetSmoothingScheduleToDefault( void );
 
@@ -65,6 +65,7 @@ GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionT
   temp.Fill( NumericTraits< ScalarRealType >::ZeroValue() );
   this->m_SmoothingSchedule        = temp;
   this->m_SmoothingScheduleDefined = false;
+  this->m_DeriveFromFinerLevel     = false;
 } // end Constructor
 
 
@@ -294,10 +295,18 @@ GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionT
   //
   // Pipeline also takes care of memory allocation for N'th output if
   // SetComputeOnlyForCurrentLevel has been set to true.
+  //
+  // If m_DeriveFromFinerLevel is true, the levels are computed from fine to
+  // coarse, and the pipeline for a level may transform to:
+  // 1.c) finer level -> smoother -> shrinker/resample -> output
 
   // Get the input and output pointers
   InputImageConstPointer input = this->GetInput();
 
+  // The outputs have been initialized by the pipeline; let the levels
+  // that are not computed request an empty region again.
+  this->ReleaseOutputs();
+
   // Check if we have to do anything at all
   if( !this->IsSmoothingUsed() && !this->IsRescaleUsed() )
   {
@@ -312,12 +321,7 @@ GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionT
 
       if( this->ComputeForCurrentLevel( level ) )
       {
-        OutputImagePointer outputPtr = this->GetOutput( level );
-        outputPtr->SetBufferedRegion( input->GetLargestPossibleRegion() );
-        outputPtr->Allocate();
-
-        ImageAlgorithm::Copy( input.GetPointer(), outputPtr.GetPointer(),
-          input->GetLargestPossibleRegion(), outputPtr->GetLargestPossibleRegion() );
+        this->GraftOrCopyInput( level, input );
       }
     }
     return; // We are done, return
@@ -333,20 +337,32 @@ GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionT
   typename ImageToImageFilterSameTypes::Pointer rescaleSameTypes;
   typename ImageToImageFilterDifferentTypes::Pointer rescaleDifferentTypes;
 
-  for( unsigned int level = 0; level < this->m_NumberOfLevels; ++level )
+  // Derive the levels from the finer levels only if all levels are computed
+  const bool deriveFromFinerLevel
+    = this->m_DeriveFromFinerLevel && !this->m_ComputeOnlyForCurrentLevel;
+
+  for( unsigned int i = 0; i < this->m_NumberOfLevels; ++i )
   {
+    // Compute the finest level first if the coarser levels are derived from it
+    const unsigned int level = deriveFromFinerLevel
+      ? this->m_NumberOfLevels - 1 - i : i;
+
     if( !this->m_ComputeOnlyForCurrentLevel )
     {
-      this->UpdateProgress( static_cast< float >( level )
+      this->UpdateProgress( static_cast< float >( i )
         / static_cast< float >( this->m_NumberOfLevels ) );
     }
 
     if( this->ComputeForCurrentLevel( level ) )
     {
-      // Allocate memory for each output
       OutputImagePointer outputPtr = this->GetOutput( level );
-      outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
-      outputPtr->Allocate();
+
+      // Derive this level from the finer level if the schedules allow it
+      if( deriveFromFinerLevel && level + 1 < this->m_NumberOfLevels
+        && this->ComputeFromFinerLevel( level, outputPtr, rescaleSameTypes ) )
+      {
+        continue;
+      }
 
       // Setup the smoother
       const bool smootherIsUsed = this->SetupSmoother( level, smoother, input );
@@ -356,16 +372,22 @@ GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionT
         smoother, smootherIsUsed, input, outputPtr,
         rescaleSameTypes, rescaleDifferentTypes );
 
-      // Update the pipeline and graft or copy results to this filters output
-      if( shrinkerOrResamplerIsUsed == 0 && smootherIsUsed )
+      // Nothing to compute, so avoid allocating a copy of the input
+      if( shrinkerOrResamplerIsUsed == 0 && !smootherIsUsed )
       {
-        UpdateAndGraft< Self, SmootherType, OutputImageType >(
-          this, smoother, outputPtr, level );
+        this->GraftOrCopyInput( level, input );
+        continue;
       }
-      else if( shrinkerOrResamplerIsUsed == 0 )
+
+      // Allocate memory for the output
+      outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
+      outputPtr->Allocate();
+
+      // Update the pipeline and graft results to this filters output
+      if( shrinkerOrResamplerIsUsed == 0 )
       {
-        ImageAlgorithm::Copy( input.GetPointer(), outputPtr.GetPointer(),
-          input->GetLargestPossibleRegion(), outputPtr->GetLargestPossibleRegion() );
+        UpdateAndGraft< Self, SmootherType, OutputImageType >(
+          this, smoother, outputPtr, level );
       }
       else if( shrinkerOrResamplerIsUsed == 1 )
       {
@@ -384,6 +406,134 @@ GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionT
 }   // end GenerateData()
 
 
+/**
+ * ******************* ComputeFromFinerLevel ***********************
+ */
+
+template< class TInputImage, class TOutputImage, class TPrecisionType >
+bool
+GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionType >
+::ComputeFromFinerLevel( const unsigned int level,
+  const OutputImagePointer & outputPtr,
+  typename ImageToImageFilterSameTypes::Pointer & rescaleSameTypes )
+{
+  // The finer level should have been computed
+  OutputImagePointer finerPtr = this->GetOutput( level + 1 );
+  if( finerPtr->GetBufferedRegion().GetNumberOfPixels() == 0 )
+  {
+    return false;
+  }
+
+  // The schedules should be nested
+  SigmaArrayType         sigmaArray, finerSigmaArray, relativeSigmaArray;
+  RescaleFactorArrayType shrinkFactors, finerShrinkFactors, relativeShrinkFactors;
+  this->GetSigma( level, sigmaArray );
+  this->GetSigma( level + 1, finerSigmaArray );
+  this->GetShrinkFactors( level, shrinkFactors );
+  this->GetShrinkFactors( level + 1, finerShrinkFactors );
+  for( unsigned int dim = 0; dim < ImageDimension; dim++ )
+  {
+    const unsigned int factor      = static_cast< unsigned int >( shrinkFactors[ dim ] );
+    const unsigned int finerFactor = static_cast< unsigned int >( finerShrinkFactors[ dim ] );
+    if( finerFactor == 0 || factor % finerFactor != 0
+      || sigmaArray[ dim ] < finerSigmaArray[ dim ] )
+    {
+      return false;
+    }
+
+    // Gaussians add up in their variances
+    relativeShrinkFactors[ dim ] = static_cast< ScalarRealType >( factor / finerFactor );
+    relativeSigmaArray[ dim ]    = vcl_sqrt( sigmaArray[ dim ] * sigmaArray[ dim ]
+      - finerSigmaArray[ dim ] * finerSigmaArray[ dim ] );
+  }
+
+  // Use a copy of the finer output that is not connected to this filter,
+  // so that the pipeline below does not update this filter.
+  OutputImagePointer finerLevel = OutputImageType::New();
+  finerLevel->Graft( finerPtr );
+
+  const bool smootherIsUsed = !this->AreSigmasAllZeros( relativeSigmaArray );
+  const bool rescaleIsUsed  = !this->AreRescaleFactorsAllOnes( relativeShrinkFactors );
+
+  // Equal schedules: share the buffer of the finer level
+  if( !smootherIsUsed && !rescaleIsUsed )
+  {
+    this->GraftNthOutput( level, finerLevel );
+    return true;
+  }
+
+  typename FinerLevelSmootherType::Pointer smoother;
+  if( smootherIsUsed )
+  {
+    smoother = FinerLevelSmootherType::New();
+    smoother->SetInput( finerLevel );
+    smoother->SetSigmaArray( relativeSigmaArray );
+  }
+
+  if( rescaleIsUsed )
+  {
+    typename ImageToImageFilterDifferentTypes::Pointer dummy;
+    this->DefineShrinkerOrResampler( true, relativeShrinkFactors, outputPtr,
+      rescaleSameTypes, dummy );
+    if( smootherIsUsed )
+    {
+      rescaleSameTypes->SetInput( smoother->GetOutput() );
+    }
+    else
+    {
+      rescaleSameTypes->SetInput( finerLevel );
+    }
+  }
+
+  // Allocate memory for the output
+  outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
+  outputPtr->Allocate();
+
+  if( rescaleIsUsed )
+  {
+    UpdateAndGraft< Self, ImageToImageFilterSameTypes, OutputImageType >(
+      this, rescaleSameTypes, outputPtr, level );
+  }
+  else
+  {
+    UpdateAndGraft< Self, FinerLevelSmootherType, OutputImageType >(
+      this, smoother, outputPtr, level );
+  }
+
+  return true;
+
+} // end ComputeFromFinerLevel()
+
+
+/**
+ * ******************* GraftOrCopyInput ***********************
+ */
+
+template< class TInputImage, class TOutputImage, class TPrecisionType >
+void
+GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionType >
+::GraftOrCopyInput( const unsigned int level,
+  const InputImageConstPointer & input )
+{
+  // Share the buffer of the input if the image types are equal
+  const OutputImageType * inputAsOutput
+    = dynamic_cast< const OutputImageType * >( input.GetPointer() );
+  if( inputAsOutput )
+  {
+    this->GraftNthOutput( level, const_cast< OutputImageType * >( inputAsOutput ) );
+    return;
+  }
+
+  OutputImagePointer outputPtr = this->GetOutput( level );
+  outputPtr->SetBufferedRegion( input->GetLargestPossibleRegion() );
+  outputPtr->Allocate();
+
+  ImageAlgorithm::Copy( input.GetPointer(), outputPtr.GetPointer(),
+    input->GetLargestPossibleRegion(), outputPtr->GetLargestPossibleRegion() );
+
+} // end GraftOrCopyInput()
+
+
 /**
  * ******************* SetupSmoother ***********************
  */
@@ -629,10 +779,18 @@ GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionT
     SuperSuperclass::GenerateOutputRequestedRegion( refOutput );
   }
 
-  // We have to set requestedRegion properly
+  // We have to set requestedRegion properly. The levels that are not
+  // computed request nothing, so that they do not trigger an update.
   for( unsigned int level = 0; level < this->m_NumberOfLevels; level++ )
   {
-    this->GetOutput( level )->SetRequestedRegionToLargestPossibleRegion();
+    if( this->ComputeForCurrentLevel( level ) )
+    {
+      this->GetOutput( level )->SetRequestedRegionToLargestPossibleRegion();
+    }
+    else
+    {
+      this->ReleaseOutput( level );
+    }
   }
 } // end GenerateOutputRequestedRegion()
 
@@ -646,7 +804,7 @@ void
 GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionType >
 ::GenerateInputRequestedRegion( void )
 {
-  if( this->IsRescaleUsed() )
+  if( this->IsRescaleUsed() && !this->m_ComputeOnlyForCurrentLevel )
   {
     /** GenericMultiResolutionPyramidImageFilter requires a larger input requested
      * region than the output requested regions to accommodate the shrinkage and
@@ -657,7 +815,10 @@ GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionT
   else
   {
     /** call the SuperSuperclass implementation of this method. This should
-     * copy the output requested region to the input requested region
+     * copy the output requested region to the input requested region.
+     * The Superclass implementation is not used when computing only the
+     * current level, since it is based on the finest level, which may
+     * request an empty region.
      */
     SuperSuperclass::GenerateInputRequestedRegion();
 
@@ -692,12 +853,35 @@ GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionT
   {
     if( this->m_ComputeOnlyForCurrentLevel && level != this->m_CurrentLevel )
     {
-      this->GetOutput( level )->Initialize();
+      this->ReleaseOutput( level );
     }
   }
 } // end ReleaseOutputs()
 
 
+/**
+ * ******************* ReleaseOutput ***********************
+ */
+
+template< class TInputImage, class TOutputImage, class TPrecisionType >
+void
+GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionType >
+::ReleaseOutput( const unsigned int level )
+{
+  OutputImagePointer output = this->GetOutput( level );
+  if( output.IsNull() ) { return; }
+
+  // An empty region at the start of the largest possible region is neither
+  // outside the (empty) buffered region, nor outside the largest region.
+  typename OutputImageType::RegionType emptyRegion;
+  emptyRegion.SetIndex( output->GetLargestPossibleRegion().GetIndex() );
+
+  output->Initialize();
+  output->SetBufferedRegion( emptyRegion );
+  output->SetRequestedRegion( emptyRegion );
+} // end ReleaseOutput()
+
+
 /**
  * ******************* ComputeForCurrentLevel ***********************
  */
@@ -914,6 +1098,8 @@ GenericMultiResolutionPyramidImageFilter< TInputImage, TOutputImage, TPrecisionT
      << this->m_CurrentLevel << std::endl;
   os << indent << "ComputeOnlyForCurrentLevel: "
      << ( this->m_ComputeOnlyForCurrentLevel ? "true" : "false" ) << std::endl;
+  os << indent << "DeriveFromFinerLevel: "
+     << ( this->m_DeriveFromFinerLevel ? "true" : "false" ) << std::endl;
   os << indent << "SmoothingScheduleDefined: "
      << ( this->m_SmoothingScheduleDefined ? "true" : "false" ) << std::endl;
   os << indent << "Smoothing Schedule: ";
@@ -35,6 +35,10 @@ namespace itk
  * if necessary. This is useful in some cases, to avoid the use of
  * a itk::CastImageFilter (to save memory for example).
  *
+ * With SetNumberOfStreamDivisions() the image is written in pieces, if the
+ * image IO supports streamed writing. Each piece is requested from the
+ * input and cast separately, so the input does not have to fit in memory.
+ *
  */
 template< class TInputImage >
 class ITKIOImageBase_HIDDEN ImageFileCastWriter : public ImageFileWriter< TInputImage >
@@ -107,6 +111,7 @@ protected:
 #endif
 
     caster->SetInput( localInputImage );
+    caster->GetOutput()->SetRequestedRegion( localInputImage->GetBufferedRegion() );
     caster->Update();
 
     /** return the pixel buffer of the casted image */
@@ -27,6 +27,7 @@
 #include "itkVectorImage.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkMetaImageIO.h"
+#include "itkImageAlgorithm.h"
 
 namespace itk
 {
@@ -80,6 +81,31 @@ ImageFileCastWriter< TInputImage >
 
   itkDebugMacro( << "Writing file: " << this->GetFileName() );
 
+  /** When the image is written in pieces, the input may contain more than
+   * the current piece. The image IO expects a buffer of the piece only, so
+   * copy the piece in that case.
+   */
+  InputImagePointer    cacheImage;
+  InputImageRegionType ioRegion;
+  ImageIORegionAdaptor< InputImageDimension >::Convert(
+    this->GetImageIO()->GetIORegion(), ioRegion,
+    input->GetLargestPossibleRegion().GetIndex() );
+  if( input->GetBufferedRegion() != ioRegion )
+  {
+    if( !input->GetBufferedRegion().IsInside( ioRegion ) )
+    {
+      itkExceptionMacro( << "The region to write " << ioRegion
+                         << " is not inside the buffered region "
+                         << input->GetBufferedRegion() );
+    }
+    cacheImage = InputImageType::New();
+    cacheImage->CopyInformation( input );
+    cacheImage->SetBufferedRegion( ioRegion );
+    cacheImage->Allocate();
+    ImageAlgorithm::Copy( input, cacheImage.GetPointer(), ioRegion, ioRegion );
+    input = cacheImage;
+  }
+
   // Make sure that the image is the right type and no more than
   // four components.
   typedef typename InputImageType::PixelType ScalarType;
@@ -0,0 +1,107 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageFileWriteJob_h
+#define __itkImageFileWriteJob_h
+
+#include "itkAsynchronousWriteQueue.h"
+
+namespace itk
+{
+
+/** \class ImageFileWriteJob
+ * \brief A job of the AsynchronousWriteQueue that casts and writes an image
+ * with the ImageFileCastWriter.
+ *
+ * SetImage() grafts the image in an image of the job, which shares the
+ * pixel buffer but not the pipeline. So the worker thread does not touch
+ * the pipeline of the caller. The caller must not change the pixels anymore,
+ * for example by disconnecting the image from the filter that produced it.
+ *
+ * \ingroup Common
+ */
+
+template< class TImage >
+class ImageFileWriteJob : public AsynchronousWriteQueue::Job
+{
+public:
+
+  /** Standard ITK-stuff. */
+  typedef ImageFileWriteJob           Self;
+  typedef AsynchronousWriteQueue::Job Superclass;
+  typedef SmartPointer< Self >        Pointer;
+  typedef SmartPointer< const Self >  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( ImageFileWriteJob, Job );
+
+  /** Typedef's. */
+  typedef TImage                        ImageType;
+  typedef typename ImageType::Pointer   ImagePointer;
+  typedef typename ImageType::PixelType PixelType;
+
+  /** Set the image to write. */
+  void SetImage( const ImageType * image );
+
+  /** Set/Get the file name, the component type of the written pixels,
+   * and whether the image is compressed. See the ImageFileCastWriter.
+   */
+  itkSetStringMacro( FileName );
+  itkGetStringMacro( FileName );
+  itkSetStringMacro( OutputComponentType );
+  itkGetStringMacro( OutputComponentType );
+  itkSetMacro( UseCompression, bool );
+  itkGetConstMacro( UseCompression, bool );
+
+  /** Write the image. */
+  virtual void Execute( void );
+
+  /** The memory of the pixel buffer, plus the buffer of the cast pixels
+   * that the ImageFileCastWriter allocates while writing.
+   */
+  virtual SizeValueType GetMemorySize( void ) const;
+
+protected:
+
+  ImageFileWriteJob();
+  virtual ~ImageFileWriteJob() {}
+
+private:
+
+  ImageFileWriteJob( const Self & ); // purposely not implemented
+  void operator=( const Self & );    // purposely not implemented
+
+  /** The size in bytes of a component type of the ImageFileCastWriter. */
+  static SizeValueType GetComponentSize( const std::string & componentType );
+
+  ImagePointer m_Image;
+  std::string  m_FileName;
+  std::string  m_OutputComponentType;
+  bool         m_UseCompression;
+
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageFileWriteJob.hxx"
+#endif
+
+#endif // end #ifndef __itkImageFileWriteJob_h
@@ -0,0 +1,163 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageFileWriteJob_hxx
+#define __itkImageFileWriteJob_hxx
+
+#include "itkImageFileWriteJob.h"
+#include "itkImageFileCastWriter.h"
+#include "itkPixelTraits.h"
+
+namespace itk
+{
+
+/**
+ * ********************* Constructor ****************************
+ */
+
+template< class TImage >
+ImageFileWriteJob< TImage >
+::ImageFileWriteJob()
+{
+  this->m_Image               = 0;
+  this->m_OutputComponentType = "";
+  this->m_UseCompression      = false;
+
+} // end Constructor
+
+
+/**
+ * ********************* SetImage ****************************
+ */
+
+template< class TImage >
+void
+ImageFileWriteJob< TImage >
+::SetImage( const ImageType * image )
+{
+  this->m_Image = 0;
+  if( image )
+  {
+    this->m_Image = ImageType::New();
+    this->m_Image->Graft( image );
+  }
+  this->Modified();
+
+} // end SetImage()
+
+
+/**
+ * ********************* Execute ****************************
+ */
+
+template< class TImage >
+void
+ImageFileWriteJob< TImage >
+::Execute( void )
+{
+  if( this->m_Image.IsNull() )
+  {
+    itkExceptionMacro( << "No image to write to \"" << this->m_FileName << "\"." );
+  }
+
+  typedef ImageFileCastWriter< ImageType > WriterType;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( this->m_Image );
+  writer->SetFileName( this->m_FileName.c_str() );
+  if( !this->m_OutputComponentType.empty() )
+  {
+    writer->SetOutputComponentType( this->m_OutputComponentType.c_str() );
+  }
+  writer->SetUseCompression( this->m_UseCompression );
+  writer->Update();
+
+} // end Execute()
+
+
+/**
+ * ********************* GetMemorySize ****************************
+ */
+
+template< class TImage >
+SizeValueType
+ImageFileWriteJob< TImage >
+::GetMemorySize( void ) const
+{
+  if( this->m_Image.IsNull() ) { return 0; }
+
+  const SizeValueType numberOfPixels
+    = this->m_Image->GetBufferedRegion().GetNumberOfPixels();
+  SizeValueType memorySize = numberOfPixels * sizeof( PixelType );
+
+  /** The writer converts scalar pixels to another component type in a
+   * buffer of the whole image.
+   */
+  if( PixelTraits< PixelType >::Dimension == 1
+    && !this->m_OutputComponentType.empty() )
+  {
+    typedef ImageFileCastWriter< ImageType > WriterType;
+    typename WriterType::Pointer writer = WriterType::New();
+    if( this->m_OutputComponentType != writer->GetDefaultOutputComponentType() )
+    {
+      memorySize += numberOfPixels * GetComponentSize( this->m_OutputComponentType );
+    }
+  }
+
+  return memorySize;
+
+} // end GetMemorySize()
+
+
+/**
+ * ********************* GetComponentSize ****************************
+ */
+
+template< class TImage >
+SizeValueType
+ImageFileWriteJob< TImage >
+::GetComponentSize( const std::string & componentType )
+{
+  if( componentType == "char" || componentType == "unsigned_char" )
+  {
+    return sizeof( char );
+  }
+  else if( componentType == "short" || componentType == "unsigned_short" )
+  {
+    return sizeof( short );
+  }
+  else if( componentType == "int" || componentType == "unsigned_int" )
+  {
+    return sizeof( int );
+  }
+  else if( componentType == "long" || componentType == "unsigned_long" )
+  {
+    return sizeof( long );
+  }
+  else if( componentType == "float" )
+  {
+    return sizeof( float );
+  }
+
+  /** A double, or an unknown type, which the writer does not convert. */
+  return sizeof( double );
+
+} // end GetComponentSize()
+
+
+} // end namespace itk
+
+#endif // end #ifndef __itkImageFileWriteJob_hxx
@@ -116,6 +116,12 @@ namespace itk
  *
  * This filter uses multithreaded filters to perform the smoothing.
  *
+ * Since all levels have the size of the input image, the memory use can be
+ * reduced by computing only a single level of the pyramid, via the
+ * SetCurrentLevel() and SetComputeOnlyForCurrentLevel() methods, like in the
+ * GenericMultiResolutionPyramidImageFilter. The outputs of the other levels
+ * are then released.
+ *
  * This filter supports streaming.
  *
  * \ingroup PyramidImageFilter Multithreaded Streamed
@@ -187,6 +193,20 @@ public:
    * ProcessObject::GenerateInputRequestedRegion() */
   virtual void GenerateInputRequestedRegion();
 
+  /** Set the current multi-resolution level. The current level is clamped to
+   * the total number of levels.
+   */
+  virtual void SetCurrentLevel( unsigned int level );
+
+  /** Get the current multi-resolution level. */
+  itkGetConstReferenceMacro( CurrentLevel, unsigned int );
+
+  /** Set a control on whether only the current level is computed. */
+  virtual void SetComputeOnlyForCurrentLevel( const bool _arg );
+
+  itkGetConstMacro( ComputeOnlyForCurrentLevel, bool );
+  itkBooleanMacro( ComputeOnlyForCurrentLevel );
+
 protected:
 
   MultiResolutionGaussianSmoothingPyramidImageFilter();
@@ -200,6 +220,19 @@ protected:
    * because it uses internally a filter that does this. */
   virtual void EnlargeOutputRequestedRegion( DataObject * output );
 
+  /** Checks whether we have to compute a level, based on
+   * m_ComputeOnlyForCurrentLevel and m_CurrentLevel.
+   */
+  bool ComputeForCurrentLevel( const unsigned int level ) const;
+
+  /** Release the outputs of the levels that are not computed, and let
+   * them request an empty region, so that they do not trigger an update.
+   */
+  void ReleaseOutputs( void );
+
+  unsigned int m_CurrentLevel;
+  bool         m_ComputeOnlyForCurrentLevel;
+
 private:
 
   MultiResolutionGaussianSmoothingPyramidImageFilter( const Self & ); // purposely not implemented
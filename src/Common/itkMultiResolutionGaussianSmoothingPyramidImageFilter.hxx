@@ -53,7 +53,56 @@ namespace itk
 template< class TInputImage, class TOutputImage >
 MultiResolutionGaussianSmoothingPyramidImageFilter< TInputImage, TOutputImage >
 ::MultiResolutionGaussianSmoothingPyramidImageFilter()
-{}
+{
+  this->m_CurrentLevel               = 0;
+  this->m_ComputeOnlyForCurrentLevel = false;
+}
+
+
+/*
+ * Set the current level
+ */
+template< class TInputImage, class TOutputImage >
+void
+MultiResolutionGaussianSmoothingPyramidImageFilter< TInputImage, TOutputImage >
+::SetCurrentLevel( unsigned int level )
+{
+  itkDebugMacro( "setting CurrentLevel to " << level );
+  if( this->m_CurrentLevel != level )
+  {
+    // clamp value to be less then number of levels
+    this->m_CurrentLevel = level;
+    if( this->m_CurrentLevel >= this->m_NumberOfLevels )
+    {
+      this->m_CurrentLevel = this->m_NumberOfLevels - 1;
+    }
+    this->ReleaseOutputs();
+
+    /** Only set the modified flag for this filter if the output is computed per level. */
+    if( this->m_ComputeOnlyForCurrentLevel )
+    {
+      this->Modified();
+    }
+  }
+}
+
+
+/*
+ * Set whether only the current level is computed
+ */
+template< class TInputImage, class TOutputImage >
+void
+MultiResolutionGaussianSmoothingPyramidImageFilter< TInputImage, TOutputImage >
+::SetComputeOnlyForCurrentLevel( const bool _arg )
+{
+  itkDebugMacro( "setting ComputeOnlyForCurrentLevel to " << _arg );
+  if( this->m_ComputeOnlyForCurrentLevel != _arg )
+  {
+    this->m_ComputeOnlyForCurrentLevel = _arg;
+    this->ReleaseOutputs();
+    this->Modified();
+  }
+}
 
 /*
  * Set the multi-resolution schedule
@@ -128,6 +177,10 @@ MultiResolutionGaussianSmoothingPyramidImageFilter< TInputImage, TOutputImage >
    */
   SmootherPointerArrayType smootherPointerArray;
 
+  // The outputs have been initialized by the pipeline; let the levels
+  // that are not computed request an empty region again.
+  this->ReleaseOutputs();
+
   // First set the input of the first filter pointer to the input image.
   caster->SetInput( inputPtr );
   smootherArray[ 0 ]->SetInput( caster->GetOutput() );
@@ -144,6 +197,8 @@ MultiResolutionGaussianSmoothingPyramidImageFilter< TInputImage, TOutputImage >
     this->UpdateProgress( static_cast< float >( ilevel )
       / static_cast< float >( this->m_NumberOfLevels ) );
 
+    if( !this->ComputeForCurrentLevel( ilevel ) ) { continue; }
+
     // Allocate memory for each output
     OutputImagePointer outputPtr = this->GetOutput( ilevel );
     outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
@@ -217,6 +272,10 @@ MultiResolutionGaussianSmoothingPyramidImageFilter< TInputImage, TOutputImage >
 ::PrintSelf( std::ostream & os, Indent indent ) const
 {
   Superclass::PrintSelf( os, indent );
+
+  os << indent << "CurrentLevel: " << this->m_CurrentLevel << std::endl;
+  os << indent << "ComputeOnlyForCurrentLevel: "
+     << ( this->m_ComputeOnlyForCurrentLevel ? "true" : "false" ) << std::endl;
 }
 
 
@@ -320,6 +379,9 @@ MultiResolutionGaussianSmoothingPyramidImageFilter< TInputImage, TOutputImage >
     }
   }
 
+  // The levels that are not computed request nothing
+  this->ReleaseOutputs();
+
 }
 
 
@@ -364,13 +426,52 @@ MultiResolutionGaussianSmoothingPyramidImageFilter< TInputImage, TOutputImage >
 {
   TOutputImage * out = dynamic_cast< TOutputImage * >( output );
 
-  if( out )
+  if( out && this->ComputeForCurrentLevel( out->GetSourceOutputIndex() ) )
   {
     out->SetRequestedRegion( out->GetLargestPossibleRegion() );
   }
 }
 
 
+/*
+ * ComputeForCurrentLevel
+ */
+
+template< class TInputImage, class TOutputImage >
+bool
+MultiResolutionGaussianSmoothingPyramidImageFilter< TInputImage, TOutputImage >
+::ComputeForCurrentLevel( const unsigned int level ) const
+{
+  return !this->m_ComputeOnlyForCurrentLevel || level == this->m_CurrentLevel;
+}
+
+
+/*
+ * ReleaseOutputs
+ */
+
+template< class TInputImage, class TOutputImage >
+void
+MultiResolutionGaussianSmoothingPyramidImageFilter< TInputImage, TOutputImage >
+::ReleaseOutputs( void )
+{
+  for( unsigned int ilevel = 0; ilevel < this->m_NumberOfLevels; ilevel++ )
+  {
+    OutputImagePointer outputPtr = this->GetOutput( ilevel );
+    if( this->ComputeForCurrentLevel( ilevel ) || !outputPtr ) { continue; }
+
+    // An empty region at the start of the largest possible region is neither
+    // outside the (empty) buffered region, nor outside the largest region.
+    typename OutputImageType::RegionType emptyRegion;
+    emptyRegion.SetIndex( outputPtr->GetLargestPossibleRegion().GetIndex() );
+
+    outputPtr->Initialize();
+    outputPtr->SetBufferedRegion( emptyRegion );
+    outputPtr->SetRequestedRegion( emptyRegion );
+  }
+}
+
+
 } // namespace itk
 
 #endif
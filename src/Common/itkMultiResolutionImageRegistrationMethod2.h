@@ -45,6 +45,7 @@
 #include "itkMultiResolutionPyramidImageFilter.h"
 #include "itkNumericTraits.h"
 #include "itkDataObjectDecorator.h"
+#include <vector>
 
 namespace itk
 {
@@ -228,6 +229,28 @@ public:
    */
   itkGetConstReferenceMacro( LastTransformParameters, ParametersType );
 
+  /** Type for a list of transform parameters, one per resolution level. */
+  typedef std::vector< ParametersType > ParametersContainerType;
+
+  /** Set/Get the final transformation parameters of the resolution levels
+   * that were completed before, for example by a registration that was
+   * interrupted. These levels are not optimized again: the stored parameters
+   * are used as their result. The IterationEvent is still invoked for these
+   * levels, so that the components can set up the transform of the level.
+   */
+  virtual void SetCompletedLevelParameters( const ParametersContainerType & parameters )
+  {
+    this->m_CompletedLevelParameters = parameters;
+    this->Modified();
+  }
+
+
+  const ParametersContainerType & GetCompletedLevelParameters( void ) const
+  {
+    return this->m_CompletedLevelParameters;
+  }
+
+
   /** Returns the transform resulting from the registration process. */
   const TransformOutputType * GetOutput( void ) const;
 
@@ -269,6 +292,12 @@ protected:
   /** Set the current level to be processed. */
   itkSetMacro( CurrentLevel, unsigned long );
 
+  /** If the level was completed before, set the last transformation
+   * parameters, the parameters of the transform, and the initial parameters
+   * of the next level to the stored result, and return true.
+   */
+  virtual bool SkipCompletedLevel( unsigned long level );
+
   /** The last transform parameters. Compared to the ITK class
    * itk::MultiResolutionImageRegistrationMethod these member variables
    * are made protected, so they can be accessed by children classes.
@@ -287,8 +316,9 @@ private:
   TransformPointer       m_Transform;
   InterpolatorPointer    m_Interpolator;
 
-  ParametersType m_InitialTransformParameters;
-  ParametersType m_InitialTransformParametersOfNextLevel;
+  ParametersType          m_InitialTransformParameters;
+  ParametersType          m_InitialTransformParametersOfNextLevel;
+  ParametersContainerType m_CompletedLevelParameters;
 
   MovingImageConstPointer   m_MovingImage;
   FixedImageConstPointer    m_FixedImage;
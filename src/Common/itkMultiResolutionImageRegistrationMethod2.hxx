@@ -155,6 +155,40 @@ MultiResolutionImageRegistrationMethod2< TFixedImage, TMovingImage >
 }
 
 
+/*
+ * Skip a level that was completed before
+ */
+template< typename TFixedImage, typename TMovingImage >
+bool
+MultiResolutionImageRegistrationMethod2< TFixedImage, TMovingImage >
+::SkipCompletedLevel( unsigned long level )
+{
+  if( level >= this->m_CompletedLevelParameters.size() )
+  {
+    return false;
+  }
+
+  if( this->m_CompletedLevelParameters[ level ].Size()
+    != this->GetTransform()->GetNumberOfParameters() )
+  {
+    itkExceptionMacro( << "Size mismatch between the stored parameters of level " << level
+                       << " (" << this->m_CompletedLevelParameters[ level ].Size()
+                       << ") and transform (" << this->GetTransform()->GetNumberOfParameters() << ")" );
+  }
+
+  this->m_LastTransformParameters = this->m_CompletedLevelParameters[ level ];
+  this->GetTransform()->SetParameters( this->m_LastTransformParameters );
+
+  if( level < this->GetNumberOfLevels() - 1 )
+  {
+    this->SetInitialTransformParametersOfNextLevel( this->m_LastTransformParameters );
+  }
+
+  return true;
+
+} // end SkipCompletedLevel()
+
+
 /*
  * Stop the Registration Process
  */
@@ -318,6 +352,12 @@ MultiResolutionImageRegistrationMethod2< TFixedImage, TMovingImage >
         break;
       }
 
+      // Levels that were completed before are not optimized again
+      if( this->SkipCompletedLevel( this->m_CurrentLevel ) )
+      {
+        continue;
+      }
+
       try
       {
         // initialize the interconnects between components
@@ -0,0 +1,226 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkParallelVectorOperations_cxx
+#define __itkParallelVectorOperations_cxx
+
+#include "itkParallelVectorOperations.h"
+#include <vector>
+
+#ifdef ELASTIX_USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace itk
+{
+
+/** The minimum number of elements per thread; below this size, starting
+ * the threads costs more than it saves. */
+static const SizeValueType ParallelVectorOperationsMinimumBlockSize = 16384;
+
+/**
+ * ********************* GetNumberOfBlocks **********************
+ */
+
+int
+ParallelVectorOperations
+::GetNumberOfBlocks( SizeValueType n )
+{
+#ifdef ELASTIX_USE_OPENMP
+  const SizeValueType maximumNumberOfBlocks
+    = static_cast< SizeValueType >( omp_get_max_threads() );
+  SizeValueType numberOfBlocks = n / ParallelVectorOperationsMinimumBlockSize;
+  if( numberOfBlocks > maximumNumberOfBlocks )
+  {
+    numberOfBlocks = maximumNumberOfBlocks;
+  }
+  return numberOfBlocks > 1 ? static_cast< int >( numberOfBlocks ) : 1;
+#else
+  return 1;
+#endif
+
+} // end GetNumberOfBlocks()
+
+
+/**
+ * ********************* InnerProduct ***************************
+ */
+
+double
+ParallelVectorOperations
+::InnerProduct( const VectorType & a, const VectorType & b )
+{
+  const int      n              = static_cast< int >( a.size() );
+  const double * pa             = a.data_block();
+  const double * pb             = b.data_block();
+  const int      numberOfBlocks = GetNumberOfBlocks( n );
+
+  if( numberOfBlocks == 1 )
+  {
+    double sum = 0.0;
+    for( int i = 0; i < n; ++i )
+    {
+      sum += pa[ i ] * pb[ i ];
+    }
+    return sum;
+  }
+
+  /** Sum per block, and then sum the blocks in a fixed order. */
+  std::vector< double > partialSums( numberOfBlocks, 0.0 );
+  const int             blockSize = ( n + numberOfBlocks - 1 ) / numberOfBlocks;
+#ifdef ELASTIX_USE_OPENMP
+  #pragma omp parallel for num_threads( numberOfBlocks ) schedule( static )
+#endif
+  for( int block = 0; block < numberOfBlocks; ++block )
+  {
+    const int begin = block * blockSize;
+    const int end   = ( begin + blockSize < n ) ? begin + blockSize : n;
+    double    sum   = 0.0;
+    for( int i = begin; i < end; ++i )
+    {
+      sum += pa[ i ] * pb[ i ];
+    }
+    partialSums[ block ] = sum;
+  }
+
+  double sum = 0.0;
+  for( int block = 0; block < numberOfBlocks; ++block )
+  {
+    sum += partialSums[ block ];
+  }
+  return sum;
+
+} // end InnerProduct()
+
+
+/**
+ * ********************* SquaredMagnitude ***********************
+ */
+
+double
+ParallelVectorOperations
+::SquaredMagnitude( const VectorType & a )
+{
+  return InnerProduct( a, a );
+
+} // end SquaredMagnitude()
+
+
+/**
+ * ********************* ScaledCopy *****************************
+ */
+
+void
+ParallelVectorOperations
+::ScaledCopy( VectorType & out, double alpha, const VectorType & a )
+{
+  if( out.size() != a.size() )
+  {
+    out.set_size( a.size() );
+  }
+
+  const int      n  = static_cast< int >( a.size() );
+  const double * pa = a.data_block();
+  double *       po = out.data_block();
+#ifdef ELASTIX_USE_OPENMP
+  #pragma omp parallel for num_threads( GetNumberOfBlocks( n ) ) schedule( static )
+#endif
+  for( int i = 0; i < n; ++i )
+  {
+    po[ i ] = alpha * pa[ i ];
+  }
+
+} // end ScaledCopy()
+
+
+/**
+ * ********************* AddScaled ******************************
+ */
+
+void
+ParallelVectorOperations
+::AddScaled( VectorType & out, const VectorType & a,
+  double alpha, const VectorType & b )
+{
+  if( out.size() != a.size() )
+  {
+    out.set_size( a.size() );
+  }
+
+  const int      n  = static_cast< int >( a.size() );
+  const double * pa = a.data_block();
+  const double * pb = b.data_block();
+  double *       po = out.data_block();
+#ifdef ELASTIX_USE_OPENMP
+  #pragma omp parallel for num_threads( GetNumberOfBlocks( n ) ) schedule( static )
+#endif
+  for( int i = 0; i < n; ++i )
+  {
+    po[ i ] = pa[ i ] + alpha * pb[ i ];
+  }
+
+} // end AddScaled()
+
+
+/**
+ * ********************* ScaleAndAdd ****************************
+ */
+
+void
+ParallelVectorOperations
+::ScaleAndAdd( VectorType & out, double alpha,
+  const VectorType & a, double beta )
+{
+  const int      n  = static_cast< int >( out.size() );
+  const double * pa = a.data_block();
+  double *       po = out.data_block();
+#ifdef ELASTIX_USE_OPENMP
+  #pragma omp parallel for num_threads( GetNumberOfBlocks( n ) ) schedule( static )
+#endif
+  for( int i = 0; i < n; ++i )
+  {
+    po[ i ] = alpha * pa[ i ] + beta * po[ i ];
+  }
+
+} // end ScaleAndAdd()
+
+
+/**
+ * ********************* MultiplyElementWise ********************
+ */
+
+void
+ParallelVectorOperations
+::MultiplyElementWise( VectorType & out, const VectorType & a )
+{
+  const int      n  = static_cast< int >( out.size() );
+  const double * pa = a.data_block();
+  double *       po = out.data_block();
+#ifdef ELASTIX_USE_OPENMP
+  #pragma omp parallel for num_threads( GetNumberOfBlocks( n ) ) schedule( static )
+#endif
+  for( int i = 0; i < n; ++i )
+  {
+    po[ i ] *= pa[ i ];
+  }
+
+} // end MultiplyElementWise()
+
+
+} // end namespace itk
+
+#endif // end #ifndef __itkParallelVectorOperations_cxx
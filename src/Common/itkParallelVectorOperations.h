@@ -0,0 +1,84 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkParallelVectorOperations_h
+#define __itkParallelVectorOperations_h
+
+#include "itkIntTypes.h"
+#include "vnl/vnl_vector.h"
+
+namespace itk
+{
+/** \class ParallelVectorOperations
+ * \brief Multi-threaded vector kernels for the optimizers.
+ *
+ * The dot products, axpys and scalings of the quasi-Newton and
+ * conjugate gradient optimizers and of the line search are linear in the
+ * number of parameters, and are done for every iteration. For B-spline
+ * transforms with millions of parameters they take a noticeable fraction
+ * of the time of an iteration. These kernels divide the vectors over the
+ * OpenMP threads when elastix is compiled with ELASTIX_USE_OPENMP, and
+ * work on raw pointers in simple loops, which compilers vectorize.
+ *
+ * Short vectors are processed by a single thread. Reductions are computed
+ * per block of the vector and then summed in block order, so that the
+ * result only depends on the number of threads. With a single thread the
+ * result is the same as that of the vnl functions.
+ *
+ * The output vectors may be the same as one of the input vectors.
+ */
+
+class ParallelVectorOperations
+{
+public:
+
+  typedef vnl_vector< double > VectorType;
+
+  /** Return a' * b. */
+  static double InnerProduct( const VectorType & a, const VectorType & b );
+
+  /** Return a' * a. */
+  static double SquaredMagnitude( const VectorType & a );
+
+  /** Compute out = alpha * a. The output is resized if needed. */
+  static void ScaledCopy( VectorType & out, double alpha, const VectorType & a );
+
+  /** Compute out = a + alpha * b. The output is resized if needed. */
+  static void AddScaled( VectorType & out, const VectorType & a,
+    double alpha, const VectorType & b );
+
+  /** Compute out = alpha * a + beta * out. */
+  static void ScaleAndAdd( VectorType & out, double alpha,
+    const VectorType & a, double beta );
+
+  /** Compute out = out .* a, the element-wise product. */
+  static void MultiplyElementWise( VectorType & out, const VectorType & a );
+
+  /** The number of threads that is used for a vector of size n. */
+  static int GetNumberOfBlocks( SizeValueType n );
+
+private:
+
+  ParallelVectorOperations();                                   // purposely not implemented
+  ParallelVectorOperations( const ParallelVectorOperations & ); // purposely not implemented
+  void operator=( const ParallelVectorOperations & );           // purposely not implemented
+
+};
+
+} // end namespace itk
+
+#endif // end #ifndef __itkParallelVectorOperations_h
@@ -49,6 +49,7 @@ ScaledSingleValuedNonLinearOptimizer
    * as squared scales (following the ITK convention)!
    */
   this->m_ScaledCostFunction->SetSquaredScales( this->GetScales() );
+  this->m_ScaledCostFunction->ResetEvaluationCache();
   this->Modified();
 
 } // end InitializeScales()
@@ -95,6 +96,33 @@ ScaledSingleValuedNonLinearOptimizer
 } // end GetUseScales()
 
 
+/**
+ * ********************* SetUseEvaluationCache ******************************
+ */
+
+void
+ScaledSingleValuedNonLinearOptimizer
+::SetUseEvaluationCache( bool arg )
+{
+  this->m_ScaledCostFunction->SetUseEvaluationCache( arg );
+  this->Modified();
+
+} // end SetUseEvaluationCache()
+
+
+/**
+ * ********************* GetUseEvaluationCache ******************************
+ */
+
+bool
+ScaledSingleValuedNonLinearOptimizer
+::GetUseEvaluationCache( void ) const
+{
+  return this->m_ScaledCostFunction->GetUseEvaluationCache();
+
+} // end GetUseEvaluationCache()
+
+
 /**
  * ********************* GetScaledValue *****************************
  */
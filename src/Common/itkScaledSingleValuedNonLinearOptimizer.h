@@ -92,7 +92,7 @@ public:
    * NB: it assumes that the scales entered by the user
    * are the squared scales (following the ITK convention).
    * Call this method in StartOptimization() and after
-   * entering new scales.
+   * entering new scales. It also resets the evaluation cache.
    */
   virtual void InitializeScales( void );
 
@@ -106,6 +106,14 @@ public:
 
   bool GetUseScales( void ) const;
 
+  /** Setting: Turn on/off the reuse of previous evaluations of the cost
+   * function, see ScaledSingleValuedCostFunction::SetUseEvaluationCache().
+   * The cache and its counters are reset by InitializeScales().
+   */
+  virtual void SetUseEvaluationCache( bool arg );
+
+  bool GetUseEvaluationCache( void ) const;
+
   /** Get the current scaled position. */
   itkGetConstReferenceMacro( ScaledCurrentPosition, ParametersType );
 
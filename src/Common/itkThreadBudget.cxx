@@ -0,0 +1,245 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkThreadBudget_cxx
+#define __itkThreadBudget_cxx
+
+#include "itkThreadBudget.h"
+#include "itkMultiThreader.h"
+
+namespace itk
+{
+
+ThreadBudget::Pointer ThreadBudget::m_Instance = 0;
+SimpleFastMutexLock   ThreadBudget::m_InstanceMutex;
+
+/**
+ * ********************* Constructor ****************************
+ */
+
+ThreadBudget::ThreadBudget()
+{
+  this->m_TotalNumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+
+} // end Constructor
+
+
+/**
+ * ********************* GetInstance ****************************
+ */
+
+ThreadBudget::Pointer
+ThreadBudget
+::GetInstance( void )
+{
+  m_InstanceMutex.Lock();
+  if( m_Instance.IsNull() )
+  {
+    m_Instance = new ThreadBudget;
+    m_Instance->UnRegister();
+  }
+  Pointer instance = m_Instance;
+  m_InstanceMutex.Unlock();
+
+  return instance;
+
+} // end GetInstance()
+
+
+/**
+ * ********************* SetTotalNumberOfThreads ****************************
+ */
+
+void
+ThreadBudget
+::SetTotalNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_Mutex.Lock();
+  this->m_TotalNumberOfThreads = numberOfThreads > 0 ? numberOfThreads : 1;
+  this->m_Mutex.Unlock();
+
+} // end SetTotalNumberOfThreads()
+
+
+/**
+ * ********************* GetTotalNumberOfThreads ****************************
+ */
+
+ThreadIdType
+ThreadBudget
+::GetTotalNumberOfThreads( void ) const
+{
+  this->m_Mutex.Lock();
+  const ThreadIdType totalNumberOfThreads = this->m_TotalNumberOfThreads;
+  this->m_Mutex.Unlock();
+  return totalNumberOfThreads;
+
+} // end GetTotalNumberOfThreads()
+
+
+/**
+ * ********************* Register ****************************
+ */
+
+void
+ThreadBudget
+::Register( const void * client, const ThreadIdType maximumNumberOfThreads )
+{
+  if( !client ) { return; }
+
+  this->m_Mutex.Lock();
+  ClientContainerType::iterator it = this->m_Clients.begin();
+  while( it != this->m_Clients.end() && it->first != client ) { ++it; }
+  if( it != this->m_Clients.end() )
+  {
+    it->second = maximumNumberOfThreads;
+  }
+  else
+  {
+    this->m_Clients.push_back( ClientType( client, maximumNumberOfThreads ) );
+  }
+  this->m_Mutex.Unlock();
+
+} // end Register()
+
+
+/**
+ * ********************* Unregister ****************************
+ */
+
+void
+ThreadBudget
+::Unregister( const void * client )
+{
+  this->m_Mutex.Lock();
+  ClientContainerType::iterator it = this->m_Clients.begin();
+  while( it != this->m_Clients.end() && it->first != client ) { ++it; }
+  if( it != this->m_Clients.end() )
+  {
+    this->m_Clients.erase( it );
+  }
+  this->m_Mutex.Unlock();
+
+} // end Unregister()
+
+
+/**
+ * ********************* GetNumberOfThreads ****************************
+ */
+
+ThreadIdType
+ThreadBudget
+::GetNumberOfThreads( const void * client ) const
+{
+  this->m_Mutex.Lock();
+
+  /** Find the client. */
+  const std::size_t numberOfClients = this->m_Clients.size();
+  std::size_t       index           = 0;
+  while( index < numberOfClients && this->m_Clients[ index ].first != client ) { ++index; }
+  if( index == numberOfClients )
+  {
+    const ThreadIdType totalNumberOfThreads = this->m_TotalNumberOfThreads;
+    this->m_Mutex.Unlock();
+    return totalNumberOfThreads;
+  }
+
+  /** First give the clients with a maximum below their share that maximum,
+   * and divide the remaining threads over the others. Repeat until the
+   * shares do not change anymore.
+   */
+  std::vector< ThreadIdType > shares( numberOfClients, 0 );
+  ThreadIdType                remainingThreads = this->m_TotalNumberOfThreads;
+  std::size_t                 remainingClients = numberOfClients;
+  bool                        changed          = true;
+  while( changed && remainingClients > 0 )
+  {
+    changed = false;
+    const ThreadIdType share = remainingThreads / remainingClients;
+    for( std::size_t i = 0; i < numberOfClients; ++i )
+    {
+      const ThreadIdType maximum = this->m_Clients[ i ].second;
+      if( shares[ i ] == 0 && maximum > 0 && maximum <= share )
+      {
+        shares[ i ]       = maximum;
+        remainingThreads -= maximum;
+        --remainingClients;
+        changed = true;
+      }
+    }
+  }
+
+  /** The other clients get an equal share, and the first ones the remainder. */
+  ThreadIdType numberOfThreads = shares[ index ];
+  if( numberOfThreads == 0 )
+  {
+    const ThreadIdType share     = remainingThreads / remainingClients;
+    ThreadIdType       remainder = remainingThreads % remainingClients;
+    for( std::size_t i = 0; i < numberOfClients; ++i )
+    {
+      if( shares[ i ] != 0 ) { continue; }
+      shares[ i ] = share;
+      if( remainder > 0 )
+      {
+        ++shares[ i ];
+        --remainder;
+      }
+    }
+    numberOfThreads = shares[ index ];
+  }
+  this->m_Mutex.Unlock();
+
+  return numberOfThreads > 0 ? numberOfThreads : 1;
+
+} // end GetNumberOfThreads()
+
+
+/**
+ * ********************* GetNumberOfClients ****************************
+ */
+
+SizeValueType
+ThreadBudget
+::GetNumberOfClients( void ) const
+{
+  this->m_Mutex.Lock();
+  const SizeValueType numberOfClients = this->m_Clients.size();
+  this->m_Mutex.Unlock();
+  return numberOfClients;
+
+} // end GetNumberOfClients()
+
+
+/**
+ * ********************* PrintSelf ****************************
+ */
+
+void
+ThreadBudget
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "TotalNumberOfThreads: " << this->GetTotalNumberOfThreads() << std::endl;
+  os << indent << "NumberOfClients: " << this->GetNumberOfClients() << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef __itkThreadBudget_cxx
@@ -0,0 +1,119 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkThreadBudget_h
+#define __itkThreadBudget_h
+
+#include "itkObject.h"
+#include "itkIntTypes.h"
+#include "itkSimpleFastMutexLock.h"
+
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+
+/** \class ThreadBudget
+ * \brief Divides the threads of the process over the registrations that
+ * run concurrently.
+ *
+ * Each registration registers itself as a client, with the maximum number
+ * of threads that it wants to use, and unregisters when it is done. The
+ * number of threads of a client is its fair share of the total number of
+ * threads: the total is divided equally over the clients, where the
+ * threads that a client with a lower maximum does not use go to the other
+ * clients, and the remainder goes to the clients that registered first.
+ * Every client gets at least one thread. So the share of a client grows
+ * when other clients finish. Clients ask for their share at moments where
+ * they can change their number of threads, for example at the start of a
+ * resolution.
+ *
+ * There is one budget per process, which is obtained with GetInstance().
+ * By default its total is the default number of threads of the
+ * MultiThreader, which is the number of cores.
+ *
+ * All functions are thread-safe.
+ *
+ * \ingroup Common
+ */
+
+class ThreadBudget : public Object
+{
+public:
+
+  /** Standard ITK-stuff. */
+  typedef ThreadBudget               Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( ThreadBudget, Object );
+
+  /** Get the budget of the process. */
+  static Pointer GetInstance( void );
+
+  /** Set/Get the number of threads that are divided over the clients. */
+  void SetTotalNumberOfThreads( const ThreadIdType numberOfThreads );
+
+  ThreadIdType GetTotalNumberOfThreads( void ) const;
+
+  /** Add a client that uses at most maximumNumberOfThreads threads, or
+   * any number if it is 0. Registering a client again changes its maximum.
+   */
+  void Register( const void * client, const ThreadIdType maximumNumberOfThreads );
+
+  /** Remove a client, so that its threads go to the others. */
+  void Unregister( const void * client );
+
+  /** The number of threads of a client at this moment. A client that is
+   * not registered gets the total number of threads.
+   */
+  ThreadIdType GetNumberOfThreads( const void * client ) const;
+
+  /** The number of registered clients. */
+  SizeValueType GetNumberOfClients( void ) const;
+
+protected:
+
+  ThreadBudget();
+  virtual ~ThreadBudget() {}
+
+  void PrintSelf( std::ostream & os, Indent indent ) const;
+
+private:
+
+  ThreadBudget( const Self & );   // purposely not implemented
+  void operator=( const Self & ); // purposely not implemented
+
+  /** The clients with their maximum, in the order of registration. */
+  typedef std::pair< const void *, ThreadIdType > ClientType;
+  typedef std::vector< ClientType >               ClientContainerType;
+
+  ClientContainerType         m_Clients;
+  ThreadIdType                m_TotalNumberOfThreads;
+  mutable SimpleFastMutexLock m_Mutex;
+
+  static Pointer             m_Instance;
+  static SimpleFastMutexLock m_InstanceMutex;
+
+};
+
+} // end namespace itk
+
+#endif // end #ifndef __itkThreadBudget_h
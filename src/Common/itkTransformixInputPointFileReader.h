@@ -40,6 +40,11 @@ namespace itk
  *
  * The second word in the text file represents the number of points that
  * should be read.
+ *
+ * For many points a binary file is faster. Its header is a text line with
+ * "binarypoint" or "binaryindex", the number of points and the dimension,
+ * for example "binarypoint 1000000 3". After the end of that line follow
+ * the coordinates of the points as little endian doubles.
  **/
 
 template< class TOutputMesh >
@@ -82,6 +87,9 @@ public:
    */
   itkGetConstMacro( NumberOfPoints, unsigned long );
 
+  /** Get whether the points are stored as binary doubles. */
+  itkGetConstMacro( PointsAreBinary, bool );
+
   /** Prepare the allocation of the output mesh during the first back
    * propagation of the pipeline. Updates the PointsAreIndices and NumberOfPoints.
    */
@@ -97,6 +105,7 @@ protected:
 
   unsigned long m_NumberOfPoints;
   bool          m_PointsAreIndices;
+  bool          m_PointsAreBinary;
 
   std::ifstream m_Reader;
 
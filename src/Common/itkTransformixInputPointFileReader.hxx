@@ -20,6 +20,10 @@
 #define __itkTransformixInputPointFileReader_hxx
 
 #include "itkTransformixInputPointFileReader.h"
+#include "itkByteSwapper.h"
+
+#include <limits>
+#include <vector>
 
 namespace itk
 {
@@ -34,6 +38,7 @@ TransformixInputPointFileReader< TOutputMesh >
 {
   this->m_NumberOfPoints   = 0;
   this->m_PointsAreIndices = false;
+  this->m_PointsAreBinary  = false;
 } // end constructor
 
 
@@ -69,14 +74,34 @@ TransformixInputPointFileReader< TOutputMesh >
   {
     this->m_Reader.close();
   }
-  this->m_Reader.open( this->m_FileName.c_str() );
+  this->m_Reader.open( this->m_FileName.c_str(), std::ios::in | std::ios::binary );
 
   /** Read the first entry */
   std::string indexOrPoint;
   this->m_Reader >> indexOrPoint;
 
   /** Set the IsIndex bool and the number of points.*/
-  if( indexOrPoint == "point" )
+  this->m_PointsAreBinary = false;
+  if( indexOrPoint == "binarypoint" || indexOrPoint == "binaryindex" )
+  {
+    /** Binary points, after a header line with the number of points and the dimension. */
+    this->m_PointsAreBinary  = true;
+    this->m_PointsAreIndices = ( indexOrPoint == "binaryindex" );
+    unsigned int dimension = 0;
+    this->m_Reader >> this->m_NumberOfPoints >> dimension;
+    if( dimension != OutputMeshType::PointDimension )
+    {
+      std::ostringstream msg;
+      msg << "The file contains points of dimension " << dimension
+          << ", but points of dimension " << OutputMeshType::PointDimension
+          << " are expected." << std::endl << "Filename: " << this->m_FileName
+          << std::endl;
+      MeshFileReaderException e( __FILE__, __LINE__, msg.str().c_str(), ITK_LOCATION );
+      throw e;
+    }
+    this->m_Reader.ignore( std::numeric_limits< std::streamsize >::max(), '\n' );
+  }
+  else if( indexOrPoint == "point" )
   {
     /** Input points are specified in world coordinates. */
     this->m_PointsAreIndices = false;
@@ -118,7 +143,42 @@ TransformixInputPointFileReader< TOutputMesh >
   PointsContainerPointer points = PointsContainerType::New();
 
   /** Read the file */
-  if( this->m_Reader.is_open() )
+  if( this->m_Reader.is_open() && this->m_PointsAreBinary )
+  {
+    /** Read all coordinates at once. */
+    std::vector< double > coordinates( this->m_NumberOfPoints * dimension );
+    if( !coordinates.empty() )
+    {
+      this->m_Reader.read( reinterpret_cast< char * >( &coordinates[ 0 ] ),
+        coordinates.size() * sizeof( double ) );
+    }
+    if( !this->m_Reader )
+    {
+      std::ostringstream msg;
+      msg << "The file is not large enough. "
+          << std::endl << "Filename: " << this->m_FileName
+          << std::endl;
+      MeshFileReaderException e( __FILE__, __LINE__, msg.str().c_str(), ITK_LOCATION );
+      throw e;
+    }
+    if( !coordinates.empty() )
+    {
+      ByteSwapper< double >::SwapRangeFromSystemToLittleEndian(
+        &coordinates[ 0 ], coordinates.size() );
+    }
+
+    points->reserve( this->m_NumberOfPoints );
+    for( unsigned long i = 0; i < this->m_NumberOfPoints; ++i )
+    {
+      PointType point;
+      for( unsigned int j = 0; j < dimension; j++ )
+      {
+        point[ j ] = coordinates[ i * dimension + j ];
+      }
+      points->push_back( point );
+    }
+  }
+  else if( this->m_Reader.is_open() )
   {
     for( unsigned int i = 0; i < this->m_NumberOfPoints; ++i )
     {
@@ -21,6 +21,71 @@
 
 #include "elxFixedRecursivePyramid.h"
 
-//nothing
+namespace elastix
+{
+
+/**
+ * ******************* SetCurrentPyramidLevel ***********************
+ */
+
+template< class TElastix >
+void
+FixedRecursivePyramid< TElastix >
+::SetCurrentPyramidLevel( const unsigned int level )
+{
+  if( !this->m_ComputePyramidImagesPerResolution ) { return; }
+
+  /** The levels are used from coarse to fine, so the coarser levels are finished. */
+  this->m_NumberOfReleasedLevels = level;
+  for( unsigned int i = 0; i < this->m_NumberOfReleasedLevels; ++i )
+  {
+    this->ReleasePyramidImage( i );
+  }
+
+} // end SetCurrentPyramidLevel()
+
+
+/**
+ * ******************* GenerateOutputRequestedRegion ***********************
+ */
+
+template< class TElastix >
+void
+FixedRecursivePyramid< TElastix >
+::GenerateOutputRequestedRegion( itk::DataObject * output )
+{
+  this->Superclass1::GenerateOutputRequestedRegion( output );
+
+  /** The released levels request an empty region, so that they do not
+   * trigger a new execution of the whole pyramid.
+   */
+  for( unsigned int i = 0; i < this->m_NumberOfReleasedLevels; ++i )
+  {
+    this->ReleasePyramidImage( i );
+  }
+
+} // end GenerateOutputRequestedRegion()
+
+
+/**
+ * ******************* GenerateData ***********************
+ */
+
+template< class TElastix >
+void
+FixedRecursivePyramid< TElastix >
+::GenerateData( void )
+{
+  /** Reuse the images of a previous registration, if possible. */
+  if( this->GraftCachedPyramidImages() ) { return; }
+
+  /** Compute the images, and store them for the next registrations. */
+  this->Superclass1::GenerateData();
+  this->AddPyramidImagesToCache();
+
+} // end GenerateData()
+
+
+} // end namespace elastix
 
 #endif //#ifndef __elxFixedRecursivePyramid_hxx
@@ -32,6 +32,11 @@ namespace elastix
  * \parameter FixedImagePyramid: Select this pyramid as follows:\n
  *    <tt>(FixedImagePyramid "FixedSmoothingImagePyramid")</tt>
  *
+ * Since all levels of this pyramid have the size of the input image, the
+ * ComputePyramidImagesPerResolution option of the FixedImagePyramidBase saves
+ * much memory: the images of a level are then computed at the start of that
+ * resolution, and the images of the other levels are released.
+ *
  * \ingroup ImagePyramids
  */
 
@@ -87,6 +92,11 @@ public:
   typedef typename Superclass2::RegistrationPointer  RegistrationPointer;
   typedef typename Superclass2::ITKBaseType          ITKBaseType;
 
+  /** Method for setting the schedule. Override from FixedImagePyramidBase,
+   * to let the pyramid compute only the images of the current level.
+   */
+  virtual void SetFixedSchedule( void );
+
 protected:
 
   /** The constructor. */
@@ -94,6 +104,14 @@ protected:
   /** The destructor. */
   virtual ~FixedSmoothingPyramid() {}
 
+  /** Reuse the pyramid images of a previous registration, if possible,
+   * and store the computed images for the next registrations.
+   */
+  virtual void GenerateData( void );
+
+  /** Update the current resolution level. */
+  virtual void SetCurrentPyramidLevel( const unsigned int level );
+
 private:
 
   /** The private constructor. */
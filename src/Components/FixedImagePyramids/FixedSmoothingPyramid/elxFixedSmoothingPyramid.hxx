@@ -22,6 +22,62 @@
 #include "elxFixedSmoothingPyramid.h"
 
 namespace elastix
-{} // end namespace elastix
+{
+
+/**
+ * ******************* SetFixedSchedule ***********************
+ */
+
+template< class TElastix >
+void
+FixedSmoothingPyramid< TElastix >
+::SetFixedSchedule( void )
+{
+  /** Set the schedule as usual. */
+  this->Superclass2::SetFixedSchedule();
+
+  /** Compute the pyramid images only for the current resolution, if desired.
+   * The option is read by the FixedImagePyramidBase.
+   */
+  this->SetComputeOnlyForCurrentLevel( this->m_ComputePyramidImagesPerResolution );
+
+} // end SetFixedSchedule()
+
+
+/**
+ * ******************* SetCurrentPyramidLevel ***********************
+ */
+
+template< class TElastix >
+void
+FixedSmoothingPyramid< TElastix >
+::SetCurrentPyramidLevel( const unsigned int level )
+{
+  /** We let the pyramid filter know that we are in a next level. */
+  this->SetCurrentLevel( level );
+
+} // end SetCurrentPyramidLevel()
+
+
+/**
+ * ******************* GenerateData ***********************
+ */
+
+template< class TElastix >
+void
+FixedSmoothingPyramid< TElastix >
+::GenerateData( void )
+{
+  /** Reuse the images of a previous registration, if possible. */
+  if( this->GraftCachedPyramidImages() ) { return; }
+
+  /** Compute the images, and store them for the next registrations. */
+  this->Superclass1::GenerateData();
+  this->AddPyramidImagesToCache();
+
+} // end GenerateData()
+
+
+} // end namespace elastix
 
 #endif //#ifndef __elxFixedSmoothingPyramid_hxx
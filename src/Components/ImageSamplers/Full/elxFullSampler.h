@@ -32,6 +32,8 @@ namespace elastix
  * the InputImageRegion.
  *
  * This sampler does not react to the NewSamplesEveryIteration parameter.
+ * With the UseComputationCache parameter, the samples are reused by the
+ * next registrations with the same fixed image.
  *
  * The parameters used in this class are:
  * \parameter ImageSampler: Select this image sampler as follows:\n
@@ -100,6 +102,9 @@ public:
 
 protected:
 
+  /** Select the samples, or copy them from the computation cache. */
+  virtual void GenerateData( void );
+
   /** The constructor. */
   FullSampler() {}
   /** The destructor. */
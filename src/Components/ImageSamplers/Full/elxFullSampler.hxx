@@ -24,7 +24,22 @@
 namespace elastix
 {
 
-//nothing
+/**
+ * ******************* GenerateData ******************
+ */
+
+template< class TElastix >
+void
+FullSampler< TElastix >
+::GenerateData( void )
+{
+  /** The samples are the same for all registrations with this fixed image. */
+  if( this->CopyCachedSamples() ) { return; }
+
+  this->Superclass1::GenerateData();
+  this->AddSamplesToCache();
+
+} // end GenerateData()
 
 } // end namespace elastix
 
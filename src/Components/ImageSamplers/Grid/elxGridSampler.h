@@ -33,6 +33,8 @@ namespace elastix
  *
  * This sampler does not react on the
  * NewSamplesEveryIteration parameter.
+ * With the UseComputationCache parameter, the samples are reused by the
+ * next registrations with the same fixed image and grid spacing.
  *
  * The parameters used in this class are:
  * \parameter ImageSampler: Select this image sampler as follows:\n
@@ -112,6 +114,12 @@ public:
 
 protected:
 
+  /** Select the samples, or copy them from the computation cache. */
+  virtual void GenerateData( void );
+
+  /** Write the grid spacing to the key of the samples in the computation cache. */
+  virtual void WriteSamplerCacheSettings( std::ostream & os ) const;
+
   /** The constructor. */
   GridSampler() {}
   /** The destructor. */
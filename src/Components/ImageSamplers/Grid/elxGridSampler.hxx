@@ -53,6 +53,39 @@ GridSampler< TElastix >
 } // end BeforeEachResolution()
 
 
+/**
+ * ******************* GenerateData ******************
+ */
+
+template< class TElastix >
+void
+GridSampler< TElastix >
+::GenerateData( void )
+{
+  /** The samples are the same for all registrations with this fixed image. */
+  if( this->CopyCachedSamples() ) { return; }
+
+  this->Superclass1::GenerateData();
+  this->AddSamplesToCache();
+
+} // end GenerateData()
+
+
+/**
+ * ******************* WriteSamplerCacheSettings ******************
+ */
+
+template< class TElastix >
+void
+GridSampler< TElastix >
+::WriteSamplerCacheSettings( std::ostream & os ) const
+{
+  os << " gridspacing " << this->GetSampleGridSpacing()
+     << " samples " << this->m_RequestedNumberOfSamples;
+
+} // end WriteSamplerCacheSettings()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef __elxGridSampler_hxx
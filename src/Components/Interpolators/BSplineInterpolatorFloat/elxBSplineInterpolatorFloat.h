@@ -43,6 +43,10 @@ namespace elastix
  *    The default order is 1. The parameter can be specified for each resolution.\n
  *    If only given for one resolution, that value is used for the other resolutions as well.
  *
+ * With the UseComputationCache parameter of ElastixBase, the B-spline coefficients
+ * of an image are reused by the next registrations that interpolate the same image
+ * with the same spline order, such as a pyramid image that was reused.
+ *
  * \ingroup Interpolators
  */
 
@@ -105,11 +109,19 @@ public:
   typedef typename Superclass2::RegistrationPointer  RegistrationPointer;
   typedef typename Superclass2::ITKBaseType          ITKBaseType;
 
+  /** Typedef for the cache that is shared by the registrations. */
+  typedef typename ElastixType::ComputationCacheType ComputationCacheType;
+
   /** Execute stuff before each new pyramid resolution:
    * \li Set the spline order.
    */
   virtual void BeforeEachResolution( void );
 
+  /** Set the input image, and compute the B-spline coefficients, or reuse
+   * the coefficients computed by a previous registration.
+   */
+  virtual void SetInputImage( const InputImageType * inputData );
+
 protected:
 
   /** The constructor. */
@@ -20,6 +20,7 @@
 #define __elxBSplineInterpolatorFloat_hxx
 
 #include "elxBSplineInterpolatorFloat.h"
+#include <sstream>
 
 namespace elastix
 {
@@ -57,6 +58,56 @@ BSplineInterpolatorFloat< TElastix >
 } // end BeforeEachResolution()
 
 
+/**
+ * ***************** SetInputImage ***********************
+ */
+
+template< class TElastix >
+void
+BSplineInterpolatorFloat< TElastix >
+::SetInputImage( const InputImageType * inputData )
+{
+  ComputationCacheType * cache = this->GetElastix()
+    ? this->GetElastix()->GetComputationCache() : 0;
+  if( !cache || !inputData )
+  {
+    this->Superclass1::SetInputImage( inputData );
+    return;
+  }
+
+  /** The coefficients only depend on the buffer of the image, its buffered
+   * region and the spline order. Images that share their buffer, such as
+   * reused pyramid images, share their coefficients.
+   */
+  const typename InputImageType::RegionType & region = inputData->GetBufferedRegion();
+  std::ostringstream operation;
+  operation << this->elxGetClassName() << " order " << this->GetSplineOrder()
+            << " index " << region.GetIndex() << " size " << region.GetSize();
+
+  itk::Object::Pointer cachedObject = cache->Find(
+    inputData->GetPixelContainer(), operation.str() );
+  const CoefficientImageType * cachedCoefficients
+    = dynamic_cast< const CoefficientImageType * >( cachedObject.GetPointer() );
+  if( cachedCoefficients )
+  {
+    /** Do what the superclass does, except computing the coefficients. */
+    this->m_Coefficients = cachedCoefficients;
+    this->Superclass1::Superclass::SetInputImage( inputData );
+    this->m_DataLength = region.GetSize();
+    return;
+  }
+
+  /** Compute the coefficients, and store a copy that is not overwritten
+   * when the coefficients of another image are computed.
+   */
+  this->Superclass1::SetInputImage( inputData );
+  typename CoefficientImageType::Pointer coefficients = CoefficientImageType::New();
+  coefficients->Graft( this->m_Coefficients );
+  cache->Add( inputData->GetPixelContainer(), operation.str(), coefficients );
+
+} // end SetInputImage()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef __elxBSplineInterpolatorFloat_hxx
@@ -238,6 +238,10 @@ PCAMetric< TFixedImage, TMovingImage >
   /** Initialize image sample matrix . */
   datablock.fill( itk::NumericTraits< RealType >::Zero );
 
+  /** Variables to store the points over the last dimension in. */
+  std::vector< FixedImagePointType >  fixedPoints;
+  std::vector< MovingImagePointType > mappedPoints;
+
   for( fiter = fbegin; fiter != fend; ++fiter )
   {
     /** Read fixed coordinates. */
@@ -247,23 +251,24 @@ PCAMetric< TFixedImage, TMovingImage >
     FixedImageContinuousIndexType voxelCoord;
     this->GetFixedImage()->TransformPhysicalPointToContinuousIndex( fixedPoint, voxelCoord );
 
+    /** Transform the sampled point at all last dimension positions at once. */
+    fixedPoints.resize( realNumLastDimPositions );
+    for( unsigned int d = 0; d < realNumLastDimPositions; ++d )
+    {
+      voxelCoord[ lastDim ] = lastDimPositions[ d ];
+      this->GetFixedImage()->TransformContinuousIndexToPhysicalPoint( voxelCoord, fixedPoints[ d ] );
+    }
+    this->TransformPointsOverLastDimension( fixedPoints, mappedPoints );
+
     unsigned int numSamplesOk = 0;
 
     /** Loop over t */
     for( unsigned int d = 0; d < realNumLastDimPositions; ++d )
     {
       /** Initialize some variables. */
-      RealType             movingImageValue;
-      MovingImagePointType mappedPoint;
-
-      /** Set fixed point's last dimension to lastDimPosition. */
-      voxelCoord[ lastDim ] = lastDimPositions[ d ];
-
-      /** Transform sampled point back to world coordinates. */
-      this->GetFixedImage()->TransformContinuousIndexToPhysicalPoint( voxelCoord, fixedPoint );
-
-      /** Transform point and check if it is inside the B-spline support region. */
-      bool sampleOk = this->TransformPoint( fixedPoint, mappedPoint );
+      RealType                     movingImageValue;
+      const MovingImagePointType & mappedPoint = mappedPoints[ d ];
+      bool                         sampleOk    = true;
 
       /** Check if point is inside mask. */
       if( sampleOk )
@@ -487,6 +492,10 @@ PCAMetric< TFixedImage, TMovingImage >
     }
   }
 
+  /** Variables to store the points over the last dimension in. */
+  std::vector< FixedImagePointType >  fixedPoints;
+  std::vector< MovingImagePointType > mappedPoints;
+
   for( fiter = fbegin; fiter != fend; ++fiter )
   {
     /** Read fixed coordinates. */
@@ -499,21 +508,23 @@ PCAMetric< TFixedImage, TMovingImage >
     const unsigned int G            = lastDimPositions.size();
     unsigned int       numSamplesOk = 0;
 
-    /** Loop over t */
+    /** Transform the sampled point at all last dimension positions at once. */
+    fixedPoints.resize( G );
     for( unsigned int d = 0; d < G; ++d )
     {
-      /** Initialize some variables. */
-      RealType             movingImageValue;
-      MovingImagePointType mappedPoint;
-
-      /** Set fixed point's last dimension to lastDimPosition. */
       voxelCoord[ lastDim ] = lastDimPositions[ d ];
+      this->GetFixedImage()->TransformContinuousIndexToPhysicalPoint( voxelCoord, fixedPoints[ d ] );
+    }
+    this->TransformPointsOverLastDimension( fixedPoints, mappedPoints );
 
-      /** Transform sampled point back to world coordinates. */
-      this->GetFixedImage()->TransformContinuousIndexToPhysicalPoint( voxelCoord, fixedPoint );
+    /** Loop over t */
+    for( unsigned int d = 0; d < G; ++d )
+    {
+      /** Initialize some variables. */
+      RealType                     movingImageValue;
+      const MovingImagePointType & mappedPoint = mappedPoints[ d ];
+      bool                         sampleOk    = true;
 
-      /** Transform point and check if it is inside the B-spline support region. */
-      bool sampleOk = this->TransformPoint( fixedPoint, mappedPoint );
       /** Check if point is inside mask. */
       if( sampleOk )
       {
@@ -707,25 +718,26 @@ PCAMetric< TFixedImage, TMovingImage >
 
     const unsigned int G = lastDimPositions.size();
 
+    /** Transform the sampled point at all last dimension positions at once. */
+    fixedPoints.resize( G );
+    for( unsigned int d = 0; d < G; ++d )
+    {
+      voxelCoord[ lastDim ] = lastDimPositions[ d ];
+      this->GetFixedImage()->TransformContinuousIndexToPhysicalPoint( voxelCoord, fixedPoints[ d ] );
+    }
+    this->TransformPointsOverLastDimension( fixedPoints, mappedPoints );
+
     for( unsigned int d = 0; d < G; ++d )
     {
       /** Initialize some variables. */
       RealType                  movingImageValue;
-      MovingImagePointType      mappedPoint;
       MovingImageDerivativeType movingImageDerivative;
 
-      /** Set fixed point's last dimension to lastDimPosition. */
-      voxelCoord[ lastDim ] = lastDimPositions[ d ];
-
-      /** Transform sampled point back to world coordinates. */
-      this->GetFixedImage()->TransformContinuousIndexToPhysicalPoint( voxelCoord, fixedPoint );
-      this->TransformPoint( fixedPoint, mappedPoint );
-
       this->EvaluateMovingImageValueAndDerivative(
-        mappedPoint, movingImageValue, &movingImageDerivative );
+        mappedPoints[ d ], movingImageValue, &movingImageDerivative );
 
       /** Get the TransformJacobian dT/dmu */
-      this->EvaluateTransformJacobian( fixedPoint, jacobian, nzjis[ d ] );
+      this->EvaluateTransformJacobian( fixedPoints[ d ], jacobian, nzjis[ d ] );
 
       /** Compute the innerproduct (dM/dx)^T (dT/dmu). */
       this->EvaluateTransformJacobianInnerProduct(
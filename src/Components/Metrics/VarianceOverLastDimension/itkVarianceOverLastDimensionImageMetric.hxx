@@ -247,6 +247,10 @@ VarianceOverLastDimensionImageMetric< TFixedImage, TMovingImage >
     }
   }
 
+  /** Variables to store the points over the last dimension in. */
+  std::vector< FixedImagePointType >  fixedPoints;
+  std::vector< MovingImagePointType > mappedPoints;
+
   /** Loop over the fixed image samples to calculate the variance over time for every sample position. */
   for( fiter = fbegin; fiter != fend; ++fiter )
   {
@@ -263,25 +267,26 @@ VarianceOverLastDimensionImageMetric< TFixedImage, TMovingImage >
     FixedImageContinuousIndexType voxelCoord;
     this->GetFixedImage()->TransformPhysicalPointToContinuousIndex( fixedPoint, voxelCoord );
 
-    /** Loop over the slowest varying dimension. */
-    float              sumValues               = 0.0;
-    float              sumValuesSquared        = 0.0;
-    unsigned int       numSamplesOk            = 0;
+    /** Transform the sampled point at all last dimension positions at once. */
     const unsigned int realNumLastDimPositions = lastDimPositions.size();
+    fixedPoints.resize( realNumLastDimPositions );
     for( unsigned int d = 0; d < realNumLastDimPositions; ++d )
     {
-      /** Initialize some variables. */
-      RealType             movingImageValue;
-      MovingImagePointType mappedPoint;
-
-      /** Set fixed point's last dimension to lastDimPosition. */
       voxelCoord[ lastDim ] = lastDimPositions[ d ];
+      this->GetFixedImage()->TransformContinuousIndexToPhysicalPoint( voxelCoord, fixedPoints[ d ] );
+    }
+    this->TransformPointsOverLastDimension( fixedPoints, mappedPoints );
 
-      /** Transform sampled point back to world coordinates. */
-      this->GetFixedImage()->TransformContinuousIndexToPhysicalPoint( voxelCoord, fixedPoint );
-
-      /** Transform point and check if it is inside the B-spline support region. */
-      bool sampleOk = this->TransformPoint( fixedPoint, mappedPoint );
+    /** Loop over the slowest varying dimension. */
+    float        sumValues        = 0.0;
+    float        sumValuesSquared = 0.0;
+    unsigned int numSamplesOk     = 0;
+    for( unsigned int d = 0; d < realNumLastDimPositions; ++d )
+    {
+      /** Initialize some variables. */
+      RealType                     movingImageValue;
+      const MovingImagePointType & mappedPoint = mappedPoints[ d ];
+      bool                         sampleOk    = true;
 
       /** Check if point is inside mask. */
       if( sampleOk )
@@ -432,6 +437,10 @@ VarianceOverLastDimensionImageMetric< TFixedImage, TMovingImage >
   std::vector< RealType >       MT( realNumLastDimPositions );
   std::vector< DerivativeType > dMTdmu( realNumLastDimPositions );
 
+  /** Variables to store the points over the last dimension in. */
+  std::vector< FixedImagePointType >  fixedPoints( realNumLastDimPositions );
+  std::vector< MovingImagePointType > mappedPoints( realNumLastDimPositions );
+
   /** Loop over the fixed image samples to calculate the variance over time for every sample position. */
   for( fiter = fbegin; fiter != fend; ++fiter )
   {
@@ -451,6 +460,14 @@ VarianceOverLastDimensionImageMetric< TFixedImage, TMovingImage >
     FixedImageContinuousIndexType voxelCoord;
     this->GetFixedImage()->TransformPhysicalPointToContinuousIndex( fixedPoint, voxelCoord );
 
+    /** Transform the sampled point at all last dimension positions at once. */
+    for( unsigned int d = 0; d < realNumLastDimPositions; ++d )
+    {
+      voxelCoord[ lastDim ] = lastDimPositions[ d ];
+      this->GetFixedImage()->TransformContinuousIndexToPhysicalPoint( voxelCoord, fixedPoints[ d ] );
+    }
+    this->TransformPointsOverLastDimension( fixedPoints, mappedPoints );
+
     /** Loop over the slowest varying dimension. */
     float        sumValues        = 0.0;
     float        sumValuesSquared = 0.0;
@@ -460,16 +477,10 @@ VarianceOverLastDimensionImageMetric< TFixedImage, TMovingImage >
     for( unsigned int d = 0; d < realNumLastDimPositions; ++d )
     {
       /** Initialize some variables. */
-      RealType                  movingImageValue;
-      MovingImagePointType      mappedPoint;
-      MovingImageDerivativeType movingImageDerivative;
-
-      /** Set fixed point's last dimension to lastDimPosition. */
-      voxelCoord[ lastDim ] = lastDimPositions[ d ];
-      /** Transform sampled point back to world coordinates. */
-      this->GetFixedImage()->TransformContinuousIndexToPhysicalPoint( voxelCoord, fixedPoint );
-      /** Transform point and check if it is inside the B-spline support region. */
-      bool sampleOk = this->TransformPoint( fixedPoint, mappedPoint );
+      RealType                     movingImageValue;
+      const MovingImagePointType & mappedPoint = mappedPoints[ d ];
+      MovingImageDerivativeType    movingImageDerivative;
+      bool                         sampleOk    = true;
 
       /** Check if point is inside mask. */
       if( sampleOk )
@@ -493,7 +504,7 @@ VarianceOverLastDimensionImageMetric< TFixedImage, TMovingImage >
         sumValuesSquared += movingImageValue * movingImageValue;
 
         /** Get the TransformJacobian dT/dmu. */
-        this->EvaluateTransformJacobian( fixedPoint, jacobian, nzjis[ d ] );
+        this->EvaluateTransformJacobian( fixedPoints[ d ], jacobian, nzjis[ d ] );
 
         /** Compute the innerproduct (dM/dx)^T (dT/dmu). */
         this->EvaluateTransformJacobianInnerProduct(
@@ -61,6 +61,11 @@ namespace elastix
  *    at once, or per resolution. Latter saves memory.\n
  *    example: <tt>(ComputePyramidImagesPerResolution "true")</tt>\n
  *    Default false.
+ * \parameter ComputePyramidImagesFromFinerLevel: Flag to specify if a resolution level is derived
+ *    from the next finer level when the schedules allow it, which is faster than computing it from the
+ *    input image. The result differs slightly. Only used if the levels are computed at once.\n
+ *    example: <tt>(ComputePyramidImagesFromFinerLevel "true")</tt>\n
+ *    Default false.
  * \parameter ImagePyramidUseShrinkImageFilter: Flag to specify if the ShrinkingImageFilter is used
  *    for rescaling the image, or the ResampleImageFilter. Shrinker is faster.\n
  *    example: <tt>(ImagePyramidUseShrinkImageFilter "true")</tt>\n
@@ -126,16 +131,26 @@ public:
    */
   virtual void SetMovingSchedule( void );
 
-  /** Update the current resolution level. */
-  virtual void BeforeEachResolution( void );
-
 protected:
 
+  /** Update the current resolution level. */
+  virtual void SetCurrentPyramidLevel( const unsigned int level );
+
   /** The constructor. */
   MovingGenericPyramid() {}
   /** The destructor. */
   virtual ~MovingGenericPyramid() {}
 
+  /** Reuse the pyramid images of a previous registration, if possible,
+   * and store the computed images for the next registrations.
+   */
+  virtual void GenerateData( void );
+
+  /** Add the smoothing schedule and the rescaling options to the key of
+   * the computation cache.
+   */
+  virtual void WritePyramidCacheSettings( std::ostream & os ) const;
+
 private:
 
   /** The private constructor. */
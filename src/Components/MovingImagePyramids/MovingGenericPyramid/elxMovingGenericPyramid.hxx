@@ -146,35 +146,79 @@ MovingGenericPyramid< TElastix >
 
   /** Decide whether or not to compute the pyramid images only for the current
    * resolution. Setting the option to true saves memory, since only one level
-   * of the pyramid gets allocated per resolution.
+   * of the pyramid gets allocated per resolution. The option is read by the
+   * MovingImagePyramidBase.
    */
-  bool computeThisResolution = false;
-  this->m_Configuration->ReadParameter( computeThisResolution,
-    "ComputePyramidImagesPerResolution", 0, false );
-  this->SetComputeOnlyForCurrentLevel( computeThisResolution );
+  this->SetComputeOnlyForCurrentLevel( this->m_ComputePyramidImagesPerResolution );
+
+  /** Decide whether or not to derive the levels from the finer levels. */
+  bool deriveFromFinerLevel = false;
+  this->m_Configuration->ReadParameter( deriveFromFinerLevel,
+    "ComputePyramidImagesFromFinerLevel", 0, false );
+  this->SetDeriveFromFinerLevel( deriveFromFinerLevel );
 
 } // end SetMovingSchedule()
 
 
 /**
- * ******************* BeforeEachResolution ***********************
+ * ******************* SetCurrentPyramidLevel ***********************
  */
 
 template< class TElastix >
 void
 MovingGenericPyramid< TElastix >
-::BeforeEachResolution( void )
+::SetCurrentPyramidLevel( const unsigned int level )
 {
-  /** What is the current resolution level? */
-  const unsigned int level = this->m_Registration->GetAsITKBaseType()->GetCurrentLevel();
-
   /** We let the pyramid filter know that we are in a next level.
    * Depending on a flag only at this point the output of the current level is computed,
    * or it was computed for all levels at once at initialization.
    */
   this->SetCurrentLevel( level );
 
-} // end BeforeEachResolution()
+} // end SetCurrentPyramidLevel()
+
+
+/**
+ * ******************* GenerateData ***********************
+ */
+
+template< class TElastix >
+void
+MovingGenericPyramid< TElastix >
+::GenerateData( void )
+{
+  /** Reuse the images of a previous registration, if possible. */
+  if( this->GraftCachedPyramidImages() ) { return; }
+
+  /** Compute the images, and store them for the next registrations. */
+  this->Superclass1::GenerateData();
+  this->AddPyramidImagesToCache();
+
+} // end GenerateData()
+
+
+/**
+ * ******************* WritePyramidCacheSettings ***********************
+ */
+
+template< class TElastix >
+void
+MovingGenericPyramid< TElastix >
+::WritePyramidCacheSettings( std::ostream & os ) const
+{
+  const SmoothingScheduleType & schedule = this->GetSmoothingSchedule();
+  os << " smoothing";
+  for( unsigned int i = 0; i < schedule.rows(); ++i )
+  {
+    for( unsigned int j = 0; j < schedule.cols(); ++j )
+    {
+      os << " " << schedule[ i ][ j ];
+    }
+  }
+  os << " shrink " << this->GetUseShrinkImageFilter()
+     << " derive " << this->GetDeriveFromFinerLevel();
+
+} // end WritePyramidCacheSettings()
 
 
 } // end namespace elastix
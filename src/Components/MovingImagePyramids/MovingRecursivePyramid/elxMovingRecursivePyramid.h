@@ -32,6 +32,10 @@ namespace elastix
  * \parameter MovingImagePyramid: Select this pyramid as follows:\n
  *    <tt>(MovingImagePyramid "MovingRecursiveImagePyramid")</tt>
  *
+ * This pyramid derives each level from the next finer level, so it computes
+ * all levels at once. With the ComputePyramidImagesPerResolution option of the
+ * MovingImagePyramidBase, the images of the finished levels are released.
+ *
  * \ingroup ImagePyramids
  */
 
@@ -89,10 +93,24 @@ public:
 protected:
 
   /** The constructor. */
-  MovingRecursivePyramid() {}
+  MovingRecursivePyramid() { this->m_NumberOfReleasedLevels = 0; }
   /** The destructor. */
   virtual ~MovingRecursivePyramid() {}
 
+  /** Reuse the pyramid images of a previous registration, if possible,
+   * and store the computed images for the next registrations.
+   */
+  virtual void GenerateData( void );
+
+  /** Release the images of the finished levels, if desired. */
+  virtual void SetCurrentPyramidLevel( const unsigned int level );
+
+  /** Keep the finished levels released when the pipeline is updated. */
+  virtual void GenerateOutputRequestedRegion( itk::DataObject * output );
+
+  /** The number of finished levels, which have been released. */
+  unsigned int m_NumberOfReleasedLevels;
+
 private:
 
   /** The private constructor. */
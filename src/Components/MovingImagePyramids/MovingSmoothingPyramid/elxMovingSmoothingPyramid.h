@@ -32,6 +32,11 @@ namespace elastix
  * \parameter MovingImagePyramid: Select this pyramid as follows:\n
  *    <tt>(MovingImagePyramid "MovingSmoothingImagePyramid")</tt>
  *
+ * Since all levels of this pyramid have the size of the input image, the
+ * ComputePyramidImagesPerResolution option of the MovingImagePyramidBase saves
+ * much memory: the images of a level are then computed at the start of that
+ * resolution, and the images of the other levels are released.
+ *
  * \ingroup ImagePyramids
  */
 
@@ -86,6 +91,11 @@ public:
   typedef typename Superclass2::RegistrationPointer  RegistrationPointer;
   typedef typename Superclass2::ITKBaseType          ITKBaseType;
 
+  /** Method for setting the schedule. Override from MovingImagePyramidBase,
+   * to let the pyramid compute only the images of the current level.
+   */
+  virtual void SetMovingSchedule( void );
+
 protected:
 
   /** The constructor. */
@@ -93,6 +103,14 @@ protected:
   /** The destructor. */
   virtual ~MovingSmoothingPyramid() {}
 
+  /** Reuse the pyramid images of a previous registration, if possible,
+   * and store the computed images for the next registrations.
+   */
+  virtual void GenerateData( void );
+
+  /** Update the current resolution level. */
+  virtual void SetCurrentPyramidLevel( const unsigned int level );
+
 private:
 
   /** The private constructor. */
@@ -21,6 +21,63 @@
 
 #include "elxMovingSmoothingPyramid.h"
 
-//nothing
+namespace elastix
+{
+
+/**
+ * ******************* SetMovingSchedule ***********************
+ */
+
+template< class TElastix >
+void
+MovingSmoothingPyramid< TElastix >
+::SetMovingSchedule( void )
+{
+  /** Set the schedule as usual. */
+  this->Superclass2::SetMovingSchedule();
+
+  /** Compute the pyramid images only for the current resolution, if desired.
+   * The option is read by the MovingImagePyramidBase.
+   */
+  this->SetComputeOnlyForCurrentLevel( this->m_ComputePyramidImagesPerResolution );
+
+} // end SetMovingSchedule()
+
+
+/**
+ * ******************* SetCurrentPyramidLevel ***********************
+ */
+
+template< class TElastix >
+void
+MovingSmoothingPyramid< TElastix >
+::SetCurrentPyramidLevel( const unsigned int level )
+{
+  /** We let the pyramid filter know that we are in a next level. */
+  this->SetCurrentLevel( level );
+
+} // end SetCurrentPyramidLevel()
+
+
+/**
+ * ******************* GenerateData ***********************
+ */
+
+template< class TElastix >
+void
+MovingSmoothingPyramid< TElastix >
+::GenerateData( void )
+{
+  /** Reuse the images of a previous registration, if possible. */
+  if( this->GraftCachedPyramidImages() ) { return; }
+
+  /** Compute the images, and store them for the next registrations. */
+  this->Superclass1::GenerateData();
+  this->AddPyramidImagesToCache();
+
+} // end GenerateData()
+
+
+} // end namespace elastix
 
 #endif //#ifndef __elxMovingSmoothingPyramid_hxx
@@ -180,6 +180,28 @@ namespace elastix
  *   The parameter can be specified for each resolution, or for all resolutions at once.\n
  *   example: <tt>(NoiseCompensation "true")</tt>\n
  *   Default/recommended: true.
+ * \parameter UsePlateauStopCriterion: Whether to stop a resolution early when the metric
+ *   has reached a plateau. With a random sampler the metric values are estimated from a new
+ *   sample every iteration, so they are noisy. The test therefore fits a straight line to the
+ *   values and gradient magnitudes of the last PlateauWindowSize iterations, and ends the
+ *   resolution when neither slope is significantly negative compared to that noise.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(UsePlateauStopCriterion "true")</tt>\n
+ *   Default: false.
+ * \parameter PlateauWindowSize: The number of iterations on which the plateau test is based.
+ *   Use a larger window for small NumberOfSpatialSamples, since the values are noisier then.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(PlateauWindowSize 200)</tt>\n
+ *   Default: 100. Minimum: 3.
+ * \parameter PlateauCheckInterval: The number of iterations between two plateau tests.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(PlateauCheckInterval 20)</tt>\n
+ *   Default: 10.
+ * \parameter PlateauTestThreshold: A slope is significantly negative when its t-statistic
+ *   is below -PlateauTestThreshold. Larger values stop earlier.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(PlateauTestThreshold 3.0)</tt>\n
+ *   Default: 2.0.
  *
  * \todo: this class contains a lot of functional code, which actually does not belong here.
  *
@@ -259,6 +281,12 @@ public:
   /** Stop optimization and pass on exception. */
   virtual void MetricErrorResponse( itk::ExceptionObject & err );
 
+  /** Write the iteration, the time, the gain and sigmoid parameters, and
+   * the gradients used by the adaptive step size to a checkpoint. A
+   * restored state also replaces the automatic parameter estimation.
+   */
+  virtual bool WriteCheckpointState( std::ostream & os ) const;
+
   /** Set/Get whether automatic parameter estimation is desired.
    * If true, make sure to set the maximum step length.
    *
@@ -104,6 +104,9 @@ AdaptiveStochasticGradientDescent< TElastix >
   const unsigned int P = this->GetElastix()->GetElxTransformBase()
     ->GetAsITKBaseType()->GetNumberOfParameters();
 
+  /** Use the current share of the threads of the process. */
+  this->SetNumberOfThreads( this->GetElastix()->GetNumberOfThreads() );
+
   /** Set the maximumNumberOfIterations. */
   SizeValueType maximumNumberOfIterations = 500;
   this->GetConfiguration()->ReadParameter( maximumNumberOfIterations,
@@ -266,6 +269,27 @@ AdaptiveStochasticGradientDescent< TElastix >
 
   } // end else: no automatic parameter estimation
 
+  /** Set the plateau stop criterion. */
+  bool usePlateauStopCriterion = false;
+  this->GetConfiguration()->ReadParameter( usePlateauStopCriterion,
+    "UsePlateauStopCriterion", this->GetComponentLabel(), level, 0 );
+  this->SetUsePlateauStopCriterion( usePlateauStopCriterion );
+
+  unsigned int plateauWindowSize = 100;
+  this->GetConfiguration()->ReadParameter( plateauWindowSize,
+    "PlateauWindowSize", this->GetComponentLabel(), level, 0 );
+  this->SetPlateauWindowSize( plateauWindowSize );
+
+  unsigned int plateauCheckInterval = 10;
+  this->GetConfiguration()->ReadParameter( plateauCheckInterval,
+    "PlateauCheckInterval", this->GetComponentLabel(), level, 0 );
+  this->SetPlateauCheckInterval( plateauCheckInterval );
+
+  double plateauTestThreshold = 2.0;
+  this->GetConfiguration()->ReadParameter( plateauTestThreshold,
+    "PlateauTestThreshold", this->GetComponentLabel(), level, 0 );
+  this->SetPlateauTestThreshold( plateauTestThreshold );
+
 } // end BeforeEachResolution()
 
 
@@ -318,7 +342,8 @@ AdaptiveStochasticGradientDescent< TElastix >
    * typedef enum {
    *   MaximumNumberOfIterations,
    *   MetricError,
-   *   MinimumStepSize } StopConditionType;
+   *   MinimumStepSize,
+   *   MetricPlateau } StopConditionType;
    */
   std::string stopcondition;
 
@@ -336,6 +361,10 @@ AdaptiveStochasticGradientDescent< TElastix >
       stopcondition = "The minimum step length has been reached";
       break;
 
+    case MetricPlateau:
+      stopcondition = "The metric value has reached a plateau";
+      break;
+
     default:
       stopcondition = "Unknown";
       break;
@@ -428,6 +457,65 @@ void
 AdaptiveStochasticGradientDescent< TElastix >
 ::ResumeOptimization( void )
 {
+  /** Restore the state of a checkpoint. The checkpoint was written in the
+   * middle of an iteration, before the time was updated, so complete that
+   * iteration. The restored gain parameters replace the estimation.
+   */
+  std::string state;
+  if( this->TakeCheckpointState( state ) )
+  {
+    std::istringstream is( state, std::ios::in | std::ios::binary );
+    unsigned long long iteration = 0;
+    double             currentTime, a, A, alpha, sigmoidMax, sigmoidMin, sigmoidScale;
+    bool               adaptive = false;
+    RegistrationCheckpoint::ReadValue( is, iteration );
+    RegistrationCheckpoint::ReadValue( is, currentTime );
+    RegistrationCheckpoint::ReadValue( is, a );
+    RegistrationCheckpoint::ReadValue( is, A );
+    RegistrationCheckpoint::ReadValue( is, alpha );
+    RegistrationCheckpoint::ReadValue( is, sigmoidMax );
+    RegistrationCheckpoint::ReadValue( is, sigmoidMin );
+    RegistrationCheckpoint::ReadValue( is, sigmoidScale );
+    RegistrationCheckpoint::ReadValue( is, adaptive );
+    if( adaptive )
+    {
+      RegistrationCheckpoint::ReadVector( is, this->m_PreviousGradient );
+      RegistrationCheckpoint::ReadVector( is, this->m_Gradient );
+    }
+    itk::Array< double > plateauValues, plateauGradients;
+    RegistrationCheckpoint::ReadVector( is, plateauValues );
+    RegistrationCheckpoint::ReadVector( is, plateauGradients );
+
+    this->m_CurrentIteration = static_cast< unsigned long >( iteration );
+    this->m_CurrentTime      = currentTime;
+    this->SetParam_a( a );
+    this->SetParam_A( A );
+    this->SetParam_alpha( alpha );
+    this->SetSigmoidMax( sigmoidMax );
+    this->SetSigmoidMin( sigmoidMin );
+    this->SetSigmoidScale( sigmoidScale );
+    this->SetPlateauHistory( plateauValues, plateauGradients );
+    this->m_AutomaticParameterEstimationDone = true;
+
+    if( adaptive || !this->GetUseAdaptiveStepSizes() )
+    {
+      this->UpdateCurrentTime();
+    }
+    this->m_CurrentIteration++;
+    if( this->m_CurrentIteration >= this->GetNumberOfIterations() )
+    {
+      this->m_StopCondition = MaximumNumberOfIterations;
+      this->StopOptimization();
+      return;
+    }
+    if( this->GetUsePlateauStopCriterion() && this->TestPlateau() )
+    {
+      this->m_StopCondition = MetricPlateau;
+      this->StopOptimization();
+      return;
+    }
+  }
+
   /** The following code relies on the fact that all
    * components have been set up and that the initial
    * position has been set, so must be called in this
@@ -446,6 +534,41 @@ AdaptiveStochasticGradientDescent< TElastix >
 } // end ResumeOptimization()
 
 
+/**
+ * ****************** WriteCheckpointState *************************
+ */
+
+template< class TElastix >
+bool
+AdaptiveStochasticGradientDescent< TElastix >
+::WriteCheckpointState( std::ostream & os ) const
+{
+  const bool adaptive = this->GetUseAdaptiveStepSizes();
+  RegistrationCheckpoint::WriteValue( os,
+    static_cast< unsigned long long >( this->m_CurrentIteration ) );
+  RegistrationCheckpoint::WriteValue( os, this->m_CurrentTime );
+  RegistrationCheckpoint::WriteValue( os, this->GetParam_a() );
+  RegistrationCheckpoint::WriteValue( os, this->GetParam_A() );
+  RegistrationCheckpoint::WriteValue( os, this->GetParam_alpha() );
+  RegistrationCheckpoint::WriteValue( os, this->GetSigmoidMax() );
+  RegistrationCheckpoint::WriteValue( os, this->GetSigmoidMin() );
+  RegistrationCheckpoint::WriteValue( os, this->GetSigmoidScale() );
+  RegistrationCheckpoint::WriteValue( os, adaptive );
+  if( adaptive )
+  {
+    RegistrationCheckpoint::WriteVector( os, this->m_PreviousGradient );
+    RegistrationCheckpoint::WriteVector( os, this->m_Gradient );
+  }
+
+  itk::Array< double > plateauValues, plateauGradients;
+  this->GetPlateauHistory( plateauValues, plateauGradients );
+  RegistrationCheckpoint::WriteVector( os, plateauValues );
+  RegistrationCheckpoint::WriteVector( os, plateauGradients );
+  return true;
+
+} // end WriteCheckpointState()
+
+
 /**
  * ****************** MetricErrorResponse *************************
  */
@@ -574,6 +697,9 @@ AdaptiveStochasticGradientDescent< TElastix >
   computeJacobianTerms->SetNumberOfJacobianMeasurements(
     this->m_NumberOfJacobianMeasurements );
 
+  /** Use the current share of the threads of the process. */
+  computeJacobianTerms->SetNumberOfThreads( this->GetElastix()->GetNumberOfThreads() );
+
   /** Check if use scales. */
   bool useScales = this->GetUseScales();
   if( useScales )
@@ -724,6 +850,9 @@ AdaptiveStochasticGradientDescent< TElastix >
   computeDisplacementDistribution->SetNumberOfJacobianMeasurements(
     this->m_NumberOfJacobianMeasurements );
 
+  /** Use the current share of the threads of the process. */
+  computeDisplacementDistribution->SetNumberOfThreads( this->GetElastix()->GetNumberOfThreads() );
+
   /** Check if use scales. */
   if( this->GetUseScales() )
   {
@@ -916,7 +1045,11 @@ AdaptiveStochasticGradientDescent< TElastix >
   double         exactgg = 0.0;
   double         diffgg  = 0.0;
 
-  /** Compute gg for some random parameters. */
+  /** Compute gg for some random parameters. The measurements are done one
+   * after the other: the metrics, their samplers and the transform are shared
+   * and hold the current parameters, so a metric pass can only evaluate one
+   * parameter vector. Each pass is multi-threaded over the samples.
+   */
   for( unsigned int i = 0; i < this->m_NumberOfGradientMeasurements; ++i )
   {
 #ifndef _ELASTIX_BUILD_LIBRARY
@@ -160,6 +160,16 @@ public:
    * after that call the superclass' implementation */
   virtual void StartOptimization( void );
 
+  /** Restore the state of a checkpoint, if one was set, and call the
+   * superclass' implementation.
+   */
+  virtual void ResumeOptimization( void );
+
+  /** Write the iteration, sigma, the evolution paths, the covariance matrix
+   * and its eigen decomposition, and the current offspring to a checkpoint.
+   */
+  virtual bool WriteCheckpointState( std::ostream & os ) const;
+
   /** Methods to set parameters and print output at different stages
    * in the registration process.*/
   virtual void BeforeRegistration( void );
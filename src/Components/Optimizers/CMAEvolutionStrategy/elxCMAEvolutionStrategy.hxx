@@ -55,6 +55,141 @@ CMAEvolutionStrategy< TElastix >::StartOptimization( void )
 }   //end StartOptimization
 
 
+/**
+ * ***************** ResumeOptimization ***********************
+ */
+
+template< class TElastix >
+void
+CMAEvolutionStrategy< TElastix >::ResumeOptimization( void )
+{
+  /** The checkpoint was written after the step of an iteration, but before
+   * the paths, the covariance matrix and sigma were updated. Complete that
+   * iteration, as Superclass1::ResumeOptimization() would have done.
+   */
+  std::string state;
+  if( this->TakeCheckpointState( state ) )
+  {
+    std::istringstream is( state, std::ios::in | std::ios::binary );
+    unsigned long long iteration = 0;
+    RegistrationCheckpoint::ReadValue( is, iteration );
+    RegistrationCheckpoint::ReadValue( is, this->m_CurrentSigma );
+    RegistrationCheckpoint::ReadValue( is, this->m_CurrentMinimumD );
+    RegistrationCheckpoint::ReadValue( is, this->m_CurrentMaximumD );
+    RegistrationCheckpoint::ReadValue( is, this->m_Heaviside );
+
+    unsigned int populationSize = 0;
+    RegistrationCheckpoint::ReadValue( is, populationSize );
+    if( populationSize != this->m_SearchDirs.size() )
+    {
+      itkExceptionMacro( << "The checkpoint was written with a population size of "
+                         << populationSize << ", but " << this->m_SearchDirs.size()
+                         << " is used now." );
+    }
+    for( unsigned int i = 0; i < populationSize; ++i )
+    {
+      RegistrationCheckpoint::ReadVector( is, this->m_SearchDirs[ i ] );
+      RegistrationCheckpoint::ReadVector( is, this->m_NormalizedSearchDirs[ i ] );
+    }
+
+    unsigned int numberOfValues = 0;
+    RegistrationCheckpoint::ReadValue( is, numberOfValues );
+    this->m_CostFunctionValues.resize( numberOfValues );
+    for( unsigned int i = 0; i < numberOfValues; ++i )
+    {
+      RegistrationCheckpoint::ReadValue( is, this->m_CostFunctionValues[ i ].first );
+      RegistrationCheckpoint::ReadValue( is, this->m_CostFunctionValues[ i ].second );
+    }
+
+    RegistrationCheckpoint::ReadVector( is, this->m_CurrentScaledStep );
+    RegistrationCheckpoint::ReadVector( is, this->m_CurrentNormalizedStep );
+    RegistrationCheckpoint::ReadVector( is, this->m_EvolutionPath );
+    RegistrationCheckpoint::ReadVector( is, this->m_ConjugateEvolutionPath );
+
+    vnl_vector< double > history;
+    RegistrationCheckpoint::ReadVector( is, history );
+    this->m_MeasureHistory.assign( history.begin(), history.end() );
+
+    vnl_vector< double > diagonal;
+    RegistrationCheckpoint::ReadMatrix( is, this->m_C );
+    RegistrationCheckpoint::ReadMatrix( is, this->m_B );
+    RegistrationCheckpoint::ReadVector( is, diagonal );
+    this->m_D.set( diagonal );
+
+    this->m_CurrentIteration = static_cast< unsigned long >( iteration );
+
+    this->UpdateConjugateEvolutionPath();
+    this->UpdateHeaviside();
+    this->UpdateEvolutionPath();
+    this->UpdateC();
+    this->UpdateSigma();
+    this->UpdateBD();
+    this->FixNumericalErrors();
+
+    if( this->TestConvergence( false ) )
+    {
+      this->StopOptimization();
+      return;
+    }
+
+    ++( this->m_CurrentIteration );
+  }
+
+  this->Superclass1::ResumeOptimization();
+
+}   // end ResumeOptimization
+
+
+/**
+ * ***************** WriteCheckpointState ***********************
+ */
+
+template< class TElastix >
+bool
+CMAEvolutionStrategy< TElastix >::WriteCheckpointState( std::ostream & os ) const
+{
+  RegistrationCheckpoint::WriteValue( os,
+    static_cast< unsigned long long >( this->m_CurrentIteration ) );
+  RegistrationCheckpoint::WriteValue( os, this->m_CurrentSigma );
+  RegistrationCheckpoint::WriteValue( os, this->m_CurrentMinimumD );
+  RegistrationCheckpoint::WriteValue( os, this->m_CurrentMaximumD );
+  RegistrationCheckpoint::WriteValue( os, this->m_Heaviside );
+
+  const unsigned int populationSize
+    = static_cast< unsigned int >( this->m_SearchDirs.size() );
+  RegistrationCheckpoint::WriteValue( os, populationSize );
+  for( unsigned int i = 0; i < populationSize; ++i )
+  {
+    RegistrationCheckpoint::WriteVector( os, this->m_SearchDirs[ i ] );
+    RegistrationCheckpoint::WriteVector( os, this->m_NormalizedSearchDirs[ i ] );
+  }
+
+  const unsigned int numberOfValues
+    = static_cast< unsigned int >( this->m_CostFunctionValues.size() );
+  RegistrationCheckpoint::WriteValue( os, numberOfValues );
+  for( unsigned int i = 0; i < numberOfValues; ++i )
+  {
+    RegistrationCheckpoint::WriteValue( os, this->m_CostFunctionValues[ i ].first );
+    RegistrationCheckpoint::WriteValue( os, this->m_CostFunctionValues[ i ].second );
+  }
+
+  RegistrationCheckpoint::WriteVector( os, this->m_CurrentScaledStep );
+  RegistrationCheckpoint::WriteVector( os, this->m_CurrentNormalizedStep );
+  RegistrationCheckpoint::WriteVector( os, this->m_EvolutionPath );
+  RegistrationCheckpoint::WriteVector( os, this->m_ConjugateEvolutionPath );
+
+  vnl_vector< double > history( static_cast< unsigned int >( this->m_MeasureHistory.size() ) );
+  std::copy( this->m_MeasureHistory.begin(), this->m_MeasureHistory.end(), history.begin() );
+  RegistrationCheckpoint::WriteVector( os, history );
+
+  RegistrationCheckpoint::WriteMatrix( os, this->m_C );
+  RegistrationCheckpoint::WriteMatrix( os, this->m_B );
+  RegistrationCheckpoint::WriteVector( os, this->m_D.diagonal() );
+  return true;
+
+}   // end WriteCheckpointState
+
+
 /**
  * ***************** InitializeProgressVariables ************************
  */
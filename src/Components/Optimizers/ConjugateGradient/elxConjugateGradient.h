@@ -82,6 +82,14 @@ namespace elastix
  *    In general it is wise to do so.\n
  *    example: <tt>(StopIfWolfeNotSatisfied "true" "false")</tt> \n
  *    Default value: "true".\n
+ * \parameter UseEvaluationCache: Whether to reuse the value and derivative of
+ *    the cost function when it is evaluated again at a position that was
+ *    evaluated recently, for example at the accepted point of a line search.\n
+ *    The cache is not used in combination with NewSamplesEveryIteration.
+ *    Each evaluation in the cache holds a copy of the parameters and the derivative,
+ *    which costs time and memory for transforms with many parameters.\n
+ *    example: <tt>(UseEvaluationCache "true" "false")</tt> \n
+ *    Default value: "false".\n
  *
  *
  * \ingroup Optimizers
@@ -292,6 +292,15 @@ ConjugateGradient< TElastix >
     this->m_StopIfWolfeNotSatisfied = false;
   }
 
+  /** Check whether to reuse previous evaluations of the cost function.
+   * This is not possible when new samples are selected every iteration.
+   */
+  bool useEvaluationCache = false;
+  this->m_Configuration->ReadParameter( useEvaluationCache,
+    "UseEvaluationCache", this->GetComponentLabel(), level, 0 );
+  this->SetUseEvaluationCache( useEvaluationCache
+    && !this->GetNewSamplesEveryIteration() );
+
   this->m_WolfeIsStopCondition     = false;
   this->m_SearchDirectionMagnitude = 0.0;
   this->m_StartLineSearch          = false;
@@ -470,6 +479,17 @@ ConjugateGradient< TElastix >
   /** Print the stopping condition */
   elxout << "Stopping condition: " << stopcondition << "." << std::endl;
 
+  /** Print the number of evaluations of the cost function that were saved. */
+  if( this->GetUseEvaluationCache() )
+  {
+    const ScaledCostFunctionType * costFunction = this->GetScaledCostFunction();
+    elxout << "Cost function evaluations reused from the cache: "
+           << costFunction->GetNumberOfSavedEvaluations() << " of "
+           << costFunction->GetNumberOfSavedEvaluations()
+      + costFunction->GetNumberOfEvaluations()
+           << "." << std::endl;
+  }
+
 }   // end AfterEachResolution
 
 
@@ -20,6 +20,7 @@
 #define __itkGenericConjugateGradientOptimizer_cxx
 
 #include "itkGenericConjugateGradientOptimizer.h"
+#include "itkParallelVectorOperations.h"
 #include "vnl/vnl_math.h"
 
 namespace itk
@@ -126,7 +127,6 @@ GenericConjugateGradientOptimizer::ResumeOptimization()
   unsigned int limitCount  = 0;
 
   ParametersType searchDir;
-  ParametersType previousSearchDir;
   DerivativeType previousGradient;
   MeasureType    previousValue;
 
@@ -156,10 +156,8 @@ GenericConjugateGradientOptimizer::ResumeOptimization()
   /** Start iterating */
   while( !this->m_Stop )
   {
-    /** Store the current search direction */
-    previousSearchDir = searchDir;
-
-    /** Compute the new search direction */
+    /** Compute the new search direction. The previous search direction is
+     * updated in place. */
     this->ComputeSearchDirection(
       previousGradient,
       this->GetCurrentGradient(),
@@ -264,13 +262,11 @@ GenericConjugateGradientOptimizer::ComputeSearchDirection(
 {
   itkDebugMacro( "ComputeSearchDirection" );
 
-  const unsigned int numberOfParameters = gradient.GetSize();
-
   /** When no previous gradient and/or previous search direction are
    * available, return the negative gradient as search direction */
   if( !this->m_PreviousGradientAndSearchDirValid )
   {
-    searchDir = -gradient;
+    ParallelVectorOperations::ScaledCopy( searchDir, -1.0, gradient );
     return;
   }
 
@@ -284,10 +280,7 @@ GenericConjugateGradientOptimizer::ComputeSearchDirection(
   }
 
   /** Compute the new search direction */
-  for( unsigned int i = 0; i < numberOfParameters; ++i )
-  {
-    searchDir[ i ] = -gradient[ i ] + beta * searchDir[ i ];
-  }
+  ParallelVectorOperations::ScaleAndAdd( searchDir, -1.0, gradient, beta );
 
 }   // end ComputeSearchDirection
 
@@ -405,17 +398,8 @@ GenericConjugateGradientOptimizer::ComputeBetaFR(
   const DerivativeType & gradient,
   const ParametersType & itkNotUsed( previousSearchDir ) )
 {
-  const unsigned int numberOfParameters = gradient.GetSize();
-  double             num                = 0.0;
-  double             den                = 0.0;
-
-  for( unsigned int i = 0; i < numberOfParameters; ++i )
-  {
-    const double & grad     = gradient[ i ];
-    const double & prevgrad = previousGradient[ i ];
-    num += grad * grad;
-    den += prevgrad * prevgrad;
-  }
+  const double num = ParallelVectorOperations::SquaredMagnitude( gradient );
+  const double den = ParallelVectorOperations::SquaredMagnitude( previousGradient );
 
   if( den <= NumericTraits< double >::epsilon() )
   {
@@ -438,17 +422,10 @@ GenericConjugateGradientOptimizer::ComputeBetaPR(
   const DerivativeType & gradient,
   const ParametersType & itkNotUsed( previousSearchDir ) )
 {
-  const unsigned int numberOfParameters = gradient.GetSize();
-  double             num                = 0.0;
-  double             den                = 0.0;
-
-  for( unsigned int i = 0; i < numberOfParameters; ++i )
-  {
-    const double & grad     = gradient[ i ];
-    const double & prevgrad = previousGradient[ i ];
-    num += grad * ( grad - prevgrad );
-    den += prevgrad * prevgrad;
-  }
+  ParallelVectorOperations::AddScaled(
+    this->m_GradientDifference, gradient, -1.0, previousGradient );
+  const double num = ParallelVectorOperations::InnerProduct( gradient, this->m_GradientDifference );
+  const double den = ParallelVectorOperations::SquaredMagnitude( previousGradient );
 
   if( den <= NumericTraits< double >::epsilon() )
   {
@@ -471,16 +448,10 @@ GenericConjugateGradientOptimizer::ComputeBetaDY(
   const DerivativeType & gradient,
   const ParametersType & previousSearchDir )
 {
-  const unsigned int numberOfParameters = gradient.GetSize();
-  double             num                = 0.0;
-  double             den                = 0.0;
-
-  for( unsigned int i = 0; i < numberOfParameters; ++i )
-  {
-    const double & grad = gradient[ i ];
-    num += grad * grad;
-    den += previousSearchDir[ i ] * ( grad - previousGradient[ i ] );
-  }
+  ParallelVectorOperations::AddScaled(
+    this->m_GradientDifference, gradient, -1.0, previousGradient );
+  const double num = ParallelVectorOperations::SquaredMagnitude( gradient );
+  const double den = ParallelVectorOperations::InnerProduct( previousSearchDir, this->m_GradientDifference );
 
   if( den <= NumericTraits< double >::epsilon() )
   {
@@ -502,16 +473,10 @@ GenericConjugateGradientOptimizer::ComputeBetaHS(
   const DerivativeType & gradient,
   const ParametersType & previousSearchDir )
 {
-  const unsigned int numberOfParameters = gradient.GetSize();
-  double             num                = 0.0;
-  double             den                = 0.0;
-
-  for( unsigned int i = 0; i < numberOfParameters; ++i )
-  {
-    const double & diff = gradient[ i ] - previousGradient[ i ];
-    num += gradient[ i ] * diff;
-    den += previousSearchDir[ i ] * diff;
-  }
+  ParallelVectorOperations::AddScaled(
+    this->m_GradientDifference, gradient, -1.0, previousGradient );
+  const double num = ParallelVectorOperations::InnerProduct( gradient, this->m_GradientDifference );
+  const double den = ParallelVectorOperations::InnerProduct( previousSearchDir, this->m_GradientDifference );
 
   if( den <= NumericTraits< double >::epsilon() )
   {
@@ -612,8 +577,10 @@ GenericConjugateGradientOptimizer::TestConvergence( bool itkNotUsed( firstLineSe
   }
 
   /** Check for convergence of gradient magnitude */
-  const double gnorm = this->GetCurrentGradient().magnitude();
-  const double xnorm = this->GetScaledCurrentPosition().magnitude();
+  const double gnorm = vcl_sqrt(
+    ParallelVectorOperations::SquaredMagnitude( this->GetCurrentGradient() ) );
+  const double xnorm = vcl_sqrt(
+    ParallelVectorOperations::SquaredMagnitude( this->GetScaledCurrentPosition() ) );
   if( gnorm / vnl_math_max( 1.0, xnorm ) <= this->GetGradientMagnitudeTolerance() )
   {
     this->m_StopCondition = GradientMagnitudeTolerance;
@@ -149,6 +149,10 @@ protected:
   bool              m_Stop;
   double            m_CurrentStepLength;
 
+  /** Buffer for the difference of the current and previous gradient,
+   * reused by ComputeBetaPR, ComputeBetaDY, and ComputeBetaHS. */
+  DerivativeType m_GradientDifference;
+
   /** Flag that is true as long as the method
    * SetMaxNrOfItWithoutImprovement is never called */
   bool m_UseDefaultMaxNrOfItWithoutImprovement;
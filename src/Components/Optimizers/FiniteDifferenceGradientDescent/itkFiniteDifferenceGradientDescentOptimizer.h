@@ -48,6 +48,9 @@ namespace itk
  * Note the similarities to the SimultaneousPerturbation optimizer and
  * the StandardGradientDescent optimizer.
  *
+ * The 2N cost function values of an iteration are computed one after
+ * another, since they all set their parameters on the same transform.
+ *
  * \ingroup Optimizers
  * \sa FiniteDifferenceGradientDescent
  */
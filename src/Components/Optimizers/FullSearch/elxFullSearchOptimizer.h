@@ -48,6 +48,24 @@ namespace elastix
  *   This varies the second transform parameter in the range [-4.0 3.0] with steps of 1.0
  *   and the third parameter in the range [-1.0 1.0] with steps of 0.5. The names are used
  *   as column headers in the screen output.
+ * \parameter FullSearchCoarseGridFactor: Searches hierarchically, when larger than 1.
+ *   First every FullSearchCoarseGridFactor-th point in each search space dimension is
+ *   evaluated, and then the points around the best coarse points.
+ *   Can be specified for each resolution.\n
+ *   example: <tt>(FullSearchCoarseGridFactor 4 2 1)</tt> \n
+ *   Default value: 1, which scans the full search space.
+ * \parameter FullSearchNumberOfRefinedCells: The number of best coarse points around which
+ *   the hierarchical search is refined. Can be specified for each resolution.\n
+ *   example: <tt>(FullSearchNumberOfRefinedCells 8 4 1)</tt> \n
+ *   Default value: 1.
+ * \parameter FullSearchCellPruningMargin: Coarse points with a metric value that is worse
+ *   than the best coarse value by more than this margin are not refined, even if they
+ *   are among the best FullSearchNumberOfRefinedCells. Can be specified for each resolution.\n
+ *   example: <tt>(FullSearchCellPruningMargin 0.1)</tt> \n
+ *   Default: no pruning.
+ *
+ * In the hierarchical search, the points of the optimization surface that were not
+ * evaluated are NaN. The number of saved metric evaluations is printed after each resolution.
  *
  * \ingroup Optimizers
  * \sa FullSearchOptimizer
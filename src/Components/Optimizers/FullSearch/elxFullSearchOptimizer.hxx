@@ -22,6 +22,7 @@
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <limits>
 #include "vnl/vnl_math.h"
 
 namespace elastix
@@ -180,6 +181,29 @@ FullSearch< TElastix >
     this->m_OptimizationSurface->Allocate();
     /** \todo try/catch block around Allocate? */
 
+    /** Set the hierarchical search options. */
+    unsigned int coarseGridFactor = 1;
+    this->GetConfiguration()->ReadParameter( coarseGridFactor,
+      "FullSearchCoarseGridFactor", this->GetComponentLabel(), level, 0 );
+    this->SetCoarseGridFactor( coarseGridFactor );
+
+    unsigned int numberOfRefinedCells = 1;
+    this->GetConfiguration()->ReadParameter( numberOfRefinedCells,
+      "FullSearchNumberOfRefinedCells", this->GetComponentLabel(), level, 0 );
+    this->SetNumberOfRefinedCells( numberOfRefinedCells );
+
+    double cellPruningMargin = itk::NumericTraits< double >::max();
+    this->GetConfiguration()->ReadParameter( cellPruningMargin,
+      "FullSearchCellPruningMargin", this->GetComponentLabel(), level, 0 );
+    this->SetCellPruningMargin( cellPruningMargin );
+
+    /** Points that are skipped by the hierarchical search remain NaN. */
+    if( this->GetCoarseGridFactor() > 1 )
+    {
+      this->m_OptimizationSurface->FillBuffer(
+        std::numeric_limits< float >::quiet_NaN() );
+    }
+
     /** Set the name of this image on disk. */
     std::string resultImageFormat = "mhd";
     this->m_Configuration->ReadParameter(
@@ -266,6 +290,14 @@ FullSearch< TElastix >
   /** Print the stopping condition */
   elxout << "Stopping condition: " << stopcondition << "." << std::endl;
 
+  /** Print the number of metric evaluations. */
+  elxout
+    << "Number of metric evaluations: "
+    << this->GetNumberOfEvaluations()
+    << " (" << this->GetNumberOfSavedEvaluations()
+    << " of " << this->GetNumberOfIterations()
+    << " grid points saved)." << std::endl;
+
   /** Write the optimization surface to disk */
   bool writeSurfaceEachResolution = false;
   this->GetConfiguration()->ReadParameter( writeSurfaceEachResolution,
@@ -24,6 +24,8 @@
 #include "itkEventObject.h"
 #include "itkExceptionObject.h"
 #include "itkNumericTraits.h"
+#include <algorithm>
+#include <utility>
 
 namespace itk
 {
@@ -45,6 +47,10 @@ FullSearchOptimizer
   m_NumberOfSearchSpaceDimensions = 0;
   m_SearchSpace                   = 0;
   m_LastSearchSpaceChanges        = 0;
+  m_CoarseGridFactor              = 1;
+  m_NumberOfRefinedCells          = 1;
+  m_CellPruningMargin             = NumericTraits< double >::max();
+  m_NumberOfEvaluations           = 0;
 
 }   //end constructor
 
@@ -59,7 +65,8 @@ FullSearchOptimizer
 
   itkDebugMacro( "StartOptimization" );
 
-  m_CurrentIteration = 0;
+  m_CurrentIteration    = 0;
+  m_NumberOfEvaluations = 0;
 
   this->ProcessSearchSpaceChanges();
 
@@ -95,6 +102,13 @@ FullSearchOptimizer
 
   itkDebugMacro( "ResumeOptimization" );
 
+  /** The hierarchical search evaluates the grid points in a different order. */
+  if( m_CoarseGridFactor > 1 )
+  {
+    this->ResumeHierarchicalOptimization();
+    return;
+  }
+
   m_Stop = false;
 
   InvokeEvent( StartEvent() );
@@ -116,6 +130,8 @@ FullSearchOptimizer
       throw err;
     }
 
+    m_NumberOfEvaluations++;
+
     if( m_Stop )
     {
       break;
@@ -149,6 +165,214 @@ FullSearchOptimizer
 }   //end function ResumeOptimization
 
 
+/**
+ * ****************** ResumeHierarchicalOptimization *************
+ */
+void
+FullSearchOptimizer
+::ResumeHierarchicalOptimization( void )
+{
+
+  itkDebugMacro( "ResumeHierarchicalOptimization" );
+
+  m_Stop                = false;
+  m_CurrentIteration    = 0;
+  m_NumberOfEvaluations = 0;
+
+  if( m_Maximize )
+  {
+    m_BestValue = NumericTraits< double >::NonpositiveMin();
+  }
+  else
+  {
+    m_BestValue = NumericTraits< double >::max();
+  }
+
+  InvokeEvent( StartEvent() );
+
+  const unsigned int        searchSpaceDimension = this->GetNumberOfSearchSpaceDimensions();
+  const SearchSpaceSizeType searchSpaceSize      = this->GetSearchSpaceSize();
+  const unsigned long       numberOfGridPoints   = this->GetNumberOfIterations();
+  const IndexValueType      factor               = static_cast< IndexValueType >( m_CoarseGridFactor );
+
+  /** Keep track of the grid points that are evaluated already. */
+  std::vector< unsigned char > scheduled( numberOfGridPoints, 0 );
+
+  /** Select the grid points of the coarse grid. */
+  std::vector< unsigned long > coarseIndices;
+  SearchSpaceIndexType         index( searchSpaceDimension );
+  for( unsigned long i = 0; i < numberOfGridPoints; i++ )
+  {
+    this->LinearIndexToIndex( i, index );
+    bool onCoarseGrid = true;
+    for( unsigned int ssdim = 0; ssdim < searchSpaceDimension; ssdim++ )
+    {
+      if( index[ ssdim ] % factor != 0 )
+      {
+        onCoarseGrid = false;
+        break;
+      }
+    }
+    if( onCoarseGrid )
+    {
+      coarseIndices.push_back( i );
+      scheduled[ i ] = 1;
+    }
+  }
+
+  std::vector< MeasureType > coarseValues;
+  this->EvaluateGridPoints( coarseIndices, coarseValues );
+  if( m_Stop )
+  {
+    return;
+  }
+
+  if( factor > 1 )
+  {
+    /** Rank the coarse grid points, best first. */
+    typedef std::pair< MeasureType, unsigned long > ValueIndexPairType;
+    std::vector< ValueIndexPairType > ranking( coarseIndices.size() );
+    for( unsigned long k = 0; k < coarseIndices.size(); k++ )
+    {
+      const MeasureType value = m_Maximize ? -coarseValues[ k ] : coarseValues[ k ];
+      ranking[ k ] = ValueIndexPairType( value, coarseIndices[ k ] );
+    }
+    const unsigned long numberOfCells = std::min(
+      static_cast< unsigned long >( m_NumberOfRefinedCells ),
+      static_cast< unsigned long >( ranking.size() ) );
+    std::partial_sort( ranking.begin(), ranking.begin() + numberOfCells, ranking.end() );
+
+    /** Strides of the linear index. */
+    std::vector< unsigned long > strides( searchSpaceDimension, 1 );
+    for( unsigned int ssdim = 1; ssdim < searchSpaceDimension; ssdim++ )
+    {
+      strides[ ssdim ] = strides[ ssdim - 1 ] * searchSpaceSize[ ssdim - 1 ];
+    }
+
+    /** Select the grid points around the best coarse grid points. */
+    std::vector< unsigned long > refinedIndices;
+    SearchSpaceIndexType         cellIndex( searchSpaceDimension );
+    SearchSpaceIndexType         lower( searchSpaceDimension );
+    SearchSpaceIndexType         upper( searchSpaceDimension );
+    for( unsigned long c = 0; c < numberOfCells; c++ )
+    {
+      /** The ranking is sorted, so all following cells are hopeless too. */
+      if( ranking[ c ].first - ranking[ 0 ].first > m_CellPruningMargin )
+      {
+        break;
+      }
+
+      /** The neighbourhood of the cell, cropped to the search space. */
+      this->LinearIndexToIndex( ranking[ c ].second, cellIndex );
+      for( unsigned int ssdim = 0; ssdim < searchSpaceDimension; ssdim++ )
+      {
+        const IndexValueType last = static_cast< IndexValueType >( searchSpaceSize[ ssdim ] ) - 1;
+        lower[ ssdim ] = std::max( cellIndex[ ssdim ] - factor + 1, IndexValueType( 0 ) );
+        upper[ ssdim ] = std::min( cellIndex[ ssdim ] + factor - 1, last );
+      }
+
+      /** Walk through the neighbourhood, in the order of UpdateCurrentPosition. */
+      index = lower;
+      bool done = false;
+      while( !done )
+      {
+        unsigned long linearIndex = 0;
+        for( unsigned int ssdim = 0; ssdim < searchSpaceDimension; ssdim++ )
+        {
+          linearIndex += strides[ ssdim ] * static_cast< unsigned long >( index[ ssdim ] );
+        }
+        if( !scheduled[ linearIndex ] )
+        {
+          scheduled[ linearIndex ] = 1;
+          refinedIndices.push_back( linearIndex );
+        }
+
+        done = true;
+        for( unsigned int ssdim = 0; ssdim < searchSpaceDimension; ssdim++ )
+        {
+          if( index[ ssdim ] < upper[ ssdim ] )
+          {
+            index[ ssdim ]++;
+            done = false;
+            break;
+          }
+          index[ ssdim ] = lower[ ssdim ];
+        }
+      }   // end while neighbourhood
+    }   // end for cells
+
+    /** Evaluate the refined points in scan order. */
+    std::sort( refinedIndices.begin(), refinedIndices.end() );
+    std::vector< MeasureType > refinedValues;
+    this->EvaluateGridPoints( refinedIndices, refinedValues );
+    if( m_Stop )
+    {
+      return;
+    }
+  }   // end if refine
+
+  m_StopCondition = FullRangeSearched;
+  StopOptimization();
+
+}   // end ResumeHierarchicalOptimization
+
+
+/**
+ * ********************** EvaluateGridPoints *********************
+ */
+void
+FullSearchOptimizer
+::EvaluateGridPoints(
+  const std::vector< unsigned long > & linearIndices,
+  std::vector< MeasureType > & values )
+{
+  const unsigned long numberOfPoints = linearIndices.size();
+  values.assign( numberOfPoints, NumericTraits< MeasureType >::Zero );
+
+  for( unsigned long k = 0; k < numberOfPoints; k++ )
+  {
+    this->LinearIndexToIndex( linearIndices[ k ], m_CurrentIndexInSearchSpace );
+    m_CurrentPointInSearchSpace = this->IndexToPoint( m_CurrentIndexInSearchSpace );
+    this->SetCurrentPosition( this->IndexToPosition( m_CurrentIndexInSearchSpace ) );
+
+    try
+    {
+      m_Value = m_CostFunction->GetValue( this->GetCurrentPosition() );
+    }
+    catch( ExceptionObject & err )
+    {
+      // An exception has occurred.
+      // Terminate immediately.
+      m_StopCondition = MetricError;
+      StopOptimization();
+
+      // Pass exception to caller
+      throw err;
+    }
+
+    values[ k ] = m_Value;
+    m_NumberOfEvaluations++;
+
+    /** Check if the value is a minimum or maximum */
+    if( ( m_Value < m_BestValue )  ^  m_Maximize )
+    {
+      m_BestValue              = m_Value;
+      m_BestPointInSearchSpace = m_CurrentPointInSearchSpace;
+      m_BestIndexInSearchSpace = m_CurrentIndexInSearchSpace;
+    }
+
+    this->InvokeEvent( IterationEvent() );
+    m_CurrentIteration++;
+
+    if( m_Stop )
+    {
+      return;
+    }
+  }
+
+}   // end EvaluateGridPoints
+
+
 /**
  * ************************** Stop optimization ******************
  */
@@ -433,6 +657,43 @@ FullSearchOptimizer
 }
 
 
+/**
+ * ********************* LinearIndexToIndex *********************
+ */
+void
+FullSearchOptimizer
+::LinearIndexToIndex( unsigned long linearIndex, SearchSpaceIndexType & index )
+{
+  const unsigned int          searchSpaceDimension = this->GetNumberOfSearchSpaceDimensions();
+  const SearchSpaceSizeType & searchSpaceSize      = this->GetSearchSpaceSize();
+
+  index.SetSize( searchSpaceDimension );
+  for( unsigned int ssdim = 0; ssdim < searchSpaceDimension; ssdim++ )
+  {
+    index[ ssdim ] = static_cast< IndexValueType >( linearIndex % searchSpaceSize[ ssdim ] );
+    linearIndex   /= searchSpaceSize[ ssdim ];
+  }
+
+}   // end LinearIndexToIndex
+
+
+/**
+ * ******************** GetNumberOfSavedEvaluations *************
+ */
+unsigned long
+FullSearchOptimizer
+::GetNumberOfSavedEvaluations( void )
+{
+  const unsigned long numberOfGridPoints = this->GetNumberOfIterations();
+  if( m_NumberOfEvaluations >= numberOfGridPoints )
+  {
+    return 0;
+  }
+  return numberOfGridPoints - m_NumberOfEvaluations;
+
+}   // end GetNumberOfSavedEvaluations
+
+
 /**
  * ********************* IndexToPoint ***************************
  */
@@ -24,6 +24,7 @@
 #include "itkImage.h"
 #include "itkArray.h"
 #include "itkFixedArray.h"
+#include <vector>
 
 namespace itk
 {
@@ -35,6 +36,20 @@ namespace itk
  * Optimizer that scans a subspace of the parameter space
  * and searches for the best parameters.
  *
+ * Instead of scanning every grid point, the search can be done
+ * hierarchically, by setting a CoarseGridFactor f larger than one. First,
+ * only the grid points whose indices are multiples of f are evaluated.
+ * Then the grid points within a distance of f - 1 of the best
+ * NumberOfRefinedCells coarse points are evaluated. Coarse points whose
+ * value is worse than the best coarse value by more than the
+ * CellPruningMargin are not refined, even if they are among the best.
+ * The number of evaluations that was saved compared to the full grid
+ * can be obtained with GetNumberOfSavedEvaluations().
+ *
+ * The grid points are evaluated one after another, since the cost function
+ * is not assumed to be safe to evaluate simultaneously. In elastix, each
+ * evaluation of the metric is multi-threaded over the samples.
+ *
  * \todo This optimizer has similar functionality as the recently added
  * itkExhaustiveOptimizer. See if we can replace it by that optimizer,
  * or inherit from it.
@@ -191,6 +206,33 @@ public:
   /** Get Stop condition. */
   itkGetConstMacro( StopCondition, StopConditionType );
 
+  /** Setting: the factor by which the coarse grid of the hierarchical
+   * search is coarser than the search space. A factor of 1 scans the full
+   * grid. Default: 1.
+   */
+  itkSetClampMacro( CoarseGridFactor, unsigned int, 1, NumericTraits< unsigned int >::max() );
+  itkGetConstMacro( CoarseGridFactor, unsigned int );
+
+  /** Setting: the number of best coarse grid points around which the
+   * search is refined, in the hierarchical search. Default: 1.
+   */
+  itkSetClampMacro( NumberOfRefinedCells, unsigned int, 1, NumericTraits< unsigned int >::max() );
+  itkGetConstMacro( NumberOfRefinedCells, unsigned int );
+
+  /** Setting: coarse grid points whose value is worse than the best coarse
+   * value by more than this margin are not refined. Default: the maximum
+   * double value, so that no cells are pruned.
+   */
+  itkSetMacro( CellPruningMargin, double );
+  itkGetConstMacro( CellPruningMargin, double );
+
+  /** Get the number of cost function evaluations of the last run. */
+  itkGetConstMacro( NumberOfEvaluations, unsigned long );
+
+  /** Get the number of grid points that were not evaluated in the last run,
+   * for example because of the hierarchical search. */
+  virtual unsigned long GetNumberOfSavedEvaluations( void );
+
 protected:
 
   FullSearchOptimizer();
@@ -215,6 +257,21 @@ protected:
   unsigned long m_LastSearchSpaceChanges;
   virtual void ProcessSearchSpaceChanges( void );
 
+  /** Convert a linear index, in the order of UpdateCurrentPosition(),
+   * to an index in the search space. */
+  virtual void LinearIndexToIndex( unsigned long linearIndex,
+    SearchSpaceIndexType & index );
+
+  /** Scan the search space hierarchically. Used by ResumeOptimization()
+   * when the CoarseGridFactor is larger than one. Always restarts the search. */
+  virtual void ResumeHierarchicalOptimization( void );
+
+  /** Evaluate the grid points with the given linear indices.
+   * For every grid point, the current index, point, position and value are
+   * updated, and an IterationEvent is invoked. The values are returned. */
+  virtual void EvaluateGridPoints( const std::vector< unsigned long > & linearIndices,
+    std::vector< MeasureType > & values );
+
 private:
 
   FullSearchOptimizer( const Self & ); // purposely not implemented
@@ -222,6 +279,11 @@ private:
 
   unsigned long m_CurrentIteration;
 
+  unsigned int  m_CoarseGridFactor;
+  unsigned int  m_NumberOfRefinedCells;
+  double        m_CellPruningMargin;
+  unsigned long m_NumberOfEvaluations;
+
 };
 
 } // end namespace itk
@@ -0,0 +1,153 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __elxPreconditionedStochasticGradientDescent_h
+#define __elxPreconditionedStochasticGradientDescent_h
+
+#include "elxAdaptiveStochasticGradientDescent.h"
+
+namespace elastix
+{
+/**
+ * \class PreconditionedStochasticGradientDescent
+ * \brief An adaptive stochastic gradient descent optimizer with a diagonal preconditioner.
+ *
+ * This optimizer is the AdaptiveStochasticGradientDescent optimizer, in which each
+ * parameter has its own step size. The update is:
+ *
+ *     \f[ x(k+1) = x(k) - a(t_k) P dC/dx \f]
+ *
+ * with \f$P\f$ a diagonal matrix. \f$P\f$ is estimated at the start of each resolution
+ * from the diagonal of the covariance matrix of the transform Jacobian,
+ * \f$c_i = 1/n \sum_j ( J_j^T J_j )_{ii}\f$, which is also used by the automatic parameter
+ * estimation of the AdaptiveStochasticGradientDescent optimizer:
+ *
+ *     \f[ P_{ii} = (1 + \kappa) \bar{c} / ( c_i + \kappa \bar{c} ) \f]
+ *
+ * with \f$\bar{c}\f$ the mean of the nonzero \f$c_i\f$ and \f$\kappa\f$ the
+ * PreconditionerRegularization. Parameters that are supported by few samples, such as
+ * the B-spline control points near the border of the image or the mask, get a larger
+ * step size, and parameters with a large Jacobian a smaller one. For a B-spline
+ * transform the block of the covariance matrix of a control point is a multiple of the
+ * identity, so this diagonal preconditioner equals the block-diagonal one.
+ *
+ * The preconditioner is applied as the (squared) scales of the optimizer, multiplied by
+ * the scales that are set by the transform, if any. Therefore the automatic parameter
+ * estimation takes the preconditioner into account, and all parameters of the
+ * AdaptiveStochasticGradientDescent optimizer can be used with this optimizer too.
+ * It is not recommended to combine this optimizer with the UseJacobianPreconditioning
+ * option of the AdvancedMattesMutualInformation metric.
+ *
+ * The parameters used in this class, in addition to the parameters of the
+ * AdaptiveStochasticGradientDescent optimizer, are:
+ * \parameter Optimizer: Select this optimizer as follows:\n
+ *   <tt>(Optimizer "PreconditionedStochasticGradientDescent")</tt>
+ * \parameter PreconditionerRegularization: The regularization \f$\kappa\f$ of the
+ *   preconditioner. Small values give a stronger preconditioning; the largest step size
+ *   factor is \f$(1 + \kappa) / \kappa\f$.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(PreconditionerRegularization 0.1)</tt>\n
+ *   Default: 0.1.
+ * \parameter NumberOfJacobianMeasurements: The number of samples on which the
+ *   preconditioner is estimated.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(NumberOfJacobianMeasurements 10000)</tt>\n
+ *   Default: max( 1000, number of parameters ).
+ *
+ * \sa AdaptiveStochasticGradientDescent, ComputeJacobianTerms
+ * \ingroup Optimizers
+ */
+
+template< class TElastix >
+class PreconditionedStochasticGradientDescent :
+  public AdaptiveStochasticGradientDescent< TElastix >
+{
+public:
+
+  /** Standard ITK. */
+  typedef PreconditionedStochasticGradientDescent        Self;
+  typedef AdaptiveStochasticGradientDescent< TElastix > Superclass;
+  typedef typename Superclass::Superclass1               Superclass1;
+  typedef typename Superclass::Superclass2               Superclass2;
+  typedef itk::SmartPointer< Self >                      Pointer;
+  typedef itk::SmartPointer< const Self >                ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( PreconditionedStochasticGradientDescent,
+    AdaptiveStochasticGradientDescent );
+
+  /** Name of this class.
+   * Use this name in the parameter file to select this specific optimizer.
+   * example: <tt>(Optimizer "PreconditionedStochasticGradientDescent")</tt>\n
+   */
+  elxClassNameMacro( "PreconditionedStochasticGradientDescent" );
+
+  /** Typedef's inherited from the superclass. */
+  typedef typename Superclass::ParametersType ParametersType;
+  typedef typename Superclass::SizeValueType  SizeValueType;
+  typedef typename Superclass1::ScalesType    ScalesType;
+
+  /** Typedef for the diagonal preconditioner. */
+  typedef itk::Array< double > PreconditionerType;
+
+  /** Read the settings of the preconditioner, after calling
+   * the superclass' implementation.
+   */
+  virtual void BeforeEachResolution( void );
+
+  /** Estimate the preconditioner, and call the superclass' implementation. */
+  virtual void StartOptimization( void );
+
+  /** Set the scales of the scaled cost function to the user scales divided
+   * by the preconditioner.
+   */
+  virtual void InitializeScales( void );
+
+  /** Get the preconditioner of the current resolution. */
+  itkGetConstReferenceMacro( Preconditioner, PreconditionerType );
+
+protected:
+
+  /** Protected typedefs */
+  typedef typename Superclass::ComputeJacobianTermsType ComputeJacobianTermsType;
+
+  PreconditionedStochasticGradientDescent();
+  virtual ~PreconditionedStochasticGradientDescent() {}
+
+  /** Estimate the preconditioner at the initial position. */
+  virtual void ComputePreconditioner( void );
+
+private:
+
+  PreconditionedStochasticGradientDescent( const Self & ); // purposely not implemented
+  void operator=( const Self & );                          // purposely not implemented
+
+  PreconditionerType m_Preconditioner;
+  double             m_PreconditionerRegularization;
+
+};
+
+} // end namespace elastix
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "elxPreconditionedStochasticGradientDescent.hxx"
+#endif
+
+#endif // end #ifndef __elxPreconditionedStochasticGradientDescent_h
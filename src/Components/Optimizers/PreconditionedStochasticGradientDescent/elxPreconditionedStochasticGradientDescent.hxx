@@ -0,0 +1,237 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __elxPreconditionedStochasticGradientDescent_hxx
+#define __elxPreconditionedStochasticGradientDescent_hxx
+
+#include "elxPreconditionedStochasticGradientDescent.h"
+
+#include <string>
+#include "itkAdvancedImageToImageMetric.h"
+#include "itkTimeProbe.h"
+
+namespace elastix
+{
+
+/**
+ * ********************** Constructor ***********************
+ */
+
+template< class TElastix >
+PreconditionedStochasticGradientDescent< TElastix >
+::PreconditionedStochasticGradientDescent()
+{
+  this->m_PreconditionerRegularization = 0.1;
+
+} // Constructor
+
+
+/**
+ * ***************** BeforeEachResolution ***********************
+ */
+
+template< class TElastix >
+void
+PreconditionedStochasticGradientDescent< TElastix >
+::BeforeEachResolution( void )
+{
+  /** Call the superclass' implementation. */
+  this->Superclass::BeforeEachResolution();
+
+  /** Get the current resolution level. */
+  unsigned int level = static_cast< unsigned int >(
+    this->m_Registration->GetAsITKBaseType()->GetCurrentLevel() );
+
+  /** Set the regularization of the preconditioner. */
+  this->m_PreconditionerRegularization = 0.1;
+  this->GetConfiguration()->ReadParameter( this->m_PreconditionerRegularization,
+    "PreconditionerRegularization", this->GetComponentLabel(), level, 0 );
+  if( this->m_PreconditionerRegularization <= 0.0 )
+  {
+    itkExceptionMacro( << "ERROR: PreconditionerRegularization should be larger than 0." );
+  }
+
+  /** Set the number of Jacobian measurements, also when the automatic
+   * parameter estimation is off. Same default as the superclass.
+   */
+  const unsigned int P = this->GetElastix()->GetElxTransformBase()
+    ->GetAsITKBaseType()->GetNumberOfParameters();
+  this->m_NumberOfJacobianMeasurements = vnl_math_max(
+    static_cast< unsigned int >( 1000 ), static_cast< unsigned int >( P ) );
+  this->GetConfiguration()->ReadParameter(
+    this->m_NumberOfJacobianMeasurements,
+    "NumberOfJacobianMeasurements",
+    this->GetComponentLabel(), level, 0 );
+
+  this->m_Preconditioner.SetSize( 0 );
+
+} // end BeforeEachResolution()
+
+
+/**
+ * ********************** StartOptimization ***********************
+ */
+
+template< class TElastix >
+void
+PreconditionedStochasticGradientDescent< TElastix >
+::StartOptimization( void )
+{
+  this->ComputePreconditioner();
+
+  this->Superclass::StartOptimization();
+
+} // end StartOptimization()
+
+
+/**
+ * ********************** InitializeScales ***********************
+ */
+
+template< class TElastix >
+void
+PreconditionedStochasticGradientDescent< TElastix >
+::InitializeScales( void )
+{
+  this->Superclass::InitializeScales();
+
+  const unsigned int P = this->m_Preconditioner.GetSize();
+  if( P == 0 )
+  {
+    /** Without a preconditioner only the scales of the user apply, as in
+     * AdaptiveStochasticGradientDescent::StartOptimization(). The scales of
+     * the preconditioner of an earlier resolution should not stay in use.
+     */
+    const ScalesType & userSquaredScales = this->GetScales();
+    ScalesType         unitScales( userSquaredScales.GetSize() );
+    unitScales.Fill( 1.0 );
+    if( userSquaredScales.GetSize() != this->GetInitialPosition().GetSize()
+      || userSquaredScales == unitScales )
+    {
+      this->SetUseScales( false );
+      this->m_ScaledCostFunction->SetSquaredScales( ScalesType() );
+    }
+    return;
+  }
+
+  /** Combine the scales set by the user or the transform with the
+   * preconditioner. A step of the optimizer in the scaled space is then
+   * a step of -a P dC/dx in the space of the transform parameters.
+   */
+  const ScalesType & userSquaredScales = this->GetScales();
+  const bool         useUserScales     = this->GetUseScales()
+    && userSquaredScales.GetSize() == P;
+  ScalesType squaredScales( P );
+  for( unsigned int i = 0; i < P; ++i )
+  {
+    const double userSquaredScale = useUserScales ? userSquaredScales[ i ] : 1.0;
+    squaredScales[ i ] = userSquaredScale / this->m_Preconditioner[ i ];
+  }
+  this->m_ScaledCostFunction->SetSquaredScales( squaredScales );
+  this->SetUseScales( true );
+
+} // end InitializeScales()
+
+
+/**
+ * ********************** ComputePreconditioner ***********************
+ */
+
+template< class TElastix >
+void
+PreconditionedStochasticGradientDescent< TElastix >
+::ComputePreconditioner( void )
+{
+  itk::TimeProbe timer;
+  timer.Start();
+  elxout << "Computing the preconditioner for "
+         << this->elxGetClassName() << " ..." << std::endl;
+
+  /** The Jacobian is evaluated at the initial position. */
+  this->GetRegistration()->GetAsITKBaseType()->GetTransform()->SetParameters(
+    this->GetInitialPosition() );
+
+  /** Cast to advanced metric type. */
+  typedef typename Superclass::ElastixType::MetricBaseType::AdvancedMetricType MetricType;
+  MetricType * testPtr = dynamic_cast< MetricType * >(
+    this->GetElastix()->GetElxMetricBase()->GetAsITKBaseType() );
+  if( !testPtr )
+  {
+    itkExceptionMacro( << "ERROR: PreconditionedStochasticGradientDescent expects "
+                       << "the metric to be of type AdvancedImageToImageMetric!" );
+  }
+
+  /** Compute the diagonal of the covariance matrix of the Jacobian. */
+  typename ComputeJacobianTermsType::Pointer computeJacobianTerms = ComputeJacobianTermsType::New();
+  computeJacobianTerms->SetFixedImage( testPtr->GetFixedImage() );
+  computeJacobianTerms->SetFixedImageRegion( testPtr->GetFixedImageRegion() );
+  computeJacobianTerms->SetFixedImageMask( testPtr->GetFixedImageMask() );
+  computeJacobianTerms->SetTransform(
+    this->GetRegistration()->GetAsITKBaseType()->GetTransform() );
+  computeJacobianTerms->SetNumberOfJacobianMeasurements(
+    this->m_NumberOfJacobianMeasurements );
+  computeJacobianTerms->SetUseScales( false );
+
+  PreconditionerType diagonal;
+  computeJacobianTerms->ComputeDiagonalCovariance( diagonal );
+
+  /** Compute the mean of the nonzero elements. */
+  const unsigned int P         = diagonal.GetSize();
+  double             sum       = 0.0;
+  unsigned int       nrNonZero = 0;
+  for( unsigned int i = 0; i < P; ++i )
+  {
+    if( diagonal[ i ] > 0.0 )
+    {
+      sum += diagonal[ i ];
+      ++nrNonZero;
+    }
+  }
+
+  if( nrNonZero == 0 )
+  {
+    elxout[ "warning" ]
+      << "WARNING: The Jacobian of the transform is zero at all samples.\n"
+      << "  The preconditioner is not used in this resolution." << std::endl;
+    this->m_Preconditioner.SetSize( 0 );
+    return;
+  }
+
+  /** Compute the preconditioner. */
+  const double mean  = sum / static_cast< double >( nrNonZero );
+  const double kappa = this->m_PreconditionerRegularization;
+  this->m_Preconditioner.SetSize( P );
+  double minP = itk::NumericTraits< double >::max();
+  double maxP = 0.0;
+  for( unsigned int i = 0; i < P; ++i )
+  {
+    this->m_Preconditioner[ i ] = ( 1.0 + kappa ) * mean / ( diagonal[ i ] + kappa * mean );
+    minP = vnl_math_min( minP, this->m_Preconditioner[ i ] );
+    maxP = vnl_math_max( maxP, this->m_Preconditioner[ i ] );
+  }
+
+  timer.Stop();
+  elxout << "  The preconditioner ranges from " << minP << " to " << maxP << ".\n"
+         << "  Computing the preconditioner took "
+         << this->ConvertSecondsToDHMS( timer.GetMean(), 2 ) << std::endl;
+
+} // end ComputePreconditioner()
+
+
+} // end namespace elastix
+
+#endif // end #ifndef __elxPreconditionedStochasticGradientDescent_hxx
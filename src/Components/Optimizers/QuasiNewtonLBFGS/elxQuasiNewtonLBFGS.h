@@ -80,6 +80,14 @@ namespace elastix
  *    In general it is wise to do so.\n
  *    example: <tt>(StopIfWolfeNotSatisfied "true" "false")</tt> \n
  *    Default value: "true".\n
+ * \parameter UseEvaluationCache: Whether to reuse the value and derivative of
+ *    the cost function when it is evaluated again at a position that was
+ *    evaluated recently, for example at the accepted point of a line search.\n
+ *    The cache is not used in combination with NewSamplesEveryIteration.
+ *    Each evaluation in the cache holds a copy of the parameters and the derivative,
+ *    which costs time and memory for transforms with many parameters.\n
+ *    example: <tt>(UseEvaluationCache "true" "false")</tt> \n
+ *    Default value: "false".\n
  *
  * \ingroup Optimizers
  */
@@ -139,6 +147,14 @@ public:
    * after that call the superclass' implementation */
   virtual void StartOptimization( void );
 
+  /** Restore the state of a checkpoint, if one was set, and call the
+   * superclass' implementation.
+   */
+  virtual void ResumeOptimization( void );
+
+  /** Write the iteration and the L-BFGS memory to a checkpoint. */
+  virtual bool WriteCheckpointState( std::ostream & os ) const;
+
   /** Methods to set parameters and print output at different stages
    * in the registration process.*/
   virtual void BeforeRegistration( void );
@@ -108,6 +108,89 @@ QuasiNewtonLBFGS< TElastix >::StartOptimization( void )
 }   //end StartOptimization
 
 
+/**
+ * ***************** ResumeOptimization ***********************
+ */
+
+template< class TElastix >
+void
+QuasiNewtonLBFGS< TElastix >::ResumeOptimization( void )
+{
+  std::string state;
+  if( this->TakeCheckpointState( state ) )
+  {
+    std::istringstream is( state, std::ios::in | std::ios::binary );
+    unsigned long long iteration = 0;
+    unsigned int       memory, point, previousPoint, bound;
+    RegistrationCheckpoint::ReadValue( is, iteration );
+    RegistrationCheckpoint::ReadValue( is, memory );
+    RegistrationCheckpoint::ReadValue( is, point );
+    RegistrationCheckpoint::ReadValue( is, previousPoint );
+    RegistrationCheckpoint::ReadValue( is, bound );
+    if( memory != this->GetMemory() )
+    {
+      itkExceptionMacro( << "The checkpoint was written with LBFGSUpdateAccuracy "
+                         << memory << ", but " << this->GetMemory() << " is used now." );
+    }
+
+    RegistrationCheckpoint::ReadVector( is, this->m_Rho );
+    for( unsigned int i = 0; i < memory; ++i )
+    {
+      RegistrationCheckpoint::ReadVector( is, this->m_S[ i ] );
+      RegistrationCheckpoint::ReadVector( is, this->m_Y[ i ] );
+    }
+
+    this->m_CurrentIteration = static_cast< unsigned long >( iteration );
+    this->m_Point            = point;
+    this->m_PreviousPoint    = previousPoint;
+    this->m_Bound            = bound;
+  }
+
+  this->Superclass1::ResumeOptimization();
+
+}   // end ResumeOptimization
+
+
+/**
+ * ***************** WriteCheckpointState ***********************
+ */
+
+template< class TElastix >
+bool
+QuasiNewtonLBFGS< TElastix >::WriteCheckpointState( std::ostream & os ) const
+{
+  /** During a line search, the memory is that of the last iteration, and
+   * the current position is the start of the line search, so the state is
+   * stored as is. Otherwise the checkpoint is written after the memory was
+   * updated, but before the next iteration was prepared.
+   */
+  const unsigned int memory        = this->GetMemory();
+  unsigned long long iteration     = this->m_CurrentIteration;
+  unsigned int       point         = this->m_Point;
+  unsigned int       previousPoint = this->m_PreviousPoint;
+  if( !this->GetInLineSearch() )
+  {
+    ++iteration;
+    previousPoint = this->m_Point;
+    point         = memory > 0 ? ( this->m_Point + 1 ) % memory : 0;
+  }
+
+  RegistrationCheckpoint::WriteValue( os, iteration );
+  RegistrationCheckpoint::WriteValue( os, memory );
+  RegistrationCheckpoint::WriteValue( os, point );
+  RegistrationCheckpoint::WriteValue( os, previousPoint );
+  RegistrationCheckpoint::WriteValue( os, this->m_Bound );
+  RegistrationCheckpoint::WriteVector( os, this->m_Rho );
+  for( unsigned int i = 0; i < memory; ++i )
+  {
+    RegistrationCheckpoint::WriteVector( os, this->m_S[ i ] );
+    RegistrationCheckpoint::WriteVector( os, this->m_Y[ i ] );
+  }
+  return true;
+
+}   // end WriteCheckpointState
+
+
 /**
 * ***************** LineSearch ************************
 */
@@ -282,6 +365,15 @@ QuasiNewtonLBFGS< TElastix >
     this->m_StopIfWolfeNotSatisfied = false;
   }
 
+  /** Check whether to reuse previous evaluations of the cost function.
+   * This is not possible when new samples are selected every iteration.
+   */
+  bool useEvaluationCache = false;
+  this->m_Configuration->ReadParameter( useEvaluationCache,
+    "UseEvaluationCache", this->GetComponentLabel(), level, 0 );
+  this->SetUseEvaluationCache( useEvaluationCache
+    && !this->GetNewSamplesEveryIteration() );
+
   this->m_WolfeIsStopCondition     = false;
   this->m_SearchDirectionMagnitude = 0.0;
   this->m_StartLineSearch          = false;
@@ -456,6 +548,17 @@ QuasiNewtonLBFGS< TElastix >
   /** Print the stopping condition */
   elxout << "Stopping condition: " << stopcondition << "." << std::endl;
 
+  /** Print the number of evaluations of the cost function that were saved. */
+  if( this->GetUseEvaluationCache() )
+  {
+    const ScaledCostFunctionType * costFunction = this->GetScaledCostFunction();
+    elxout << "Cost function evaluations reused from the cache: "
+           << costFunction->GetNumberOfSavedEvaluations() << " of "
+           << costFunction->GetNumberOfSavedEvaluations()
+      + costFunction->GetNumberOfEvaluations()
+           << "." << std::endl;
+  }
+
 }   // end AfterEachResolution
 
 
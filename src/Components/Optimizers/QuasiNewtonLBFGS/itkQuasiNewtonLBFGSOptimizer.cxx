@@ -21,6 +21,7 @@
 
 #include "itkQuasiNewtonLBFGSOptimizer.h"
 #include "itkArray.h"
+#include "itkParallelVectorOperations.h"
 #include "vnl/vnl_math.h"
 
 namespace itk
@@ -172,13 +173,8 @@ QuasiNewtonLBFGSOptimizer::ResumeOptimization()
      * compute the search direction in the next iterations */
     if( this->GetMemory() > 0 )
     {
-      ParametersType s;
-      DerivativeType y;
-      s = this->GetCurrentStepLength() * searchDir;
-      y = this->GetCurrentGradient() - previousGradient;
-      this->StoreCurrentPoint( s, y );
-      s.clear();
-      y.clear();
+      this->StoreCurrentPointInPlace(
+        this->GetCurrentStepLength(), searchDir, previousGradient );
     }
 
     /** Number of valid entries in m_S and m_Y */
@@ -246,7 +242,7 @@ QuasiNewtonLBFGSOptimizer::ComputeDiagonalMatrix( DiagonalMatrixType & diag_H0 )
   {
     const DerivativeType & y  = this->m_Y[ this->m_PreviousPoint ];
     const double           ys = 1.0 / this->m_Rho[ this->m_PreviousPoint ];
-    const double           yy = y.squared_magnitude();
+    const double           yy = ParallelVectorOperations::SquaredMagnitude( y );
     fill_value = ys / yy;
     if( fill_value <= 0. )
     {
@@ -276,11 +272,10 @@ QuasiNewtonLBFGSOptimizer::ComputeSearchDirection(
   typedef Array< double > AlphaType;
   AlphaType alpha( this->GetMemory() );
 
-  const unsigned int numberOfParameters = gradient.GetSize();
   DiagonalMatrixType H0;
   this->ComputeDiagonalMatrix( H0 );
 
-  searchDir = -gradient;
+  ParallelVectorOperations::ScaledCopy( searchDir, -1.0, gradient );
 
   int cp = static_cast< int >( this->m_Point );
 
@@ -291,31 +286,19 @@ QuasiNewtonLBFGSOptimizer::ComputeSearchDirection(
     {
       cp = this->GetMemory() - 1;
     }
-    const double sq = inner_product( this->m_S[ cp ], searchDir );
+    const double sq = ParallelVectorOperations::InnerProduct( this->m_S[ cp ], searchDir );
     alpha[ cp ] = this->m_Rho[ cp ] * sq;
-    const double &         alpha_cp = alpha[ cp ];
-    const DerivativeType & y        = this->m_Y[ cp ];
-    for( unsigned int j = 0; j < numberOfParameters; ++j )
-    {
-      searchDir[ j ] -= alpha_cp * y[ j ];
-    }
+    ParallelVectorOperations::AddScaled( searchDir, searchDir, -alpha[ cp ], this->m_Y[ cp ] );
   }
 
-  for( unsigned int j = 0; j < numberOfParameters; ++j )
-  {
-    searchDir[ j ] *= H0[ j ];
-  }
+  ParallelVectorOperations::MultiplyElementWise( searchDir, H0 );
 
   for( unsigned int i = 0; i < this->m_Bound; ++i )
   {
-    const double           yr             = inner_product( this->m_Y[ cp ], searchDir );
-    const double           beta           = this->m_Rho[ cp ] * yr;
-    const double           alpha_min_beta = alpha[ cp ] - beta;
-    const ParametersType & s              = this->m_S[ cp ];
-    for( unsigned int j = 0; j < numberOfParameters; ++j )
-    {
-      searchDir[ j ] += alpha_min_beta * s[ j ];
-    }
+    const double yr             = ParallelVectorOperations::InnerProduct( this->m_Y[ cp ], searchDir );
+    const double beta           = this->m_Rho[ cp ] * yr;
+    const double alpha_min_beta = alpha[ cp ] - beta;
+    ParallelVectorOperations::AddScaled( searchDir, searchDir, alpha_min_beta, this->m_S[ cp ] );
     ++cp;
     if( static_cast< unsigned int >( cp ) == this->GetMemory() )
     {
@@ -326,7 +309,7 @@ QuasiNewtonLBFGSOptimizer::ComputeSearchDirection(
   /** Normalize if no information about previous steps is available yet */
   if( this->m_Bound == 0 )
   {
-    searchDir /= gradient.magnitude();
+    searchDir /= vcl_sqrt( ParallelVectorOperations::SquaredMagnitude( gradient ) );
   }
 
 }   // end ComputeSearchDirection
@@ -414,6 +397,29 @@ QuasiNewtonLBFGSOptimizer::StoreCurrentPoint(
 }   // end StoreCurrentPoint
 
 
+/**
+ * ********************* StoreCurrentPointInPlace *****************
+ */
+
+void
+QuasiNewtonLBFGSOptimizer::StoreCurrentPointInPlace(
+  double step,
+  const ParametersType & searchDir,
+  const DerivativeType & previousGradient )
+{
+  itkDebugMacro( "StoreCurrentPointInPlace" );
+
+  /** Overwrite the oldest entry of the ring buffer. */
+  ParametersType & s = this->m_S[ this->m_Point ];
+  DerivativeType & y = this->m_Y[ this->m_Point ];
+
+  ParallelVectorOperations::ScaledCopy( s, step, searchDir );                              // s
+  ParallelVectorOperations::AddScaled( y, this->m_CurrentGradient, -1.0, previousGradient ); // y
+  this->m_Rho[ this->m_Point ] = 1.0 / ParallelVectorOperations::InnerProduct( s, y );      // 1/ys
+
+}   // end StoreCurrentPointInPlace
+
+
 /**
  * ********************* TestConvergence ************************
  */
@@ -441,8 +447,10 @@ QuasiNewtonLBFGSOptimizer::TestConvergence( bool firstLineSearchDone )
   }
 
   /** Check for convergence of gradient magnitude */
-  const double gnorm = this->GetCurrentGradient().magnitude();
-  const double xnorm = this->GetScaledCurrentPosition().magnitude();
+  const double gnorm = vcl_sqrt(
+    ParallelVectorOperations::SquaredMagnitude( this->GetCurrentGradient() ) );
+  const double xnorm = vcl_sqrt(
+    ParallelVectorOperations::SquaredMagnitude( this->GetScaledCurrentPosition() ) );
   if( gnorm / vnl_math_max( 1.0, xnorm ) <= this->GetGradientMagnitudeTolerance() )
   {
     this->m_StopCondition = GradientMagnitudeTolerance;
@@ -51,6 +51,11 @@ namespace itk
  * The steplength is determined at each iteration by means of a
  * line search routine. The itk::MoreThuenteLineSearchOptimizer works well.
  *
+ * The vectors \f$s\f$ and \f$y\f$ of the last \f$M\f$ steps are stored in
+ * a ring buffer, and are computed in place. The vector operations use the
+ * itk::ParallelVectorOperations, which are multi-threaded for large numbers
+ * of parameters.
+ *
  *
  * \ingroup Numerics Optimizers
  */
@@ -190,6 +195,14 @@ protected:
     const ParametersType & step,
     const DerivativeType & grad_dif );
 
+  /** Like StoreCurrentPoint, but computes s = step * searchDir and
+   * y = m_CurrentGradient - previousGradient directly in the ring buffer
+   * entries m_S[ m_Point ] and m_Y[ m_Point ], without temporary vectors. */
+  virtual void StoreCurrentPointInPlace(
+    double step,
+    const ParametersType & searchDir,
+    const DerivativeType & previousGradient );
+
   /** Check if convergence has occured;
    * The firstLineSearchDone bool allows the implementation of TestConvergence to
    * decide to skip a few convergence checks when no line search has performed yet
@@ -32,6 +32,10 @@ namespace elastix
  *
  * This optimizer supports the NewSamplesEveryIteration parameter.
  *
+ * The perturbations are evaluated one after another, since they all set
+ * their parameters on the same transform. Each evaluation of the metric
+ * is multi-threaded over the samples.
+ *
  * The parameters used in this class are:
  * \parameter Optimizer: Select this optimizer as follows:\n
  *    <tt>(Optimizer "SimultaneousPerturbation")</tt>
@@ -59,6 +59,27 @@ namespace elastix
 *   SP_alpha can be defined for each resolution. \n
 *   example: <tt>(SP_alpha 0.602 0.602 0.602)</tt> \n
 *   The default/recommended value is 0.602.
+* \parameter UsePlateauStopCriterion: Whether to stop a resolution before MaximumNumberOfIterations
+*   when the metric does not improve anymore. Because the gain a/(A+k+1)^alpha decays, a plateau
+*   may also mean that the steps have become too small; then consider a larger SP_a instead.
+*   The parameter can be specified for each resolution, or for all resolutions at once.\n
+*   example: <tt>(UsePlateauStopCriterion "true")</tt>\n
+*   Default: false.
+* \parameter PlateauWindowSize: The number of most recent iterations whose metric values and
+*   gradient magnitudes are fitted by a straight line.
+*   The parameter can be specified for each resolution, or for all resolutions at once.\n
+*   example: <tt>(PlateauWindowSize 50)</tt>\n
+*   Default: 100. Minimum: 3.
+* \parameter PlateauCheckInterval: The plateau test is done every PlateauCheckInterval iterations,
+*   once the window is full.
+*   The parameter can be specified for each resolution, or for all resolutions at once.\n
+*   example: <tt>(PlateauCheckInterval 10)</tt>\n
+*   Default: 10.
+* \parameter PlateauTestThreshold: The resolution ends when the t-statistics of both slopes
+*   are above -PlateauTestThreshold.
+*   The parameter can be specified for each resolution, or for all resolutions at once.\n
+*   example: <tt>(PlateauTestThreshold 2.0)</tt>\n
+*   Default: 2.0.
 *
 * \sa StandardGradientDescentOptimizer
 * \ingroup Optimizers
@@ -128,6 +149,14 @@ public:
   /** Stop optimisation and pass on exception. */
   virtual void MetricErrorResponse( itk::ExceptionObject & err );
 
+  /** Restore the state of a checkpoint, if one was set, and call the
+   * superclass' implementation.
+   */
+  virtual void ResumeOptimization( void );
+
+  /** Write the iteration, the time and the gain parameters to a checkpoint. */
+  virtual bool WriteCheckpointState( std::ostream & os ) const;
+
   /** Add SetCurrentPositionPublic, which calls the protected
   * SetCurrentPosition of the itkStandardGradientDescentOptimizer class.
   */
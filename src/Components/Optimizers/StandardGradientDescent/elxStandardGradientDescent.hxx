@@ -73,6 +73,9 @@ StandardGradientDescent< TElastix >
   unsigned int level = static_cast< unsigned int >(
     this->m_Registration->GetAsITKBaseType()->GetCurrentLevel() );
 
+  /** Use the current share of the threads of the process. */
+  this->SetNumberOfThreads( this->GetElastix()->GetNumberOfThreads() );
+
   /** Set the maximumNumberOfIterations. */
   unsigned int maximumNumberOfIterations = 500;
   this->GetConfiguration()->ReadParameter( maximumNumberOfIterations,
@@ -108,6 +111,27 @@ StandardGradientDescent< TElastix >
       << std::endl;
   }
 
+  /** Set the plateau stop criterion. */
+  bool usePlateauStopCriterion = false;
+  this->GetConfiguration()->ReadParameter( usePlateauStopCriterion,
+    "UsePlateauStopCriterion", this->GetComponentLabel(), level, 0 );
+  this->SetUsePlateauStopCriterion( usePlateauStopCriterion );
+
+  unsigned int plateauWindowSize = 100;
+  this->GetConfiguration()->ReadParameter( plateauWindowSize,
+    "PlateauWindowSize", this->GetComponentLabel(), level, 0 );
+  this->SetPlateauWindowSize( plateauWindowSize );
+
+  unsigned int plateauCheckInterval = 10;
+  this->GetConfiguration()->ReadParameter( plateauCheckInterval,
+    "PlateauCheckInterval", this->GetComponentLabel(), level, 0 );
+  this->SetPlateauCheckInterval( plateauCheckInterval );
+
+  double plateauTestThreshold = 2.0;
+  this->GetConfiguration()->ReadParameter( plateauTestThreshold,
+    "PlateauTestThreshold", this->GetComponentLabel(), level, 0 );
+  this->SetPlateauTestThreshold( plateauTestThreshold );
+
 }   // end BeforeEachResolution()
 
 
@@ -144,7 +168,8 @@ StandardGradientDescent< TElastix >
 ::AfterEachResolution( void )
 {
   /**
-   * enum   StopConditionType {  MaximumNumberOfIterations, MetricError }
+   * enum   StopConditionType {  MaximumNumberOfIterations, MetricError,
+   *   MinimumStepSize, MetricPlateau }
    */
   std::string stopcondition;
   switch( this->GetStopCondition() )
@@ -158,6 +183,10 @@ StandardGradientDescent< TElastix >
       stopcondition = "Error in metric";
       break;
 
+    case MetricPlateau:
+      stopcondition = "The metric value has reached a plateau";
+      break;
+
     default:
       stopcondition = "Unknown";
       break;
@@ -223,6 +252,86 @@ StandardGradientDescent< TElastix >
 }   // end StartOptimization()
 
 
+/**
+ * ****************** ResumeOptimization *************************
+ */
+
+template< class TElastix >
+void
+StandardGradientDescent< TElastix >
+::ResumeOptimization( void )
+{
+  /** The checkpoint was written in the middle of an iteration, before
+   * the time was updated. Complete that iteration.
+   */
+  std::string state;
+  if( this->TakeCheckpointState( state ) )
+  {
+    std::istringstream is( state, std::ios::in | std::ios::binary );
+    unsigned long long iteration = 0;
+    double             currentTime, a, A, alpha;
+    RegistrationCheckpoint::ReadValue( is, iteration );
+    RegistrationCheckpoint::ReadValue( is, currentTime );
+    RegistrationCheckpoint::ReadValue( is, a );
+    RegistrationCheckpoint::ReadValue( is, A );
+    RegistrationCheckpoint::ReadValue( is, alpha );
+    itk::Array< double > plateauValues, plateauGradients;
+    RegistrationCheckpoint::ReadVector( is, plateauValues );
+    RegistrationCheckpoint::ReadVector( is, plateauGradients );
+
+    this->m_CurrentIteration = static_cast< unsigned long >( iteration );
+    this->m_CurrentTime      = currentTime;
+    this->SetParam_a( a );
+    this->SetParam_A( A );
+    this->SetParam_alpha( alpha );
+    this->SetPlateauHistory( plateauValues, plateauGradients );
+
+    this->UpdateCurrentTime();
+    this->m_CurrentIteration++;
+    if( this->m_CurrentIteration >= this->GetNumberOfIterations() )
+    {
+      this->m_StopCondition = MaximumNumberOfIterations;
+      this->StopOptimization();
+      return;
+    }
+    if( this->GetUsePlateauStopCriterion() && this->TestPlateau() )
+    {
+      this->m_StopCondition = MetricPlateau;
+      this->StopOptimization();
+      return;
+    }
+  }
+
+  this->Superclass1::ResumeOptimization();
+
+}   // end ResumeOptimization()
+
+
+/**
+ * ****************** WriteCheckpointState *************************
+ */
+
+template< class TElastix >
+bool
+StandardGradientDescent< TElastix >
+::WriteCheckpointState( std::ostream & os ) const
+{
+  RegistrationCheckpoint::WriteValue( os,
+    static_cast< unsigned long long >( this->m_CurrentIteration ) );
+  RegistrationCheckpoint::WriteValue( os, this->m_CurrentTime );
+  RegistrationCheckpoint::WriteValue( os, this->GetParam_a() );
+  RegistrationCheckpoint::WriteValue( os, this->GetParam_A() );
+  RegistrationCheckpoint::WriteValue( os, this->GetParam_alpha() );
+
+  itk::Array< double > plateauValues, plateauGradients;
+  this->GetPlateauHistory( plateauValues, plateauGradients );
+  RegistrationCheckpoint::WriteVector( os, plateauValues );
+  RegistrationCheckpoint::WriteVector( os, plateauGradients );
+  return true;
+
+}   // end WriteCheckpointState()
+
+
 /**
  * ****************** MetricErrorResponse *************************
  */
@@ -21,6 +21,8 @@
 #include "itkCommand.h"
 #include "itkEventObject.h"
 #include "itkExceptionObject.h"
+#include "itkParallelVectorOperations.h"
+#include "vnl/vnl_math.h"
 
 #ifdef ELASTIX_USE_OPENMP
 #include <omp.h>
@@ -50,6 +52,13 @@ GradientDescentOptimizer2
   this->m_Value              = 0.0;
   this->m_StopCondition      = MaximumNumberOfIterations;
 
+  this->m_UsePlateauStopCriterion   = false;
+  this->m_PlateauWindowSize         = 100;
+  this->m_PlateauCheckInterval      = 10;
+  this->m_PlateauTestThreshold      = 2.0;
+  this->m_PlateauValueTStatistic    = 0.0;
+  this->m_PlateauGradientTStatistic = 0.0;
+
   this->m_Threader       = ThreaderType::New();
   this->m_UseMultiThread = false;
   this->m_UseOpenMP      = false;
@@ -81,6 +90,10 @@ GradientDescentOptimizer2
   os << std::endl;
   os << indent << "Gradient: " << this->m_Gradient;
   os << std::endl;
+  os << indent << "UsePlateauStopCriterion: " << this->m_UsePlateauStopCriterion << std::endl;
+  os << indent << "PlateauWindowSize: " << this->m_PlateauWindowSize << std::endl;
+  os << indent << "PlateauCheckInterval: " << this->m_PlateauCheckInterval << std::endl;
+  os << indent << "PlateauTestThreshold: " << this->m_PlateauTestThreshold << std::endl;
 
 } // end PrintSelf()
 
@@ -95,6 +108,12 @@ GradientDescentOptimizer2
 {
   this->m_CurrentIteration = 0;
 
+  /** Forget the history of a previous optimization. */
+  this->m_PlateauValueHistory.clear();
+  this->m_PlateauGradientHistory.clear();
+  this->m_PlateauValueTStatistic    = 0.0;
+  this->m_PlateauGradientTStatistic = 0.0;
+
   /** Get the number of parameters; checks also if a cost function has been set at all.
    * if not: an exception is thrown */
   this->GetScaledCostFunction()->GetNumberOfParameters();
@@ -145,6 +164,11 @@ GradientDescentOptimizer2
       break;
     }
 
+    if( this->m_UsePlateauStopCriterion )
+    {
+      this->UpdatePlateauHistory();
+    }
+
     this->AdvanceOneStep();
 
     /** StopOptimization may have been called. */
@@ -162,11 +186,170 @@ GradientDescentOptimizer2
       break;
     }
 
+    if( this->m_UsePlateauStopCriterion && this->TestPlateau() )
+    {
+      this->m_StopCondition = MetricPlateau;
+      this->StopOptimization();
+      break;
+    }
+
   } // end while
 
 } // end ResumeOptimization()
 
 
+/**
+ * ***************** UpdatePlateauHistory ************************
+ */
+
+void
+GradientDescentOptimizer2
+::UpdatePlateauHistory( void )
+{
+  this->m_PlateauValueHistory.push_back( this->m_Value );
+  this->m_PlateauGradientHistory.push_back( vcl_sqrt(
+    ParallelVectorOperations::SquaredMagnitude( this->m_Gradient ) ) );
+
+  while( this->m_PlateauValueHistory.size() > this->m_PlateauWindowSize )
+  {
+    this->m_PlateauValueHistory.pop_front();
+    this->m_PlateauGradientHistory.pop_front();
+  }
+
+} // end UpdatePlateauHistory()
+
+
+/**
+ * ***************** TestPlateau ************************
+ */
+
+bool
+GradientDescentOptimizer2
+::TestPlateau( void )
+{
+  if( this->m_PlateauValueHistory.size() < this->m_PlateauWindowSize
+    || ( this->m_CurrentIteration % this->m_PlateauCheckInterval ) != 0 )
+  {
+    return false;
+  }
+
+  this->m_PlateauValueTStatistic
+    = ComputeSlopeTStatistic( this->m_PlateauValueHistory );
+  this->m_PlateauGradientTStatistic
+    = ComputeSlopeTStatistic( this->m_PlateauGradientHistory );
+
+  /** The cost function is minimized, so progress shows as a negative slope.
+   * A plateau is reached when neither the value nor the gradient magnitude
+   * decreases significantly anymore.
+   */
+  return this->m_PlateauValueTStatistic > -this->m_PlateauTestThreshold
+         && this->m_PlateauGradientTStatistic > -this->m_PlateauTestThreshold;
+
+} // end TestPlateau()
+
+
+/**
+ * ***************** GetPlateauHistory ************************
+ */
+
+void
+GradientDescentOptimizer2
+::GetPlateauHistory( Array< double > & values,
+  Array< double > & gradientMagnitudes ) const
+{
+  const unsigned int n = static_cast< unsigned int >( this->m_PlateauValueHistory.size() );
+  values.SetSize( n );
+  gradientMagnitudes.SetSize( n );
+  for( unsigned int i = 0; i < n; ++i )
+  {
+    values[ i ]             = this->m_PlateauValueHistory[ i ];
+    gradientMagnitudes[ i ] = this->m_PlateauGradientHistory[ i ];
+  }
+
+} // end GetPlateauHistory()
+
+
+/**
+ * ***************** SetPlateauHistory ************************
+ */
+
+void
+GradientDescentOptimizer2
+::SetPlateauHistory( const Array< double > & values,
+  const Array< double > & gradientMagnitudes )
+{
+  if( values.GetSize() != gradientMagnitudes.GetSize() )
+  {
+    itkExceptionMacro( << "The plateau history of the values and the gradient magnitudes "
+                       << "should have the same length." );
+  }
+
+  this->m_PlateauValueHistory.assign( values.begin(), values.end() );
+  this->m_PlateauGradientHistory.assign( gradientMagnitudes.begin(), gradientMagnitudes.end() );
+
+  /** The window may have been larger when the history was stored. */
+  while( this->m_PlateauValueHistory.size() > this->m_PlateauWindowSize )
+  {
+    this->m_PlateauValueHistory.pop_front();
+    this->m_PlateauGradientHistory.pop_front();
+  }
+
+} // end SetPlateauHistory()
+
+
+/**
+ * ***************** ComputeSlopeTStatistic ************************
+ */
+
+double
+GradientDescentOptimizer2
+::ComputeSlopeTStatistic( const std::deque< double > & samples )
+{
+  /** Fit y = a + b x with x = 0, 1, ..., n-1. */
+  const double n     = static_cast< double >( samples.size() );
+  const double meanX = 0.5 * ( n - 1.0 );
+  const double sxx   = n * ( n * n - 1.0 ) / 12.0;
+
+  double meanY = 0.0;
+  for( std::deque< double >::const_iterator it = samples.begin(); it != samples.end(); ++it )
+  {
+    meanY += *it;
+  }
+  meanY /= n;
+
+  double sxy = 0.0;
+  double x   = 0.0;
+  for( std::deque< double >::const_iterator it = samples.begin(); it != samples.end(); ++it, x += 1.0 )
+  {
+    sxy += ( x - meanX ) * ( *it - meanY );
+  }
+  const double slope = sxy / sxx;
+
+  /** Residual variance and standard error of the slope. */
+  double ssr = 0.0;
+  x = 0.0;
+  for( std::deque< double >::const_iterator it = samples.begin(); it != samples.end(); ++it, x += 1.0 )
+  {
+    const double residual = *it - meanY - slope * ( x - meanX );
+    ssr += residual * residual;
+  }
+  const double standardError = vcl_sqrt( ssr / ( ( n - 2.0 ) * sxx ) );
+
+  /** A perfect fit: the slope is exact. */
+  if( standardError <= 0.0 )
+  {
+    if( slope < 0.0 )
+    {
+      return -NumericTraits< double >::max();
+    }
+    return slope > 0.0 ? NumericTraits< double >::max() : 0.0;
+  }
+
+  return slope / standardError;
+
+} // end ComputeSlopeTStatistic()
+
+
 /**
  * ***************** MetricErrorResponse ************************
  */
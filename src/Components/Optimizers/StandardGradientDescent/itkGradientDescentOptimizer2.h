@@ -20,6 +20,8 @@
 
 #include "itkScaledSingleValuedNonLinearOptimizer.h"
 #include "itkMultiThreader.h"
+#include "itkArray.h"
+#include <deque>
 
 namespace itk
 {
@@ -37,8 +39,16 @@ namespace itk
 * \f]
 *
 * The learning rate is a fixed scalar defined via SetLearningRate().
-* The optimizer steps through a user defined number of iterations;
-* no convergence checking is done.
+* The optimizer steps through a user defined number of iterations.
+*
+* Optionally, the optimization stops early when the cost function has reached
+* a plateau. The values and gradient magnitudes of the last PlateauWindowSize
+* iterations are then kept, and every PlateauCheckInterval iterations a least
+* squares line is fitted to both. When neither slope is significantly negative,
+* i.e. when both t-statistics of the slopes exceed -PlateauTestThreshold, the
+* optimization stops with the MetricPlateau condition. The test only uses the
+* values that the optimizer computes anyway, so it does not cost additional
+* cost function evaluations.
 *
 * Additionally, user can scale each component of the \f$\partial f / \partial p\f$
 * but setting a scaling vector using method SetScale().
@@ -82,7 +92,8 @@ public:
   typedef enum {
     MaximumNumberOfIterations,
     MetricError,
-    MinimumStepSize
+    MinimumStepSize,
+    MetricPlateau
   } StopConditionType;
 
   /** Advance one step following the gradient direction. */
@@ -129,6 +140,38 @@ public:
   /** Get current search direction */
   itkGetConstReferenceMacro( SearchDirection, DerivativeType );
 
+  /** Set/Get whether the optimization stops when a plateau is detected. Default: false. */
+  itkSetMacro( UsePlateauStopCriterion, bool );
+  itkGetConstMacro( UsePlateauStopCriterion, bool );
+
+  /** Set/Get the number of iterations on which the plateau test is based. Default: 100. */
+  itkSetClampMacro( PlateauWindowSize, unsigned long, 3, NumericTraits< unsigned long >::max() );
+  itkGetConstMacro( PlateauWindowSize, unsigned long );
+
+  /** Set/Get the number of iterations between two plateau tests. Default: 10. */
+  itkSetClampMacro( PlateauCheckInterval, unsigned long, 1, NumericTraits< unsigned long >::max() );
+  itkGetConstMacro( PlateauCheckInterval, unsigned long );
+
+  /** Set/Get the threshold on the t-statistics of the slopes. Default: 2.0. */
+  itkSetMacro( PlateauTestThreshold, double );
+  itkGetConstMacro( PlateauTestThreshold, double );
+
+  /** Get the t-statistics of the slopes of the value and the gradient
+   * magnitude, computed by the last plateau test.
+   */
+  itkGetConstMacro( PlateauValueTStatistic, double );
+  itkGetConstMacro( PlateauGradientTStatistic, double );
+
+  /** Get/Set the values and gradient magnitudes of the plateau test window,
+   * oldest first. Used to save and restore an interrupted optimization;
+   * StartOptimization() clears the window.
+   */
+  virtual void GetPlateauHistory( Array< double > & values,
+    Array< double > & gradientMagnitudes ) const;
+
+  virtual void SetPlateauHistory( const Array< double > & values,
+    const Array< double > & gradientMagnitudes );
+
   /** Set the number of threads. */
   void SetNumberOfThreads( ThreadIdType numberOfThreads )
   {
@@ -147,6 +190,19 @@ protected:
   virtual ~GradientDescentOptimizer2() {}
   void PrintSelf( std::ostream & os, Indent indent ) const;
 
+  /** Store the current value and gradient magnitude for the plateau test. */
+  virtual void UpdatePlateauHistory( void );
+
+  /** Returns true if the history window is full, a test is due in the
+   * current iteration, and neither slope is significantly negative.
+   */
+  virtual bool TestPlateau( void );
+
+  /** Compute the t-statistic of the slope of a least squares line
+   * through the samples, which are assumed to be equidistant.
+   */
+  static double ComputeSlopeTStatistic( const std::deque< double > & samples );
+
   /** Typedefs for multi-threading. */
   typedef itk::MultiThreader             ThreaderType;
   typedef ThreaderType::ThreadInfoStruct ThreadInfoType;
@@ -164,6 +220,16 @@ protected:
   unsigned long m_NumberOfIterations;
   unsigned long m_CurrentIteration;
 
+  /** Settings and history of the plateau test. */
+  bool                 m_UsePlateauStopCriterion;
+  unsigned long        m_PlateauWindowSize;
+  unsigned long        m_PlateauCheckInterval;
+  double               m_PlateauTestThreshold;
+  double               m_PlateauValueTStatistic;
+  double               m_PlateauGradientTStatistic;
+  std::deque< double > m_PlateauValueHistory;
+  std::deque< double > m_PlateauGradientHistory;
+
 private:
 
   GradientDescentOptimizer2( const Self & ); // purposely not implemented
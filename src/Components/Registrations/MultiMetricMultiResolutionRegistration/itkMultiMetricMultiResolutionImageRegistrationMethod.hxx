@@ -400,6 +400,12 @@ MultiMetricMultiResolutionImageRegistrationMethod< TFixedImage, TMovingImage >
       break;
     }
 
+    // Levels that were completed before are not optimized again
+    if( this->SkipCompletedLevel( currentLevel ) )
+    {
+      continue;
+    }
+
     try
     {
       // initialize the interconnects between components
@@ -500,6 +500,12 @@ MultiInputMultiResolutionImageRegistrationMethodBase< TFixedImage, TMovingImage
       break;
     }
 
+    // Levels that were completed before are not optimized again
+    if( this->SkipCompletedLevel( currentLevel ) )
+    {
+      continue;
+    }
+
     try
     {
       // initialize the interconnects between components
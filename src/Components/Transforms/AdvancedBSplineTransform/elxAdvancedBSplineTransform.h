@@ -76,6 +76,13 @@ namespace elastix
  *   <em>Nonrigid registration of dynamic medical imaging data using nD+t B-splines and a
  *   groupwise optimization approach</em>, C.T. Metz, S. Klein, M. Schaap, T. van Walsum and
  *   W.J. Niessen, Medical Image Analysis, in press.
+ * \parameter UseDyadicGridRefinement: if the grid spacing is halved between two resolutions,
+ *   with control points that coincide, compute the new coefficients directly with the
+ *   B-spline two-scale relation, instead of by resampling. Near the border of the grid this
+ *   gives other coefficients, since the two-scale relation does not mirror the grid.
+ *   Not used with UseCyclicTransform. \n
+ *   example: <tt>(UseDyadicGridRefinement "true")</tt> \n
+ *   The default is "false".
  *
  *
  * The transform parameters necessary for transformix, additionally defined by this class, are:
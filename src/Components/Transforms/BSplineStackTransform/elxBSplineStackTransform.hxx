@@ -472,6 +472,7 @@ BSplineStackTransform< TElastix >
   this->m_GridUpsampler->SetRequiredGridSpacing( requiredGridSpacing );
   this->m_GridUpsampler->SetRequiredGridRegion( requiredGridRegion );
   this->m_GridUpsampler->SetRequiredGridDirection( requiredGridDirection );
+  this->m_GridUpsampler->SetNumberOfThreads( this->m_Elastix->GetNumberOfThreads() );
 
   for( unsigned int t = 0; t < this->m_NumberOfSubTransforms; ++t )
   {
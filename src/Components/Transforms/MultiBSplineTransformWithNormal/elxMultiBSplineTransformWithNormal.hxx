@@ -457,6 +457,7 @@ MultiBSplineTransformWithNormal< TElastix >
   this->m_GridUpsampler->SetRequiredGridSpacing( requiredGridSpacing );
   this->m_GridUpsampler->SetRequiredGridRegion( requiredGridRegion );
   this->m_GridUpsampler->SetRequiredGridDirection( requiredGridDirection );
+  this->m_GridUpsampler->SetNumberOfThreads( this->m_Elastix->GetNumberOfThreads() );
 
   typedef itk::Vector< double, itkGetStaticConstMacro( SpaceDimension ) > VectorType;
 
@@ -458,6 +458,13 @@ RecursiveBSplineTransform< TElastix >
   this->m_GridUpsampler->SetRequiredGridRegion( requiredGridRegion );
   this->m_GridUpsampler->SetRequiredGridDirection( requiredGridDirection );
 
+  /** Use the threads of this registration, and possibly the dyadic refinement. */
+  bool useDyadicGridRefinement = false;
+  this->GetConfiguration()->ReadParameter( useDyadicGridRefinement,
+    "UseDyadicGridRefinement", this->GetComponentLabel(), 0, 0, false );
+  this->m_GridUpsampler->SetUseDyadicRefinement( useDyadicGridRefinement && !this->m_Cyclic );
+  this->m_GridUpsampler->SetNumberOfThreads( this->m_Elastix->GetNumberOfThreads() );
+
   /** Compute the upsampled B-spline parameters. */
   ParametersType upsampledParameters;
   this->m_GridUpsampler->UpsampleParameters( latestParameters, upsampledParameters );
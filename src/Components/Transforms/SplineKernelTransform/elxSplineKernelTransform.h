@@ -70,6 +70,20 @@ namespace elastix
  * Default: 0.3. You cannot specify this parameter for each resolution differently.\n
  * Valid values are withing -1.0 and 0.5. 0.5 means incompressible.
  * Negative values are a bit odd, but possible. See Wikipedia on PoissonRatio.
+ * \parameter SplineDecoupledSolve: solve the landmark system once for all
+ * dimensions, instead of one system that is SpaceDimension times larger. This
+ * gives the same result, with much less memory and time. Only used for the
+ * ThinPlateSpline, ThinPlateR2LogRSpline and VolumeSpline.\n
+ *   example: <tt>(SplineDecoupledSolve "true")</tt>\n
+ * Default: false.
+ * \parameter SplineFarFieldThreshold: approximate the contribution of
+ * clusters of landmarks far away from a point, which speeds up the
+ * transformation of points for large landmark sets. A cluster with radius R
+ * at distance r is approximated when R < threshold * r. The error is of
+ * the order threshold^3. A value of 0 gives the exact transform. Only used
+ * for the ThinPlateSpline, ThinPlateR2LogRSpline and VolumeSpline.\n
+ *   example: <tt>(SplineFarFieldThreshold 0.2 )</tt>\n
+ * Default: 0.0.
  *
  * \commandlinearg -fp: a file specifying a set of points that will serve
  * as fixed image landmarks.\n
@@ -104,6 +118,16 @@ namespace elastix
  *   example: <tt>(SplinePoissonRatio 0.3 )</tt>\n
  * Valid values are withing -1.0 and 0.5. 0.5 means incompressible.
  * Negative values are a bit odd, but possible. See Wikipedia on PoissonRatio.
+ * \transformparameter SplineDecoupledSolve: solve the landmark system once
+ * for all dimensions. See the parameter with the same name.\n
+ *   example: <tt>(SplineDecoupledSolve "true")</tt>\n
+ * \transformparameter SplineFarFieldThreshold: approximate the contribution
+ * of clusters of far away landmarks. See the parameter with the same name.
+ * Typically this is set manually for transformix, to speed up the resampling.\n
+ *   example: <tt>(SplineFarFieldThreshold 0.2 )</tt>\n
+ * \transformparameter TPSMatrixInversionMethod: the matrix decomposition
+ * used, one of {SVD, QR}. QR is faster.\n
+ *   example: <tt>(TPSMatrixInversionMethod "QR")</tt>\n
  * \transformparameter FixedImageLandmarks: The landmark positions in the
  * fixed image, in world coordinates. Positions written as x1 y1 [z1] x2 y2 [z2] etc.\n
  *   example: <tt>(FixedImageLandmarks 10.0 11.0 12.0 4.0 4.0 4.0 6.0 6.0 6.0 )</tt>
@@ -236,6 +260,11 @@ protected:
    */
   virtual bool DetermineTargetLandmarks( void );
 
+  /** Read the SplineDecoupledSolve and SplineFarFieldThreshold options
+   * and pass them to the kernel transform.
+   */
+  virtual void ReadLargeLandmarkSetOptions( void );
+
   /** General function to read all landmarks. */
   virtual void ReadLandmarkFile(
     const std::string & filename,
@@ -201,6 +201,9 @@ SplineKernelTransform< TElastix >
     matrixInversionMethod, "TPSMatrixInversionMethod", 0, true );
   this->m_KernelTransform->SetMatrixInversionMethod( matrixInversionMethod );
 
+  /** Set the options for large landmark sets. */
+  this->ReadLargeLandmarkSetOptions();
+
   /** Load fixed image (source) landmark positions. */
   this->DetermineSourceLandmarks();
 
@@ -222,6 +225,30 @@ SplineKernelTransform< TElastix >
 } // end BeforeRegistration()
 
 
+/**
+ * ************************* ReadLargeLandmarkSetOptions *********************
+ */
+
+template< class TElastix >
+void
+SplineKernelTransform< TElastix >
+::ReadLargeLandmarkSetOptions( void )
+{
+  /** Solve the landmark system once for all dimensions. */
+  bool decoupledSolve = false;
+  this->GetConfiguration()->ReadParameter(
+    decoupledSolve, "SplineDecoupledSolve", this->GetComponentLabel(), 0, -1 );
+  this->m_KernelTransform->SetDecoupledSolve( decoupledSolve );
+
+  /** Far-field approximation of TransformPoint(); 0 means exact. */
+  double farFieldThreshold = 0.0;
+  this->GetConfiguration()->ReadParameter(
+    farFieldThreshold, "SplineFarFieldThreshold", this->GetComponentLabel(), 0, -1 );
+  this->m_KernelTransform->SetFarFieldThreshold( farFieldThreshold );
+
+} // end ReadLargeLandmarkSetOptions()
+
+
 /**
  * ************************* DetermineSourceLandmarks *********************
  */
@@ -432,6 +459,18 @@ SplineKernelTransform< TElastix >
     poissonRatio, "SplinePoissonRatio", this->GetComponentLabel(), 0, -1 );
   this->m_KernelTransform->SetPoissonRatio( poissonRatio );
 
+  /** Set the matrix inversion method (one of {SVD, QR}). */
+  std::string matrixInversionMethod = "SVD";
+  this->GetConfiguration()->ReadParameter(
+    matrixInversionMethod, "TPSMatrixInversionMethod", 0, false );
+  this->m_KernelTransform->SetMatrixInversionMethod( matrixInversionMethod );
+
+  /** Set the options for large landmark sets. The inverse of L is only
+   * needed for the Jacobian, i.e. not for transforming points.
+   */
+  this->ReadLargeLandmarkSetOptions();
+  this->m_KernelTransform->SetPrecomputeLInverse( false );
+
   /** Read number of parameters. */
   unsigned int numberOfParameters = 0;
   this->GetConfiguration()->ReadParameter(
@@ -493,6 +532,19 @@ SplineKernelTransform< TElastix >
   xl::xout[ "transpar" ] << "(SplineRelaxationFactor "
                          << this->m_KernelTransform->GetStiffness() << ")" << std::endl;
 
+  /** Write the options for large landmark sets. */
+  xl::xout[ "transpar" ] << "(TPSMatrixInversionMethod \""
+                         << this->m_KernelTransform->GetMatrixInversionMethod() << "\")" << std::endl;
+  std::string decoupledSolve = "false";
+  if( this->m_KernelTransform->GetDecoupledSolve() )
+  {
+    decoupledSolve = "true";
+  }
+  xl::xout[ "transpar" ] << "(SplineDecoupledSolve \""
+                         << decoupledSolve << "\")" << std::endl;
+  xl::xout[ "transpar" ] << "(SplineFarFieldThreshold "
+                         << this->m_KernelTransform->GetFarFieldThreshold() << ")" << std::endl;
+
   /** Write the fixed image landmarks. */
   const ParametersType & fixedParams = this->m_KernelTransform->GetFixedParameters();
   xl::xout[ "transpar" ] << "(FixedImageLandmarks ";
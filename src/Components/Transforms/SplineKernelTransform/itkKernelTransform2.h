@@ -40,6 +40,7 @@ PURPOSE.  See the above copyright notices for more information.
 #include "itkMatrix.h"
 #include "itkPointSet.h"
 #include <deque>
+#include <vector>
 #include <math.h>
 #include "vnl/vnl_matrix_fixed.h"
 #include "vnl/vnl_matrix.h"
@@ -86,6 +87,9 @@ namespace itk
  * - Support for matrix inversion by QR decomposition, instead of SVD.
  *   QR is much faster. Used in SetParameters() and SetFixedParameters().
  * - Much faster Jacobian computation for some of the derived kernel transforms.
+ * - For kernels with G = U(r) * I: a decoupled solve of the landmark system
+ *   and a tree-based far-field approximation of TransformPoint(), which make
+ *   the transform usable for large landmark sets.
  *
  * \ingroup Transforms
  *
@@ -296,6 +300,51 @@ public:
   itkSetMacro( MatrixInversionMethod, std::string );
   itkGetConstReferenceMacro( MatrixInversionMethod, std::string );
 
+  /** Solve the landmark system once for all dimensions. For kernels with
+   * G = U(r) * I (see m_FastComputationPossible) the system L W = Y decouples
+   * into one (N+D+1) x (N+D+1) system with D right-hand sides, instead of one
+   * D(N+D+1) x D(N+D+1) system. This reduces the memory of L and its inverse
+   * by a factor D^2 and the decomposition time by a factor D^3. The result is
+   * the same up to round-off. For other kernels this option is ignored.
+   * Default: false.
+   */
+  virtual void SetDecoupledSolve( bool _arg )
+  {
+    if( this->m_DecoupledSolve != _arg )
+    {
+      this->m_DecoupledSolve               = _arg;
+      this->m_LMatrixComputed              = false;
+      this->m_LInverseComputed             = false;
+      this->m_LMatrixDecompositionComputed = false;
+      this->m_WMatrixComputed              = false;
+      this->Modified();
+    }
+  }
+
+
+  itkGetConstMacro( DecoupledSolve, bool );
+  itkBooleanMacro( DecoupledSolve );
+
+  /** Compute the inverse of L when the source landmarks are set. The inverse
+   * is only needed by GetJacobian(), i.e. during registration. When the
+   * transform is only used to transform points (transformix), this can be
+   * switched off to avoid a second O(N^3) computation. Default: true.
+   */
+  itkSetMacro( PrecomputeLInverse, bool );
+  itkGetConstMacro( PrecomputeLInverse, bool );
+  itkBooleanMacro( PrecomputeLInverse );
+
+  /** Threshold for the tree-based far-field approximation in TransformPoint().
+   * The landmarks are organised in a kd-tree. A cluster of landmarks with
+   * radius R at distance r of the point is replaced by a second order
+   * expansion around its center when R < threshold * r. The relative error
+   * is of the order threshold^3; typical values are 0.1 - 0.3. A value of 0
+   * gives the exact (O(N) per point) evaluation. Only possible for kernels with
+   * G = U(r) * I, for other kernels this option is ignored. Default: 0.
+   */
+  virtual void SetFarFieldThreshold( double threshold );
+  itkGetConstMacro( FarFieldThreshold, double );
+
   /** Must be provided. */
   virtual void GetSpatialJacobian(
     const InputPointType & ipp, SpatialJacobianType & sj ) const
@@ -420,6 +469,30 @@ protected:
     const InputPointType & inputPoint,
     OutputPointType & result ) const;
 
+  /** Compute the radial kernel U(r) and its first and second derivative,
+   * for kernels with G = U(r) * I. Needed for the far-field approximation.
+   */
+  virtual void ComputeRadialKernel( const TScalarType & r, TScalarType & value,
+    TScalarType & derivative, TScalarType & secondDerivative ) const;
+
+  /** Compute the deformation contribution using the far-field approximation. */
+  void ComputeDeformationContributionFarField(
+    const InputPointType & inputPoint,
+    OutputPointType & result ) const;
+
+  /** Build the kd-tree used by the far-field approximation. The tree only
+   * depends on the source landmarks.
+   */
+  void BuildFarFieldTree( void );
+
+  /** Update the weights and moments of the far-field tree nodes from the
+   * deformation coefficients (the D matrix).
+   */
+  void UpdateFarFieldWeights( void );
+
+  /** Compute (if needed) and cache the SVD or QR decomposition of L. */
+  void ComputeLMatrixDecomposition( void );
+
   /** Compute K matrix. */
   void ComputeK( void );
 
@@ -522,6 +595,51 @@ protected:
    */
   bool m_FastComputationPossible;
 
+  /** Returns true if the decoupled solve is requested and possible. */
+  bool GetUseDecoupledSolve( void ) const
+  {
+    return this->m_DecoupledSolve && this->m_FastComputationPossible;
+  }
+
+
+  /** A node of the far-field kd-tree. With c the center of the node and
+   * v_i = p_i - c, the weight is the sum of the deformation coefficients
+   * sum_i d_i of the landmarks in the node, the moment is sum_i d_i v_i^T,
+   * and the second moment of output dimension k is sum_i d_i[k] v_i v_i^T.
+   */
+  struct FarFieldNodeType
+  {
+    InputPointType m_Center;
+    TScalarType    m_Radius;
+    BMatrixType    m_Weight;
+    AMatrixType    m_Moment;
+    AMatrixType    m_SecondMoment[ NDimensions ];
+    unsigned long  m_Begin;
+    unsigned long  m_End;
+    unsigned long  m_Children[ 2 ];
+    bool           m_IsLeaf;
+  };
+
+  /** The far-field kd-tree, with the landmarks and their deformation
+   * coefficients in tree order.
+   */
+  std::vector< FarFieldNodeType > m_FarFieldTree;
+  std::vector< unsigned long >    m_FarFieldIndices;
+  std::vector< InputPointType >   m_FarFieldPoints;
+  std::vector< BMatrixType >      m_FarFieldWeights;
+
+  /** Compares two landmarks, given by their index, along one dimension. */
+  struct FarFieldCompareType
+  {
+    const std::vector< InputPointType > * m_Points;
+    unsigned int                          m_Dimension;
+    bool operator()( const unsigned long a, const unsigned long b ) const
+    {
+      return ( *this->m_Points )[ a ][ this->m_Dimension ]
+             < ( *this->m_Points )[ b ][ this->m_Dimension ];
+    }
+  };
+
 private:
 
   KernelTransform2( const Self & ); // purposely not implemented
@@ -532,6 +650,10 @@ private:
   /** Using SVD or QR decomposition. */
   std::string m_MatrixInversionMethod;
 
+  bool   m_DecoupledSolve;
+  bool   m_PrecomputeLInverse;
+  double m_FarFieldThreshold;
+
 };
 
 } // end namespace itk
@@ -35,6 +35,7 @@ PURPOSE.  See the above copyright notices for more information.
 #define _itkKernelTransform2_hxx
 
 #include "itkKernelTransform2.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -70,6 +71,9 @@ KernelTransform2< TScalarType, NDimensions >
 
   this->m_MatrixInversionMethod   = "SVD";
   this->m_FastComputationPossible = false;
+  this->m_DecoupledSolve          = false;
+  this->m_PrecomputeLInverse      = true;
+  this->m_FarFieldThreshold       = 0.0;
 
   this->m_HasNonZeroSpatialHessian           = true;
   this->m_HasNonZeroJacobianOfSpatialHessian = true;
@@ -112,9 +116,13 @@ KernelTransform2< TScalarType, NDimensions >
     this->m_LMatrixComputed              = false;
     this->m_LInverseComputed             = false;
     this->m_LMatrixDecompositionComputed = false;
+    this->m_FarFieldTree.clear();
 
     // you must recompute L and Linv - this does not require the targ landmarks
-    this->ComputeLInverse();
+    if( this->m_PrecomputeLInverse )
+    {
+      this->ComputeLInverse();
+    }
 
     // Precompute the nonzerojacobianindices vector
     const NumberOfParametersType nrParams = this->GetNumberOfParameters();
@@ -214,6 +222,295 @@ KernelTransform2< TScalarType, NDimensions >
 } // end ComputeDeformationContribution()
 
 
+/**
+ * ******************* ComputeRadialKernel *******************
+ */
+
+template< class TScalarType, unsigned int NDimensions >
+void
+KernelTransform2< TScalarType, NDimensions >
+::ComputeRadialKernel( const TScalarType &, TScalarType &, TScalarType &, TScalarType & ) const
+{
+  itkExceptionMacro( << "ComputeRadialKernel() is not implemented for this kernel." );
+} // end ComputeRadialKernel()
+
+
+/**
+ * ******************* SetFarFieldThreshold *******************
+ */
+
+template< class TScalarType, unsigned int NDimensions >
+void
+KernelTransform2< TScalarType, NDimensions >
+::SetFarFieldThreshold( double threshold )
+{
+  threshold = threshold > 0.0 ? threshold : 0.0;
+  if( this->m_FarFieldThreshold != threshold )
+  {
+    this->m_FarFieldThreshold = threshold;
+    this->Modified();
+  }
+
+  /** Build the tree now if the coefficients are already known. */
+  if( this->m_FarFieldThreshold > 0.0 && this->m_FastComputationPossible
+    && this->m_WMatrixComputed )
+  {
+    if( this->m_FarFieldTree.empty() )
+    {
+      this->BuildFarFieldTree();
+    }
+    this->UpdateFarFieldWeights();
+  }
+
+} // end SetFarFieldThreshold()
+
+
+/**
+ * ******************* BuildFarFieldTree *******************
+ *
+ * The landmarks are recursively split at the median of the
+ * dimension with the largest extent, until at most leafSize
+ * landmarks remain in a node.
+ */
+
+template< class TScalarType, unsigned int NDimensions >
+void
+KernelTransform2< TScalarType, NDimensions >
+::BuildFarFieldTree( void )
+{
+  const unsigned long numberOfLandmarks = this->m_SourceLandmarks->GetNumberOfPoints();
+  const unsigned long leafSize          = 16;
+
+  this->m_FarFieldTree.clear();
+  this->m_FarFieldIndices.resize( numberOfLandmarks );
+  this->m_FarFieldPoints.resize( numberOfLandmarks );
+  if( numberOfLandmarks == 0 )
+  {
+    return;
+  }
+
+  /** Copy the landmarks, in original order. */
+  std::vector< InputPointType > landmarks( numberOfLandmarks );
+  PointsIterator                sp = this->m_SourceLandmarks->GetPoints()->Begin();
+  for( unsigned long lnd = 0; lnd < numberOfLandmarks; ++lnd, ++sp )
+  {
+    landmarks[ lnd ]               = sp->Value();
+    this->m_FarFieldIndices[ lnd ] = lnd;
+  }
+
+  FarFieldNodeType root;
+  root.m_Begin  = 0;
+  root.m_End    = numberOfLandmarks;
+  root.m_IsLeaf = true;
+  this->m_FarFieldTree.push_back( root );
+
+  FarFieldCompareType compare;
+  compare.m_Points = &landmarks;
+
+  std::vector< unsigned long > todo( 1, 0 );
+  while( !todo.empty() )
+  {
+    const unsigned long nodeId = todo.back();
+    todo.pop_back();
+    const unsigned long begin = this->m_FarFieldTree[ nodeId ].m_Begin;
+    const unsigned long end   = this->m_FarFieldTree[ nodeId ].m_End;
+
+    /** Bounding box, center and radius of the node. */
+    InputPointType lower = landmarks[ this->m_FarFieldIndices[ begin ] ];
+    InputPointType upper = lower;
+    for( unsigned long k = begin + 1; k < end; ++k )
+    {
+      const InputPointType & p = landmarks[ this->m_FarFieldIndices[ k ] ];
+      for( unsigned int dim = 0; dim < NDimensions; ++dim )
+      {
+        lower[ dim ] = std::min( lower[ dim ], p[ dim ] );
+        upper[ dim ] = std::max( upper[ dim ], p[ dim ] );
+      }
+    }
+
+    InputPointType center;
+    unsigned int   splitDimension = 0;
+    for( unsigned int dim = 0; dim < NDimensions; ++dim )
+    {
+      center[ dim ] = 0.5 * ( lower[ dim ] + upper[ dim ] );
+      if( upper[ dim ] - lower[ dim ] > upper[ splitDimension ] - lower[ splitDimension ] )
+      {
+        splitDimension = dim;
+      }
+    }
+
+    TScalarType radius = 0.0;
+    for( unsigned long k = begin; k < end; ++k )
+    {
+      radius = std::max( radius, static_cast< TScalarType >(
+        landmarks[ this->m_FarFieldIndices[ k ] ].EuclideanDistanceTo( center ) ) );
+    }
+
+    this->m_FarFieldTree[ nodeId ].m_Center = center;
+    this->m_FarFieldTree[ nodeId ].m_Radius = radius;
+
+    /** Split at the median. */
+    if( end - begin <= leafSize )
+    {
+      continue;
+    }
+    const unsigned long middle = begin + ( end - begin ) / 2;
+    compare.m_Dimension = splitDimension;
+    std::nth_element( this->m_FarFieldIndices.begin() + begin,
+      this->m_FarFieldIndices.begin() + middle,
+      this->m_FarFieldIndices.begin() + end, compare );
+
+    FarFieldNodeType child;
+    child.m_IsLeaf = true;
+    for( unsigned int c = 0; c < 2; ++c )
+    {
+      child.m_Begin = c == 0 ? begin : middle;
+      child.m_End   = c == 0 ? middle : end;
+      this->m_FarFieldTree[ nodeId ].m_Children[ c ] = this->m_FarFieldTree.size();
+      todo.push_back( this->m_FarFieldTree.size() );
+      this->m_FarFieldTree.push_back( child );
+    }
+    this->m_FarFieldTree[ nodeId ].m_IsLeaf = false;
+  }
+
+  /** Store the landmarks in tree order. */
+  for( unsigned long k = 0; k < numberOfLandmarks; ++k )
+  {
+    this->m_FarFieldPoints[ k ] = landmarks[ this->m_FarFieldIndices[ k ] ];
+  }
+
+} // end BuildFarFieldTree()
+
+
+/**
+ * ******************* UpdateFarFieldWeights *******************
+ */
+
+template< class TScalarType, unsigned int NDimensions >
+void
+KernelTransform2< TScalarType, NDimensions >
+::UpdateFarFieldWeights( void )
+{
+  const unsigned long numberOfLandmarks = this->m_FarFieldIndices.size();
+
+  this->m_FarFieldWeights.resize( numberOfLandmarks );
+  for( unsigned long k = 0; k < numberOfLandmarks; ++k )
+  {
+    for( unsigned int dim = 0; dim < NDimensions; ++dim )
+    {
+      this->m_FarFieldWeights[ k ][ dim ]
+        = this->m_DMatrix( dim, this->m_FarFieldIndices[ k ] );
+    }
+  }
+
+  for( unsigned long nodeId = 0; nodeId < this->m_FarFieldTree.size(); ++nodeId )
+  {
+    FarFieldNodeType & node = this->m_FarFieldTree[ nodeId ];
+    node.m_Weight.fill( NumericTraits< TScalarType >::ZeroValue() );
+    node.m_Moment.fill( NumericTraits< TScalarType >::ZeroValue() );
+    for( unsigned int odim = 0; odim < NDimensions; ++odim )
+    {
+      node.m_SecondMoment[ odim ].fill( NumericTraits< TScalarType >::ZeroValue() );
+    }
+
+    for( unsigned long k = node.m_Begin; k < node.m_End; ++k )
+    {
+      const BMatrixType &   w = this->m_FarFieldWeights[ k ];
+      const InputVectorType v = this->m_FarFieldPoints[ k ] - node.m_Center;
+      node.m_Weight += w;
+      for( unsigned int odim = 0; odim < NDimensions; ++odim )
+      {
+        for( unsigned int dim = 0; dim < NDimensions; ++dim )
+        {
+          const TScalarType wv = w[ odim ] * v[ dim ];
+          node.m_Moment( odim, dim ) += wv;
+          for( unsigned int dim2 = 0; dim2 < NDimensions; ++dim2 )
+          {
+            node.m_SecondMoment[ odim ]( dim, dim2 ) += wv * v[ dim2 ];
+          }
+        }
+      }
+    }
+  }
+
+} // end UpdateFarFieldWeights()
+
+
+/**
+ * ******************* ComputeDeformationContributionFarField *******************
+ *
+ * Traverses the tree. For a node that is far enough from the point, the
+ * contribution sum_i U(|x - p_i|) d_i is approximated by a second order
+ * expansion around the center c of the node. With y = x - c, r = |y| and
+ * v_i = p_i - c:
+ *   U(|y - v|) ~ U - U' y^T v / r + (U'' - U' / r) (y^T v)^2 / ( 2 r^2 )
+ *                + U' v^T v / ( 2 r ),
+ * which is summed using the moments of the node. The remaining leaves are
+ * evaluated exactly.
+ */
+
+template< class TScalarType, unsigned int NDimensions >
+void
+KernelTransform2< TScalarType, NDimensions >
+::ComputeDeformationContributionFarField(
+  const InputPointType & thisPoint, OutputPointType & opp ) const
+{
+  /** The tree is balanced, so its depth is far below the stack size. */
+  unsigned long stack[ 128 ];
+  unsigned int  top = 0;
+  stack[ top++ ] = 0;
+
+  TScalarType u, du, d2u;
+  while( top > 0 )
+  {
+    const FarFieldNodeType & node = this->m_FarFieldTree[ stack[ --top ] ];
+    const InputVectorType    y    = thisPoint - node.m_Center;
+    const TScalarType        r    = y.GetNorm();
+
+    if( node.m_Radius < this->m_FarFieldThreshold * r )
+    {
+      this->ComputeRadialKernel( r, u, du, d2u );
+      const TScalarType duOverR = du / r;
+      const TScalarType c2      = 0.5 * ( d2u - duOverR ) / ( r * r );
+      for( unsigned int odim = 0; odim < NDimensions; ++odim )
+      {
+        const AMatrixType & m2  = node.m_SecondMoment[ odim ];
+        TScalarType         tmp = u * node.m_Weight[ odim ];
+        for( unsigned int dim = 0; dim < NDimensions; ++dim )
+        {
+          TScalarType m2y = 0.0;
+          for( unsigned int dim2 = 0; dim2 < NDimensions; ++dim2 )
+          {
+            m2y += m2( dim, dim2 ) * y[ dim2 ];
+          }
+          tmp += ( c2 * m2y - duOverR * node.m_Moment( odim, dim ) ) * y[ dim ]
+            + 0.5 * duOverR * m2( dim, dim );
+        }
+        opp[ odim ] += tmp;
+      }
+    }
+    else if( node.m_IsLeaf )
+    {
+      for( unsigned long k = node.m_Begin; k < node.m_End; ++k )
+      {
+        this->ComputeRadialKernel(
+          thisPoint.EuclideanDistanceTo( this->m_FarFieldPoints[ k ] ), u, du, d2u );
+        for( unsigned int odim = 0; odim < NDimensions; ++odim )
+        {
+          opp[ odim ] += u * this->m_FarFieldWeights[ k ][ odim ];
+        }
+      }
+    }
+    else
+    {
+      stack[ top++ ] = node.m_Children[ 0 ];
+      stack[ top++ ] = node.m_Children[ 1 ];
+    }
+  }
+
+} // end ComputeDeformationContributionFarField()
+
+
 /**
  * ******************* ComputeD *******************
  */
@@ -259,35 +556,72 @@ KernelTransform2< TScalarType, NDimensions >
   this->ComputeY();
 
   /** L matrix decomposition and solving for Y matrix. */
-  if( this->m_MatrixInversionMethod == "SVD" )
+  this->ComputeLMatrixDecomposition();
+  if( this->GetUseDecoupledSolve() )
   {
-    if( !this->m_LMatrixDecompositionComputed )
+    /** One scalar system, with a right-hand side per dimension. */
+    this->m_WMatrix.set_size( this->m_YMatrix.rows(), NDimensions );
+    for( unsigned int dim = 0; dim < NDimensions; ++dim )
     {
-      if( this->m_LMatrixDecompositionSVD != 0 )
+      if( this->m_MatrixInversionMethod == "SVD" )
       {
-        delete this->m_LMatrixDecompositionSVD;
+        this->m_WMatrix.set_column( dim,
+          this->m_LMatrixDecompositionSVD->solve( this->m_YMatrix.get_column( dim ) ) );
       }
+      else
+      {
+        this->m_WMatrix.set_column( dim,
+          this->m_LMatrixDecompositionQR->solve( this->m_YMatrix.get_column( dim ) ) );
+      }
+    }
+  }
+  else if( this->m_MatrixInversionMethod == "SVD" )
+  {
+    this->m_WMatrix = this->m_LMatrixDecompositionSVD->solve( this->m_YMatrix );
+  }
+  else
+  {
+    this->m_WMatrix = this->m_LMatrixDecompositionQR->solve( this->m_YMatrix );
+  }
+
+  /** Reorganize W. */
+  this->ReorganizeW();
+  this->m_WMatrixComputed = true;
+
+} // end ComputeWMatrix()
+
+
+/**
+ * ******************* ComputeLMatrixDecomposition *******************
+ *
+ * The decompositions are cached for performance reasons during registration.
+ * In every iteration SetParameters() is called, which in turn calls
+ * ComputeWMatrix(). The L matrix is not changed however, and therefore
+ * it is not needed to redo the decomposition.
+ */
+
+template< class TScalarType, unsigned int NDimensions >
+void
+KernelTransform2< TScalarType, NDimensions >
+::ComputeLMatrixDecomposition( void )
+{
+  if( this->m_MatrixInversionMethod == "SVD" )
+  {
+    if( !this->m_LMatrixDecompositionComputed || this->m_LMatrixDecompositionSVD == 0 )
+    {
+      delete this->m_LMatrixDecompositionSVD;
       this->m_LMatrixDecompositionSVD      = new SVDDecompositionType( this->m_LMatrix, 1e-8 );
       this->m_LMatrixDecompositionComputed = true;
     }
-    this->m_WMatrix = this->m_LMatrixDecompositionSVD->solve( this->m_YMatrix );
-    //vnl_svd<TScalarType> svd( this->m_LMatrix, 1e-8 );
-    //this->m_WMatrix = svd.solve( this->m_YMatrix );
   }
   else if( this->m_MatrixInversionMethod == "QR" )
   {
-    if( !this->m_LMatrixDecompositionComputed )
+    if( !this->m_LMatrixDecompositionComputed || this->m_LMatrixDecompositionQR == 0 )
     {
-      if( this->m_LMatrixDecompositionQR != 0 )
-      {
-        delete this->m_LMatrixDecompositionQR;
-      }
+      delete this->m_LMatrixDecompositionQR;
       this->m_LMatrixDecompositionQR       = new QRDecompositionType( this->m_LMatrix );
       this->m_LMatrixDecompositionComputed = true;
     }
-    this->m_WMatrix = this->m_LMatrixDecompositionQR->solve( this->m_YMatrix );
-//     vnl_qr<TScalarType> qr( this->m_LMatrix );
-//     this->m_WMatrix = qr.solve( this->m_YMatrix );
   }
   else
   {
@@ -295,11 +629,7 @@ KernelTransform2< TScalarType, NDimensions >
                        << this->m_MatrixInversionMethod << ")" );
   }
 
-  /** Reorganize W. */
-  this->ReorganizeW();
-  this->m_WMatrixComputed = true;
-
-} // end ComputeWMatrix()
+} // end ComputeLMatrixDecomposition()
 
 
 /**
@@ -316,6 +646,24 @@ KernelTransform2< TScalarType, NDimensions >
     this->ComputeL();
   }
 
+  /** The decoupled L is small, so reuse its decomposition, which
+   * is needed anyway by ComputeWMatrix().
+   */
+  if( this->GetUseDecoupledSolve() )
+  {
+    this->ComputeLMatrixDecomposition();
+    if( this->m_MatrixInversionMethod == "SVD" )
+    {
+      this->m_LMatrixInverse = this->m_LMatrixDecompositionSVD->inverse();
+    }
+    else
+    {
+      this->m_LMatrixInverse = this->m_LMatrixDecompositionQR->inverse();
+    }
+    this->m_LInverseComputed = true;
+    return;
+  }
+
   if( this->m_MatrixInversionMethod == "SVD" )
   {
     //this->m_LMatrixInverse = vnl_matrix_inverse<TScalarType>( this->m_LMatrix );
@@ -347,6 +695,54 @@ KernelTransform2< TScalarType, NDimensions >
 ::ComputeL( void )
 {
   const unsigned long       numberOfLandmarks = this->m_SourceLandmarks->GetNumberOfPoints();
+
+  /** For kernels with G = U(r) * I the system decouples into the scalar
+   * system L = [ K P; P^T 0 ], with K_ij = U(|p_i - p_j|) and P_i = [ p_i^T 1 ],
+   * which is the same for each dimension.
+   */
+  if( this->GetUseDecoupledSolve() )
+  {
+    const unsigned long size = numberOfLandmarks + NDimensions + 1;
+    this->m_LMatrix.set_size( size, size );
+    this->m_LMatrix.fill( 0.0 );
+
+    GMatrixType    G;
+    PointsIterator p1  = this->m_SourceLandmarks->GetPoints()->Begin();
+    PointsIterator end = this->m_SourceLandmarks->GetPoints()->End();
+    unsigned long  i   = 0;
+    while( p1 != end )
+    {
+      this->ComputeReflexiveG( p1, G );
+      this->m_LMatrix( i, i ) = G( 0, 0 );
+
+      PointsIterator p2 = p1;
+      ++p2;
+      for( unsigned long j = i + 1; p2 != end; ++p2, ++j )
+      {
+        this->ComputeG( p1.Value() - p2.Value(), G );
+        this->m_LMatrix( i, j ) = G( 0, 0 );
+        this->m_LMatrix( j, i ) = G( 0, 0 );
+      }
+
+      const InputPointType & p = p1.Value();
+      for( unsigned int dim = 0; dim < NDimensions; ++dim )
+      {
+        this->m_LMatrix( i, numberOfLandmarks + dim ) = p[ dim ];
+        this->m_LMatrix( numberOfLandmarks + dim, i ) = p[ dim ];
+      }
+      this->m_LMatrix( i, numberOfLandmarks + NDimensions ) = 1.0;
+      this->m_LMatrix( numberOfLandmarks + NDimensions, i ) = 1.0;
+      ++p1; ++i;
+    }
+
+    /** K and P are not needed in this case. */
+    this->m_KMatrix.clear();
+    this->m_PMatrix.clear();
+    this->m_LMatrixComputed              = true;
+    this->m_LMatrixDecompositionComputed = false;
+    return;
+  }
+
   vnl_matrix< TScalarType > O2( NDimensions * ( NDimensions + 1 ),
   NDimensions * ( NDimensions + 1 ), 0 );
 
@@ -462,6 +858,22 @@ KernelTransform2< TScalarType, NDimensions >
   typename VectorSetType::ConstIterator displacement = this->m_Displacements->Begin();
   const unsigned long numberOfLandmarks = this->m_SourceLandmarks->GetNumberOfPoints();
 
+  /** Decoupled system: one column per dimension. */
+  if( this->GetUseDecoupledSolve() )
+  {
+    this->m_YMatrix.set_size( numberOfLandmarks + NDimensions + 1, NDimensions );
+    this->m_YMatrix.fill( 0.0 );
+    for( unsigned long i = 0; i < numberOfLandmarks; i++ )
+    {
+      for( unsigned int j = 0; j < NDimensions; j++ )
+      {
+        this->m_YMatrix.put( i, j, displacement.Value()[ j ] );
+      }
+      displacement++;
+    }
+    return;
+  }
+
   this->m_YMatrix.set_size( NDimensions * ( numberOfLandmarks + NDimensions + 1 ), 1 );
   this->m_YMatrix.fill( 0.0 );
 
@@ -495,35 +907,71 @@ KernelTransform2< TScalarType, NDimensions >
 
   // The deformable (non-affine) part of the registration goes here
   this->m_DMatrix.set_size( NDimensions, numberOfLandmarks );
-  unsigned int ci = 0;
 
-  for( unsigned long lnd = 0; lnd < numberOfLandmarks; lnd++ )
+  if( this->GetUseDecoupledSolve() )
   {
-    for( unsigned int dim = 0; dim < NDimensions; dim++ )
+    // W holds one column per dimension
+    for( unsigned long lnd = 0; lnd < numberOfLandmarks; lnd++ )
     {
-      this->m_DMatrix( dim, lnd ) = this->m_WMatrix( ci++, 0 );
+      for( unsigned int dim = 0; dim < NDimensions; dim++ )
+      {
+        this->m_DMatrix( dim, lnd ) = this->m_WMatrix( lnd, dim );
+      }
+    }
+    for( unsigned int j = 0; j < NDimensions; j++ )
+    {
+      for( unsigned int i = 0; i < NDimensions; i++ )
+      {
+        this->m_AMatrix( i, j ) = this->m_WMatrix( numberOfLandmarks + j, i );
+      }
+    }
+    for( unsigned int k = 0; k < NDimensions; k++ )
+    {
+      this->m_BVector( k ) = this->m_WMatrix( numberOfLandmarks + NDimensions, k );
     }
   }
-
-  // This matrix holds the rotational part of the Affine component
-  for( unsigned int j = 0; j < NDimensions; j++ )
+  else
   {
-    for( unsigned int i = 0; i < NDimensions; i++ )
+    unsigned int ci = 0;
+
+    for( unsigned long lnd = 0; lnd < numberOfLandmarks; lnd++ )
     {
-      this->m_AMatrix( i, j ) = this->m_WMatrix( ci++, 0 );
+      for( unsigned int dim = 0; dim < NDimensions; dim++ )
+      {
+        this->m_DMatrix( dim, lnd ) = this->m_WMatrix( ci++, 0 );
+      }
     }
-  }
 
-  // This vector holds the translational part of the Affine component
-  for( unsigned int k = 0; k < NDimensions; k++ )
-  {
-    this->m_BVector( k ) = this->m_WMatrix( ci++, 0 );
+    // This matrix holds the rotational part of the Affine component
+    for( unsigned int j = 0; j < NDimensions; j++ )
+    {
+      for( unsigned int i = 0; i < NDimensions; i++ )
+      {
+        this->m_AMatrix( i, j ) = this->m_WMatrix( ci++, 0 );
+      }
+    }
+
+    // This vector holds the translational part of the Affine component
+    for( unsigned int k = 0; k < NDimensions; k++ )
+    {
+      this->m_BVector( k ) = this->m_WMatrix( ci++, 0 );
+    }
   }
 
   // release WMatrix memory by assigning a small one.
   this->m_WMatrix         = WMatrixType( 1, 1 );
   this->m_WMatrixComputed = true;
 
+  // update the far-field tree with the new coefficients
+  if( this->m_FarFieldThreshold > 0.0 && this->m_FastComputationPossible )
+  {
+    if( this->m_FarFieldTree.empty() )
+    {
+      this->BuildFarFieldTree();
+    }
+    this->UpdateFarFieldWeights();
+  }
+
 } // end ReorganizeW()
 
 
@@ -538,7 +986,14 @@ KernelTransform2< TScalarType, NDimensions >
 {
   OutputPointType opp;
   opp.Fill( NumericTraits< typename OutputPointType::ValueType >::ZeroValue() );
-  this->ComputeDeformationContribution( thisPoint, opp );
+  if( this->m_FarFieldThreshold > 0.0 && !this->m_FarFieldTree.empty() )
+  {
+    this->ComputeDeformationContributionFarField( thisPoint, opp );
+  }
+  else
+  {
+    this->ComputeDeformationContribution( thisPoint, opp );
+  }
 
   // Add the rotational part of the Affine component
   for( unsigned int j = 0; j < NDimensions; j++ )
@@ -665,9 +1120,13 @@ KernelTransform2< TScalarType, NDimensions >
   this->m_LMatrixComputed              = false;
   this->m_LInverseComputed             = false;
   this->m_LMatrixDecompositionComputed = false;
+  this->m_FarFieldTree.clear();
 
   // you must recompute L and Linv - this does not require the targ lms
-  this->ComputeLInverse();
+  if( this->m_PrecomputeLInverse )
+  {
+    this->ComputeLInverse();
+  }
 
 } // end SetFixedParameters()
 
@@ -755,6 +1214,17 @@ KernelTransform2< TScalarType, NDimensions >
   NonZeroJacobianIndicesType & nonZeroJacobianIndices ) const
 {
   const unsigned long numberOfLandmarks = this->m_SourceLandmarks->GetNumberOfPoints();
+
+  /** The inverse of L is needed, with the layout of the current solve. */
+  const bool          decoupled = this->GetUseDecoupledSolve();
+  const unsigned long lSize     = ( numberOfLandmarks + NDimensions + 1 )
+    * ( decoupled ? 1 : NDimensions );
+  if( this->m_LMatrixInverse.rows() != lSize )
+  {
+    itkExceptionMacro( << "The inverse of the L matrix is not available. "
+                       << "Call ComputeLInverse() or switch on PrecomputeLInverse." );
+  }
+
   jac.SetSize( NDimensions, numberOfLandmarks * NDimensions );
   jac.Fill( 0.0 );
   GMatrixType    Gmatrix, GMatrixSym; // dim x dim
@@ -814,6 +1284,9 @@ KernelTransform2< TScalarType, NDimensions >
     //
     // C) For all kernels, both Linv and G are symmetric.
     //    Reduces memory access to Linv by a factor 2.
+    //
+    // With the decoupled solve only the scalar Linv is stored, i.e. one
+    // value per block, so the block index is used instead of lnd * d.
   else
   {
     // Precompute G's.
@@ -834,8 +1307,9 @@ KernelTransform2< TScalarType, NDimensions >
       ScalarType g = gVector[ lnd ];
 
       // Property C: First process the diagonal only
-      unsigned int lIdx = lnd * NDimensions;
-      ScalarType   linv = this->m_LMatrixInverse[ lIdx ][ lIdx ];
+      const unsigned int stride = decoupled ? 1 : NDimensions;
+      unsigned int       lIdx   = lnd * NDimensions;
+      ScalarType         linv   = this->m_LMatrixInverse[ lnd * stride ][ lnd * stride ];
       // Property B: only access non-zero values
       for( unsigned int dim = 0; dim < NDimensions; dim++ )
       {
@@ -850,7 +1324,7 @@ KernelTransform2< TScalarType, NDimensions >
 
         // Property B: only access non-zero values
         unsigned int lIdx = lidx * NDimensions;
-        ScalarType   linv = this->m_LMatrixInverse[ lnd * NDimensions ][ lIdx ];
+        ScalarType   linv = this->m_LMatrixInverse[ lnd * stride ][ lidx * stride ];
 
         // Property B: only access non-zero values
         for( unsigned int dim = 0; dim < NDimensions; dim++ )
@@ -866,19 +1340,38 @@ KernelTransform2< TScalarType, NDimensions >
     }
 
     // Affine part of the transform:
-    for( unsigned int odim = 0; odim < NDimensions; odim++ )
+    if( decoupled )
     {
-      const unsigned long index = ( numberOfLandmarks + NDimensions ) * NDimensions + odim;
-
-      for( unsigned long lidx = 0; lidx < numberOfLandmarks * NDimensions; lidx++ )
+      // The affine contribution is the same for each dimension
+      for( unsigned long lidx = 0; lidx < numberOfLandmarks; lidx++ )
       {
-        ScalarType tmp = 0.0;
+        ScalarType tmp = this->m_LMatrixInverse[ numberOfLandmarks + NDimensions ][ lidx ];
         for( unsigned int dim = 0; dim < NDimensions; dim++ )
         {
-          unsigned int indtmp = ( numberOfLandmarks + dim ) * NDimensions + odim;
-          tmp += p[ dim ] * this->m_LMatrixInverse[ indtmp ][ lidx ];
+          tmp += p[ dim ] * this->m_LMatrixInverse[ numberOfLandmarks + dim ][ lidx ];
+        }
+        for( unsigned int odim = 0; odim < NDimensions; odim++ )
+        {
+          jac[ odim ][ lidx * NDimensions + odim ] += tmp;
+        }
+      }
+    }
+    else
+    {
+      for( unsigned int odim = 0; odim < NDimensions; odim++ )
+      {
+        const unsigned long index = ( numberOfLandmarks + NDimensions ) * NDimensions + odim;
+
+        for( unsigned long lidx = 0; lidx < numberOfLandmarks * NDimensions; lidx++ )
+        {
+          ScalarType tmp = 0.0;
+          for( unsigned int dim = 0; dim < NDimensions; dim++ )
+          {
+            unsigned int indtmp = ( numberOfLandmarks + dim ) * NDimensions + odim;
+            tmp += p[ dim ] * this->m_LMatrixInverse[ indtmp ][ lidx ];
+          }
+          jac[ odim ][ lidx ] += tmp + this->m_LMatrixInverse[ index ][ lidx ];
         }
-        jac[ odim ][ lidx ] += tmp + this->m_LMatrixInverse[ index ][ lidx ];
       }
     }
   } // end if this->m_FastComputationPossible
@@ -923,6 +1416,14 @@ KernelTransform2< TScalarType, NDimensions >
      << this->m_PoissonRatio << std::endl;
   os << indent << "MatrixInversionMethod: "
      << this->m_MatrixInversionMethod << std::endl;
+  os << indent << "DecoupledSolve: "
+     << this->m_DecoupledSolve << std::endl;
+  os << indent << "PrecomputeLInverse: "
+     << this->m_PrecomputeLInverse << std::endl;
+  os << indent << "FarFieldThreshold: "
+     << this->m_FarFieldThreshold << std::endl;
+  os << indent << "FarFieldTree: "
+     << this->m_FarFieldTree.size() << " nodes" << std::endl;
 
   /** Just print the sizes of these matrices, not their contents. */
   os << indent << "LMatrix: " << this->m_LMatrix.rows()
@@ -119,6 +119,12 @@ protected:
   virtual void ComputeDeformationContribution( const InputPointType & inputPoint,
     OutputPointType & result ) const;
 
+  /** Compute the radial kernel U(r) = r^2 log(r) and its derivatives
+   * U'(r) = r ( 2 log(r) + 1 ) and U''(r) = 2 log(r) + 3.
+   */
+  virtual void ComputeRadialKernel( const TScalarType & r, TScalarType & value,
+    TScalarType & derivative, TScalarType & secondDerivative ) const;
+
 private:
 
   ThinPlateR2LogRSplineKernelTransform2( const Self & ); // purposely not implemented
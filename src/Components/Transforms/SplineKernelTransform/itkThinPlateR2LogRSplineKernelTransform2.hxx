@@ -77,6 +77,27 @@ ThinPlateR2LogRSplineKernelTransform2< TScalarType, NDimensions >::ComputeDeform
 }
 
 
+template< class TScalarType, unsigned int NDimensions >
+void
+ThinPlateR2LogRSplineKernelTransform2< TScalarType, NDimensions >::ComputeRadialKernel( const TScalarType & r,
+  TScalarType & value, TScalarType & derivative, TScalarType & secondDerivative ) const
+{
+  if( r > 1e-8 )
+  {
+    const TScalarType logR = vcl_log( r );
+    value            = r * r * logR;
+    derivative       = r * ( 2.0 * logR + 1.0 );
+    secondDerivative = 2.0 * logR + 3.0;
+  }
+  else
+  {
+    value            = NumericTraits< TScalarType >::Zero;
+    derivative       = NumericTraits< TScalarType >::Zero;
+    secondDerivative = NumericTraits< TScalarType >::Zero;
+  }
+}
+
+
 } // namespace itk
 
 #endif
@@ -121,6 +121,16 @@ protected:
   virtual void ComputeDeformationContribution(
     const InputPointType & inputPoint, OutputPointType & result ) const;
 
+  /** Compute the radial kernel U(r) = r and its derivatives. */
+  virtual void ComputeRadialKernel( const TScalarType & r, TScalarType & value,
+    TScalarType & derivative, TScalarType & secondDerivative ) const
+  {
+    value            = r;
+    derivative       = NumericTraits< TScalarType >::OneValue();
+    secondDerivative = NumericTraits< TScalarType >::ZeroValue();
+  }
+
+
 private:
 
   ThinPlateSplineKernelTransform2( const Self & ); // purposely not implemented
@@ -119,6 +119,16 @@ protected:
   virtual void ComputeDeformationContribution( const InputPointType & inputPoint,
     OutputPointType & result ) const;
 
+  /** Compute the radial kernel U(r) = r^3 and its derivatives. */
+  virtual void ComputeRadialKernel( const TScalarType & r, TScalarType & value,
+    TScalarType & derivative, TScalarType & secondDerivative ) const
+  {
+    value            = r * r * r;
+    derivative       = 3.0 * r * r;
+    secondDerivative = 6.0 * r;
+  }
+
+
 private:
 
   VolumeSplineKernelTransform2( const Self & ); // purposely not implemented
@@ -24,6 +24,9 @@
 #include "elxBaseComponentSE.h"
 #include "itkObject.h"
 #include "itkMultiResolutionPyramidImageFilter.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
 
 namespace elastix
 {
@@ -49,6 +52,18 @@ namespace elastix
  * \parameter WritePyramidImagesAfterEachResolution: ...\n
  *    example: <tt>(WritePyramidImagesAfterEachResolution "true")</tt>\n
  *    default "false".
+ * \parameter ComputePyramidImagesPerResolution: Flag to specify if all resolution levels are computed
+ *    at once, or per resolution. The latter saves memory, since the images of the other resolutions
+ *    are released. The generic and the smoothing pyramid compute the images of a resolution
+ *    at the start of that resolution. The recursive pyramid derives each level from the next
+ *    finer level, so it still computes all levels at once, but releases the finished levels.\n
+ *    example: <tt>(ComputePyramidImagesPerResolution "true")</tt>\n
+ *    Default false.
+ *
+ * After the registration, the peak memory used by the pyramid images is reported.
+ *
+ * With the UseComputationCache parameter of ElastixBase, the pyramid images are
+ * reused by the next registrations that use the same pyramid and schedule.
  *
  * \ingroup ImagePyramids
  * \ingroup ComponentBaseClasses
@@ -85,6 +100,9 @@ public:
   /** Typedef's from ITKBaseType. */
   typedef typename ITKBaseType::ScheduleType ScheduleType;
 
+  /** Typedef for the cache that is shared by the registrations. */
+  typedef typename ElastixType::ComputationCacheType ComputationCacheType;
+
   /** Cast to ITKBaseType. */
   virtual ITKBaseType * GetAsITKBaseType( void )
   {
@@ -100,15 +118,33 @@ public:
 
 
   /** Execute stuff before the actual registration:
+   * \li Read whether the pyramid images are computed per resolution.
    * \li Set the schedule of the fixed image pyramid.
    */
   virtual void BeforeRegistrationBase( void );
 
   /** Execute stuff before each resolution:
+   * \li Set the current level of the pyramid.
    * \li Write the pyramid image to file.
    */
   virtual void BeforeEachResolutionBase( void );
 
+  /** Execute stuff after each resolution:
+   * \li Keep track of the memory used by the pyramid images.
+   */
+  virtual void AfterEachResolutionBase( void );
+
+  /** Execute stuff after the registration:
+   * \li Report the peak memory used by the pyramid images.
+   */
+  virtual void AfterRegistrationBase( void );
+
+  /** Get the number of bytes of the pyramid images that are held in memory.
+   * A buffer that is shared by several levels is counted once, and a buffer
+   * that is shared with the input image is not counted.
+   */
+  virtual std::size_t GetPyramidImagesMemorySize( void );
+
   /** Method for setting the schedule. */
   virtual void SetFixedSchedule( void );
 
@@ -119,10 +155,44 @@ public:
 protected:
 
   /** The constructor. */
-  FixedImagePyramidBase() {}
+  FixedImagePyramidBase();
   /** The destructor. */
   virtual ~FixedImagePyramidBase() {}
 
+  /** Set the current level of the pyramid. Pyramids that can compute the
+   * levels separately override this function. The default does nothing.
+   */
+  virtual void SetCurrentPyramidLevel( const unsigned int itkNotUsed( level ) ) {}
+
+  /** Release the image of a level, and let it request an empty region, so
+   * that it does not trigger a new execution of the pyramid.
+   */
+  virtual void ReleasePyramidImage( const unsigned int level );
+
+  /** Graft the images of the requested levels from the computation cache
+   * that is shared by the registrations. Returns false, without changing
+   * the outputs, if one of them is not in the cache. Pyramids call this
+   * function in GenerateData(), before computing the images.
+   */
+  virtual bool GraftCachedPyramidImages( void );
+
+  /** Store the computed images in the computation cache. Pyramids call
+   * this function in GenerateData(), after computing the images.
+   */
+  virtual void AddPyramidImagesToCache( void );
+
+  /** The description of the operation that computes the image of a level,
+   * which is used as key in the computation cache. It contains the name of
+   * the pyramid and the schedule. Pyramids with more settings append them
+   * in WritePyramidCacheSettings().
+   */
+  virtual std::string GetPyramidCacheOperation( const unsigned int level ) const;
+
+  virtual void WritePyramidCacheSettings( std::ostream & itkNotUsed( os ) ) const {}
+
+  bool        m_ComputePyramidImagesPerResolution;
+  std::size_t m_PeakPyramidImagesMemorySize;
+
 private:
 
   /** The private constructor. */
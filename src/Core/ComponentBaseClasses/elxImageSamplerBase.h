@@ -25,6 +25,9 @@
 #include "elxBaseComponentSE.h"
 
 #include "itkImageSamplerBase.h"
+#include "itkImageMaskSpatialObject.h"
+#include <ostream>
+#include <string>
 
 namespace elastix
 {
@@ -36,6 +39,11 @@ namespace elastix
  *
  * This class contains all the common functionality for ImageSamplers.
  *
+ * With the UseComputationCache parameter of ElastixBase, samplers that
+ * always select the same samples, such as the grid and the full sampler,
+ * reuse the samples of earlier registrations with the same fixed image,
+ * mask and settings.
+ *
  * \ingroup ImageSamplers
  * \ingroup ComponentBaseClasses
  */
@@ -66,6 +74,13 @@ public:
   /** ITKBaseType. */
   typedef itk::ImageSamplerBase< InputImageType > ITKBaseType;
 
+  /** Typedefs for the samples that are stored in the computation cache. */
+  typedef typename ElastixType::ComputationCacheType     ComputationCacheType;
+  typedef typename ITKBaseType::ImageSampleContainerType ImageSampleContainerType;
+  typedef typename ITKBaseType::MaskType                 MaskType;
+  typedef itk::ImageMaskSpatialObject<
+    InputImageType::ImageDimension >                     ImageMaskSpatialObjectType;
+
   /** Cast to ITKBaseType. */
   virtual ITKBaseType * GetAsITKBaseType( void )
   {
@@ -93,6 +108,29 @@ protected:
   /** The destructor. */
   virtual ~ImageSamplerBase() {}
 
+  /** Copy the samples from the computation cache that is shared by the
+   * registrations. Returns false, without changing the output, if they are
+   * not in the cache. Samplers that select the same samples every time call
+   * this function in GenerateData(), before selecting the samples.
+   */
+  virtual bool CopyCachedSamples( void );
+
+  /** Store a copy of the selected samples in the computation cache.
+   * Samplers call this function in GenerateData(), after selecting the samples.
+   */
+  virtual void AddSamplesToCache( void );
+
+  /** Get the key of the samples in the computation cache: the pixel buffer
+   * of the input image, the mask image, and a description of the region,
+   * the image geometry and the settings. Returns false if the samples
+   * cannot be cached, for example because the mask is not an image.
+   */
+  virtual bool GetSamplesCacheKey( const itk::Object * & object,
+    const itk::Object * & maskObject, std::string & operation );
+
+  /** Samplers with settings write them in this function. */
+  virtual void WriteSamplerCacheSettings( std::ostream & itkNotUsed( os ) ) const {}
+
 private:
 
   /** The private constructor. */
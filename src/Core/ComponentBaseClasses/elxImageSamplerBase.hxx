@@ -20,6 +20,7 @@
 #define __elxImageSamplerBase_hxx
 
 #include "elxImageSamplerBase.h"
+#include <sstream>
 
 namespace elastix
 {
@@ -67,6 +68,112 @@ ImageSamplerBase< TElastix >
 } // end BeforeEachResolutionBase()
 
 
+/**
+ * ******************* CopyCachedSamples ******************
+ */
+
+template< class TElastix >
+bool
+ImageSamplerBase< TElastix >
+::CopyCachedSamples( void )
+{
+  ComputationCacheType * cache = this->GetElastix()->GetComputationCache();
+  const itk::Object *    object     = 0;
+  const itk::Object *    maskObject = 0;
+  std::string            operation;
+  if( !cache || !this->GetSamplesCacheKey( object, maskObject, operation ) )
+  {
+    return false;
+  }
+
+  itk::Object::Pointer cachedObject = cache->Find( object, operation, maskObject );
+  const ImageSampleContainerType * cachedSamples
+    = dynamic_cast< const ImageSampleContainerType * >( cachedObject.GetPointer() );
+  if( !cachedSamples ) { return false; }
+
+  this->GetAsITKBaseType()->GetOutput()->CastToSTLContainer()
+    = cachedSamples->CastToSTLConstContainer();
+  return true;
+
+} // end CopyCachedSamples()
+
+
+/**
+ * ******************* AddSamplesToCache ******************
+ */
+
+template< class TElastix >
+void
+ImageSamplerBase< TElastix >
+::AddSamplesToCache( void )
+{
+  ComputationCacheType * cache = this->GetElastix()->GetComputationCache();
+  const itk::Object *    object     = 0;
+  const itk::Object *    maskObject = 0;
+  std::string            operation;
+  if( !cache || !this->GetSamplesCacheKey( object, maskObject, operation ) )
+  {
+    return;
+  }
+
+  /** Store a copy, since the output is cleared when the sampler is executed again. */
+  typename ImageSampleContainerType::Pointer cachedSamples = ImageSampleContainerType::New();
+  cachedSamples->CastToSTLContainer()
+    = this->GetAsITKBaseType()->GetOutput()->CastToSTLConstContainer();
+  cache->Add( object, operation, cachedSamples, maskObject );
+
+} // end AddSamplesToCache()
+
+
+/**
+ * ******************* GetSamplesCacheKey ******************
+ */
+
+template< class TElastix >
+bool
+ImageSamplerBase< TElastix >
+::GetSamplesCacheKey( const itk::Object * & object,
+  const itk::Object * & maskObject, std::string & operation )
+{
+  ITKBaseType *          sampler = this->GetAsITKBaseType();
+  const InputImageType * input   = sampler->GetInput();
+  if( !input || !input->GetPixelContainer() ) { return false; }
+
+  /** The samples depend on the mask image, which is kept by the cache. */
+  object     = input->GetPixelContainer();
+  maskObject = 0;
+  const MaskType * mask = sampler->GetMask();
+  if( mask )
+  {
+    const ImageMaskSpatialObjectType * imageMask
+      = dynamic_cast< const ImageMaskSpatialObjectType * >( mask );
+    if( !imageMask || !imageMask->GetImage() ) { return false; }
+    maskObject = imageMask->GetImage();
+  }
+
+  /** The coordinates of the samples depend on the geometry of the image. */
+  std::ostringstream key;
+  key << this->elxGetClassName()
+      << " index " << sampler->GetInputImageRegion().GetIndex()
+      << " size " << sampler->GetInputImageRegion().GetSize()
+      << " origin " << input->GetOrigin()
+      << " spacing " << input->GetSpacing()
+      << " direction";
+  for( unsigned int i = 0; i < InputImageType::ImageDimension; ++i )
+  {
+    for( unsigned int j = 0; j < InputImageType::ImageDimension; ++j )
+    {
+      key << " " << input->GetDirection()[ i ][ j ];
+    }
+  }
+  this->WriteSamplerCacheSettings( key );
+  operation = key.str();
+
+  return true;
+
+} // end GetSamplesCacheKey()
+
+
 } // end namespace elastix
 
 #endif //#ifndef __elxImageSamplerBase_hxx
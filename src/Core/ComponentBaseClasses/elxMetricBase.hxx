@@ -171,14 +171,13 @@ MetricBase< TElastix >
     thisAsAdvanced->SetUseMultiThread( useMultiThreading );
     if( useMultiThreading )
     {
-      std::string tmp = this->m_Configuration->GetCommandLineArgument( "-threads" );
-      if( tmp != "" )
-      {
-        const unsigned int nrOfThreads = atoi( tmp.c_str() );
-        thisAsAdvanced->SetNumberOfThreads( nrOfThreads );
-      }
+      /** Use the current share of the threads of the process. */
+      thisAsAdvanced->SetNumberOfThreads( this->GetElastix()->GetNumberOfThreads() );
     }
 
+    /** Reuse the image extrema of previous registrations, if desired. */
+    thisAsAdvanced->SetComputationCache( this->GetElastix()->GetComputationCache() );
+
   } // end advanced metric
 
 } // end BeforeEachResolutionBase()
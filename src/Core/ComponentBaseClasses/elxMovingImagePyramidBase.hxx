@@ -21,10 +21,28 @@
 
 #include "elxMovingImagePyramidBase.h"
 #include "itkImageFileCastWriter.h"
+#include "itkImageFileWriteJob.h"
+#include <algorithm>
+#include <sstream>
+#include <vector>
 
 namespace elastix
 {
 
+/**
+ * ******************* Constructor *******************
+ */
+
+template< class TElastix >
+MovingImagePyramidBase< TElastix >
+::MovingImagePyramidBase()
+{
+  this->m_ComputePyramidImagesPerResolution = false;
+  this->m_PeakPyramidImagesMemorySize       = 0;
+
+} // end Constructor
+
+
 /**
  * ******************* BeforeRegistrationBase *******************
  */
@@ -34,6 +52,15 @@ void
 MovingImagePyramidBase< TElastix >
 ::BeforeRegistrationBase( void )
 {
+  /** Decide whether or not to compute the pyramid images only for the current
+   * resolution. Setting the option to true saves memory, since only one level
+   * of the pyramid is held in memory per resolution.
+   */
+  this->m_ComputePyramidImagesPerResolution = false;
+  this->m_Configuration->ReadParameter( this->m_ComputePyramidImagesPerResolution,
+    "ComputePyramidImagesPerResolution", 0, false );
+  this->m_PeakPyramidImagesMemorySize = 0;
+
   /** Call SetMovingSchedule.*/
   this->SetMovingSchedule();
 
@@ -52,6 +79,12 @@ MovingImagePyramidBase< TElastix >
   /** What is the current resolution level? */
   const unsigned int level = this->m_Registration->GetAsITKBaseType()->GetCurrentLevel();
 
+  /** We let the pyramid know that we are in a next level, before the pyramid
+   * image is written. Depending on a flag the output of the current level is
+   * only computed from now on, or it was computed for all levels at once.
+   */
+  this->SetCurrentPyramidLevel( level );
+
   /** Decide whether or not to write the pyramid images this resolution. */
   bool writePyramidImage = false;
   this->m_Configuration->ReadParameter( writePyramidImage,
@@ -92,6 +125,39 @@ MovingImagePyramidBase< TElastix >
 } // end BeforeEachResolutionBase()
 
 
+/**
+ * ******************* AfterEachResolutionBase *******************
+ */
+
+template< class TElastix >
+void
+MovingImagePyramidBase< TElastix >
+::AfterEachResolutionBase( void )
+{
+  /** The images of this resolution have been computed by now. */
+  this->m_PeakPyramidImagesMemorySize = std::max(
+    this->m_PeakPyramidImagesMemorySize, this->GetPyramidImagesMemorySize() );
+
+} // end AfterEachResolutionBase()
+
+
+/**
+ * ******************* AfterRegistrationBase *******************
+ */
+
+template< class TElastix >
+void
+MovingImagePyramidBase< TElastix >
+::AfterRegistrationBase( void )
+{
+  elxout << "Peak memory used by the images of "
+         << this->GetComponentLabel() << ": "
+         << static_cast< double >( this->m_PeakPyramidImagesMemorySize ) / 1048576.0
+         << " MB." << std::endl;
+
+} // end AfterRegistrationBase()
+
+
 /**
  * ********************** SetMovingSchedule **********************
  */
@@ -181,6 +247,42 @@ MovingImagePyramidBase< TElastix >
   this->m_Configuration->ReadParameter(
     doCompression, "CompressResultImage", 0, false );
 
+  /** Let the write queue of elastix write the image in the background, if
+   * there is one. The pyramid image is computed first, like the writer does.
+   */
+  itk::AsynchronousWriteQueue * writeQueue = this->GetElastix()->GetWriteQueue();
+  if( writeQueue )
+  {
+    OutputImageType * pyramidImage = this->GetAsITKBaseType()->GetOutput( level );
+    try
+    {
+      pyramidImage->UpdateOutputInformation();
+      pyramidImage->SetRequestedRegionToLargestPossibleRegion();
+      pyramidImage->PropagateRequestedRegion();
+      pyramidImage->UpdateOutputData();
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      /** Add information to the exception. */
+      excp.SetLocation( "MovingImagePyramidBase - BeforeEachResolutionBase()" );
+      std::string err_str = excp.GetDescription();
+      err_str += "\nError occurred while computing pyramid image.\n";
+      excp.SetDescription( err_str );
+
+      /** Pass the exception to an higher level. */
+      throw excp;
+    }
+
+    typedef itk::ImageFileWriteJob< OutputImageType > WriteJobType;
+    typename WriteJobType::Pointer writeJob = WriteJobType::New();
+    writeJob->SetImage( pyramidImage );
+    writeJob->SetFileName( filename );
+    writeJob->SetOutputComponentType( resultImagePixelType );
+    writeJob->SetUseCompression( doCompression );
+    writeQueue->Push( writeJob );
+    return;
+  }
+
   /** Create writer. */
   typedef itk::ImageFileCastWriter< OutputImageType > WriterType;
   typename WriterType::Pointer writer = WriterType::New();
@@ -213,6 +315,181 @@ MovingImagePyramidBase< TElastix >
 } // end WritePyramidImage()
 
 
+/**
+ * ******************* GetPyramidImagesMemorySize ********************
+ */
+
+template< class TElastix >
+std::size_t
+MovingImagePyramidBase< TElastix >
+::GetPyramidImagesMemorySize( void )
+{
+  ITKBaseType * pyramid = this->GetAsITKBaseType();
+
+  /** Count each buffer once, and do not count the buffer of the input image. */
+  std::vector< const void * > countedBuffers;
+  if( pyramid->GetInput() )
+  {
+    countedBuffers.push_back( pyramid->GetInput()->GetPixelContainer() );
+  }
+
+  std::size_t memorySize = 0;
+  for( unsigned int level = 0; level < pyramid->GetNumberOfLevels(); ++level )
+  {
+    const OutputImageType * output = pyramid->GetOutput( level );
+    if( !output || !output->GetPixelContainer() ) { continue; }
+
+    const void * buffer = output->GetPixelContainer();
+    if( std::find( countedBuffers.begin(), countedBuffers.end(), buffer )
+      != countedBuffers.end() )
+    {
+      continue;
+    }
+    countedBuffers.push_back( buffer );
+
+    memorySize += output->GetPixelContainer()->Size()
+      * sizeof( typename OutputImageType::PixelType );
+  }
+
+  return memorySize;
+
+} // end GetPyramidImagesMemorySize()
+
+
+/**
+ * ******************* ReleasePyramidImage ********************
+ */
+
+template< class TElastix >
+void
+MovingImagePyramidBase< TElastix >
+::ReleasePyramidImage( const unsigned int level )
+{
+  OutputImageType * output = this->GetAsITKBaseType()->GetOutput( level );
+  if( !output ) { return; }
+
+  /** An empty region at the start of the largest possible region is neither
+   * outside the (empty) buffered region, nor outside the largest region.
+   */
+  typename OutputImageType::RegionType emptyRegion;
+  emptyRegion.SetIndex( output->GetLargestPossibleRegion().GetIndex() );
+
+  output->Initialize();
+  output->SetBufferedRegion( emptyRegion );
+  output->SetRequestedRegion( emptyRegion );
+
+} // end ReleasePyramidImage()
+
+
+/**
+ * ******************* GraftCachedPyramidImages ********************
+ */
+
+template< class TElastix >
+bool
+MovingImagePyramidBase< TElastix >
+::GraftCachedPyramidImages( void )
+{
+  ComputationCacheType * cache   = this->GetElastix()->GetComputationCache();
+  ITKBaseType *          pyramid = this->GetAsITKBaseType();
+  if( !cache || !pyramid->GetInput() ) { return false; }
+
+  /** All requested levels must be in the cache. Levels that request an
+   * empty region are not computed.
+   */
+  const unsigned int numberOfLevels = pyramid->GetNumberOfLevels();
+  std::vector< typename OutputImageType::Pointer > cachedImages( numberOfLevels );
+  for( unsigned int level = 0; level < numberOfLevels; ++level )
+  {
+    if( pyramid->GetOutput( level )->GetRequestedRegion().GetNumberOfPixels() == 0 )
+    {
+      continue;
+    }
+
+    itk::Object::Pointer cachedObject = cache->Find(
+      pyramid->GetInput(), this->GetPyramidCacheOperation( level ) );
+    cachedImages[ level ] = dynamic_cast< OutputImageType * >( cachedObject.GetPointer() );
+    if( cachedImages[ level ].IsNull() ) { return false; }
+  }
+
+  /** Share the buffers of the cached images. */
+  for( unsigned int level = 0; level < numberOfLevels; ++level )
+  {
+    if( cachedImages[ level ].IsNotNull() )
+    {
+      pyramid->GraftNthOutput( level, cachedImages[ level ] );
+    }
+  }
+
+  return true;
+
+} // end GraftCachedPyramidImages()
+
+
+/**
+ * ******************* AddPyramidImagesToCache ********************
+ */
+
+template< class TElastix >
+void
+MovingImagePyramidBase< TElastix >
+::AddPyramidImagesToCache( void )
+{
+  ComputationCacheType * cache   = this->GetElastix()->GetComputationCache();
+  ITKBaseType *          pyramid = this->GetAsITKBaseType();
+  if( !cache || !pyramid->GetInput() ) { return; }
+
+  for( unsigned int level = 0; level < pyramid->GetNumberOfLevels(); ++level )
+  {
+    /** Only complete images are stored. */
+    const OutputImageType * output = pyramid->GetOutput( level );
+    if( output->GetBufferedRegion().GetNumberOfPixels() == 0
+      || output->GetBufferedRegion() != output->GetLargestPossibleRegion() )
+    {
+      continue;
+    }
+
+    /** Store an image that shares the buffer of the output. The pyramid
+     * allocates a new buffer when it is executed again.
+     */
+    typename OutputImageType::Pointer cachedImage = OutputImageType::New();
+    cachedImage->Graft( output );
+    cache->Add( pyramid->GetInput(), this->GetPyramidCacheOperation( level ), cachedImage );
+  }
+
+} // end AddPyramidImagesToCache()
+
+
+/**
+ * ******************* GetPyramidCacheOperation ********************
+ */
+
+template< class TElastix >
+std::string
+MovingImagePyramidBase< TElastix >
+::GetPyramidCacheOperation( const unsigned int level ) const
+{
+  const ScheduleType & schedule = this->GetAsITKBaseType()->GetSchedule();
+
+  /** The whole schedule is included, since some pyramids derive a level
+   * from the other levels.
+   */
+  std::ostringstream operation;
+  operation << this->elxGetClassName() << " level " << level << " schedule";
+  for( unsigned int i = 0; i < schedule.rows(); ++i )
+  {
+    for( unsigned int j = 0; j < schedule.cols(); ++j )
+    {
+      operation << " " << schedule[ i ][ j ];
+    }
+  }
+  this->WritePyramidCacheSettings( operation );
+
+  return operation.str();
+
+} // end GetPyramidCacheOperation()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef __elxMovingImagePyramidBase_hxx
@@ -23,6 +23,7 @@
 #include "elxMacro.h"
 
 #include "elxBaseComponentSE.h"
+#include "elxRegistrationCheckpoint.h"
 #include "itkOptimizer.h"
 
 namespace elastix
@@ -108,6 +109,23 @@ public:
   virtual void SetSinusScales( double amplitude, double frequency,
     unsigned long numberOfParameters );
 
+  /** Write the internal state of the optimizer to a checkpoint, see
+   * RegistrationCheckpoint. Returns false if the optimizer does not support
+   * checkpoints, which is the default. This function is called from the
+   * AfterEachIteration() of elastix.
+   */
+  virtual bool WriteCheckpointState( std::ostream & /** os */ ) const
+  {
+    return false;
+  }
+
+
+  /** Set the state of a checkpoint, written by WriteCheckpointState().
+   * Optimizers that support checkpoints restore the state in the next
+   * StartOptimization(), instead of starting with a fresh state.
+   */
+  virtual void SetCheckpointState( const std::string & state );
+
 protected:
 
   /** The constructor. */
@@ -123,6 +141,11 @@ protected:
   /** Check whether the user asked to select new samples every iteration. */
   virtual bool GetNewSamplesEveryIteration( void ) const;
 
+  /** Get the state set by SetCheckpointState(), and forget it, so that it
+   * is restored only once. Returns false if no state was set.
+   */
+  virtual bool TakeCheckpointState( std::string & state );
+
 private:
 
   /** The private constructor. */
@@ -135,6 +158,9 @@ private:
    */
   bool m_NewSamplesEveryIteration;
 
+  /** The state of a checkpoint that has not been restored yet. */
+  std::string m_CheckpointState;
+
 };
 
 } // end namespace elastix
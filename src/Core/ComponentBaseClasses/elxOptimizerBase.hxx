@@ -151,6 +151,41 @@ OptimizerBase< TElastix >
 } // end GetNewSamplesEveryIteration()
 
 
+/**
+ * ****************** SetCheckpointState ********************
+ */
+
+template< class TElastix >
+void
+OptimizerBase< TElastix >
+::SetCheckpointState( const std::string & state )
+{
+  this->m_CheckpointState = state;
+
+} // end SetCheckpointState()
+
+
+/**
+ * ****************** TakeCheckpointState ********************
+ */
+
+template< class TElastix >
+bool
+OptimizerBase< TElastix >
+::TakeCheckpointState( std::string & state )
+{
+  if( this->m_CheckpointState.empty() )
+  {
+    return false;
+  }
+
+  state.swap( this->m_CheckpointState );
+  this->m_CheckpointState.clear();
+  return true;
+
+} // end TakeCheckpointState()
+
+
 /**
  * ****************** SetSinusScales ********************
  */
@@ -67,6 +67,9 @@ namespace elastix
  *    example: <tt>(ErodeMovingMask2 "true" "false")</tt>
  *    This setting overrules ErodeMask and ErodeMovingMask.\n
  *
+ * With the UseComputationCache parameter of ElastixBase, the eroded masks
+ * are reused by the next registrations.
+ *
  * \ingroup Registrations
  * \ingroup ComponentBaseClasses
  */
@@ -178,6 +181,9 @@ protected:
   typedef itk::ErodeMaskImageFilter< MovingMaskImageType > MovingMaskErodeFilterType;
   typedef typename MovingMaskErodeFilterType::Pointer      MovingMaskErodeFilterPointer;
 
+  /** Typedef for the cache that is shared by the registrations. */
+  typedef typename ElastixType::ComputationCacheType ComputationCacheType;
+
   /** Generate a spatial object from a mask image, possibly after eroding the image
    * Input:
    * \li the mask as an image, consisting of 1's and 0's;
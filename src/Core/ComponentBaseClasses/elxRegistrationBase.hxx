@@ -19,6 +19,7 @@
 #define __elxRegistrationBase_hxx
 
 #include "elxRegistrationBase.h"
+#include <sstream>
 
 namespace elastix
 {
@@ -118,6 +119,28 @@ RegistrationBase< TElastix >
     return fixedMaskSpatialObject;
   }
 
+  /** Reuse the eroded mask of a previous registration, if possible. The
+   * erosion only depends on the schedule of this level.
+   */
+  ComputationCacheType * cache = this->GetElastix()->GetComputationCache();
+  std::ostringstream     operation;
+  operation << "ErodeFixedMask schedule";
+  for( unsigned int i = 0; i < FixedImageDimension; ++i )
+  {
+    operation << " " << pyramid->GetSchedule()[ level ][ i ];
+  }
+  if( cache )
+  {
+    itk::Object::Pointer  cachedObject          = cache->Find( maskImage, operation.str() );
+    FixedMaskImagePointer cachedErodedMaskImage
+      = dynamic_cast< FixedMaskImageType * >( cachedObject.GetPointer() );
+    if( cachedErodedMaskImage.IsNotNull() )
+    {
+      fixedMaskSpatialObject->SetImage( cachedErodedMaskImage );
+      return fixedMaskSpatialObject;
+    }
+  }
+
   /** Erode, and convert to spatial object. */
   FixedMaskErodeFilterPointer erosion = FixedMaskErodeFilterType::New();
   erosion->SetInput( maskImage );
@@ -147,6 +170,12 @@ RegistrationBase< TElastix >
   /** Release some memory. */
   erodedFixedMaskAsImage->DisconnectPipeline();
 
+  /** Store the eroded mask for the next registrations. */
+  if( cache )
+  {
+    cache->Add( maskImage, operation.str(), erodedFixedMaskAsImage );
+  }
+
   fixedMaskSpatialObject->SetImage( erodedFixedMaskAsImage );
   return fixedMaskSpatialObject;
 
@@ -178,6 +207,28 @@ RegistrationBase< TElastix >
     return movingMaskSpatialObject;
   }
 
+  /** Reuse the eroded mask of a previous registration, if possible. The
+   * erosion only depends on the schedule of this level.
+   */
+  ComputationCacheType * cache = this->GetElastix()->GetComputationCache();
+  std::ostringstream     operation;
+  operation << "ErodeMovingMask schedule";
+  for( unsigned int i = 0; i < MovingImageDimension; ++i )
+  {
+    operation << " " << pyramid->GetSchedule()[ level ][ i ];
+  }
+  if( cache )
+  {
+    itk::Object::Pointer   cachedObject          = cache->Find( maskImage, operation.str() );
+    MovingMaskImagePointer cachedErodedMaskImage
+      = dynamic_cast< MovingMaskImageType * >( cachedObject.GetPointer() );
+    if( cachedErodedMaskImage.IsNotNull() )
+    {
+      movingMaskSpatialObject->SetImage( cachedErodedMaskImage );
+      return movingMaskSpatialObject;
+    }
+  }
+
   /** Erode, and convert to spatial object. */
   MovingMaskErodeFilterPointer erosion = MovingMaskErodeFilterType::New();
   erosion->SetInput( maskImage );
@@ -207,6 +258,12 @@ RegistrationBase< TElastix >
   /** Release some memory */
   erodedMovingMaskAsImage->DisconnectPipeline();
 
+  /** Store the eroded mask for the next registrations. */
+  if( cache )
+  {
+    cache->Add( maskImage, operation.str(), erodedMovingMaskAsImage );
+  }
+
   movingMaskSpatialObject->SetImage( erodedMovingMaskAsImage );
   return movingMaskSpatialObject;
 
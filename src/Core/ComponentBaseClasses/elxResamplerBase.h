@@ -25,6 +25,9 @@
 #include "itkResampleImageFilter.h"
 #include "elxProgressCommand.h"
 
+#include <string>
+#include <vector>
+
 namespace elastix
 {
 /**
@@ -64,6 +67,15 @@ namespace elastix
  *    of the written image is desired.\n
  *    example: <tt>(CompressResultImage "true")</tt> \n
  *    The default is "false".
+ * \parameter ResultImageMemoryBudget: the maximum amount of memory in megabytes
+ *    that is used for the result image. If the result image does not fit, it is
+ *    resampled, cast and written in pieces, if the image format supports streamed
+ *    writing, such as mhd, mha and nrrd. Otherwise the image is written at once.
+ *    The moving image itself is still read in memory completely. This parameter
+ *    is used by elastix and by transformix, and it is not used by the library,
+ *    which returns the result image in memory.\n
+ *    example: <tt>(ResultImageMemoryBudget 1024)</tt> \n
+ *    The default is 0, which means no maximum.
  *
  * \ingroup Resamplers
  * \ingroup ComponentBaseClasses
@@ -174,6 +186,25 @@ public:
   /** Function to perform resample and write the result output image to a file. */
   virtual void ResampleAndWriteResultImage( const char * filename, const bool & showProgress = true );
 
+  /** Function to resample the result output image, and to let the write queue
+   * of elastix write it in the background. Without a write queue (see the
+   * AsynchronousOutputMemoryBudget parameter), or if the result image is
+   * written in pieces, this simply calls ResampleAndWriteResultImage().
+   */
+  virtual void ResampleAndWriteResultImageAsynchronously(
+    const char * filename, const bool & showProgress = true );
+
+  /** Function to resample all input images with the same transform, and to
+   * write each result image to the corresponding file. The transform is
+   * evaluated once for each voxel of the output grid, and the mapped points
+   * are used for all images. These points are kept in memory, which costs
+   * ImageDimension doubles per voxel. Therefore, if the result images are
+   * written in pieces to stay within the ResultImageMemoryBudget, the images
+   * are resampled one by one instead.
+   */
+  virtual void ResampleAndWriteResultImages(
+    const std::vector< std::string > & filenames, const bool & showProgress = true );
+
   /** Function to write the result output image to a file. */
   virtual void WriteResultImage( OutputImageType * imageimage,
     const char * filename, const bool & showProgress = true );
@@ -191,6 +222,11 @@ protected:
   /** Method that sets the transform, the interpolator and the inputImage. */
   virtual void SetComponents( void );
 
+  /** Get the number of pieces in which the result image is resampled and
+   * written, such that each piece fits in the ResultImageMemoryBudget.
+   */
+  virtual unsigned int GetNumberOfResultImagePieces( void ) const;
+
   /** Variable that defines to print the progress or not. */
   bool m_ShowProgress;
 
@@ -21,10 +21,16 @@
 #include "elxResamplerBase.h"
 
 #include "itkImageFileCastWriter.h"
+#include "itkImageFileWriteJob.h"
 #include "itkChangeInformationImageFilter.h"
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
+#include "itkTransformToDisplacementFieldFilter.h"
+#include "itkWarpImageFilter.h"
 #include "itkTimeProbe.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace elastix
 {
 
@@ -123,7 +129,7 @@ ResamplerBase< TElastix >
     elxout << "Applying transform this resolution ..." << std::endl;
     try
     {
-      this->ResampleAndWriteResultImage( makeFileName.str().c_str() );
+      this->ResampleAndWriteResultImageAsynchronously( makeFileName.str().c_str() );
     }
     catch( itk::ExceptionObject & excp )
     {
@@ -183,7 +189,7 @@ ResamplerBase< TElastix >
     /** Apply the final transform, and save the result. */
     try
     {
-      this->ResampleAndWriteResultImage( makeFileName.str().c_str(), false );
+      this->ResampleAndWriteResultImageAsynchronously( makeFileName.str().c_str(), false );
     }
     catch( itk::ExceptionObject & excp )
     {
@@ -326,6 +332,12 @@ ResamplerBase< TElastix >
   /** Make sure the resampler is updated. */
   this->GetAsITKBaseType()->Modified();
 
+  /** If the result image is written in pieces, the writer drives the
+   * resampler, and it reports the progress.
+   */
+  const unsigned int numberOfPieces = this->GetNumberOfResultImagePieces();
+  const bool         showResamplingProgress = showProgress && numberOfPieces == 1;
+
   /** Add a progress observer to the resampler. */
 #ifndef _ELASTIX_BUILD_LIBRARY
   typename ProgressCommandType::Pointer progressObserver = ProgressCommandType::New();
@@ -338,6 +350,85 @@ ResamplerBase< TElastix >
 #endif
 
   /** Do the resampling. */
+  if( numberOfPieces == 1 )
+  {
+    try
+    {
+      this->GetAsITKBaseType()->Update();
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      /** Add information to the exception. */
+      excp.SetLocation( "ResamplerBase - WriteResultImage()" );
+      std::string err_str = excp.GetDescription();
+      err_str += "\nError occurred while resampling the image.\n";
+      excp.SetDescription( err_str );
+
+      /** Pass the exception to an higher level. */
+      throw excp;
+    }
+  }
+  else
+  {
+    elxout << "  Resampling and writing the result image in "
+           << numberOfPieces << " pieces." << std::endl;
+  }
+
+  /** Perform the writing. */
+  this->WriteResultImage( this->GetAsITKBaseType()->GetOutput(), filename, showProgress );
+
+  /** Disconnect from the resampler. */
+#ifndef _ELASTIX_BUILD_LIBRARY
+  if( showProgress )
+  {
+    progressObserver->DisconnectObserver( this->GetAsITKBaseType() );
+  }
+#endif
+
+} // end ResampleAndWriteResultImage()
+
+
+/**
+ * ************* ResampleAndWriteResultImageAsynchronously ****************
+ */
+
+template< class TElastix >
+void
+ResamplerBase< TElastix >
+::ResampleAndWriteResultImageAsynchronously( const char * filename,
+  const bool & showProgress )
+{
+  /** The RayCastResampleInterpolator changes the transform when the image
+   * is written, so it is written directly, like an image in pieces.
+   */
+  typedef itk::AdvancedRayCastInterpolateImageFunction<  InputImageType,
+    CoordRepType > RayCastInterpolatorType;
+  const bool isRayCast = dynamic_cast< const RayCastInterpolatorType * >(
+    this->GetAsITKBaseType()->GetInterpolator() ) != 0;
+
+  itk::AsynchronousWriteQueue * writeQueue = this->GetElastix()->GetWriteQueue();
+  if( !writeQueue || isRayCast || this->GetNumberOfResultImagePieces() > 1 )
+  {
+    this->ResampleAndWriteResultImage( filename, showProgress );
+    return;
+  }
+
+  /** Make sure the resampler is updated. */
+  this->GetAsITKBaseType()->Modified();
+  typename OutputImageType::Pointer resultImage = this->GetAsITKBaseType()->GetOutput();
+
+  /** Add a progress observer to the resampler. */
+#ifndef _ELASTIX_BUILD_LIBRARY
+  typename ProgressCommandType::Pointer progressObserver = ProgressCommandType::New();
+  if( showProgress )
+  {
+    progressObserver->ConnectObserver( this->GetAsITKBaseType() );
+    progressObserver->SetStartString( "  Progress: " );
+    progressObserver->SetEndString( "%" );
+  }
+#endif
+
+  /** Do the resampling, with the current transform. */
   try
   {
     this->GetAsITKBaseType()->Update();
@@ -345,7 +436,7 @@ ResamplerBase< TElastix >
   catch( itk::ExceptionObject & excp )
   {
     /** Add information to the exception. */
-    excp.SetLocation( "ResamplerBase - WriteResultImage()" );
+    excp.SetLocation( "ResamplerBase - ResampleAndWriteResultImageAsynchronously()" );
     std::string err_str = excp.GetDescription();
     err_str += "\nError occurred while resampling the image.\n";
     excp.SetDescription( err_str );
@@ -354,10 +445,6 @@ ResamplerBase< TElastix >
     throw excp;
   }
 
-  /** Perform the writing. */
-  this->WriteResultImage( this->GetAsITKBaseType()->GetOutput(), filename, showProgress );
-
-  /** Disconnect from the resampler. */
 #ifndef _ELASTIX_BUILD_LIBRARY
   if( showProgress )
   {
@@ -365,7 +452,217 @@ ResamplerBase< TElastix >
   }
 #endif
 
-} // end ResampleAndWriteResultImage()
+  /** Take the result image from the resampler, so that the next resampling
+   * does not overwrite it while it is written.
+   */
+  resultImage->DisconnectPipeline();
+
+  /** Possibly change direction cosines to their original value, as specified
+   * in the tp-file, or by the fixed image. This is only necessary when
+   * the UseDirectionCosines flag was set to false.
+   */
+  DirectionType originalDirection;
+  bool          retdc = this->GetElastix()->GetOriginalFixedImageDirection( originalDirection );
+  if( retdc && !this->GetElastix()->GetUseDirectionCosines() )
+  {
+    resultImage->SetDirection( originalDirection );
+  }
+
+  /** Read output pixeltype from parameter the file. Replace possible " " with "_". */
+  std::string resultImagePixelType = "short";
+  this->m_Configuration->ReadParameter( resultImagePixelType,
+    "ResultImagePixelType", 0, false );
+  std::basic_string< char >::size_type       pos  = resultImagePixelType.find( " " );
+  const std::basic_string< char >::size_type npos = std::basic_string< char >::npos;
+  if( pos != npos ) { resultImagePixelType.replace( pos, 1, "_" ); }
+
+  /** Read from the parameter file if compression is desired. */
+  bool doCompression = false;
+  this->m_Configuration->ReadParameter(
+    doCompression, "CompressResultImage", 0, false );
+
+  /** Cast, compress and write the image in the background. */
+  typedef itk::ImageFileWriteJob< OutputImageType > WriteJobType;
+  typename WriteJobType::Pointer writeJob = WriteJobType::New();
+  writeJob->SetImage( resultImage );
+  writeJob->SetFileName( filename );
+  writeJob->SetOutputComponentType( resultImagePixelType );
+  writeJob->SetUseCompression( doCompression );
+  writeQueue->Push( writeJob );
+
+} // end ResampleAndWriteResultImageAsynchronously()
+
+
+/**
+ * ******************* ResampleAndWriteResultImages ********************
+ */
+
+template< class TElastix >
+void
+ResamplerBase< TElastix >
+::ResampleAndWriteResultImages( const std::vector< std::string > & filenames,
+  const bool & showProgress )
+{
+  const unsigned int numberOfImages = this->m_Elastix->GetNumberOfMovingImages();
+  if( filenames.size() != numberOfImages )
+  {
+    itkExceptionMacro( << "The number of file names (" << filenames.size()
+                       << ") does not match the number of input images ("
+                       << numberOfImages << ")." );
+  }
+
+  /** Typedef's for computing the mapped points, as displacements. */
+  typedef itk::Vector< CoordRepType, ImageDimension >   DisplacementType;
+  typedef itk::Image< DisplacementType, ImageDimension > DisplacementFieldType;
+  typedef itk::TransformToDisplacementFieldFilter<
+    DisplacementFieldType, CoordRepType >             DisplacementFieldGeneratorType;
+  typedef itk::WarpImageFilter<
+    InputImageType, OutputImageType,
+    DisplacementFieldType >                           WarperType;
+  typedef typename WarperType::InterpolatorType       WarpInterpolatorType;
+  typedef itk::AdvancedRayCastInterpolateImageFunction<
+    InputImageType, CoordRepType >                    RayCastInterpolatorType;
+
+  /** Resample the images one by one if there is only one image, if the
+   * ray cast interpolator is used (it uses the transform itself), or if the
+   * interpolator can not be used by the warper. Also when the result images
+   * are written in pieces: the displacement field would then need the memory
+   * that the pieces are meant to save.
+   */
+  ITKBaseType *          resampler = this->GetAsITKBaseType();
+  WarpInterpolatorType * warpInterpolator = dynamic_cast< WarpInterpolatorType * >(
+    this->m_Elastix->GetElxResampleInterpolatorBase() );
+  if( numberOfImages == 1
+    || dynamic_cast< const RayCastInterpolatorType * >( resampler->GetInterpolator() )
+    || warpInterpolator == 0
+    || this->GetNumberOfResultImagePieces() > 1 )
+  {
+    for( unsigned int i = 0; i < numberOfImages; ++i )
+    {
+      resampler->SetInput( this->m_Elastix->GetMovingImage( i ) );
+      this->ResampleAndWriteResultImage( filenames[ i ].c_str(), showProgress );
+    }
+    resampler->SetInput( this->m_Elastix->GetMovingImage() );
+    return;
+  }
+
+  /** Map each voxel of the output grid once. */
+  typename DisplacementFieldGeneratorType::Pointer fieldGenerator
+    = DisplacementFieldGeneratorType::New();
+  fieldGenerator->SetSize( resampler->GetSize() );
+  fieldGenerator->SetOutputStartIndex( resampler->GetOutputStartIndex() );
+  fieldGenerator->SetOutputOrigin( resampler->GetOutputOrigin() );
+  fieldGenerator->SetOutputSpacing( resampler->GetOutputSpacing() );
+  fieldGenerator->SetOutputDirection( resampler->GetOutputDirection() );
+  fieldGenerator->SetTransform( resampler->GetTransform() );
+
+  elxout << "  Mapping the output grid once for "
+         << numberOfImages << " images ..." << std::endl;
+#ifndef _ELASTIX_BUILD_LIBRARY
+  typename ProgressCommandType::Pointer fieldProgressObserver = ProgressCommandType::New();
+  if( showProgress )
+  {
+    fieldProgressObserver->ConnectObserver( fieldGenerator );
+    fieldProgressObserver->SetStartString( "  Progress: " );
+    fieldProgressObserver->SetEndString( "%" );
+  }
+#endif
+  try
+  {
+    fieldGenerator->Update();
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    /** Add information to the exception. */
+    excp.SetLocation( "ResamplerBase - ResampleAndWriteResultImages()" );
+    std::string err_str = excp.GetDescription();
+    err_str += "\nError occurred while mapping the output grid.\n";
+    excp.SetDescription( err_str );
+
+    /** Pass the exception to an higher level. */
+    throw excp;
+  }
+#ifndef _ELASTIX_BUILD_LIBRARY
+  if( showProgress )
+  {
+    fieldProgressObserver->DisconnectObserver( fieldGenerator );
+  }
+#endif
+
+  /** Keep the mapped points, without keeping the generator up to date. */
+  typename DisplacementFieldType::Pointer displacementField = fieldGenerator->GetOutput();
+  displacementField->DisconnectPipeline();
+  fieldGenerator = 0;
+
+  /** Only interpolate each image at the mapped points. */
+  for( unsigned int i = 0; i < numberOfImages; ++i )
+  {
+    elxout << "  Resampling image " << i << " ..." << std::endl;
+
+    typename WarperType::Pointer warper = WarperType::New();
+    warper->SetInput( this->m_Elastix->GetMovingImage( i ) );
+    warper->SetDisplacementField( displacementField );
+    warper->SetInterpolator( warpInterpolator );
+    warper->SetEdgePaddingValue( resampler->GetDefaultPixelValue() );
+    warper->SetOutputSize( resampler->GetSize() );
+    warper->SetOutputStartIndex( resampler->GetOutputStartIndex() );
+    warper->SetOutputOrigin( resampler->GetOutputOrigin() );
+    warper->SetOutputSpacing( resampler->GetOutputSpacing() );
+    warper->SetOutputDirection( resampler->GetOutputDirection() );
+
+#ifndef _ELASTIX_BUILD_LIBRARY
+    typename ProgressCommandType::Pointer progressObserver = ProgressCommandType::New();
+    if( showProgress )
+    {
+      progressObserver->ConnectObserver( warper );
+      progressObserver->SetStartString( "  Progress: " );
+      progressObserver->SetEndString( "%" );
+    }
+#endif
+
+    /** Resample while writing. */
+    this->WriteResultImage( warper->GetOutput(), filenames[ i ].c_str(), showProgress );
+
+#ifndef _ELASTIX_BUILD_LIBRARY
+    if( showProgress )
+    {
+      progressObserver->DisconnectObserver( warper );
+    }
+#endif
+  }
+
+} // end ResampleAndWriteResultImages()
+
+
+/**
+ * ******************* GetNumberOfResultImagePieces ********************
+ */
+
+template< class TElastix >
+unsigned int
+ResamplerBase< TElastix >
+::GetNumberOfResultImagePieces( void ) const
+{
+  /** The default is no maximum, so one piece. */
+  double memoryBudget = 0.0;
+  this->m_Configuration->ReadParameter( memoryBudget,
+    "ResultImageMemoryBudget", 0, false );
+  if( memoryBudget <= 0.0 ) { return 1; }
+
+  /** Each pixel of a piece is resampled, and possibly cast to a pixel
+   * type of at most the size of a double.
+   */
+  const double bytesPerPixel = sizeof( OutputPixelType ) + sizeof( double );
+  const double numberOfPixels
+    = this->GetAsITKBaseType()->GetSize().CalculateProductOfElements();
+  const double numberOfPieces = std::ceil(
+    numberOfPixels * bytesPerPixel / ( memoryBudget * 1024.0 * 1024.0 ) );
+
+  /** The writer does not split beyond the number of pixels. */
+  return static_cast< unsigned int >(
+    std::max( 1.0, std::min( numberOfPieces, numberOfPixels ) ) );
+
+} // end GetNumberOfResultImagePieces()
 
 
 /**
@@ -433,7 +730,22 @@ ResamplerBase< TElastix >
   writer->SetOutputComponentType( resultImagePixelType.c_str() );
   writer->SetUseCompression( doCompression );
 
+  /** Write the image in pieces, if it does not fit in the memory budget.
+   * Each piece is then resampled and cast just before it is written.
+   */
+  const unsigned int numberOfPieces = this->GetNumberOfResultImagePieces();
+  writer->SetNumberOfStreamDivisions( numberOfPieces );
+
   /** Do the writing. */
+#ifndef _ELASTIX_BUILD_LIBRARY
+  typename ProgressCommandType::Pointer progressObserver = ProgressCommandType::New();
+  if( showProgress && numberOfPieces > 1 )
+  {
+    progressObserver->ConnectObserver( writer );
+    progressObserver->SetStartString( "  Progress: " );
+    progressObserver->SetEndString( "%" );
+  }
+#endif
   if( showProgress )
   {
     xl::xout[ "coutonly" ] << std::flush;
@@ -454,6 +766,13 @@ ResamplerBase< TElastix >
     /** Pass the exception to an higher level. */
     throw excp;
   }
+
+#ifndef _ELASTIX_BUILD_LIBRARY
+  if( showProgress && numberOfPieces > 1 )
+  {
+    progressObserver->DisconnectObserver( writer );
+  }
+#endif
 } // end WriteResultImage()
 
 
@@ -774,6 +1093,16 @@ ResamplerBase< TElastix >
   xl::xout[ "transpar" ] << "(CompressResultImage \""
                          << doCompression << "\")" << std::endl;
 
+  /** Write the memory budget, if any, so that transformix uses it too. */
+  double memoryBudget = 0.0;
+  this->m_Configuration->ReadParameter(
+    memoryBudget, "ResultImageMemoryBudget", 0, false );
+  if( memoryBudget > 0.0 )
+  {
+    xl::xout[ "transpar" ] << "(ResultImageMemoryBudget "
+                           << memoryBudget << ")" << std::endl;
+  }
+
 } // end WriteToFile()
 
 
@@ -830,6 +1159,17 @@ ResamplerBase< TElastix >
   paramsMap->insert( make_pair( parameterName, parameterValues ) );
   parameterValues.clear();
 
+  /** Write the memory budget, if any. */
+  std::string memoryBudget = "0";
+  if( this->m_Configuration->ReadParameter(
+    memoryBudget, "ResultImageMemoryBudget", 0, false ) )
+  {
+    parameterName = "ResultImageMemoryBudget";
+    parameterValues.push_back( memoryBudget );
+    paramsMap->insert( make_pair( parameterName, parameterValues ) );
+    parameterValues.clear();
+  }
+
 } // end CreateTransformParametersMap()
 
 
@@ -26,9 +26,11 @@
 #include "itkAdvancedCombinationTransform.h"
 #include "elxComponentDatabase.h"
 #include "elxProgressCommand.h"
+#include "itkMultiThreader.h"
 
 #include <fstream>
 #include <iomanip>
+#include <vector>
 
 namespace elastix
 {
@@ -107,6 +109,42 @@ namespace elastix
  * The location is relative to the path from where elastix/transformix is started!\n
  * Default: "NoInitialTransform", which (obviously) means that there is no initial transform
  * to be loaded.
+ * \transformparameter NumberOfStreamDivisions: The number of slabs in which transformix
+ * generates and writes the deformation field and the spatial Jacobian (determinant) images,
+ * to limit the memory usage for large images. Streaming requires a writer that supports it, such as mha or nrrd.
+ * Otherwise the image is written at once.\n
+ * example <tt>(NumberOfStreamDivisions 16)</tt>\n
+ * Default: 1, which means no streaming.
+ * \transformparameter DeformationFieldPixelType: The component type of the deformation
+ * field written by transformix (-def all). Choose from {float, double}.\n
+ * example <tt>(DeformationFieldPixelType "double")</tt>\n
+ * Default: "float".
+ * \transformparameter CompressDeformationField: Whether the deformation field is written
+ * compressed. The ITK image writers cannot stream compressed output, so a compressed
+ * deformation field is always generated and written at once, and NumberOfStreamDivisions
+ * then does not limit the memory usage; transformix warns about this combination.\n
+ * example <tt>(CompressDeformationField "true")</tt>\n
+ * Default: "false".
+ * \transformparameter InverseMaximumNumberOfIterations: The maximum number of
+ * fixed-point iterations per voxel when transformix computes the inverse
+ * deformation field (-inv all).\n
+ * example <tt>(InverseMaximumNumberOfIterations 100)</tt>\n
+ * Default: 50.
+ * \transformparameter InverseTolerance: The tolerance on the residual
+ * || T(x) - y ||, in physical units, for the inverse deformation field.\n
+ * example <tt>(InverseTolerance 0.01)</tt>\n
+ * Default: 0.001.
+ * \transformparameter InverseCoarseGridFactor: The iteration for the inverse is seeded
+ * by the inverse on a grid that is this many times coarser. Use 1 to disable the seed.\n
+ * example <tt>(InverseCoarseGridFactor 8)</tt>\n
+ * Default: 4.
+ * \transformparameter WriteInverseBSplineTransform: If the (current) transform is a
+ * B-spline, also write a transform parameter file "TransformParameters.inverse.txt"
+ * with a B-spline of the same order on the same grid, interpolating the inverse of the
+ * whole transform at the grid nodes. It has no initial transform, and its Size, Spacing,
+ * Origin and Direction are those of the inverse deformation field.\n
+ * example <tt>(WriteInverseBSplineTransform "true")</tt>\n
+ * Default: "false".
  *
  * The command line arguments used by this class are:
  * \commandlinearg -t0: optional argument for elastix for specifying an initial transform
@@ -119,9 +157,19 @@ namespace elastix
  *    "point", depending if the user supplies voxel indices or real world coordinates.
  *    The second line should be the number of points that should be transformed. The
  *    third and following lines give the indices or points.\n
+ *    For many points, a binary file is faster. It starts with a text line
+ *    "binarypoint <number of points> <dimension>" (or "binaryindex ..."), followed by
+ *    the coordinates as little endian doubles. The transformed points are then written
+ *    in the same format to "outputpoints.bin", in world coordinates. The points are
+ *    transformed by the threads of transformix, also for VTK files.\n
  *    It is also possible to deform all points, thereby generating a deformation field
  *    image. This is done by:\n
  *    example: <tt>-def all</tt> \n
+ * \commandlinearg -inv: optional argument for transformix for generating the
+ *    deformation field of the inverse transform, on the output grid given by the
+ *    Size, Spacing, Origin and Direction parameters. The inverse is computed
+ *    directly, by a multi-threaded fixed-point iteration.\n
+ *    example: <tt>-inv all</tt> \n
  *
  * \ingroup Transforms
  * \ingroup ComponentBaseClasses
@@ -301,6 +349,9 @@ public:
   /** Function to compute the determinant of the spatial Jacobian. */
   virtual void ComputeSpatialJacobian( void ) const;
 
+  /** Function to compute the deformation field of the inverse transform. */
+  virtual void ComputeInverseDeformationField( void ) const;
+
   /** Makes sure that the final parameters from the registration components
    * are copied, set, and stored.
    */
@@ -331,6 +382,26 @@ protected:
   void AutomaticScalesEstimationStackTransform(
     const unsigned int & numSubTransforms, ScalesType & scales ) const;
 
+  /** Get the grid of the fixed image. Without a fixed image, as in transformix,
+   * the output grid of the resampler is returned, which is read from the same
+   * transform parameter file.
+   */
+  void GetFixedImageGrid( typename FixedImageType::SizeType & size,
+    typename FixedImageType::IndexType & index,
+    typename FixedImageType::SpacingType & spacing,
+    typename FixedImageType::PointType & origin ) const;
+
+  /** Read the number of slabs in which output images are streamed. */
+  unsigned int GetNumberOfStreamDivisions( void ) const;
+
+  /** Transform the points in parallel, with the threads of this registration. */
+  void TransformPointsInParallel( const std::vector< InputPointType > & inputPoints,
+    std::vector< OutputPointType > & outputPoints ) const;
+
+  /** Generate and write the deformation field, with vectors of TComponent. */
+  template< class TComponent >
+  void GenerateDeformationFieldImage( void ) const;
+
   /** Member variables. */
   ParametersType * m_TransformParametersPointer;
   std::string      m_TransformParametersFileName;
@@ -346,9 +417,24 @@ private:
   /** Boolean to decide whether or not the transform parameters are written. */
   bool m_ReadWriteTransformParameters;
 
+  /** Write "NoInitialTransform", while writing a transform that replaces the
+   * whole chain of transforms, such as the inverse B-spline transform.
+   */
+  mutable bool m_WriteWithoutInitialTransform;
+
+  /** The threader parameters and callback of TransformPointsInParallel(). */
+  struct TransformPointsThreaderParameterType
+  {
+    const ITKBaseType *                   t_Transform;
+    const std::vector< InputPointType > * t_InputPoints;
+    std::vector< OutputPointType > *      t_OutputPoints;
+  };
+
+  static ITK_THREAD_RETURN_TYPE TransformPointsThreaderCallback( void * arg );
+
   std::string GetInitialTransformParametersFileName( void ) const
   {
-    if( !this->GetInitialTransform() )
+    if( !this->GetInitialTransform() || this->m_WriteWithoutInitialTransform )
     {
       return "NoInitialTransform";
     }
@@ -29,6 +29,8 @@
 #include "itkTransformToDisplacementFieldFilter.h"
 #include "itkTransformToDeterminantOfSpatialJacobianSource.h"
 #include "itkTransformToSpatialJacobianSource.h"
+#include "itkTransformToInverseDisplacementFieldSource.h"
+#include "itkAdvancedBSplineDeformableTransformBase.h"
 #include "itkImageFileWriter.h"
 #include "itkImageGridSampler.h"
 #include "itkContinuousIndex.h"
@@ -36,7 +38,9 @@
 #include "itkMesh.h"
 #include "itkMeshFileReader.h"
 #include "itkMeshFileWriter.h"
-#include "itkTransformMeshFilter.h"
+#include "itkByteSwapper.h"
+
+#include <algorithm>
 
 namespace itk
 {
@@ -110,8 +114,9 @@ TransformBase< TElastix >
 ::TransformBase()
 {
   /** Initialize. */
-  this->m_TransformParametersPointer   = 0;
-  this->m_ReadWriteTransformParameters = true;
+  this->m_TransformParametersPointer    = 0;
+  this->m_ReadWriteTransformParameters  = true;
+  this->m_WriteWithoutInitialTransform = false;
 
 } // end Constructor()
 
@@ -221,6 +226,17 @@ TransformBase< TElastix >
     elxout << "-jacmat   " << check << std::endl;
   }
 
+  /** Check for appearance of "-inv". */
+  check = this->m_Configuration->GetCommandLineArgument( "-inv" );
+  if( check == "" )
+  {
+    elxout << "-inv      unspecified, so no inverse deformation field computed" << std::endl;
+  }
+  else
+  {
+    elxout << "-inv      " << check << std::endl;
+  }
+
   /** Return a value. */
   return returndummy;
 
@@ -735,14 +751,11 @@ TransformBase< TElastix >
   typedef typename FixedImageType::SpacingType   FixedImageSpacingType;
   typedef typename FixedImageType::PointType     FixedImageOriginType;
   typedef typename FixedImageType::DirectionType FixedImageDirectionType;
-  FixedImageSizeType size
-    = this->m_Elastix->GetFixedImage()->GetLargestPossibleRegion().GetSize();
-  FixedImageIndexType index
-    = this->m_Elastix->GetFixedImage()->GetLargestPossibleRegion().GetIndex();
-  FixedImageSpacingType spacing
-    = this->m_Elastix->GetFixedImage()->GetSpacing();
-  FixedImageOriginType origin
-    = this->m_Elastix->GetFixedImage()->GetOrigin();
+  FixedImageSizeType    size;
+  FixedImageIndexType   index;
+  FixedImageSpacingType spacing;
+  FixedImageOriginType  origin;
+  this->GetFixedImageGrid( size, index, spacing, origin );
   /** The following line would be logically: */
   //FixedImageDirectionType direction =
   //  this->m_Elastix->GetFixedImage()->GetDirection();
@@ -923,14 +936,11 @@ TransformBase< TElastix >
   typedef typename FixedImageType::SpacingType   FixedImageSpacingType;
   typedef typename FixedImageType::PointType     FixedImageOriginType;
   typedef typename FixedImageType::DirectionType FixedImageDirectionType;
-  FixedImageSizeType size
-    = this->m_Elastix->GetFixedImage()->GetLargestPossibleRegion().GetSize();
-  FixedImageIndexType index
-    = this->m_Elastix->GetFixedImage()->GetLargestPossibleRegion().GetIndex();
-  FixedImageSpacingType spacing
-    = this->m_Elastix->GetFixedImage()->GetSpacing();
-  FixedImageOriginType origin
-    = this->m_Elastix->GetFixedImage()->GetOrigin();
+  FixedImageSizeType    size;
+  FixedImageIndexType   index;
+  FixedImageSpacingType spacing;
+  FixedImageOriginType  origin;
+  this->GetFixedImageGrid( size, index, spacing, origin );
   /** The following line would be logically: */
   //FixedImageDirectionType direction =
   //  this->m_Elastix->GetFixedImage()->GetDirection();
@@ -1233,11 +1243,52 @@ TransformBase< TElastix >
 
   /** Apply the transform. */
   elxout << "  The input points are transformed." << std::endl;
-  for( unsigned int j = 0; j < nrofpoints; j++ )
+  this->TransformPointsInParallel( inputpointvec, outputpointvec );
+
+  /** Write the output points of a binary input point file as binary too. */
+  if( ippReader->GetPointsAreBinary() )
   {
-    /** Call TransformPoint. */
-    outputpointvec[ j ] = this->GetAsITKBaseType()->TransformPoint( inputpointvec[ j ] );
+    std::string outputPointsFileName = this->m_Configuration
+      ->GetCommandLineArgument( "-out" );
+    outputPointsFileName += "outputpoints.bin";
+    elxout << "  The transformed points are saved in: "
+           <<  outputPointsFileName << std::endl;
 
+    std::vector< double > coordinates( nrofpoints * MovingImageDimension );
+    for( unsigned int j = 0; j < nrofpoints; j++ )
+    {
+      for( unsigned int i = 0; i < MovingImageDimension; i++ )
+      {
+        coordinates[ j * MovingImageDimension + i ] = outputpointvec[ j ][ i ];
+      }
+    }
+
+    std::ofstream outputPointsFile( outputPointsFileName.c_str(),
+      std::ios::out | std::ios::binary );
+    outputPointsFile << "binarypoint " << nrofpoints << " "
+                     << MovingImageDimension << "\n";
+    if( !coordinates.empty() )
+    {
+      itk::ByteSwapper< double >::SwapRangeFromSystemToLittleEndian(
+        &coordinates[ 0 ], coordinates.size() );
+      outputPointsFile.write( reinterpret_cast< const char * >( &coordinates[ 0 ] ),
+        coordinates.size() * sizeof( double ) );
+    }
+
+    /** A failed or short write, e.g. because the disk is full, leaves the
+     * stream in a failed state.
+     */
+    outputPointsFile.close();
+    if( outputPointsFile.fail() )
+    {
+      itkExceptionMacro( << "ERROR: could not write all " << nrofpoints
+                         << " transformed points to " << outputPointsFileName );
+    }
+    return;
+  }
+
+  for( unsigned int j = 0; j < nrofpoints; j++ )
+  {
     /** Transform back to index in fixed image domain. */
     dummyImage->TransformPhysicalPointToContinuousIndex(
       outputpointvec[ j ], fixedcindex );
@@ -1351,8 +1402,7 @@ TransformBase< TElastix >
     DummyIPPPixelType, FixedImageDimension, MeshTraitsType > MeshType;
   typedef itk::MeshFileReader< MeshType > MeshReaderType;
   typedef itk::MeshFileWriter< MeshType > MeshWriterType;
-  typedef itk::TransformMeshFilter<
-    MeshType, MeshType, CombinationTransformType >       TransformMeshFilterType;
+  typedef typename MeshType::PointsContainer PointsContainerType;
 
   /** Read the input points. */
   typename MeshReaderType::Pointer meshReader = MeshReaderType::New();
@@ -1373,20 +1423,36 @@ TransformBase< TElastix >
   unsigned long nrofpoints = meshReader->GetOutput()->GetNumberOfPoints();
   elxout << "  Number of specified input points: " << nrofpoints << std::endl;
 
-  /** Apply the transform. */
+  /** Apply the transform to the points of the mesh, in place. */
   elxout << "  The input points are transformed." << std::endl;
-  typename TransformMeshFilterType::Pointer meshTransformer = TransformMeshFilterType::New();
-  meshTransformer->SetTransform(
-    const_cast< CombinationTransformType * >( this->GetAsCombinationTransform() ) );
-  meshTransformer->SetInput( meshReader->GetOutput() );
-  try
-  {
-    meshTransformer->Update();
-  }
-  catch( itk::ExceptionObject & err )
-  {
-    xl::xout[ "error" ] << "  Error while transforming points." << std::endl;
-    xl::xout[ "error" ] << err << std::endl;
+  typename MeshType::Pointer mesh   = meshReader->GetOutput();
+  PointsContainerType *      points = mesh->GetPoints();
+  if( points )
+  {
+    std::vector< InputPointType >  inputPoints;
+    std::vector< OutputPointType > outputPoints;
+    inputPoints.reserve( points->Size() );
+    for( typename PointsContainerType::ConstIterator it = points->Begin();
+      it != points->End(); ++it )
+    {
+      inputPoints.push_back( it.Value() );
+    }
+    try
+    {
+      this->TransformPointsInParallel( inputPoints, outputPoints );
+    }
+    catch( itk::ExceptionObject & err )
+    {
+      xl::xout[ "error" ] << "  Error while transforming points." << std::endl;
+      xl::xout[ "error" ] << err << std::endl;
+      return;
+    }
+    std::size_t j = 0;
+    for( typename PointsContainerType::Iterator it = points->Begin();
+      it != points->End(); ++it, ++j )
+    {
+      it.Value() = outputPoints[ j ];
+    }
   }
 
   /** Create filename and file stream. */
@@ -1397,7 +1463,7 @@ TransformBase< TElastix >
          <<  outputPointsFileName << std::endl;
   typename MeshWriterType::Pointer meshWriter = MeshWriterType::New();
   meshWriter->SetFileName( outputPointsFileName.c_str() );
-  meshWriter->SetInput( meshTransformer->GetOutput() );
+  meshWriter->SetInput( mesh );
 
   try
   {
@@ -1412,23 +1478,123 @@ TransformBase< TElastix >
 } // end TransformPointsSomePointsVTK()
 
 
+/**
+ * ************** TransformPointsInParallel *********************
+ */
+
+template< class TElastix >
+void
+TransformBase< TElastix >
+::TransformPointsInParallel( const std::vector< InputPointType > & inputPoints,
+  std::vector< OutputPointType > & outputPoints ) const
+{
+  outputPoints.resize( inputPoints.size() );
+  if( inputPoints.empty() ) { return; }
+
+  /** Fill the threader parameter struct with information. */
+  TransformPointsThreaderParameterType temp;
+  temp.t_Transform    = this->GetAsITKBaseType();
+  temp.t_InputPoints  = &inputPoints;
+  temp.t_OutputPoints = &outputPoints;
+
+  /** Use the threads of this registration, but not more than points. */
+  itk::ThreadIdType numberOfThreads = this->GetElastix()->GetNumberOfThreads();
+  if( inputPoints.size() < numberOfThreads )
+  {
+    numberOfThreads = static_cast< itk::ThreadIdType >( inputPoints.size() );
+  }
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( numberOfThreads );
+  threader->SetSingleMethod( TransformPointsThreaderCallback, &temp );
+  threader->SingleMethodExecute();
+
+} // end TransformPointsInParallel()
+
+
+/**
+ * ************** TransformPointsThreaderCallback *********************
+ */
+
+template< class TElastix >
+ITK_THREAD_RETURN_TYPE
+TransformBase< TElastix >
+::TransformPointsThreaderCallback( void * arg )
+{
+  /** Get the current thread id and user data. */
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *                       infoStruct  = static_cast< ThreadInfoType * >( arg );
+  const std::size_t                      threadId    = infoStruct->ThreadID;
+  const std::size_t                      nrOfThreads = infoStruct->NumberOfThreads;
+  TransformPointsThreaderParameterType * temp
+    = static_cast< TransformPointsThreaderParameterType * >( infoStruct->UserData );
+
+  /** Compute the range for this thread. */
+  const std::size_t nrOfPoints = temp->t_InputPoints->size();
+  const std::size_t subSize    = ( nrOfPoints + nrOfThreads - 1 ) / nrOfThreads;
+  const std::size_t jmin       = std::min( threadId * subSize, nrOfPoints );
+  const std::size_t jmax       = std::min( jmin + subSize, nrOfPoints );
+
+  /** Transform the points of this range. */
+  for( std::size_t j = jmin; j < jmax; j++ )
+  {
+    ( *temp->t_OutputPoints )[ j ]
+      = temp->t_Transform->TransformPoint( ( *temp->t_InputPoints )[ j ] );
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+
+} // end TransformPointsThreaderCallback()
+
+
 /**
  * ************** TransformPointsAllPoints **********************
  *
  * This function transforms all indexes to a physical point.
  * The difference vector (= the deformation at that index) is
- * stored in an image of vectors (of floats).
+ * stored in an image of vectors, of floats or doubles.
  */
 
 template< class TElastix >
 void
 TransformBase< TElastix >
 ::TransformPointsAllPoints( void ) const
+{
+  /** Read the component type of the deformation vectors. */
+  std::string pixelType = "float";
+  this->m_Configuration->ReadParameter( pixelType,
+    "DeformationFieldPixelType", 0, false );
+  if( pixelType == "double" )
+  {
+    this->template GenerateDeformationFieldImage< double >();
+  }
+  else
+  {
+    if( pixelType != "float" )
+    {
+      xl::xout[ "warning" ] << "WARNING: DeformationFieldPixelType \"" << pixelType
+                            << "\" is not supported, \"float\" is used instead." << std::endl;
+    }
+    this->template GenerateDeformationFieldImage< float >();
+  }
+
+} // end TransformPointsAllPoints()
+
+
+/**
+ * ************** GenerateDeformationFieldImage **********************
+ */
+
+template< class TElastix >
+template< class TComponent >
+void
+TransformBase< TElastix >
+::GenerateDeformationFieldImage( void ) const
 {
   /** Typedef's. */
   typedef typename FixedImageType::DirectionType FixedImageDirectionType;
   typedef itk::Vector<
-    float, FixedImageDimension >                      VectorPixelType;
+    TComponent, FixedImageDimension >                 VectorPixelType;
   typedef itk::Image<
     VectorPixelType, FixedImageDimension >            DeformationFieldImageType;
   typedef itk::TransformToDisplacementFieldFilter<
@@ -1484,6 +1650,31 @@ TransformBase< TElastix >
   defWriter->SetInput( infoChanger->GetOutput() );
   defWriter->SetFileName( makeFileName.str().c_str() );
 
+  /** Possibly compress the image. */
+  bool doCompression = false;
+  this->m_Configuration->ReadParameter( doCompression,
+    "CompressDeformationField", 0, false );
+  defWriter->SetUseCompression( doCompression );
+
+  /** Possibly generate and write the image in slabs, to limit memory usage.
+   * The ITK writers can not stream compressed images, so then the whole
+   * deformation field is kept in memory.
+   */
+  const unsigned int numberOfStreamDivisions = this->GetNumberOfStreamDivisions();
+  defWriter->SetNumberOfStreamDivisions( numberOfStreamDivisions );
+  if( numberOfStreamDivisions > 1 && doCompression )
+  {
+    xl::xout[ "warning" ] << "WARNING: CompressDeformationField is \"true\", so the "
+                          << "deformation field is written at once, and the "
+                          << "NumberOfStreamDivisions (" << numberOfStreamDivisions
+                          << ") do not limit the memory usage." << std::endl;
+  }
+  else if( numberOfStreamDivisions > 1 )
+  {
+    elxout << "  Streaming the output in " << numberOfStreamDivisions
+           << " divisions." << std::endl;
+  }
+
   /** Do the writing. */
   elxout << "  Computing and writing the deformation field ..." << std::endl;
   try
@@ -1493,7 +1684,7 @@ TransformBase< TElastix >
   catch( itk::ExceptionObject & excp )
   {
     /** Add information to the exception. */
-    excp.SetLocation( "TransformBase - TransformPointsAllPoints()" );
+    excp.SetLocation( "TransformBase - GenerateDeformationFieldImage()" );
     std::string err_str = excp.GetDescription();
     err_str += "\nError occurred while writing deformation field image.\n";
     excp.SetDescription( err_str );
@@ -1502,7 +1693,7 @@ TransformBase< TElastix >
     throw excp;
   }
 
-} // end TransformPointsAllPoints()
+} // end GenerateDeformationFieldImage()
 
 
 /**
@@ -1587,6 +1778,15 @@ TransformBase< TElastix >
   jacWriter->SetInput( infoChanger->GetOutput() );
   jacWriter->SetFileName( makeFileName.str().c_str() );
 
+  /** Possibly generate and write the image in slabs, to limit memory usage. */
+  const unsigned int numberOfStreamDivisions = this->GetNumberOfStreamDivisions();
+  jacWriter->SetNumberOfStreamDivisions( numberOfStreamDivisions );
+  if( numberOfStreamDivisions > 1 )
+  {
+    elxout << "  Streaming the output in " << numberOfStreamDivisions
+           << " divisions." << std::endl;
+  }
+
   /** Do the writing. */
   elxout << "  Computing and writing the spatial Jacobian determinant..." << std::endl;
   try
@@ -1689,6 +1889,15 @@ TransformBase< TElastix >
   typename JacobianWriterType::Pointer jacWriter = JacobianWriterType::New();
   jacWriter->SetInput( infoChanger->GetOutput() );
   jacWriter->SetFileName( makeFileName.str().c_str() );
+
+  /** Possibly generate and write the image in slabs, to limit memory usage. */
+  const unsigned int numberOfStreamDivisions = this->GetNumberOfStreamDivisions();
+  jacWriter->SetNumberOfStreamDivisions( numberOfStreamDivisions );
+  if( numberOfStreamDivisions > 1 )
+  {
+    elxout << "  Streaming the output in " << numberOfStreamDivisions
+           << " divisions." << std::endl;
+  }
   /** Hack to change the pixel type to vector. Not necessary for mhd. */
   typename PixelTypeChangeCommandType::Pointer jacStartWriteCommand
     = PixelTypeChangeCommandType::New();
@@ -1718,6 +1927,272 @@ TransformBase< TElastix >
 } // end ComputeSpatialJacobian()
 
 
+/**
+ * ************** ComputeInverseDeformationField **********************
+ *
+ * This function computes the inverse of the transform directly, by a
+ * multi-threaded fixed-point iteration at every voxel, instead of by a
+ * second registration. Optionally the inverse is also fitted with a
+ * B-spline, which is written as a transform parameter file.
+ */
+
+template< class TElastix >
+void
+TransformBase< TElastix >
+::ComputeInverseDeformationField( void ) const
+{
+  /** If the optional command "-inv" is given in the command line arguments,
+   * then and only then we continue.
+   */
+  std::string inv = this->GetConfiguration()->GetCommandLineArgument( "-inv" );
+  if( inv != "all" )
+  {
+    elxout << "  The command-line option \"-inv\" is not used, "
+           << "so no inverse deformation field computed." << std::endl;
+    return;
+  }
+
+  /** Typedef's. */
+  typedef typename FixedImageType::DirectionType FixedImageDirectionType;
+  typedef itk::Vector<
+    float, FixedImageDimension >                      VectorPixelType;
+  typedef itk::Image<
+    VectorPixelType, FixedImageDimension >            DeformationFieldImageType;
+  typedef itk::TransformToInverseDisplacementFieldSource<
+    DeformationFieldImageType, CoordRepType >         InverseGeneratorType;
+  typedef itk::ChangeInformationImageFilter<
+    DeformationFieldImageType >                       ChangeInfoFilterType;
+  typedef itk::ImageFileWriter<
+    DeformationFieldImageType >                       DeformationFieldWriterType;
+
+  /** Read the settings of the fixed-point iteration. */
+  unsigned int maximumNumberOfIterations = 50;
+  double       tolerance                 = 1e-3;
+  unsigned int coarseGridFactor          = 4;
+  this->m_Configuration->ReadParameter( maximumNumberOfIterations,
+    "InverseMaximumNumberOfIterations", 0, false );
+  this->m_Configuration->ReadParameter( tolerance, "InverseTolerance", 0, false );
+  this->m_Configuration->ReadParameter( coarseGridFactor, "InverseCoarseGridFactor", 0, false );
+
+  /** Create and setup the inverse deformation field generator. */
+  typename InverseGeneratorType::Pointer invGenerator = InverseGeneratorType::New();
+  invGenerator->SetTransform( const_cast< const ITKBaseType * >(
+      this->GetAsITKBaseType() ) );
+  invGenerator->SetOutputSize(
+    this->m_Elastix->GetElxResamplerBase()->GetAsITKBaseType()->GetSize() );
+  invGenerator->SetOutputSpacing(
+    this->m_Elastix->GetElxResamplerBase()->GetAsITKBaseType()->GetOutputSpacing() );
+  invGenerator->SetOutputOrigin(
+    this->m_Elastix->GetElxResamplerBase()->GetAsITKBaseType()->GetOutputOrigin() );
+  invGenerator->SetOutputIndex(
+    this->m_Elastix->GetElxResamplerBase()->GetAsITKBaseType()->GetOutputStartIndex() );
+  invGenerator->SetOutputDirection(
+    this->m_Elastix->GetElxResamplerBase()->GetAsITKBaseType()->GetOutputDirection() );
+  invGenerator->SetMaximumNumberOfIterations( maximumNumberOfIterations );
+  invGenerator->SetTolerance( tolerance );
+  invGenerator->SetCoarseGridFactor( vnl_math_max( coarseGridFactor, 1u ) );
+
+  /** Possibly change direction cosines to their original value, as specified
+   * in the tp-file, or by the fixed image. This is only necessary when
+   * the UseDirectionCosines flag was set to false.
+   */
+  typename ChangeInfoFilterType::Pointer infoChanger = ChangeInfoFilterType::New();
+  FixedImageDirectionType originalDirection;
+  bool                    retdc = this->GetElastix()->GetOriginalFixedImageDirection( originalDirection );
+  infoChanger->SetOutputDirection( originalDirection );
+  infoChanger->SetChangeDirection( retdc & !this->GetElastix()->GetUseDirectionCosines() );
+  infoChanger->SetInput( invGenerator->GetOutput() );
+
+#ifndef _ELASTIX_BUILD_LIBRARY
+  /** Track the progress of the generation of the inverse deformation field. */
+  typename ProgressCommandType::Pointer progressObserver = ProgressCommandType::New();
+  progressObserver->ConnectObserver( invGenerator );
+  progressObserver->SetStartString( "  Progress: " );
+  progressObserver->SetEndString( "%" );
+#endif
+
+  /** Create a name for the inverse deformation field file. */
+  std::string resultImageFormat = "mhd";
+  this->m_Configuration->ReadParameter( resultImageFormat, "ResultImageFormat", 0, false );
+  std::ostringstream makeFileName( "" );
+  makeFileName << this->m_Configuration->GetCommandLineArgument( "-out" )
+               << "inverseDeformationField." << resultImageFormat;
+
+  /** Write outputImage to disk. */
+  typename DeformationFieldWriterType::Pointer defWriter
+    = DeformationFieldWriterType::New();
+  defWriter->SetInput( infoChanger->GetOutput() );
+  defWriter->SetFileName( makeFileName.str().c_str() );
+
+  /** Possibly generate and write the image in slabs, to limit memory usage.
+   * The ITK writers can not stream compressed images, so then the whole
+   * deformation field is kept in memory.
+   */
+  const unsigned int numberOfStreamDivisions = this->GetNumberOfStreamDivisions();
+  defWriter->SetNumberOfStreamDivisions( numberOfStreamDivisions );
+  if( numberOfStreamDivisions > 1 && doCompression )
+  {
+    xl::xout[ "warning" ] << "WARNING: CompressDeformationField is \"true\", so the "
+                          << "deformation field is written at once, and the "
+                          << "NumberOfStreamDivisions (" << numberOfStreamDivisions
+                          << ") do not limit the memory usage." << std::endl;
+  }
+  else if( numberOfStreamDivisions > 1 )
+  {
+    elxout << "  Streaming the output in " << numberOfStreamDivisions
+           << " divisions." << std::endl;
+  }
+
+  /** Do the writing. */
+  elxout << "  Computing and writing the inverse deformation field ..." << std::endl;
+  try
+  {
+    defWriter->Update();
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    /** Add information to the exception. */
+    excp.SetLocation( "TransformBase - ComputeInverseDeformationField()" );
+    std::string err_str = excp.GetDescription();
+    err_str += "\nError occurred while writing inverse deformation field image.\n";
+    excp.SetDescription( err_str );
+
+    /** Pass the exception to an higher level. */
+    throw excp;
+  }
+
+  /** Report the convergence. */
+  elxout << "  Maximum residual of the inverse: "
+         << invGenerator->GetMaximumResidual() << std::endl;
+  if( invGenerator->GetNumberOfNonConvergedPoints() > 0 )
+  {
+    xl::xout[ "warning" ] << "WARNING: the inverse did not converge in "
+                          << invGenerator->GetNumberOfNonConvergedPoints()
+                          << " voxels. The transform may not be invertible there." << std::endl;
+  }
+
+  /** Possibly fit the inverse with a B-spline. */
+  bool writeInverseBSpline = false;
+  this->m_Configuration->ReadParameter( writeInverseBSpline,
+    "WriteInverseBSplineTransform", 0, false );
+  if( !writeInverseBSpline )
+  {
+    return;
+  }
+
+  typedef itk::AdvancedBSplineDeformableTransformBase<
+    CoordRepType, FixedImageDimension >               BSplineTransformBaseType;
+  const BSplineTransformBaseType * bspline = dynamic_cast< const BSplineTransformBaseType * >(
+    this->GetAsITKBaseType()->GetCurrentTransform() );
+  if( bspline == 0 )
+  {
+    xl::xout[ "warning" ] << "WARNING: WriteInverseBSplineTransform requires a B-spline "
+                          << "transform, so no inverse B-spline transform is written." << std::endl;
+    return;
+  }
+
+  bool useCyclicTransform = false;
+  this->m_Configuration->ReadParameter( useCyclicTransform, "UseCyclicTransform", 0, false );
+  if( useCyclicTransform )
+  {
+    xl::xout[ "warning" ] << "WARNING: WriteInverseBSplineTransform does not support a cyclic "
+                          << "B-spline, so no inverse B-spline transform is written." << std::endl;
+    return;
+  }
+
+  /** Fit a B-spline of the same order on the grid of the forward transform. */
+  unsigned int splineOrder = 3;
+  this->m_Configuration->ReadParameter( splineOrder, "BSplineTransformSplineOrder", 0, false );
+  ParametersType inverseParameters;
+  invGenerator->ComputeInverseBSplineParameters(
+    bspline->GetGridRegion(), bspline->GetGridSpacing(),
+    bspline->GetGridOrigin(), bspline->GetGridDirection(),
+    splineOrder, inverseParameters );
+
+  /** Write it like any transform parameter file. The B-spline replaces the
+   * whole chain of transforms, so it is written without initial transform.
+   * Its image grid is the output grid of the inverse field.
+   */
+  std::ostringstream makeParameterFileName( "" );
+  makeParameterFileName << this->m_Configuration->GetCommandLineArgument( "-out" )
+                        << "TransformParameters.inverse.txt";
+  this->m_WriteWithoutInitialTransform = true;
+  try
+  {
+    this->m_Elastix->WriteTransformParameterFile(
+      makeParameterFileName.str(), inverseParameters, false );
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    this->m_WriteWithoutInitialTransform = false;
+    excp.SetLocation( "TransformBase - ComputeInverseDeformationField()" );
+    std::string err_str = excp.GetDescription();
+    err_str += "\nError occurred while writing the inverse B-spline transform.\n";
+    excp.SetDescription( err_str );
+    throw excp;
+  }
+  this->m_WriteWithoutInitialTransform = false;
+
+  elxout << "  The inverse B-spline transform is written to "
+         << makeParameterFileName.str() << std::endl;
+
+} // end ComputeInverseDeformationField()
+
+
+/**
+ * ************** GetNumberOfStreamDivisions **********************
+ */
+
+template< class TElastix >
+unsigned int
+TransformBase< TElastix >
+::GetNumberOfStreamDivisions( void ) const
+{
+  unsigned int numberOfStreamDivisions = 1;
+  this->m_Configuration->ReadParameter( numberOfStreamDivisions,
+    "NumberOfStreamDivisions", 0, false );
+
+  return vnl_math_max( numberOfStreamDivisions, 1u );
+
+} // end GetNumberOfStreamDivisions()
+
+
+/**
+ * ************** GetFixedImageGrid **********************
+ */
+
+template< class TElastix >
+void
+TransformBase< TElastix >
+::GetFixedImageGrid( typename FixedImageType::SizeType & size,
+  typename FixedImageType::IndexType & index,
+  typename FixedImageType::SpacingType & spacing,
+  typename FixedImageType::PointType & origin ) const
+{
+  const FixedImageType * fixedImage = this->m_Elastix->GetFixedImage();
+  if( fixedImage )
+  {
+    size    = fixedImage->GetLargestPossibleRegion().GetSize();
+    index   = fixedImage->GetLargestPossibleRegion().GetIndex();
+    spacing = fixedImage->GetSpacing();
+    origin  = fixedImage->GetOrigin();
+    return;
+  }
+
+  /** In transformix there is no fixed image. */
+  const typename ElastixType::ResamplerBaseType::ITKBaseType * resampler
+    = this->m_Elastix->GetElxResamplerBase()->GetAsITKBaseType();
+  for( unsigned int i = 0; i < FixedImageDimension; ++i )
+  {
+    size[ i ]    = resampler->GetSize()[ i ];
+    index[ i ]   = resampler->GetOutputStartIndex()[ i ];
+    spacing[ i ] = resampler->GetOutputSpacing()[ i ];
+    origin[ i ]  = resampler->GetOutputOrigin()[ i ];
+  }
+
+} // end GetFixedImageGrid()
+
+
 /**
  * ************** SetTransformParametersFileName ****************
  */
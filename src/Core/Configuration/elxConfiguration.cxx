@@ -266,6 +266,19 @@ Configuration
 } // end SetCommandLineArgument()
 
 
+/**
+ * ****************** SetCommandLineArguments ********************
+ */
+
+void
+Configuration
+::SetCommandLineArguments( const CommandLineArgumentMapType & _arg )
+{
+  this->m_CommandLineArgumentMap = _arg;
+
+} // end SetCommandLineArguments()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef __elxMyConfiguration_CXX__
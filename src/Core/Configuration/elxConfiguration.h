@@ -79,6 +79,11 @@ public:
 
   void SetCommandLineArgument( const std::string & key, const std::string & value );
 
+  /** Replace all command line arguments, but keep the parameters that were
+   * read from the (transform) parameter file by Initialize().
+   */
+  void SetCommandLineArguments( const CommandLineArgumentMapType & _arg );
+
   /** Get/Set the name of the parameterFileName. */
   itkGetStringMacro( ParameterFileName );
   itkSetStringMacro( ParameterFileName );
@@ -18,6 +18,8 @@
 #include "elxElastixBase.h"
 #include <sstream>
 #include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkProcessObject.h"
+#include "itkThreadBudget.h"
 
 namespace elastix
 {
@@ -65,13 +67,37 @@ ElastixBase::ElastixBase()
   this->m_InitialTransform = 0;
   this->m_FinalTransform   = 0;
 
+  /** The computation cache is set by ElastixMain. */
+  this->m_ComputationCache = 0;
+
   /** From Elastix 4.3 to 4.7: Ignore direction cosines by default, for
    * backward compatability. From Elastix 4.8: set it to true by default.*/
   this->m_UseDirectionCosines = true;
 
+  /** Read the transform in every call of ApplyTransform(). */
+  this->m_ReuseTransform = false;
+
+  /** The write queue is created by BeforeAllBase, if desired. */
+  this->m_WriteQueue = 0;
+
+  /** Until the registration is registered at the thread budget. */
+  this->m_NumberOfThreads = itk::ThreadBudget::GetInstance()->GetTotalNumberOfThreads();
+
 } // end Constructor
 
 
+/**
+ * ********************* Destructor ***********************
+ */
+
+ElastixBase::~ElastixBase()
+{
+  /** Give the threads of this registration to the others. */
+  itk::ThreadBudget::GetInstance()->Unregister( this );
+
+} // end Destructor
+
+
 /**
  * ********************* SetDBIndex ***********************
  */
@@ -211,15 +237,7 @@ ElastixBase::BeforeAllBase( void )
 #endif
 
   /** Check for appearance of -threads, which specifies the maximum number of threads. */
-  check = this->GetConfiguration()->GetCommandLineArgument( "-threads" );
-  if( check == "" )
-  {
-    elxout << "-threads  unspecified, so all available threads are used" << std::endl;
-  }
-  else
-  {
-    elxout << "-threads  " << check << std::endl;
-  }
+  this->RegisterAtThreadBudget();
 
   /** Check the very important UseDirectionCosines parameter. */
   this->m_UseDirectionCosines = true;
@@ -245,6 +263,36 @@ ElastixBase::BeforeAllBase( void )
   RandomGeneratorType::Pointer randomGenerator = RandomGeneratorType::GetInstance();
   randomGenerator->SetSeed( static_cast< SeedType >( randomSeed ) );
 
+  /** Only use the computation cache that is shared by the registrations
+   * if desired, since it keeps the stored images in memory. A batch of
+   * moving images uses it by default, to share the fixed image preprocessing.
+   */
+  bool useComputationCache
+    = this->GetConfiguration()->GetCommandLineArgument( "-mlist" ) != "";
+  this->GetConfiguration()->ReadParameter( useComputationCache,
+    "UseComputationCache", 0, false );
+  if( !useComputationCache )
+  {
+    this->m_ComputationCache = 0;
+  }
+
+  /** Only write the intermediate images in the background if there is a
+   * memory budget for the images that wait to be written.
+   */
+  double asynchronousOutputMemoryBudget = 0.0;
+  this->GetConfiguration()->ReadParameter( asynchronousOutputMemoryBudget,
+    "AsynchronousOutputMemoryBudget", 0, false );
+  if( asynchronousOutputMemoryBudget > 0.0 )
+  {
+    this->m_WriteQueue = WriteQueueType::New();
+    this->m_WriteQueue->SetMemoryBudget( static_cast< itk::SizeValueType >(
+      asynchronousOutputMemoryBudget * 1024.0 * 1024.0 ) );
+  }
+  else
+  {
+    this->m_WriteQueue = 0;
+  }
+
   /** Return a value. */
   return returndummy;
 
@@ -304,15 +352,7 @@ ElastixBase::BeforeAllTransformixBase( void )
   }
 
   /** Check for appearance of -threads, which specifies the maximum number of threads. */
-  check = this->GetConfiguration()->GetCommandLineArgument( "-threads" );
-  if( check == "" )
-  {
-    elxout << "-threads  unspecified, so all available threads are used" << std::endl;
-  }
-  else
-  {
-    elxout << "-threads  " << check << std::endl;
-  }
+  this->RegisterAtThreadBudget();
 #ifndef _ELASTIX_BUILD_LIBRARY
   /** Print "-tp". */
   check = this->GetConfiguration()->GetCommandLineArgument( "-tp" );
@@ -364,6 +404,33 @@ ElastixBase::AfterRegistrationBase( void )
   /** Remove the "iteration" writing field. */
   xl::xout.RemoveTargetCell( "iteration" );
 
+  /** Print some statistics of the computation cache. */
+  if( this->m_ComputationCache.IsNotNull() )
+  {
+    elxout << "Computation cache: "
+           << this->m_ComputationCache->GetNumberOfEntries() << " results stored, "
+           << this->m_ComputationCache->GetNumberOfHits() << " reused." << std::endl;
+  }
+
+  /** Wait for the intermediate images that are written in the background. */
+  if( this->m_WriteQueue.IsNotNull() )
+  {
+    elxout << "Waiting for the images that are written in the background ..." << std::endl;
+    try
+    {
+      this->m_WriteQueue->Flush();
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      xl::xout[ "error" ] << "Exception caught: " << std::endl;
+      xl::xout[ "error" ] << excp << "Resuming elastix." << std::endl;
+    }
+    elxout << "  " << this->m_WriteQueue->GetNumberOfExecutedJobs()
+           << " images were written in the background, with at most "
+           << static_cast< double >( this->m_WriteQueue->GetPeakMemorySize() ) / 1048576.0
+           << " MB waiting." << std::endl;
+  }
+
 } // end AfterRegistrationBase()
 
 
@@ -467,6 +534,76 @@ ElastixBase::GetUseDirectionCosines( void ) const
 }
 
 
+/**
+ * ********************* RegisterAtThreadBudget ***********************
+ */
+
+void
+ElastixBase::RegisterAtThreadBudget( void )
+{
+  /** No maximum is 0. */
+  const std::string check = this->GetConfiguration()->GetCommandLineArgument( "-threads" );
+  if( check == "" )
+  {
+    elxout << "-threads  unspecified, so all available threads are used" << std::endl;
+  }
+  else
+  {
+    elxout << "-threads  " << check << std::endl;
+  }
+  const unsigned int maximumNumberOfThreads
+    = check == "" ? 0 : static_cast< unsigned int >( atoi( check.c_str() ) );
+  itk::ThreadBudget::GetInstance()->Register( this, maximumNumberOfThreads );
+  this->m_NumberOfThreads = itk::ThreadBudget::GetInstance()->GetNumberOfThreads( this );
+
+} // end RegisterAtThreadBudget()
+
+
+/**
+ * ********************* UpdateNumberOfThreads ***********************
+ */
+
+void
+ElastixBase::UpdateNumberOfThreads( void )
+{
+  itk::ThreadBudget::Pointer budget = itk::ThreadBudget::GetInstance();
+  const itk::ThreadIdType numberOfThreads = budget->GetNumberOfThreads( this );
+  if( numberOfThreads != this->m_NumberOfThreads && budget->GetNumberOfClients() > 1 )
+  {
+    elxout << "The share of this registration changed from "
+           << this->m_NumberOfThreads << " to " << numberOfThreads
+           << " threads, since " << budget->GetNumberOfClients()
+           << " registrations run concurrently." << std::endl;
+  }
+  this->m_NumberOfThreads = numberOfThreads;
+
+  /** Set the number of threads of the components that are process objects,
+   * such as the pyramids, the samplers and the resampler.
+   */
+  ObjectContainerPointer containers[] = {
+    this->m_FixedImagePyramidContainer, this->m_MovingImagePyramidContainer,
+    this->m_InterpolatorContainer, this->m_ImageSamplerContainer,
+    this->m_MetricContainer, this->m_OptimizerContainer,
+    this->m_RegistrationContainer, this->m_ResamplerContainer,
+    this->m_ResampleInterpolatorContainer, this->m_TransformContainer
+  };
+  for( unsigned int c = 0; c < sizeof( containers ) / sizeof( containers[ 0 ] ); ++c )
+  {
+    if( containers[ c ].IsNull() ) { continue; }
+    for( unsigned int i = 0; i < containers[ c ]->Size(); ++i )
+    {
+      itk::ProcessObject * processObject
+        = dynamic_cast< itk::ProcessObject * >( containers[ c ]->ElementAt( i ).GetPointer() );
+      if( processObject )
+      {
+        processObject->SetNumberOfThreads( numberOfThreads );
+      }
+    }
+  }
+
+} // end UpdateNumberOfThreads()
+
+
 /**
  * ******************** SetOriginalFixedImageDirectionFlat ********************
  */
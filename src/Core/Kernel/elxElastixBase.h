@@ -38,6 +38,9 @@
 #include "itkVectorContainer.h"
 #include "itkImageFileReader.h"
 #include "itkChangeInformationImageFilter.h"
+#include "itkComputationCache.h"
+#include "itkAsynchronousWriteQueue.h"
+#include "itkIntTypes.h"
 
 #include <fstream>
 #include <iomanip>
@@ -97,12 +100,40 @@ namespace elastix
  *   Most importantly, it affects the output precision of the parameters in the transform parameter file.\n
  *   example: <tt>(DefaultOutputPrecision 6)</tt>\n
  *   Default value: 6.
+ * \parameter UseComputationCache: Whether to reuse the results of expensive operations
+ *   of previous registrations, when elastix is run with multiple parameter files, or with
+ *   a batch of moving images (see -mlist). The pyramid images, the eroded masks, the
+ *   B-spline interpolation coefficients, the image extrema and the samples of the grid
+ *   and full samplers are stored, and reused when a next registration asks for the
+ *   same operation on the same image. This saves time, but the stored images are kept
+ *   in memory until elastix finishes, or, for a batch, until the moving image is done.
+ *   Set the option in each parameter file that should store or reuse results.\n
+ *   example: <tt>(UseComputationCache "true")</tt>\n
+ *   Default value: "false", or "true" for a batch of moving images.
+ * \parameter AsynchronousOutputMemoryBudget: The memory in MB of the intermediate images
+ *   that may wait to be written in the background. With a budget, the result images of
+ *   WriteResultImageAfterEachIteration and WriteResultImageAfterEachResolution, and the
+ *   images of WritePyramidImagesAfterEachResolution, are cast, compressed and written by a
+ *   background thread, while the registration continues. The registration only waits when
+ *   the waiting images exceed the budget. The budget counts the images that wait or are
+ *   being written, including the buffer in which an image is cast to the ResultImagePixelType,
+ *   but not the memory of the image file writers and the compression. The resampling itself
+ *   is still done by the registration, since it needs the current transform. The background
+ *   thread takes one thread of the itk::ThreadBudget, see -threads.\n
+ *   example: <tt>(AsynchronousOutputMemoryBudget 1024)</tt>\n
+ *   Default value: 0, which means that the images are written directly.
  *
  * The command line arguments used by this class are:
  * \commandlinearg -f: mandatory argument for elastix with the file name of the fixed image. \n
  *    example: <tt>-f fixedImage.mhd</tt> \n
  * \commandlinearg -m: mandatory argument for elastix with the file name of the moving image. \n
  *    example: <tt>-m movingImage.mhd</tt> \n
+ * \commandlinearg -mlist: argument for elastix that replaces -m, with a text file that lists
+ *    the moving images, one per line, or a directory with the moving images. Each moving
+ *    image is registered to the fixed image, and the results are written to a subdirectory
+ *    of the output directory, named after the moving image. The fixed image and mask are
+ *    read once, and their preprocessing is shared by the registrations. \n
+ *    example: <tt>-mlist movingImages.txt</tt> \n
  * \commandlinearg -out: mandatory argument for both elastix and transformix
  *    with the name of the directory that is going to contain everything that
  *    elastix or tranformix returns as output. \n
@@ -131,11 +162,22 @@ namespace elastix
  *    This argument is only valid for running under Windows. For Linux, run
  *    elastix with "nice".
  * \commandlinearg -threads: optional argument for both elastix and transformix to
- *    specify the maximum number of threads used by this process. Default: no maximum. \n
+ *    specify the maximum number of threads used by this registration. Default: no maximum. \n
  *    example: <tt>-threads 2</tt> \n
+ *    Registrations that run concurrently in one process share the threads of the
+ *    itk::ThreadBudget of the process, which has a thread per core by default. Each
+ *    registration gets its share at the start of every resolution, so the share grows
+ *    when other registrations finish. The components of a registration use its share,
+ *    instead of the global number of threads of ITK.
  * \commandlinearg -in: optional argument for transformix with the file name of an input image. \n
  *    example: <tt>-in inputImage.mhd</tt> \n
  *    If this option is skipped, a deformation field of the transform will be generated.
+ *    Several input images are given as <tt>-in0</tt>, <tt>-in1</tt>, etc. They are
+ *    resampled with one evaluation of the transform per output voxel, and written to
+ *    result.0.mhd, result.1.mhd, etc.
+ * \commandlinearg -inlist: argument for transformix that replaces -in, with a text file
+ *    that lists the input images, one per line, or a directory with the input images. \n
+ *    example: <tt>-inlist channels.txt</tt> \n
  *
  * \ingroup Kernel
  */
@@ -164,6 +206,10 @@ public:
   typedef itk::VectorContainer<
     unsigned int, std::string >               FileNameContainerType;
   typedef FileNameContainerType::Pointer FileNameContainerPointer;
+  typedef itk::ComputationCache            ComputationCacheType;
+  typedef ComputationCacheType::Pointer    ComputationCachePointer;
+  typedef itk::AsynchronousWriteQueue      WriteQueueType;
+  typedef WriteQueueType::Pointer          WriteQueuePointer;
 
   /** Other typedef's. */
   typedef ComponentDatabase                ComponentDatabaseType;
@@ -305,6 +351,52 @@ public:
   elxSetObjectMacro( FinalTransform, ObjectType );
   elxGetObjectMacro( FinalTransform, ObjectType );
 
+  /** Set/Get the cache that is shared by the registrations of multiple
+   * parameter files. Get returns null if the UseComputationCache
+   * parameter is false.
+   */
+  elxSetObjectMacro( ComputationCache, ComputationCacheType );
+  elxGetObjectMacro( ComputationCache, ComputationCacheType );
+
+  /** Set/Get whether ApplyTransform() uses the transform that was read by a
+   * previous call, instead of reading the transform parameter files again.
+   * The transformix service mode uses this for requests with the same
+   * transform parameter file.
+   */
+  virtual void SetReuseTransform( const bool _arg )
+  {
+    this->m_ReuseTransform = _arg;
+  }
+
+
+  virtual bool GetReuseTransform( void ) const
+  {
+    return this->m_ReuseTransform;
+  }
+
+
+  /** Get the queue that writes the intermediate images in the background.
+   * Returns null if the AsynchronousOutputMemoryBudget parameter is 0, in
+   * which case the components write the images themselves.
+   */
+  elxGetObjectMacro( WriteQueue, WriteQueueType );
+
+  /** Get the number of threads that this registration uses at this moment,
+   * which is its share of the itk::ThreadBudget of the process.
+   */
+  virtual itk::ThreadIdType GetNumberOfThreads( void ) const
+  {
+    return this->m_NumberOfThreads;
+  }
+
+
+  /** Ask the itk::ThreadBudget for the current share of this registration,
+   * and give the components that are process objects that number of threads.
+   * ElastixTemplate calls this function before the registration, before each
+   * resolution, and before applying the transform.
+   */
+  virtual void UpdateNumberOfThreads( void );
+
   /** Empty Run()-function to be overridden. */
   virtual int Run( void ) = 0;
 
@@ -362,7 +454,7 @@ public:
 protected:
 
   ElastixBase();
-  virtual ~ElastixBase() {}
+  virtual ~ElastixBase();
 
   ConfigurationPointer     m_Configuration;
   DBIndexType              m_DBIndex;
@@ -535,9 +627,27 @@ private:
   ObjectPointer m_InitialTransform;
   ObjectPointer m_FinalTransform;
 
+  /** The cache shared by the registrations. */
+  ComputationCachePointer m_ComputationCache;
+
   /** Use or ignore direction cosines. */
   bool m_UseDirectionCosines;
 
+  /** Skip reading the transform in ApplyTransform(). */
+  bool m_ReuseTransform;
+
+  /** The queue that writes the intermediate images in the background. */
+  WriteQueuePointer m_WriteQueue;
+
+  /** The current share of the threads of the process. */
+  itk::ThreadIdType m_NumberOfThreads;
+
+  /** Register this registration at the itk::ThreadBudget, with the maximum
+   * number of threads from the command line argument -threads, which is printed.
+   * The components get their share with GetNumberOfThreads().
+   */
+  void RegisterAtThreadBudget( void );
+
   /** Read a series of command line options that satisfy the following syntax:
    * {-f,-f0} \<filename0\> [-f1 \<filename1\> [ -f2 \<filename2\> ... ] ]
    *
@@ -150,6 +150,8 @@ ElastixMain::ElastixMain()
 
   this->m_ResultImageContainer = 0;
 
+  this->m_ComputationCache = 0;
+
   this->m_FinalTransform   = 0;
   this->m_InitialTransform = 0;
   this->m_TransformParametersMap.clear();
@@ -379,6 +381,11 @@ ElastixMain::Run( void )
   this->GetElastixBase()->SetMovingMaskContainer( this->GetMovingMaskContainer() );
   this->GetElastixBase()->SetResultImageContainer( this->GetResultImageContainer() );
 
+  /** Set the cache that is shared by the registrations. Also this is
+   * optional.
+   */
+  this->GetElastixBase()->SetComputationCache( this->GetComputationCache() );
+
   /** Set the initial transform, if it happens to be there. */
   this->GetElastixBase()->SetInitialTransform( this->GetInitialTransform() );
 
@@ -971,6 +978,7 @@ ElastixMain::SetProcessPriority( void ) const
 void
 ElastixMain::SetMaximumNumberOfThreads( void ) const
 {
+#ifndef _ELASTIX_BUILD_LIBRARY
   /** Get the number of threads from the command line. */
   std::string maximumNumberOfThreadsString
     = this->m_Configuration->GetCommandLineArgument( "-threads" );
@@ -983,6 +991,7 @@ ElastixMain::SetMaximumNumberOfThreads( void ) const
     itk::MultiThreader::SetGlobalMaximumNumberOfThreads(
       maximumNumberOfThreads );
   }
+#endif
 } // end SetMaximumNumberOfThreads()
 
 
@@ -129,6 +129,8 @@ public:
   typedef ElastixBase::ObjectContainerPointer           ObjectContainerPointer;
   typedef ElastixBase::DataObjectContainerPointer       DataObjectContainerPointer;
   typedef ElastixBase::FlatDirectionCosinesType         FlatDirectionCosinesType;
+  typedef ElastixBase::ComputationCacheType             ComputationCacheType;
+  typedef ElastixBase::ComputationCachePointer          ComputationCachePointer;
 
   /** Typedefs for the database that holds pointers to New() functions.
    * Those functions are used to instantiate components, such as the metric etc.
@@ -183,6 +185,13 @@ public:
   itkSetObjectMacro( ResultImageContainer, DataObjectContainerType );
   itkGetObjectMacro( ResultImageContainer, DataObjectContainerType );
 
+  /** Set/Get the cache that is shared by the registrations of multiple
+   * parameter files. It is only used if the UseComputationCache parameter
+   * is true.
+   */
+  itkSetObjectMacro( ComputationCache, ComputationCacheType );
+  itkGetObjectMacro( ComputationCache, ComputationCacheType );
+
   /** Set/Get the configuration object. */
   itkSetObjectMacro( Configuration, ConfigurationType );
   itkGetObjectMacro( Configuration, ConfigurationType );
@@ -269,6 +278,11 @@ public:
   /** Set maximum number of threads, which is read from the command line arguments.
    * Syntax:
    * -threads \<int\>
+   * The executables run one registration at a time, so they also use it as
+   * the global maximum of ITK, which limits the ITK filters that elastix does
+   * not configure. The library does not change the global maximum, since
+   * several registrations may run concurrently; they share the threads of
+   * the itk::ThreadBudget, see ElastixBase.
    */
   virtual void SetMaximumNumberOfThreads( void ) const;
 
@@ -324,6 +338,9 @@ protected:
   DataObjectContainerPointer m_MovingMaskContainer;
   DataObjectContainerPointer m_ResultImageContainer;
 
+  /** The cache shared by the registrations. */
+  ComputationCachePointer m_ComputationCache;
+
   /** A transform that is the result of registration. */
   ObjectPointer m_FinalTransform;
 
@@ -37,6 +37,7 @@
 #include "elxResamplerBase.h"
 #include "elxResampleInterpolatorBase.h"
 #include "elxTransformBase.h"
+#include "elxRegistrationCheckpoint.h"
 
 #include "itkTimeProbe.h"
 
@@ -94,6 +95,29 @@ namespace elastix
  *    example: <tt>(WriteTransformParametersEachResolution "true")</tt>\n
  *    This parameter can not be specified for each resolution separately.
  *    Default value: "false".
+ * \parameter CheckpointInterval: The number of iterations between two checkpoints.
+ *    A checkpoint stores the state of the registration in the file
+ *    Checkpoint.<ElastixLevel>.bin in the output directory: the current
+ *    resolution and iteration, the transform parameters, and the internal state
+ *    of the optimizer, if the optimizer supports that. A checkpoint is also
+ *    written at the start of each resolution and after the registration.
+ *    A registration that was interrupted can be resumed from the checkpoint
+ *    with the command line option "-resume", or with ResumeFromCheckpoint.\n
+ *    example: <tt>(CheckpointInterval 100)</tt>\n
+ *    This parameter can not be specified for each resolution separately.
+ *    Default value: 0, which means that no checkpoints are written.
+ * \parameter ResumeFromCheckpoint: The checkpoint file from which the registration
+ *    is resumed. The resolutions that were completed are not optimized again, and
+ *    the resolution that was interrupted continues from the stored parameters and
+ *    optimizer state. Optimizers that do not support checkpoints continue from the
+ *    stored parameters with a fresh state. The command line option "-resume"
+ *    overrides this parameter. In a run with several parameter files, the elastix
+ *    levels (parameter files) before the one of the checkpoint are not optimized
+ *    again, but completed from their final checkpoints Checkpoint.<ElastixLevel>.bin
+ *    in the same directory, so CheckpointInterval should be set in each parameter
+ *    file. The levels after the one of the checkpoint run normally.\n
+ *    example: <tt>(ResumeFromCheckpoint "out/Checkpoint.0.bin")</tt>\n
+ *    Default value: "", no resume.
  * \parameter UseDirectionCosines: Controls whether to use or ignore the
  * direction cosines (world matrix, transform matrix) set in the images.
  * Voxel spacing and image origin are always taken into account, regardless
@@ -321,6 +345,14 @@ public:
    * present, it tries to read it from the parameter file. */
   virtual bool GetOriginalFixedImageDirection( FixedImageDirectionType & direction ) const;
 
+  /** Write a transform parameter file with the given transform parameters,
+   * by calling the WriteToFile() functions of the transform, the resample
+   * interpolator and the resampler. Unlike CreateTransformParameterFile(),
+   * the file is not used as the initial transform of a next registration.
+   */
+  virtual void WriteTransformParameterFile( const std::string & fileName,
+    const RegistrationCheckpoint::ParametersType & parameters, const bool toLog );
+
 protected:
 
   ElastixTemplate();
@@ -395,6 +427,26 @@ protected:
   /** Set the direction in the superclass' m_OriginalFixedImageDirection variable */
   virtual void SetOriginalFixedImageDirection( const FixedImageDirectionType & arg );
 
+  /** Read the checkpoint settings, and the checkpoint to resume from, if any. */
+  virtual void InitializeCheckpoints( void );
+
+  /** Write a checkpoint for the given resolution and iteration. The optimizer
+   * state is only stored if requested. Failures are reported as a warning.
+   */
+  virtual void WriteCheckpoint( const unsigned int level,
+    const unsigned int iterationCounter,
+    const RegistrationCheckpoint::ParametersType & parameters,
+    const bool storeOptimizerState );
+
+  /** Checkpoint settings and state. */
+  typedef RegistrationCheckpoint::ParametersContainerType ParametersContainerType;
+
+  unsigned int            m_CheckpointInterval;
+  std::string             m_CheckpointFileName;
+  RegistrationCheckpoint  m_ResumeCheckpoint;
+  bool                    m_ResumeInThisResolution;
+  ParametersContainerType m_CompletedLevelParameters;
+
 private:
 
   ElastixTemplate( const Self & ); // purposely not implemented
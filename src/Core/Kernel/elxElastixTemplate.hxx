@@ -60,6 +60,10 @@ ElastixTemplate< TFixedImage, TMovingImage >
   /** Initialize the this->m_IterationCounter. */
   this->m_IterationCounter = 0;
 
+  /** No checkpoints by default. */
+  this->m_CheckpointInterval     = 0;
+  this->m_ResumeInThisResolution = false;
+
   /** Initialize CurrentTransformParameterFileName. */
   this->m_CurrentTransformParameterFileName = "";
   this->m_TransformParametersMap.clear();
@@ -341,6 +345,9 @@ ElastixTemplate< TFixedImage, TMovingImage >
   int dummy = this->BeforeAllTransformix();
   if( dummy != 0 ) { return dummy; }
 
+  /** Use the current share of the threads of the process. */
+  this->UpdateNumberOfThreads();
+
   /** Set the inputImage (=movingImage).
    * If "-in" was given or an input image was given in some other way,
    * load the image.
@@ -377,7 +384,14 @@ ElastixTemplate< TFixedImage, TMovingImage >
   elxout << "Calling all ReadFromFile()'s ..." << std::endl;
   this->GetElxResampleInterpolatorBase()->ReadFromFile();
   this->GetElxResamplerBase()->ReadFromFile();
-  this->GetElxTransformBase()->ReadFromFile();
+  if( this->GetReuseTransform() )
+  {
+    elxout << "  Reusing the transform that was read before." << std::endl;
+  }
+  else
+  {
+    this->GetElxTransformBase()->ReadFromFile();
+  }
 
   /** Tell the user. */
   timer.Stop();
@@ -445,6 +459,23 @@ ElastixTemplate< TFixedImage, TMovingImage >
   elxout << "  Computing spatial Jacobian done, it took "
          << this->ConvertSecondsToDHMS( timer.GetMean(), 2 ) << std::endl;
 
+  /** Call ComputeInverseDeformationField. */
+  timer.Reset();
+  timer.Start();
+  elxout << "Compute inverse deformation field ..." << std::endl;
+  try
+  {
+    this->GetElxTransformBase()->ComputeInverseDeformationField();
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    xout[ "error" ] << excp << std::endl;
+    xout[ "error" ] << "However, transformix continues anyway." << std::endl;
+  }
+  timer.Stop();
+  elxout << "  Computing inverse deformation field done, it took "
+         << this->ConvertSecondsToDHMS( timer.GetMean(), 2 ) << std::endl;
+
   /** Resample the image. */
   if( this->GetMovingImage() != 0 )
   {
@@ -463,9 +494,27 @@ ElastixTemplate< TFixedImage, TMovingImage >
     /** Write the resampled image to disk.
      * Actually we could loop over all resamplers.
      * But for now, there seems to be no use yet for that.
+     * With several input images, they are all resampled with one mapping of
+     * the output grid, and written to "result.<i>.<format>".
      */
 #ifndef _ELASTIX_BUILD_LIBRARY
-    this->GetElxResamplerBase()->ResampleAndWriteResultImage( makeFileName.str().c_str() );
+    const unsigned int numberOfImages = this->GetNumberOfMovingImages();
+    if( numberOfImages > 1 )
+    {
+      std::vector< std::string > fileNames( numberOfImages );
+      for( unsigned int i = 0; i < numberOfImages; ++i )
+      {
+        std::ostringstream makeFileNameI( "" );
+        makeFileNameI << this->GetConfiguration()->GetCommandLineArgument( "-out" )
+                      << "result." << i << "." << resultImageFormat;
+        fileNames[ i ] = makeFileNameI.str();
+      }
+      this->GetElxResamplerBase()->ResampleAndWriteResultImages( fileNames );
+    }
+    else
+    {
+      this->GetElxResamplerBase()->ResampleAndWriteResultImage( makeFileName.str().c_str() );
+    }
 #else
     this->GetElxResamplerBase()->CreateItkResultImage();
 #endif
@@ -558,11 +607,17 @@ ElastixTemplate< TFixedImage, TMovingImage >
   this->m_Timer0.Reset();
   this->m_Timer0.Start();
 
+  /** Use the current share of the threads of the process. */
+  this->UpdateNumberOfThreads();
+
   /** Call all the BeforeRegistration() functions. */
   this->BeforeRegistrationBase();
   CallInEachComponent( &BaseComponentType::BeforeRegistrationBase );
   CallInEachComponent( &BaseComponentType::BeforeRegistration );
 
+  /** Read the checkpoint settings, and the checkpoint to resume from. */
+  this->InitializeCheckpoints();
+
   /** Add a column to iteration with the iteration number. */
   xout[ "iteration" ].AddTargetCell( "1:ItNr" );
 
@@ -614,6 +669,24 @@ ElastixTemplate< TFixedImage, TMovingImage >
   /** Print the current resolution. */
   elxout << "\nResolution: " << level << std::endl;
 
+  /** Store the result of the previous resolution, and write a checkpoint. */
+  if( this->m_CheckpointInterval > 0 && level > 0
+    && this->m_CompletedLevelParameters.size() < level )
+  {
+    this->m_CompletedLevelParameters.push_back(
+      this->GetElxRegistrationBase()->GetAsITKBaseType()->GetLastTransformParameters() );
+    this->WriteCheckpoint( level, 0,
+      this->m_CompletedLevelParameters.back(), false );
+  }
+
+  const bool completedBefore = level < this->GetElxRegistrationBase()
+    ->GetAsITKBaseType()->GetCompletedLevelParameters().size();
+  if( completedBefore )
+  {
+    elxout << "This resolution was completed before the checkpoint was written,\n"
+           << "  so it is not optimized again." << std::endl;
+  }
+
   /** Create a TransformParameter-file for the current resolution. */
   bool writeIterationInfo = true;
   this->GetConfiguration()->ReadParameter( writeIterationInfo,
@@ -623,11 +696,55 @@ ElastixTemplate< TFixedImage, TMovingImage >
     this->OpenIterationInfoFile();
   }
 
+  /** Use the current share of the threads of the process, which grows
+   * when other registrations finish.
+   */
+  this->UpdateNumberOfThreads();
+
   /** Call all the BeforeEachResolution() functions. */
   this->BeforeEachResolutionBase();
   CallInEachComponent( &BaseComponentType::BeforeEachResolutionBase );
   CallInEachComponent( &BaseComponentType::BeforeEachResolution );
 
+  /** Continue the interrupted resolution from the checkpoint. */
+  if( this->m_ResumeInThisResolution
+    && level == this->m_ResumeCheckpoint.ResolutionLevel && !completedBefore )
+  {
+    this->m_ResumeInThisResolution = false;
+    const unsigned int numberOfParameters = this->GetElxTransformBase()
+      ->GetAsITKBaseType()->GetNumberOfParameters();
+    if( this->m_ResumeCheckpoint.CurrentParameters.GetSize() != numberOfParameters )
+    {
+      itkExceptionMacro( << "The checkpoint contains "
+                         << this->m_ResumeCheckpoint.CurrentParameters.GetSize()
+                         << " transform parameters, but the transform has "
+                         << numberOfParameters << "." );
+    }
+    this->GetElxRegistrationBase()->GetAsITKBaseType()
+      ->SetInitialTransformParametersOfNextLevel( this->m_ResumeCheckpoint.CurrentParameters );
+    this->m_IterationCounter = this->m_ResumeCheckpoint.IterationCounter;
+
+    /** Restore the optimizer state, if it was written by the same optimizer. */
+    const std::string optimizerName = this->GetElxOptimizerBase()->elxGetClassName();
+    if( !this->m_ResumeCheckpoint.OptimizerState.empty()
+      && this->m_ResumeCheckpoint.OptimizerName == optimizerName )
+    {
+      this->GetElxOptimizerBase()->SetCheckpointState( this->m_ResumeCheckpoint.OptimizerState );
+      elxout << "Continuing at iteration " << this->m_IterationCounter
+             << " with the stored optimizer state." << std::endl;
+    }
+    else
+    {
+      elxout << "Continuing at iteration " << this->m_IterationCounter
+             << " with a fresh optimizer state, since the checkpoint has no state of the "
+             << optimizerName << " optimizer." << std::endl;
+    }
+
+    /** Release the memory of the checkpoint. */
+    this->m_ResumeCheckpoint.CurrentParameters = RegistrationCheckpoint::ParametersType();
+    this->m_ResumeCheckpoint.OptimizerState.clear();
+  }
+
   /** Print the extra preparation time needed for this resolution. */
   this->m_Timer0.Stop();
   elxout << "Elastix initialization of all components (for this resolution) took: "
@@ -779,6 +896,16 @@ ElastixTemplate< TFixedImage, TMovingImage >
   /** Count the number of iterations. */
   this->m_IterationCounter++;
 
+  /** Write a checkpoint every CheckpointInterval iterations. */
+  if( this->m_CheckpointInterval > 0
+    && this->m_IterationCounter % this->m_CheckpointInterval == 0 )
+  {
+    this->WriteCheckpoint(
+      this->GetElxRegistrationBase()->GetAsITKBaseType()->GetCurrentLevel(),
+      this->m_IterationCounter,
+      this->GetElxOptimizerBase()->GetAsITKBaseType()->GetCurrentPosition(), true );
+  }
+
   /** Start timer for next iteration. */
   this->m_IterationTimer.Reset();
   this->m_IterationTimer.Start();
@@ -801,6 +928,24 @@ ElastixTemplate< TFixedImage, TMovingImage >
   /** A white line. */
   elxout << std::endl;
 
+  /** Write a checkpoint in which all resolutions are completed. */
+  const unsigned int numberOfLevels = static_cast< unsigned int >(
+    this->GetElxRegistrationBase()->GetAsITKBaseType()->GetNumberOfLevels() );
+  if( this->m_CheckpointInterval > 0 )
+  {
+    if( this->m_CompletedLevelParameters.size() < numberOfLevels )
+    {
+      this->m_CompletedLevelParameters.push_back(
+        this->GetElxRegistrationBase()->GetAsITKBaseType()->GetLastTransformParameters() );
+    }
+
+    /** Also when all resolutions were completed in an earlier run, so that a
+     * later elastix level can be resumed from this output directory.
+     */
+    this->WriteCheckpoint( numberOfLevels, 0,
+      this->m_CompletedLevelParameters.back(), false );
+  }
+
   /** Create the final TransformParameters filename. */
   bool writeFinalTansformParameters = true;
   this->GetConfiguration()->ReadParameter( writeFinalTansformParameters,
@@ -840,6 +985,156 @@ ElastixTemplate< TFixedImage, TMovingImage >
 } // end AfterRegistration()
 
 
+/**
+ * ************** InitializeCheckpoints *******************
+ */
+
+template< class TFixedImage, class TMovingImage >
+void
+ElastixTemplate< TFixedImage, TMovingImage >
+::InitializeCheckpoints( void )
+{
+  /** Read the number of iterations between two checkpoints. */
+  this->m_CheckpointInterval = 0;
+  this->GetConfiguration()->ReadParameter( this->m_CheckpointInterval,
+    "CheckpointInterval", 0, false );
+
+  std::ostringstream makeFileName( "" );
+  makeFileName << this->GetConfiguration()->GetCommandLineArgument( "-out" )
+               << "Checkpoint."
+               << this->GetConfiguration()->GetElastixLevel()
+               << ".bin";
+  this->m_CheckpointFileName = makeFileName.str();
+
+  this->m_CompletedLevelParameters.clear();
+  this->m_ResumeInThisResolution = false;
+
+  /** The command line option has precedence over the parameter file. */
+  std::string resumeFileName
+    = this->GetConfiguration()->GetCommandLineArgument( "-resume" );
+  if( resumeFileName.empty() )
+  {
+    this->GetConfiguration()->ReadParameter( resumeFileName,
+      "ResumeFromCheckpoint", 0, false );
+  }
+  if( resumeFileName.empty() )
+  {
+    return;
+  }
+
+  /** Read the checkpoint; an exception is thrown if that fails. */
+  this->m_ResumeCheckpoint.Read( resumeFileName );
+
+  const unsigned int elastixLevel = this->GetConfiguration()->GetElastixLevel();
+  const unsigned int numberOfLevels = static_cast< unsigned int >(
+    this->GetElxRegistrationBase()->GetAsITKBaseType()->GetNumberOfLevels() );
+  if( this->m_ResumeCheckpoint.ElastixLevel < elastixLevel )
+  {
+    /** This level had not started yet when the registration was interrupted. */
+    elxout << "The checkpoint " << resumeFileName << " was written in elastix level "
+           << this->m_ResumeCheckpoint.ElastixLevel << ", so it is not used in level "
+           << elastixLevel << "." << std::endl;
+    this->m_ResumeCheckpoint = RegistrationCheckpoint();
+    return;
+  }
+  if( this->m_ResumeCheckpoint.ElastixLevel > elastixLevel )
+  {
+    /** This level was completed before the registration was interrupted. It is
+     * not optimized again, but completed with the final parameters from its own
+     * checkpoint, which is in the same directory, so that the next level starts
+     * from the same initial transform as in the interrupted run.
+     */
+    const std::string::size_type slash = resumeFileName.find_last_of( "/\\" );
+    std::ostringstream levelFileName( "" );
+    levelFileName << ( slash == std::string::npos ? std::string( "" ) : resumeFileName.substr( 0, slash + 1 ) )
+                  << "Checkpoint." << elastixLevel << ".bin";
+    this->m_ResumeCheckpoint = RegistrationCheckpoint();
+    try
+    {
+      this->m_ResumeCheckpoint.Read( levelFileName.str() );
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      itkExceptionMacro( << "Resuming from " << resumeFileName << " requires the final checkpoint "
+                         << "of the completed elastix level " << elastixLevel << ":\n"
+                         << excp.GetDescription() );
+    }
+    if( this->m_ResumeCheckpoint.ElastixLevel != elastixLevel
+      || this->m_ResumeCheckpoint.CompletedLevelParameters.size() != numberOfLevels )
+    {
+      itkExceptionMacro( << "The checkpoint " << levelFileName.str() << " does not contain the final "
+                         << "parameters of all " << numberOfLevels << " resolutions of elastix level "
+                         << elastixLevel << ", so " << resumeFileName << " can not be resumed." );
+    }
+    resumeFileName = levelFileName.str();
+  }
+
+  if( this->m_ResumeCheckpoint.CompletedLevelParameters.size() > numberOfLevels
+    || this->m_ResumeCheckpoint.ResolutionLevel > numberOfLevels )
+  {
+    itkExceptionMacro( << "The checkpoint " << resumeFileName
+                       << " does not match the number of resolutions (" << numberOfLevels << ")." );
+  }
+
+  elxout << "Resuming from the checkpoint " << resumeFileName << ", at resolution "
+         << this->m_ResumeCheckpoint.ResolutionLevel << ", iteration "
+         << this->m_ResumeCheckpoint.IterationCounter << "." << std::endl;
+
+  /** The completed resolutions are not optimized again. */
+  this->m_CompletedLevelParameters = this->m_ResumeCheckpoint.CompletedLevelParameters;
+  this->GetElxRegistrationBase()->GetAsITKBaseType()
+    ->SetCompletedLevelParameters( this->m_CompletedLevelParameters );
+  this->m_ResumeCheckpoint.CompletedLevelParameters.clear();
+
+  /** An interrupted resolution continues from the stored parameters. */
+  this->m_ResumeInThisResolution = this->m_ResumeCheckpoint.IterationCounter > 0;
+
+} // end InitializeCheckpoints()
+
+
+/**
+ * ************** WriteCheckpoint *******************
+ */
+
+template< class TFixedImage, class TMovingImage >
+void
+ElastixTemplate< TFixedImage, TMovingImage >
+::WriteCheckpoint( const unsigned int level,
+  const unsigned int iterationCounter,
+  const RegistrationCheckpoint::ParametersType & parameters,
+  const bool storeOptimizerState )
+{
+  RegistrationCheckpoint checkpoint;
+  checkpoint.ElastixLevel             = this->GetConfiguration()->GetElastixLevel();
+  checkpoint.ResolutionLevel          = level;
+  checkpoint.IterationCounter         = iterationCounter;
+  checkpoint.CompletedLevelParameters = this->m_CompletedLevelParameters;
+  checkpoint.CurrentParameters        = parameters;
+  checkpoint.OptimizerName            = this->GetElxOptimizerBase()->elxGetClassName();
+
+  if( storeOptimizerState )
+  {
+    std::ostringstream state( std::ios::out | std::ios::binary );
+    if( this->GetElxOptimizerBase()->WriteCheckpointState( state ) )
+    {
+      checkpoint.OptimizerState = state.str();
+    }
+  }
+
+  /** A checkpoint that cannot be written should not stop the registration. */
+  try
+  {
+    checkpoint.Write( this->m_CheckpointFileName );
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    xout[ "error" ] << excp << std::endl;
+    xout[ "error" ] << "However, elastix continues anyway." << std::endl;
+  }
+
+} // end WriteCheckpoint()
+
+
 /**
  * ************** CreateTransformParameterFile ******************
  *
@@ -852,11 +1147,34 @@ void
 ElastixTemplate< TFixedImage, TMovingImage >
 ::CreateTransformParameterFile( const std::string fileName, const bool toLog )
 {
-  using namespace xl;
-
   /** Store CurrentTransformParameterFileName. */
   this->m_CurrentTransformParameterFileName = fileName;
 
+  /** Set it in the Transform, for later use. */
+  this->GetElxTransformBase()->SetTransformParametersFileName( fileName.c_str() );
+
+  /** Write the current position of the optimizer. */
+  this->WriteTransformParameterFile( fileName,
+    this->GetElxOptimizerBase()->GetAsITKBaseType()->GetCurrentPosition(), toLog );
+
+} // end CreateTransformParameterFile()
+
+
+/**
+ * ************** WriteTransformParameterFile ******************
+ *
+ * Setup the xout transform parameter file, and call all
+ * the WriteToFile() functions.
+ */
+
+template< class TFixedImage, class TMovingImage >
+void
+ElastixTemplate< TFixedImage, TMovingImage >
+::WriteTransformParameterFile( const std::string & fileName,
+  const RegistrationCheckpoint::ParametersType & parameters, const bool toLog )
+{
+  using namespace xl;
+
   /** Create transformParameterFile and xout["transpar"]. */
   xoutsimple_type transformationParameterInfo;
   std::ofstream   transformParameterFile;
@@ -867,9 +1185,6 @@ ElastixTemplate< TFixedImage, TMovingImage >
 
   xout.AddTargetCell( "transpar", &transformationParameterInfo );
 
-  /** Set it in the Transform, for later use. */
-  this->GetElxTransformBase()->SetTransformParametersFileName( fileName.c_str() );
-
   /** Open the TransformParameter file. */
   transformParameterFile.open( fileName.c_str() );
   if( !transformParameterFile.is_open() )
@@ -901,8 +1216,7 @@ ElastixTemplate< TFixedImage, TMovingImage >
    * Actually we could loop over all resample interpolators, resamplers,
    * and transforms etc. But for now, there seems to be no use yet for that.
    */
-  this->GetElxTransformBase()->WriteToFile(
-    this->GetElxOptimizerBase()->GetAsITKBaseType()->GetCurrentPosition() );
+  this->GetElxTransformBase()->WriteToFile( parameters );
   this->GetElxResampleInterpolatorBase()->WriteToFile();
   this->GetElxResamplerBase()->WriteToFile();
 
@@ -916,7 +1230,7 @@ ElastixTemplate< TFixedImage, TMovingImage >
   /** Remove the "transpar" writing field. */
   xout.RemoveTargetCell( "transpar" );
 
-} // end CreateTransformParameterFile()
+} // end WriteTransformParameterFile()
 
 
 /**
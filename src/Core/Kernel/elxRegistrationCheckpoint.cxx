@@ -0,0 +1,272 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "elxRegistrationCheckpoint.h"
+
+#if defined( _WIN32 ) && !defined( __CYGWIN__ )
+  #include <windows.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace elastix
+{
+
+/** The file starts with a magic string, followed by the format version. */
+static const char         CheckpointMagic[ 8 ] = { 'E', 'L', 'X', 'C', 'K', 'P', 'T', '\0' };
+static const unsigned int CheckpointVersion    = 1;
+
+/**
+ * ********************* Constructor ****************************
+ */
+
+RegistrationCheckpoint::RegistrationCheckpoint()
+{
+  this->ElastixLevel     = 0;
+  this->ResolutionLevel  = 0;
+  this->IterationCounter = 0;
+
+} // end Constructor
+
+
+/**
+ * ********************* Write ****************************
+ */
+
+void
+RegistrationCheckpoint::Write( const std::string & fileName ) const
+{
+  /** Write to a temporary file first. */
+  const std::string tempFileName = fileName + ".tmp";
+  std::ofstream     file( tempFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+  if( !file.is_open() )
+  {
+    itkGenericExceptionMacro( << "Could not open " << tempFileName << " for writing the checkpoint." );
+  }
+
+  file.write( CheckpointMagic, sizeof( CheckpointMagic ) );
+  WriteValue( file, CheckpointVersion );
+  WriteValue( file, this->ElastixLevel );
+  WriteValue( file, this->ResolutionLevel );
+  WriteValue( file, this->IterationCounter );
+
+  const unsigned int numberOfCompletedLevels
+    = static_cast< unsigned int >( this->CompletedLevelParameters.size() );
+  WriteValue( file, numberOfCompletedLevels );
+  for( unsigned int i = 0; i < numberOfCompletedLevels; ++i )
+  {
+    WriteParameters( file, this->CompletedLevelParameters[ i ] );
+  }
+  WriteParameters( file, this->CurrentParameters );
+
+  WriteString( file, this->OptimizerName );
+  WriteString( file, this->OptimizerState );
+
+  file.close();
+  if( file.fail() )
+  {
+    itkGenericExceptionMacro( << "Could not write the checkpoint to " << tempFileName << "." );
+  }
+
+  /** Replace the previous checkpoint in one step, so that there is always
+   * a complete checkpoint on disk. On POSIX systems rename() replaces an
+   * existing file atomically; on Windows it fails if the file exists.
+   */
+#if defined( _WIN32 ) && !defined( __CYGWIN__ )
+  const bool renamed = MoveFileExA( tempFileName.c_str(), fileName.c_str(),
+    MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0;
+#else
+  const bool renamed = std::rename( tempFileName.c_str(), fileName.c_str() ) == 0;
+#endif
+  if( !renamed )
+  {
+    itkGenericExceptionMacro( << "Could not rename " << tempFileName << " to " << fileName << "." );
+  }
+
+} // end Write()
+
+
+/**
+ * ********************* Read ****************************
+ */
+
+void
+RegistrationCheckpoint::Read( const std::string & fileName )
+{
+  std::ifstream file( fileName.c_str(), std::ios::in | std::ios::binary );
+  if( !file.is_open() )
+  {
+    itkGenericExceptionMacro( << "Could not open the checkpoint " << fileName << "." );
+  }
+
+  char magic[ sizeof( CheckpointMagic ) ];
+  file.read( magic, sizeof( magic ) );
+  unsigned int version = 0;
+  if( !file.fail() )
+  {
+    ReadValue( file, version );
+  }
+  if( file.fail() || std::memcmp( magic, CheckpointMagic, sizeof( magic ) ) != 0
+    || version != CheckpointVersion )
+  {
+    itkGenericExceptionMacro( << fileName << " is not an elastix checkpoint of version "
+                              << CheckpointVersion << "." );
+  }
+
+  ReadValue( file, this->ElastixLevel );
+  ReadValue( file, this->ResolutionLevel );
+  ReadValue( file, this->IterationCounter );
+
+  /** Each level takes at least the size of its parameter vector. */
+  unsigned int numberOfCompletedLevels = 0;
+  ReadValue( file, numberOfCompletedLevels );
+  CheckRemainingSize( file, numberOfCompletedLevels, sizeof( unsigned long long ) );
+  this->CompletedLevelParameters.resize( numberOfCompletedLevels );
+  for( unsigned int i = 0; i < numberOfCompletedLevels; ++i )
+  {
+    ReadParameters( file, this->CompletedLevelParameters[ i ] );
+  }
+  ReadParameters( file, this->CurrentParameters );
+
+  ReadString( file, this->OptimizerName );
+  ReadString( file, this->OptimizerState );
+
+} // end Read()
+
+
+/**
+ * ********************* WriteString ****************************
+ */
+
+void
+RegistrationCheckpoint::WriteString( std::ostream & os, const std::string & value )
+{
+  const unsigned long long size = value.size();
+  WriteValue( os, size );
+  os.write( value.data(), static_cast< std::streamsize >( size ) );
+
+} // end WriteString()
+
+
+/**
+ * ********************* ReadString ****************************
+ */
+
+void
+RegistrationCheckpoint::ReadString( std::istream & is, std::string & value )
+{
+  unsigned long long size = 0;
+  ReadValue( is, size );
+  CheckRemainingSize( is, size, 1 );
+  value.resize( static_cast< std::string::size_type >( size ) );
+  if( size > 0 )
+  {
+    is.read( &value[ 0 ], static_cast< std::streamsize >( size ) );
+    CheckStream( is );
+  }
+
+} // end ReadString()
+
+
+/**
+ * ********************* WriteParameters ****************************
+ */
+
+void
+RegistrationCheckpoint::WriteParameters( std::ostream & os, const ParametersType & parameters )
+{
+  const unsigned long long size = parameters.GetSize();
+  WriteValue( os, size );
+  os.write( reinterpret_cast< const char * >( parameters.data_block() ),
+    static_cast< std::streamsize >( size * sizeof( double ) ) );
+
+} // end WriteParameters()
+
+
+/**
+ * ********************* ReadParameters ****************************
+ */
+
+void
+RegistrationCheckpoint::ReadParameters( std::istream & is, ParametersType & parameters )
+{
+  unsigned long long size = 0;
+  ReadValue( is, size );
+  CheckRemainingSize( is, size, sizeof( double ) );
+  parameters.SetSize( static_cast< unsigned int >( size ) );
+  is.read( reinterpret_cast< char * >( parameters.data_block() ),
+    static_cast< std::streamsize >( size * sizeof( double ) ) );
+  CheckStream( is );
+
+} // end ReadParameters()
+
+
+/**
+ * ********************* CheckStream ****************************
+ */
+
+void
+RegistrationCheckpoint::CheckStream( std::istream & is )
+{
+  if( is.fail() )
+  {
+    itkGenericExceptionMacro( << "Unexpected end of checkpoint data." );
+  }
+
+} // end CheckStream()
+
+
+/**
+ * ********************* CheckRemainingSize ****************************
+ */
+
+void
+RegistrationCheckpoint::CheckRemainingSize( std::istream & is,
+  const unsigned long long numberOfElements, const std::size_t elementSize )
+{
+  /** Streams that cannot seek are not checked. */
+  const std::streampos current = is.tellg();
+  if( current == std::streampos( -1 ) )
+  {
+    return;
+  }
+  is.seekg( 0, std::ios::end );
+  const std::streampos end = is.tellg();
+  is.clear();
+  is.seekg( current );
+  if( end == std::streampos( -1 ) )
+  {
+    return;
+  }
+
+  /** The parentheses prevent the expansion of the max macro of windows.h. */
+  const unsigned long long remaining = static_cast< unsigned long long >( end - current );
+  if( numberOfElements > ( std::numeric_limits< unsigned int >::max )()
+    || numberOfElements > remaining / elementSize )
+  {
+    itkGenericExceptionMacro( << "Corrupt checkpoint data: " << numberOfElements
+                              << " elements of " << elementSize << " bytes do not fit in the remaining "
+                              << remaining << " bytes." );
+  }
+
+} // end CheckRemainingSize()
+
+
+} // end namespace elastix
@@ -0,0 +1,191 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __elxRegistrationCheckpoint_h
+#define __elxRegistrationCheckpoint_h
+
+#include "itkOptimizerParameters.h"
+#include "itkMacro.h"
+#include "vnl/vnl_vector.h"
+#include "vnl/vnl_matrix.h"
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace elastix
+{
+
+/**
+ * \class RegistrationCheckpoint
+ * \brief The state of an interrupted registration, which can be written
+ * to and read from a compact binary file.
+ *
+ * A checkpoint stores the elastix level (the index of the parameter file),
+ * the resolution and the iteration within that resolution, the final
+ * transform parameters of the resolutions that were completed, the current
+ * transform parameters, and the internal state of the optimizer. The
+ * optimizer state is an opaque block of bytes, which is written and read by
+ * the optimizer component itself, see OptimizerBase::WriteCheckpointState().
+ *
+ * Files are written to a temporary file first, which then replaces the
+ * previous checkpoint in a single rename, so that an interruption while
+ * writing never destroys the previous checkpoint. When reading, the sizes of
+ * vectors and strings are checked against the remaining data before memory
+ * is allocated, so a corrupt file results in an exception.
+ * The numbers are stored in the byte order of the machine.
+ *
+ * The static Write* and Read* functions can be used by components to
+ * serialize their state.
+ *
+ * \ingroup Kernel
+ */
+
+class RegistrationCheckpoint
+{
+public:
+
+  typedef RegistrationCheckpoint Self;
+
+  /** Typedef for the transform parameters. */
+  typedef itk::OptimizerParameters< double > ParametersType;
+  typedef std::vector< ParametersType >      ParametersContainerType;
+
+  RegistrationCheckpoint();
+  virtual ~RegistrationCheckpoint() {}
+
+  /** The elastix level in which the checkpoint was written. */
+  unsigned int ElastixLevel;
+
+  /** The resolution level in which the checkpoint was written. */
+  unsigned int ResolutionLevel;
+
+  /** The number of iterations done in this resolution. */
+  unsigned int IterationCounter;
+
+  /** The final transform parameters of the completed resolutions. */
+  ParametersContainerType CompletedLevelParameters;
+
+  /** The transform parameters at the time of the checkpoint. */
+  ParametersType CurrentParameters;
+
+  /** The name of the optimizer component, and its internal state. An empty
+   * state means that the optimizer does not support checkpoints.
+   */
+  std::string OptimizerName;
+  std::string OptimizerState;
+
+  /** Write the checkpoint to a file. Throws an exception on failure. */
+  void Write( const std::string & fileName ) const;
+
+  /** Read the checkpoint from a file. Throws an exception on failure. */
+  void Read( const std::string & fileName );
+
+  /** Write/read a value of a plain type. */
+  template< class T >
+  static void WriteValue( std::ostream & os, const T & value )
+  {
+    os.write( reinterpret_cast< const char * >( &value ), sizeof( T ) );
+  }
+
+
+  template< class T >
+  static void ReadValue( std::istream & is, T & value )
+  {
+    is.read( reinterpret_cast< char * >( &value ), sizeof( T ) );
+    CheckStream( is );
+  }
+
+
+  /** Write/read a vector, an itk::Array or itk::OptimizerParameters. */
+  template< class T >
+  static void WriteVector( std::ostream & os, const vnl_vector< T > & vector )
+  {
+    const unsigned long long size = vector.size();
+    WriteValue( os, size );
+    os.write( reinterpret_cast< const char * >( vector.data_block() ),
+      static_cast< std::streamsize >( size * sizeof( T ) ) );
+  }
+
+
+  template< class T >
+  static void ReadVector( std::istream & is, vnl_vector< T > & vector )
+  {
+    unsigned long long size = 0;
+    ReadValue( is, size );
+    CheckRemainingSize( is, size, sizeof( T ) );
+    vector.set_size( static_cast< unsigned int >( size ) );
+    is.read( reinterpret_cast< char * >( vector.data_block() ),
+      static_cast< std::streamsize >( size * sizeof( T ) ) );
+    CheckStream( is );
+  }
+
+
+  /** Write/read a matrix, or an itk::Array2D. */
+  template< class T >
+  static void WriteMatrix( std::ostream & os, const vnl_matrix< T > & matrix )
+  {
+    const unsigned long long rows = matrix.rows();
+    const unsigned long long cols = matrix.cols();
+    WriteValue( os, rows );
+    WriteValue( os, cols );
+    os.write( reinterpret_cast< const char * >( matrix.data_block() ),
+      static_cast< std::streamsize >( rows * cols * sizeof( T ) ) );
+  }
+
+
+  template< class T >
+  static void ReadMatrix( std::istream & is, vnl_matrix< T > & matrix )
+  {
+    unsigned long long rows = 0;
+    unsigned long long cols = 0;
+    ReadValue( is, rows );
+    ReadValue( is, cols );
+    CheckRemainingSize( is, cols, sizeof( T ) );
+    CheckRemainingSize( is, rows, sizeof( T ) * ( cols > 0 ? cols : 1 ) );
+    matrix.set_size( static_cast< unsigned int >( rows ), static_cast< unsigned int >( cols ) );
+    is.read( reinterpret_cast< char * >( matrix.data_block() ),
+      static_cast< std::streamsize >( rows * cols * sizeof( T ) ) );
+    CheckStream( is );
+  }
+
+
+  /** Write/read a string. */
+  static void WriteString( std::ostream & os, const std::string & value );
+
+  static void ReadString( std::istream & is, std::string & value );
+
+  /** Write/read the parameters, keeping the memory managed by the parameters. */
+  static void WriteParameters( std::ostream & os, const ParametersType & parameters );
+
+  static void ReadParameters( std::istream & is, ParametersType & parameters );
+
+  /** Throw an exception if the last read failed. */
+  static void CheckStream( std::istream & is );
+
+  /** Throw an exception if numberOfElements elements of elementSize bytes
+   * cannot be read from the remainder of the stream.
+   */
+  static void CheckRemainingSize( std::istream & is,
+    const unsigned long long numberOfElements, const std::size_t elementSize );
+
+};
+
+} // end namespace elastix
+
+#endif // end #ifndef __elxRegistrationCheckpoint_h
@@ -27,6 +27,7 @@
 #include "elxTransformixMain.h"
 
 #include "elxMacro.h"
+#include "itkThreadBudget.h"
 
 #ifdef ELASTIX_USE_OPENCL
 #include "itkOpenCLSetup.h"
@@ -203,6 +204,79 @@ TransformixMain::Run(
 } // end Run()
 
 
+/**
+ * ******************* RunWithLoadedTransform *******************
+ */
+
+int
+TransformixMain::RunWithLoadedTransform( ArgumentMapType & argmap )
+{
+  /** Without a previous run there is nothing to reuse. */
+  if( this->m_Elastix.IsNull() )
+  {
+    return this->Run( argmap );
+  }
+
+  /** Replace the command line arguments, but keep the parameters. */
+  this->m_Configuration->SetCommandLineArguments( argmap );
+
+  /** Set process properties. */
+  this->SetProcessPriority();
+  this->SetMaximumNumberOfThreads();
+
+  /** Forget the images of the previous run. */
+  this->ReleaseResources();
+
+  /** ApplyTransform, without reading the transform again. */
+  int errorCode = 0;
+  this->GetElastixBase()->SetReuseTransform( true );
+  try
+  {
+    errorCode = this->GetElastixBase()->ApplyTransform();
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    /** We just print the exception and let the program quit. */
+    xl::xout[ "error" ] << std::endl
+                        << "--------------- Exception ---------------"
+                        << std::endl << excp
+                        << "-----------------------------------------" << std::endl;
+    errorCode = 1;
+  }
+  this->GetElastixBase()->SetReuseTransform( false );
+
+  /** Save the image container. */
+  this->SetMovingImageContainer(
+    this->GetElastixBase()->GetMovingImageContainer() );
+  this->SetResultImageContainer(
+    this->GetElastixBase()->GetResultImageContainer() );
+
+  return errorCode;
+
+} // end RunWithLoadedTransform()
+
+
+/**
+ * ********************** ReleaseResources *************************
+ */
+
+void
+TransformixMain::ReleaseResources( void )
+{
+  this->SetMovingImageContainer( 0 );
+  this->SetResultImageContainer( 0 );
+  if( this->m_Elastix.IsNotNull() )
+  {
+    this->GetElastixBase()->SetMovingImageContainer( 0 );
+    this->GetElastixBase()->SetResultImageContainer( 0 );
+
+    /** A next run registers again. */
+    itk::ThreadBudget::GetInstance()->Unregister( this->GetElastixBase() );
+  }
+
+} // end ReleaseResources()
+
+
 /**
  * ********************* SetInputImage **************************
  */
@@ -98,6 +98,18 @@ public:
   /** Run version for using transformix as library. */
   virtual int Run( ArgumentMapType & argmap, std::vector< ParameterMapType > & inputMaps );
 
+  /** Apply the transform of a previous Run() again, with other command line
+   * arguments (-in, -def, -out, etc.) but the same transform parameter file.
+   * The components are reused, and the transform parameter files are not read
+   * again. Without a previous Run(), this simply calls Run( argmap ).
+   */
+  virtual int RunWithLoadedTransform( ArgumentMapType & argmap );
+
+  /** Release the input and result images of the last run, and its share
+   * of the itk::ThreadBudget, but keep the components and the transform.
+   */
+  virtual void ReleaseResources( void );
+
   /** Get and Set input- and outputImage. */
   virtual void SetInputImageContainer(
     DataObjectContainerType * inputImageContainer );
@@ -18,6 +18,7 @@
 
 #include "elastix.h"
 #include "elxElastixMain.h"
+#include <set>
 
 int
 main( int argc, char ** argv )
@@ -59,6 +60,8 @@ main( int argc, char ** argv )
   typedef ElastixMainType::ObjectPointer              ObjectPointer;
   typedef ElastixMainType::DataObjectContainerPointer DataObjectContainerPointer;
   typedef ElastixMainType::FlatDirectionCosinesType   FlatDirectionCosinesType;
+  typedef ElastixMainType::ComputationCacheType       ComputationCacheType;
+  typedef ElastixMainType::ComputationCachePointer    ComputationCachePointer;
 
   typedef ElastixMainType::ArgumentMapType ArgumentMapType;
   typedef ArgumentMapType::value_type      ArgumentMapEntryType;
@@ -78,6 +81,7 @@ main( int argc, char ** argv )
   DataObjectContainerPointer movingImageContainer = 0;
   DataObjectContainerPointer fixedMaskContainer   = 0;
   DataObjectContainerPointer movingMaskContainer  = 0;
+  ComputationCachePointer    computationCache     = ComputationCacheType::New();
   FlatDirectionCosinesType   fixedImageOriginalDirection;
   int                        returndummy        = 0;
   unsigned long              nrOfParameterFiles = 0;
@@ -86,6 +90,9 @@ main( int argc, char ** argv )
   bool                       outFolderPresent = false;
   std::string                outFolder        = "";
   std::string                logFileName      = "";
+  std::vector< std::string > movingImageBatch;
+  std::vector< std::string > batchOutputNames;
+  int                        batchReturnValue = 0;
 
   /** Put command line parameters into parameterFileList. */
   for( unsigned int i = 1; static_cast< long >( i ) < ( argc - 1 ); i += 2 )
@@ -158,6 +165,38 @@ main( int argc, char ** argv )
     returndummy |= -1;
   }
 
+  /** Check the batch of moving images, and name the output subdirectories
+   * after the moving images.
+   */
+  const bool batchMode = argMap.count( "-mlist" ) > 0;
+  if( batchMode )
+  {
+    if( argMap.count( "-m" ) || argMap.count( "-resume" ) )
+    {
+      std::cerr << "ERROR: the CommandLine option \"-mlist\" can not be combined with \"-m\" or \"-resume\"." << std::endl;
+      returndummy |= -1;
+    }
+    else if( !ReadImageBatch( argMap[ "-mlist" ], movingImageBatch ) )
+    {
+      std::cerr << "ERROR: no moving images found in \"" << argMap[ "-mlist" ] << "\"." << std::endl;
+      returndummy |= -1;
+    }
+
+    std::set< std::string > uniqueOutputNames;
+    for( unsigned int b = 0; b < movingImageBatch.size(); b++ )
+    {
+      batchOutputNames.push_back(
+        itksys::SystemTools::GetFilenameWithoutExtension( movingImageBatch[ b ] ) );
+      if( !uniqueOutputNames.insert( batchOutputNames[ b ] ).second )
+      {
+        std::cerr << "ERROR: the moving images \"" << movingImageBatch[ b ]
+                  << "\" and another one have the same name, so their results can not be "
+                  << "written to separate directories." << std::endl;
+        returndummy |= -1;
+      }
+    }
+  }
+
   /** Check if the -out option is given. */
   if( outFolderPresent )
   {
@@ -221,80 +260,131 @@ main( int argc, char ** argv )
    * Do the (possibly multiple) registration(s).
    */
 
-  for( unsigned int i = 0; i < nrOfParameterFiles; i++ )
+  const unsigned int numberOfBatchItems
+    = batchMode ? static_cast< unsigned int >( movingImageBatch.size() ) : 1;
+  unsigned int numberOfFailedBatchItems = 0;
+  for( unsigned int b = 0; b < numberOfBatchItems; b++ )
   {
-    /** Create another instance of ElastixMain. */
-    elastices.push_back( ElastixMainType::New() );
-
-    /** Set stuff we get from a former registration. */
-    elastices[ i ]->SetInitialTransform( transform );
-    elastices[ i ]->SetFixedImageContainer( fixedImageContainer );
-    elastices[ i ]->SetMovingImageContainer( movingImageContainer );
-    elastices[ i ]->SetFixedMaskContainer( fixedMaskContainer );
-    elastices[ i ]->SetMovingMaskContainer( movingMaskContainer );
-    elastices[ i ]->SetOriginalFixedImageDirectionFlat( fixedImageOriginalDirection );
-
-    /** Set the current elastix-level. */
-    elastices[ i ]->SetElastixLevel( i );
-    elastices[ i ]->SetTotalNumberOfElastixLevels( nrOfParameterFiles );
-
-    /** Delete the previous ParameterFileName. */
-    if( argMap.count( "-p" ) )
+    /** Every moving image of a batch starts from scratch, but shares the
+     * fixed image and mask, and the computation cache.
+     */
+    ParameterFileListType batchParameterFileList = parameterFileList;
+    if( batchMode )
     {
-      argMap.erase( "-p" );
+      /** Write the results of this moving image to a subdirectory. */
+      const std::string batchOutFolder = outFolder + batchOutputNames[ b ] + "/";
+      itksys::SystemTools::MakeDirectory( batchOutFolder.c_str() );
+      argMap[ "-m" ]   = movingImageBatch[ b ];
+      argMap[ "-out" ] = batchOutFolder;
+
+      elxout << "=========================================================================" << "\n" << std::endl;
+      elxout << "Registering moving image " << b + 1 << " of " << numberOfBatchItems
+             << ": \"" << movingImageBatch[ b ] << "\".\n"
+             << "The results are written to \"" << batchOutFolder << "\".\n" << std::endl;
     }
 
-    /** Read the first parameterFileName in the queue. */
-    ArgPairType argPair = parameterFileList.front();
-    parameterFileList.pop();
+    for( unsigned int i = 0; i < nrOfParameterFiles; i++ )
+    {
+      /** Create another instance of ElastixMain. */
+      elastices.push_back( ElastixMainType::New() );
+
+      /** Set stuff we get from a former registration. */
+      elastices.back()->SetInitialTransform( transform );
+      elastices.back()->SetFixedImageContainer( fixedImageContainer );
+      elastices.back()->SetMovingImageContainer( movingImageContainer );
+      elastices.back()->SetFixedMaskContainer( fixedMaskContainer );
+      elastices.back()->SetMovingMaskContainer( movingMaskContainer );
+      elastices.back()->SetComputationCache( computationCache );
+      elastices.back()->SetOriginalFixedImageDirectionFlat( fixedImageOriginalDirection );
+
+      /** Set the current elastix-level. */
+      elastices.back()->SetElastixLevel( i );
+      elastices.back()->SetTotalNumberOfElastixLevels( nrOfParameterFiles );
+
+      /** Delete the previous ParameterFileName. */
+      if( argMap.count( "-p" ) )
+      {
+        argMap.erase( "-p" );
+      }
 
-    /** Put it in the ArgumentMap. */
-    argMap.insert( ArgumentMapEntryType( argPair.first, argPair.second ) );
+      /** Read the first parameterFileName in the queue. */
+      ArgPairType argPair = batchParameterFileList.front();
+      batchParameterFileList.pop();
 
-    /** Print a start message. */
-    elxout << "-------------------------------------------------------------------------" << "\n" << std::endl;
-    elxout << "Running elastix with parameter file " << i
-           << ": \"" << argMap[ "-p" ] << "\".\n" << std::endl;
+      /** Put it in the ArgumentMap. */
+      argMap.insert( ArgumentMapEntryType( argPair.first, argPair.second ) );
 
-    /** Declare a timer, start it and print the start time. */
-    itk::TimeProbe timer;
-    timer.Start();
-    elxout << "Current time: " << GetCurrentDateAndTime() << "." << std::endl;
+      /** Print a start message. */
+      elxout << "-------------------------------------------------------------------------" << "\n" << std::endl;
+      elxout << "Running elastix with parameter file " << i
+             << ": \"" << argMap[ "-p" ] << "\".\n" << std::endl;
 
-    /** Start registration. */
-    returndummy = elastices[ i ]->Run( argMap );
+      /** Declare a timer, start it and print the start time. */
+      itk::TimeProbe timer;
+      timer.Start();
+      elxout << "Current time: " << GetCurrentDateAndTime() << "." << std::endl;
 
-    /** Check for errors. */
-    if( returndummy != 0 )
+      /** Start registration. */
+      returndummy = elastices.back()->Run( argMap );
+
+      /** Check for errors. A batch continues with the next moving image. */
+      if( returndummy != 0 )
+      {
+        xl::xout[ "error" ] << "Errors occurred!" << std::endl;
+        if( !batchMode ) { return returndummy; }
+        break;
+      }
+
+      /** Get the transform, the fixedImage and the movingImage
+       * in order to put it in the (possibly) next registration.
+       */
+      transform                   = elastices.back()->GetFinalTransform();
+      fixedImageContainer         = elastices.back()->GetFixedImageContainer();
+      movingImageContainer        = elastices.back()->GetMovingImageContainer();
+      fixedMaskContainer          = elastices.back()->GetFixedMaskContainer();
+      movingMaskContainer         = elastices.back()->GetMovingMaskContainer();
+      fixedImageOriginalDirection = elastices.back()->GetOriginalFixedImageDirectionFlat();
+
+      /** Print a finish message. */
+      elxout << "Running elastix with parameter file " << i
+             << ": \"" << argMap[ "-p" ] << "\", has finished.\n" << std::endl;
+
+      /** Stop timer and print it. */
+      timer.Stop();
+      elxout << "\nCurrent time: " << GetCurrentDateAndTime() << "." << std::endl;
+      elxout << "Time used for running elastix with this parameter file:\n  "
+             << ConvertSecondsToDHMS( timer.GetMean(), 1 ) << ".\n" << std::endl;
+
+      /** Try to release some memory. */
+      elastices.back() = 0;
+
+    } // end loop over registrations
+
+    if( batchMode )
     {
-      xl::xout[ "error" ] << "Errors occurred!" << std::endl;
-      return returndummy;
+      if( returndummy != 0 )
+      {
+        ++numberOfFailedBatchItems;
+        batchReturnValue = returndummy;
+      }
+
+      /** Release the moving image and the results that were computed from it. */
+      elastices.clear();
+      transform            = 0;
+      movingImageContainer = 0;
+      movingMaskContainer  = 0;
+      computationCache->RemoveUnusedEntries();
     }
 
-    /** Get the transform, the fixedImage and the movingImage
-     * in order to put it in the (possibly) next registration.
-     */
-    transform                   = elastices[ i ]->GetFinalTransform();
-    fixedImageContainer         = elastices[ i ]->GetFixedImageContainer();
-    movingImageContainer        = elastices[ i ]->GetMovingImageContainer();
-    fixedMaskContainer          = elastices[ i ]->GetFixedMaskContainer();
-    movingMaskContainer         = elastices[ i ]->GetMovingMaskContainer();
-    fixedImageOriginalDirection = elastices[ i ]->GetOriginalFixedImageDirectionFlat();
-
-    /** Print a finish message. */
-    elxout << "Running elastix with parameter file " << i
-           << ": \"" << argMap[ "-p" ] << "\", has finished.\n" << std::endl;
-
-    /** Stop timer and print it. */
-    timer.Stop();
-    elxout << "\nCurrent time: " << GetCurrentDateAndTime() << "." << std::endl;
-    elxout << "Time used for running elastix with this parameter file:\n  "
-           << ConvertSecondsToDHMS( timer.GetMean(), 1 ) << ".\n" << std::endl;
-
-    /** Try to release some memory. */
-    elastices[ i ] = 0;
+  } // end loop over moving images
 
-  } // end loop over registrations
+  if( batchMode )
+  {
+    elxout << "=========================================================================" << "\n" << std::endl;
+    elxout << "Registered " << numberOfBatchItems - numberOfFailedBatchItems
+           << " of " << numberOfBatchItems << " moving images successfully.\n" << std::endl;
+    returndummy = batchReturnValue;
+  }
 
   elxout << "-------------------------------------------------------------------------" << "\n" << std::endl;
 
@@ -308,7 +398,7 @@ main( int argc, char ** argv )
    * are deleted before the modules are closed.
    */
 
-  for( unsigned int i = 0; i < nrOfParameterFiles; i++ )
+  for( unsigned int i = 0; i < elastices.size(); i++ )
   {
     elastices[ i ] = 0;
   }
@@ -318,6 +408,7 @@ main( int argc, char ** argv )
   movingImageContainer = 0;
   fixedMaskContainer   = 0;
   movingMaskContainer  = 0;
+  computationCache     = 0;
 
   /** Close the modules. */
   ElastixMainType::UnloadComponents();
@@ -362,7 +453,11 @@ PrintHelp( void )
   std::cout << "  -t0       parameter file for initial transform\n";
   std::cout << "  -priority set the process priority to high, abovenormal, normal (default),\n"
             << "            belownormal, or idle (Windows only option)\n";
-  std::cout << "  -threads  set the maximum number of threads of elastix\n"
+  std::cout << "  -threads  set the maximum number of threads of elastix\n";
+  std::cout << "  -resume   checkpoint file from which an interrupted registration is resumed\n";
+  std::cout << "  -mlist    text file with a moving image per line, or a directory with moving\n"
+            << "            images, which replaces \"-m\". Each moving image is registered to\n"
+            << "            the fixed image, with the results in a subdirectory of \"-out\"\n"
             << std::endl;
 
   /** The parameter file.*/
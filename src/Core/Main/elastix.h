@@ -30,6 +30,10 @@
 #include <itksys/SystemTools.hxx>
 #include <itksys/SystemInformation.hxx>
 #include "itkTimeProbe.h"
+#include "itkImageIOFactory.h"
+#include <itksys/Directory.hxx>
+#include <algorithm>
+#include <fstream>
 #include <time.h>
 
 /** Declare PrintHelp function.
@@ -102,4 +106,60 @@ GetCurrentDateAndTime( void )
 } // end GetCurrentDateAndTime()
 
 
+/** Read the file names of a batch of images, from a text file with one
+ * file name per line, or from a directory. In the latter case all files
+ * that ITK can read as an image are used, in alphabetical order. Empty lines
+ * and lines that start with "//" are skipped. Returns false if the batch
+ * cannot be read or is empty.
+ */
+bool
+ReadImageBatch( const std::string & batchName,
+  std::vector< std::string > & fileNames )
+{
+  fileNames.clear();
+
+  /** A directory: use the files that can be read as an image. */
+  if( itksys::SystemTools::FileIsDirectory( batchName.c_str() ) )
+  {
+    itksys::Directory directory;
+    if( !directory.Load( batchName.c_str() ) ) { return false; }
+
+    for( unsigned long i = 0; i < directory.GetNumberOfFiles(); i++ )
+    {
+      const std::string fileName = batchName + "/" + directory.GetFile( i );
+      if( itksys::SystemTools::FileIsDirectory( fileName.c_str() ) ) { continue; }
+
+      itk::ImageIOBase::Pointer imageIO = itk::ImageIOFactory::CreateImageIO(
+        fileName.c_str(), itk::ImageIOFactory::ReadMode );
+      if( imageIO.IsNotNull() )
+      {
+        fileNames.push_back( fileName );
+      }
+    }
+    std::sort( fileNames.begin(), fileNames.end() );
+
+    return !fileNames.empty();
+  }
+
+  /** A text file: use a file name per line. */
+  std::ifstream batchFile( batchName.c_str() );
+  if( !batchFile.is_open() ) { return false; }
+
+  std::string line;
+  while( std::getline( batchFile, line ) )
+  {
+    const std::string::size_type first = line.find_first_not_of( " \t\r" );
+    if( first == std::string::npos || line.compare( first, 2, "//" ) == 0 )
+    {
+      continue;
+    }
+    const std::string::size_type last = line.find_last_not_of( " \t\r" );
+    fileNames.push_back( line.substr( first, last - first + 1 ) );
+  }
+
+  return !fileNames.empty();
+
+} // end ReadImageBatch()
+
+
 #endif
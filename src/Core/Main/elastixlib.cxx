@@ -145,6 +145,8 @@ ELASTIX::RegisterImages(
   typedef ElastixMainType::DataObjectContainerType    DataObjectContainerType;
   typedef ElastixMainType::DataObjectContainerPointer DataObjectContainerPointer;
   typedef ElastixMainType::FlatDirectionCosinesType   FlatDirectionCosinesType;
+  typedef ElastixMainType::ComputationCacheType       ComputationCacheType;
+  typedef ElastixMainType::ComputationCachePointer    ComputationCachePointer;
 
   typedef ElastixMainType::ArgumentMapType ArgumentMapType;
   typedef ArgumentMapType::value_type      ArgumentMapEntryType;
@@ -165,6 +167,7 @@ ELASTIX::RegisterImages(
   DataObjectContainerPointer fixedMaskContainer   = 0;
   DataObjectContainerPointer movingMaskContainer  = 0;
   DataObjectContainerPointer resultImageContainer = 0;
+  ComputationCachePointer    computationCache     = ComputationCacheType::New();
   FlatDirectionCosinesType   fixedImageOriginalDirection;
   int                        returndummy = 0;
   ArgumentMapType            argMap;
@@ -302,6 +305,7 @@ ELASTIX::RegisterImages(
     elastices[ i ]->SetFixedMaskContainer( fixedMaskContainer );
     elastices[ i ]->SetMovingMaskContainer( movingMaskContainer );
     elastices[ i ]->SetResultImageContainer( resultImageContainer );
+    elastices[ i ]->SetComputationCache( computationCache );
     elastices[ i ]->SetOriginalFixedImageDirectionFlat( fixedImageOriginalDirection );
 
     /** Set the current elastix-level. */
@@ -402,6 +406,7 @@ ELASTIX::RegisterImages(
   fixedMaskContainer   = 0;
   movingMaskContainer  = 0;
   resultImageContainer = 0;
+  computationCache     = 0;
 
   /** Close the modules. */
   ElastixMainType::UnloadComponents();
@@ -27,6 +27,16 @@
 /**
  * \class ElastixFilter
  * \brief ITK Filter interface to the Elastix registration library.
+ *
+ * To register many moving images to the same fixed image, use a filter for
+ * each moving image, with the same fixed image object and the same
+ * computation cache. The filters then share the fixed image pyramid, the
+ * eroded fixed mask, the fixed samples of the grid and full samplers, and
+ * the fixed image extrema.
+ *
+ * Filters can run concurrently in separate threads. The threads of the
+ * process are then divided over the running registrations, where
+ * SetNumberOfThreads() sets the maximum of a registration.
  */
 
 namespace elastix
@@ -57,6 +67,8 @@ public:
   typedef ElastixMainType::ArgumentMapType          ArgumentMapType;
   typedef ArgumentMapType::value_type               ArgumentMapEntryType;
   typedef ElastixMainType::FlatDirectionCosinesType FlatDirectionCosinesType;
+  typedef ElastixMainType::ComputationCacheType     ComputationCacheType;
+  typedef ElastixMainType::ComputationCachePointer  ComputationCachePointer;
 
   typedef ElastixMainType::DataObjectContainerType           DataObjectContainerType;
   typedef ElastixMainType::DataObjectContainerPointer        DataObjectContainerPointer;
@@ -162,6 +174,15 @@ public:
   itkGetConstReferenceMacro( LogToFile, bool );
   itkBooleanMacro( LogToFile );
 
+  /** Set/Get the computation cache that is shared with other filters. When
+   * it is set, UseComputationCache is "true" for the parameter maps that do
+   * not specify it. The results of images that are not used anymore are
+   * released when the filter is updated. By default each update uses a new
+   * cache, which is only shared by its parameter maps.
+   */
+  itkSetObjectMacro( ComputationCache, ComputationCacheType );
+  itkGetObjectMacro( ComputationCache, ComputationCacheType );
+
 protected:
 
   ElastixFilter( void );
@@ -198,6 +219,8 @@ private:
   bool m_LogToConsole;
   bool m_LogToFile;
 
+  ComputationCachePointer m_ComputationCache;
+
   unsigned int m_InputUID;
 
 };
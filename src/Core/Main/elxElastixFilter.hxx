@@ -46,6 +46,8 @@ ElastixFilter< TFixedImage, TMovingImage >
   this->m_LogToConsole = false;
   this->m_LogToFile    = false;
 
+  this->m_ComputationCache = 0;
+
   ParameterObjectPointer defaultParameterObject = ParameterObject::New();
   defaultParameterObject->AddParameterMap( ParameterObject::GetDefaultParameterMap( "translation" ) );
   defaultParameterObject->AddParameterMap( ParameterObject::GetDefaultParameterMap( "affine" ) );
@@ -78,6 +80,7 @@ ElastixFilter< TFixedImage, TMovingImage >
   DataObjectContainerPointer movingMaskContainer  = 0;
   DataObjectContainerPointer resultImageContainer = 0;
   ElastixMainObjectPointer   transform            = 0;
+  ComputationCachePointer    computationCache     = this->m_ComputationCache;
   ParameterMapVectorType     transformParameterMapVector;
   FlatDirectionCosinesType   fixedImageOriginalDirection;
 
@@ -128,6 +131,24 @@ ElastixFilter< TFixedImage, TMovingImage >
     itkExceptionMacro( "Empty parameter map in parameter object." );
   }
 
+  // A shared cache is used unless the parameter maps say otherwise, and
+  // releases the results of the images of previous updates
+  if( computationCache.IsNotNull() )
+  {
+    for( unsigned int i = 0; i < parameterMapVector.size(); ++i )
+    {
+      if( parameterMapVector[ i ].count( "UseComputationCache" ) == 0 )
+      {
+        parameterMapVector[ i ][ "UseComputationCache" ] = ParameterValueVectorType( 1, "true" );
+      }
+    }
+    computationCache->RemoveUnusedEntries();
+  }
+  else
+  {
+    computationCache = ComputationCacheType::New();
+  }
+
   // Elastix must always write result image to guarantee that the ITK pipeline is in a consistent state
   parameterMapVector[ parameterMapVector.size() - 1 ][ "WriteResultImage" ] = ParameterValueVectorType( 1, "true" );
 
@@ -149,6 +170,10 @@ ElastixFilter< TFixedImage, TMovingImage >
     argumentMap.insert( ArgumentMapEntryType( "-mp", this->m_MovingPointSetFileName ) );
   }
 
+  // The number of threads of this filter is the maximum of this registration. When
+  // several registrations run concurrently, they share the threads of the process.
+  argumentMap.insert( ArgumentMapEntryType( "-threads", ParameterObject::ToString( this->GetNumberOfThreads() ) ) );
+
   // Setup output directory
   if( this->GetOutputDirectory().empty() )
   {
@@ -222,6 +247,7 @@ ElastixFilter< TFixedImage, TMovingImage >
     elastix->SetFixedMaskContainer( fixedMaskContainer );
     elastix->SetMovingMaskContainer( movingMaskContainer );
     elastix->SetResultImageContainer( resultImageContainer );
+    elastix->SetComputationCache( computationCache );
     elastix->SetOriginalFixedImageDirectionFlat( fixedImageOriginalDirection );
 
     // Start registration
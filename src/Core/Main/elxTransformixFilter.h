@@ -96,6 +96,11 @@ public:
   itkGetConstMacro( ComputeDeformationField, bool );
   itkBooleanMacro( ComputeDeformationField );
 
+  /** Compute inverse deformation field On/Off. */
+  itkSetMacro( ComputeInverseDeformationField, bool );
+  itkGetConstMacro( ComputeInverseDeformationField, bool );
+  itkBooleanMacro( ComputeInverseDeformationField );
+
   /** Get/Set transform parameter object. */
   virtual void SetTransformParameterObject( ParameterObjectPointer transformParameterObject );
 
@@ -151,6 +156,7 @@ private:
   bool        m_ComputeSpatialJacobian;
   bool        m_ComputeDeterminantOfSpatialJacobian;
   bool        m_ComputeDeformationField;
+  bool        m_ComputeInverseDeformationField;
 
   std::string m_OutputDirectory;
   std::string m_LogFileName;
@@ -38,6 +38,7 @@ TransformixFilter< TMovingImage >
   this->m_ComputeSpatialJacobian              = false;
   this->m_ComputeDeterminantOfSpatialJacobian = false;
   this->m_ComputeDeformationField             = false;
+  this->m_ComputeInverseDeformationField      = false;
 
   this->m_OutputDirectory = "";
   this->m_LogFileName     = "";
@@ -69,13 +70,15 @@ TransformixFilter< TMovingImage >
       this->GetFixedPointSetFileName().empty() &&
       !this->GetComputeSpatialJacobian() &&
       !this->GetComputeDeterminantOfSpatialJacobian() &&
-      !this->GetComputeDeformationField() )
+      !this->GetComputeDeformationField() &&
+      !this->GetComputeInverseDeformationField() )
   {
     itkExceptionMacro( "Expected at least one of SeTMovingImage(), "
                     << "SetFixedPointSetFileName() "
                     << "ComputeSpatialJacobianOn(), "
-                    << "ComputeDeterminantOfSpatialJacobianOn() or "
-                    << "ComputeDeformationFieldOn(), "
+                    << "ComputeDeterminantOfSpatialJacobianOn(), "
+                    << "ComputeDeformationFieldOn() or "
+                    << "ComputeInverseDeformationFieldOn(), "
                     << "to be active.\"" );
   }
 
@@ -105,6 +108,11 @@ TransformixFilter< TMovingImage >
     argumentMap.insert( ArgumentMapEntryType( "-def", "all" ) );
   }
 
+  if( this->GetComputeInverseDeformationField() )
+  {
+    argumentMap.insert( ArgumentMapEntryType( "-inv", "all" ) );
+  }
+
   if( !this->GetFixedPointSetFileName().empty() )
   {
     argumentMap.insert( ArgumentMapEntryType( "-def", this->GetFixedPointSetFileName() ) );
@@ -115,6 +123,7 @@ TransformixFilter< TMovingImage >
   if( ( this->GetComputeSpatialJacobian()
     || this->GetComputeDeterminantOfSpatialJacobian()
     || this->GetComputeDeformationField()
+    || this->GetComputeInverseDeformationField()
     || !this->GetFixedPointSetFileName().empty()
     || this->GetLogToFile() )
     && this->GetOutputDirectory().empty() )
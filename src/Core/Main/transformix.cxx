@@ -18,6 +18,54 @@
 
 #include "elastix.h"
 #include "elxTransformixMain.h"
+#include "itkParameterFileParser.h"
+
+#include <map>
+#include <set>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+
+/** Some typedef's. */
+typedef elx::TransformixMain                 TransformixMainType;
+typedef TransformixMainType::Pointer         TransformixMainPointer;
+typedef TransformixMainType::ArgumentMapType ArgumentMapType;
+typedef ArgumentMapType::value_type          ArgumentMapEntryType;
+
+/** A transformix run of the service that has read its transform, with the
+ * transform parameter files of its chain of initial transforms.
+ */
+struct CachedTransformixType
+{
+  TransformixMainPointer     Transformix;
+  std::vector< std::string > FileNames;
+  std::vector< long >        ModifiedTimes;
+  unsigned long              LastRequest;
+};
+
+/** Put the (key, value) pairs of the arguments in the argument map. */
+void CreateArgumentMap( const std::vector< std::string > & arguments,
+  ArgumentMapType & argMap );
+
+/** Check the arguments of a transformix run, and expand "-inlist". */
+int CheckArgumentMap( ArgumentMapType & argMap );
+
+/** Check that the output directory is given and exists. */
+int CheckOutputFolder( const ArgumentMapType & argMap );
+
+/** Split a request of the transformix service in arguments. */
+void SplitRequest( const std::string & request, std::vector< std::string > & arguments );
+
+/** Convert the value of "-maxtransforms" to a positive number. */
+bool ReadMaximumNumberOfTransforms( const std::string & value, unsigned int & maximumNumberOfTransforms );
+
+/** Get the transform parameter file and its initial transforms, with their modification times. */
+void GetTransformChain( const std::string & transformParameterFileName,
+  std::vector< std::string > & fileNames, std::vector< long > & modifiedTimes );
+
+/** Run transformix as a service, which serves the requests of the input stream. */
+int RunService( const ArgumentMapType & serviceArgMap,
+  const unsigned int maximumNumberOfTransforms, std::istream & requests );
 
 int
 main( int argc, char ** argv )
@@ -51,12 +99,6 @@ main( int argc, char ** argv )
     }
   }
 
-  /** Some typedef's.*/
-  typedef elx::TransformixMain                 TransformixMainType;
-  typedef TransformixMainType::Pointer         TransformixMainPointer;
-  typedef TransformixMainType::ArgumentMapType ArgumentMapType;
-  typedef ArgumentMapType::value_type          ArgumentMapEntryType;
-
   /** Support Mevis Dicom Tiff (if selected in cmake) */
   RegisterMevisDicomTiff();
 
@@ -66,15 +108,157 @@ main( int argc, char ** argv )
   /** Initialize. */
   int             returndummy = 0;
   ArgumentMapType argMap;
-  bool            outFolderPresent = false;
-  std::string     outFolder        = "";
-  std::string     logFileName      = "";
+  std::string     logFileName = "";
+
+  /** Put command line parameters into the argument map. */
+  const std::vector< std::string > arguments( argv + 1, argv + argc );
+  CreateArgumentMap( arguments, argMap );
+
+  /** The argv0 argument, required for finding the component.dll/so's. */
+  argMap.insert( ArgumentMapEntryType( "-argv0", argv[ 0 ] ) );
+
+  /** Check the arguments. The service checks the arguments of each request. */
+  const bool   runAsService              = argMap.count( "-service" ) > 0;
+  unsigned int maximumNumberOfTransforms = 16;
+  if( runAsService )
+  {
+    const std::string & requestFileName = argMap[ "-service" ];
+    if( requestFileName != "stdin"
+      && !itksys::SystemTools::FileExists( requestFileName.c_str(), true ) )
+    {
+      std::cerr << "ERROR: the request file \"" << requestFileName
+                << "\" of \"-service\" does not exist." << std::endl;
+      returndummy |= -1;
+    }
+    if( argMap.count( "-maxtransforms" ) > 0
+      && !ReadMaximumNumberOfTransforms( argMap[ "-maxtransforms" ], maximumNumberOfTransforms ) )
+    {
+      std::cerr << "ERROR: \"-maxtransforms\" should be a positive number, not \""
+                << argMap[ "-maxtransforms" ] << "\"." << std::endl;
+      returndummy |= -1;
+    }
+  }
+  else
+  {
+    returndummy |= CheckArgumentMap( argMap );
+  }
+
+  /** Check if the -out option is given and setup xout. */
+  returndummy |= CheckOutputFolder( argMap );
+  if( argMap.count( "-out" ) > 0 && returndummy == 0 )
+  {
+    /** Setup xout. */
+    logFileName = argMap[ "-out" ] + "transformix.log";
+    int returndummy2 = elx::xoutSetup( logFileName.c_str(), true, true );
+    if( returndummy2 )
+    {
+      std::cerr << "ERROR while setting up xout." << std::endl;
+    }
+    returndummy |= returndummy2;
+  }
+
+  /** Stop if some fatal errors occurred. */
+  if( returndummy )
+  {
+    return returndummy;
+  }
+
+  elxout << std::endl;
+
+  /** Declare a timer, start it and print the start time. */
+  itk::TimeProbe totaltimer;
+  totaltimer.Start();
+  elxout << "transformix is started at " << GetCurrentDateAndTime() << ".\n" << std::endl;
+
+  /** Print where transformix was run. */
+  elxout << "which transformix:   " << argv[ 0 ] << std::endl;
+  itksys::SystemInformation info;
+  info.RunCPUCheck();
+  info.RunOSCheck();
+  info.RunMemoryCheck();
+  elxout << "transformix runs at: " << info.GetHostname() << std::endl;
+  elxout << "  " << info.GetOSName() << " "
+         << info.GetOSRelease() << ( info.Is64Bits() ? " (x64), " : ", " )
+         << info.GetOSVersion() << std::endl;
+  elxout << "  with " << info.GetTotalPhysicalMemory() << " MB memory, and "
+         << info.GetNumberOfPhysicalCPU() << " cores @ "
+         << static_cast< unsigned int >( info.GetProcessorClockFrequency() )
+         << " MHz." << std::endl;
+
+  /**
+   * ********************* START TRANSFORMATION *******************
+   */
+
+  if( runAsService )
+  {
+    /** Serve the requests, until the end of the input. */
+    if( argMap[ "-service" ] == "stdin" )
+    {
+      returndummy = RunService( argMap, maximumNumberOfTransforms, std::cin );
+    }
+    else
+    {
+      std::ifstream requestFile( argMap[ "-service" ].c_str() );
+      if( requestFile.is_open() )
+      {
+        returndummy = RunService( argMap, maximumNumberOfTransforms, requestFile );
+      }
+      else
+      {
+        xl::xout[ "error" ] << "ERROR: could not open the request file \""
+                            << argMap[ "-service" ] << "\"." << std::endl;
+        returndummy = -1;
+      }
+    }
+  }
+  else
+  {
+    /** Set transformix. */
+    transformix = TransformixMainType::New();
+
+    /** Print a start message. */
+    elxout << "Running transformix with parameter file \""
+           << argMap[ "-tp" ] << "\".\n" << std::endl;
+
+    /** Run transformix. */
+    returndummy = transformix->Run( argMap );
+  }
 
-  /** Put command line parameters into parameterFileList. */
-  for( unsigned int i = 1; static_cast< long >( i ) < argc - 1; i += 2 )
+  /** Check if transformix run without errors. */
+  if( returndummy != 0 )
   {
-    std::string key( argv[ i ] );
-    std::string value( argv[ i + 1 ] );
+    xl::xout[ "error" ] << "Errors occurred" << std::endl;
+    return returndummy;
+  }
+
+  /** Stop timer and print it. */
+  totaltimer.Stop();
+  elxout << "\ntransformix has finished at " << GetCurrentDateAndTime() << "." << std::endl;
+  elxout << "Total time elapsed: "
+         << ConvertSecondsToDHMS( totaltimer.GetMean(), 1 ) << ".\n" << std::endl;
+
+  /** Clean up. */
+  transformix = 0;
+  TransformixMainType::UnloadComponents();
+
+  /** Exit and return the error code. */
+  return returndummy;
+
+} // end main
+
+
+/**
+ * ********************* CreateArgumentMap **********************
+ */
+
+void
+CreateArgumentMap( const std::vector< std::string > & arguments,
+  ArgumentMapType & argMap )
+{
+  for( std::size_t i = 0; i + 1 < arguments.size(); i += 2 )
+  {
+    std::string key( arguments[ i ] );
+    std::string value( arguments[ i + 1 ] );
 
     if( key == "-out" )
     {
@@ -93,10 +277,6 @@ main( int argc, char ** argv )
         value = value.substr( 1, value.length() - 2 );
       }
 
-      /** Save this information. */
-      outFolderPresent = true;
-      outFolder        = value;
-
     } // end if key == "-out"
 
     /** Attempt to save the arguments in the ArgumentMap. */
@@ -114,8 +294,17 @@ main( int argc, char ** argv )
 
   } // end for loop
 
-  /** The argv0 argument, required for finding the component.dll/so's. */
-  argMap.insert( ArgumentMapEntryType( "-argv0", argv[ 0 ] ) );
+} // end CreateArgumentMap()
+
+
+/**
+ * ********************* CheckArgumentMap ***********************
+ */
+
+int
+CheckArgumentMap( ArgumentMapType & argMap )
+{
+  int returndummy = 0;
 
   /** Check that the option "-tp" is given. */
   if( argMap.count( "-tp" ) == 0 )
@@ -124,110 +313,344 @@ main( int argc, char ** argv )
     returndummy |= -1;
   }
 
+  /** Put the images of "-inlist" in the argument map as "-in0", "-in1", etc. */
+  if( argMap.count( "-inlist" ) > 0 )
+  {
+    std::vector< std::string > inputImages;
+    if( argMap.count( "-in" ) > 0 || argMap.count( "-in0" ) > 0 )
+    {
+      std::cerr << "ERROR: the CommandLine option \"-inlist\" can not be combined with \"-in\"." << std::endl;
+      returndummy |= -1;
+    }
+    else if( !ReadImageBatch( argMap[ "-inlist" ], inputImages ) )
+    {
+      std::cerr << "ERROR: no input images found in \"" << argMap[ "-inlist" ] << "\"." << std::endl;
+      returndummy |= -1;
+    }
+    for( unsigned int i = 0; i < inputImages.size() && returndummy == 0; ++i )
+    {
+      std::ostringstream key( "" );
+      key << "-in" << i;
+      argMap.insert( ArgumentMapEntryType( key.str(), inputImages[ i ] ) );
+    }
+  }
+
   /** Check that at least one of the following options is given. */
   if( argMap.count( "-in" ) == 0
+    && argMap.count( "-in0" ) == 0
     && argMap.count( "-ipp" ) == 0
     && argMap.count( "-def" ) == 0
     && argMap.count( "-jac" ) == 0
-    && argMap.count( "-jacmat" ) == 0 )
+    && argMap.count( "-jacmat" ) == 0
+    && argMap.count( "-inv" ) == 0 )
   {
     std::cerr << "ERROR: At least one of the CommandLine options \"-in\", "
-              << "\"-def\", \"-jac\", or \"-jacmat\" should be given!" << std::endl;
+              << "\"-def\", \"-jac\", \"-jacmat\", or \"-inv\" should be given!" << std::endl;
     returndummy |= -1;
   }
 
-  /** Check if the -out option is given and setup xout. */
-  if( outFolderPresent )
+  return returndummy;
+
+} // end CheckArgumentMap()
+
+
+/**
+ * ********************* CheckOutputFolder **********************
+ */
+
+int
+CheckOutputFolder( const ArgumentMapType & argMap )
+{
+  ArgumentMapType::const_iterator it = argMap.find( "-out" );
+  if( it == argMap.end() )
+  {
+    std::cerr << "ERROR: No CommandLine option \"-out\" given!" << std::endl;
+    return -2;
+  }
+
+  /** Check if the output directory exists. */
+  if( !itksys::SystemTools::FileIsDirectory( it->second.c_str() ) )
+  {
+    std::cerr << "ERROR: the output directory \"" << it->second << "\" does not exist." << std::endl;
+    std::cerr << "You are responsible for creating it." << std::endl;
+    return -2;
+  }
+
+  return 0;
+
+} // end CheckOutputFolder()
+
+
+/**
+ * ************************ SplitRequest ************************
+ *
+ * The arguments are separated by white space. An argument that
+ * contains white space, such as a path, can be put in double quotes.
+ */
+
+void
+SplitRequest( const std::string & request, std::vector< std::string > & arguments )
+{
+  arguments.clear();
+
+  std::string argument   = "";
+  bool        inArgument = false;
+  bool        inQuotes   = false;
+  for( std::size_t i = 0; i < request.size(); ++i )
   {
-    /** Check if the output directory exists. */
-    bool outFolderExists = itksys::SystemTools::FileIsDirectory( outFolder.c_str() );
-    if( !outFolderExists )
+    const char c = request[ i ];
+    if( c == '"' )
     {
-      std::cerr << "ERROR: the output directory \"" << outFolder << "\" does not exist." << std::endl;
-      std::cerr << "You are responsible for creating it." << std::endl;
-      returndummy |= -2;
+      inQuotes   = !inQuotes;
+      inArgument = true;
     }
-    else
+    else if( !inQuotes && ( c == ' ' || c == '\t' || c == '\r' ) )
     {
-      /** Setup xout. */
-      logFileName = argMap[ "-out" ] + "transformix.log";
-      int returndummy2 = elx::xoutSetup( logFileName.c_str(), true, true );
-      if( returndummy2 )
+      if( inArgument )
       {
-        std::cerr << "ERROR while setting up xout." << std::endl;
+        arguments.push_back( argument );
+        argument   = "";
+        inArgument = false;
       }
-      returndummy |= returndummy2;
+    }
+    else
+    {
+      argument  += c;
+      inArgument = true;
     }
   }
-  else
+  if( inArgument )
   {
-    returndummy = -2;
-    std::cerr << "ERROR: No CommandLine option \"-out\" given!" << std::endl;
+    arguments.push_back( argument );
   }
 
-  /** Stop if some fatal errors occurred. */
-  if( returndummy )
+} // end SplitRequest()
+
+
+/**
+ * ***************** ReadMaximumNumberOfTransforms ****************
+ */
+
+bool
+ReadMaximumNumberOfTransforms( const std::string & value, unsigned int & maximumNumberOfTransforms )
+{
+  /** Only accept a complete, positive, decimal number. */
+  if( value.empty() || value[ 0 ] < '0' || value[ 0 ] > '9' ) { return false; }
+  char * end = 0;
+  errno = 0;
+  const unsigned long number = std::strtoul( value.c_str(), &end, 10 );
+  if( *end != '\0' || errno == ERANGE || number == 0 || number > UINT_MAX )
   {
-    return returndummy;
+    return false;
   }
 
-  elxout << std::endl;
+  maximumNumberOfTransforms = static_cast< unsigned int >( number );
+  return true;
 
-  /** Declare a timer, start it and print the start time. */
-  itk::TimeProbe totaltimer;
-  totaltimer.Start();
-  elxout << "transformix is started at " << GetCurrentDateAndTime() << ".\n" << std::endl;
+} // end ReadMaximumNumberOfTransforms()
 
-  /** Print where transformix was run. */
-  elxout << "which transformix:   " << argv[ 0 ] << std::endl;
-  itksys::SystemInformation info;
-  info.RunCPUCheck();
-  info.RunOSCheck();
-  info.RunMemoryCheck();
-  elxout << "transformix runs at: " << info.GetHostname() << std::endl;
-  elxout << "  " << info.GetOSName() << " "
-         << info.GetOSRelease() << ( info.Is64Bits() ? " (x64), " : ", " )
-         << info.GetOSVersion() << std::endl;
-  elxout << "  with " << info.GetTotalPhysicalMemory() << " MB memory, and "
-         << info.GetNumberOfPhysicalCPU() << " cores @ "
-         << static_cast< unsigned int >( info.GetProcessorClockFrequency() )
-         << " MHz." << std::endl;
 
-  /**
-   * ********************* START TRANSFORMATION *******************
-   */
-
-  /** Set transformix. */
-  transformix = TransformixMainType::New();
+/**
+ * *********************** GetTransformChain **********************
+ *
+ * Follows the InitialTransformParametersFileName entries, like
+ * TransformBase::ReadFromFile() does, so relative file names are
+ * relative to the current directory.
+ */
 
-  /** Print a start message. */
-  elxout << "Running transformix with parameter file \""
-         << argMap[ "-tp" ] << "\".\n" << std::endl;
+void
+GetTransformChain( const std::string & transformParameterFileName,
+  std::vector< std::string > & fileNames, std::vector< long > & modifiedTimes )
+{
+  typedef itk::ParameterFileParser       ParserType;
+  typedef ParserType::ParameterMapType   ParameterMapType;
 
-  /** Run transformix. */
-  returndummy = transformix->Run( argMap );
+  fileNames.clear();
+  modifiedTimes.clear();
 
-  /** Check if transformix run without errors. */
-  if( returndummy != 0 )
+  std::set< std::string > visitedFileNames;
+  std::string             fileName = transformParameterFileName;
+  while( fileName != "NoInitialTransform"
+    && visitedFileNames.insert( itksys::SystemTools::CollapseFullPath( fileName.c_str() ) ).second )
   {
-    xl::xout[ "error" ] << "Errors occurred" << std::endl;
-    return returndummy;
+    fileNames.push_back( fileName );
+    modifiedTimes.push_back( itksys::SystemTools::ModifiedTime( fileName.c_str() ) );
+
+    ParserType::Pointer parser = ParserType::New();
+    parser->SetParameterFileName( fileName.c_str() );
+    parser->ReadParameterFile();
+    const ParameterMapType &         parameterMap = parser->GetParameterMap();
+    ParameterMapType::const_iterator it
+      = parameterMap.find( "InitialTransformParametersFileName" );
+    if( it == parameterMap.end() || it->second.empty() ) { break; }
+    fileName = it->second[ 0 ];
   }
 
-  /** Stop timer and print it. */
-  totaltimer.Stop();
-  elxout << "\ntransformix has finished at " << GetCurrentDateAndTime() << "." << std::endl;
-  elxout << "Total time elapsed: "
-         << ConvertSecondsToDHMS( totaltimer.GetMean(), 1 ) << ".\n" << std::endl;
+} // end GetTransformChain()
 
-  /** Clean up. */
-  transformix = 0;
-  TransformixMainType::UnloadComponents();
 
-  /** Exit and return the error code. */
-  return returndummy;
+/**
+ * ************************* RunService *************************
+ *
+ * Each line of the input is a request, with the arguments of a
+ * transformix run, for example "-tp tp.txt -def points.txt -out out/".
+ * The service writes a line "OK" or "ERROR <code>" to the standard output
+ * for each request; all other output goes to the standard error and the
+ * log file. The service stops at the end of the input, or at "exit".
+ *
+ * The transforms of the last requests are kept in memory, with their
+ * components, so a request with the same transform parameter file does
+ * not read and construct the transform again. A cached transform is read
+ * again when the modification time of its transform parameter file, or
+ * of one of the files of its initial transforms, changed.
+ */
 
-} // end main
+int
+RunService( const ArgumentMapType & serviceArgMap,
+  const unsigned int maximumNumberOfTransforms, std::istream & requests )
+{
+  typedef std::map< std::string, CachedTransformixType > CacheType;
+
+  /** The replies go to the standard output, all other output to the standard error. */
+  std::ostream     replyStream( std::cout.rdbuf() );
+  std::streambuf * coutBuffer = std::cout.rdbuf( std::cerr.rdbuf() );
+
+  ArgumentMapType::const_iterator serviceIt = serviceArgMap.find( "-service" );
+  elxout << "transformix service is reading requests from "
+         << ( serviceIt->second == "stdin" ? "the standard input" : serviceIt->second )
+         << ".\n"
+         << "  At most " << maximumNumberOfTransforms
+         << " transforms are kept in memory.\n" << std::endl;
+
+  CacheType     cache;
+  unsigned long requestNumber = 0;
+  std::string   request;
+  while( std::getline( requests, request ) )
+  {
+    /** Skip empty lines and comments. */
+    std::vector< std::string > arguments;
+    SplitRequest( request, arguments );
+    if( arguments.empty() || arguments[ 0 ].compare( 0, 2, "//" ) == 0 )
+    {
+      continue;
+    }
+    if( arguments[ 0 ] == "exit" || arguments[ 0 ] == "quit" )
+    {
+      break;
+    }
+    ++requestNumber;
+    elxout << "Request " << requestNumber << ": " << request << std::endl;
+
+    /** The arguments of the service, such as -threads, are the defaults. */
+    ArgumentMapType argMap;
+    CreateArgumentMap( arguments, argMap );
+    for( ArgumentMapType::const_iterator it = serviceArgMap.begin();
+      it != serviceArgMap.end(); ++it )
+    {
+      if( it->first != "-service" && it->first != "-out" && it->first != "-maxtransforms" )
+      {
+        argMap.insert( *it );
+      }
+    }
+
+    int returndummy = CheckArgumentMap( argMap );
+    returndummy |= CheckOutputFolder( argMap );
+    if( returndummy == 0 )
+    {
+      itk::TimeProbe timer;
+      timer.Start();
+
+      const std::string transformParameterFileName = argMap[ "-tp" ];
+
+      try
+      {
+        /** Reuse the transform, if none of its files changed on disk. A changed
+         * file name of an initial transform changes the file that refers to it.
+         */
+        CacheType::iterator it = cache.find( transformParameterFileName );
+        bool                isModified = it == cache.end();
+        for( std::size_t i = 0; !isModified && i < it->second.FileNames.size(); ++i )
+        {
+          isModified = itksys::SystemTools::ModifiedTime( it->second.FileNames[ i ].c_str() )
+            != it->second.ModifiedTimes[ i ];
+        }
+        if( !isModified )
+        {
+          returndummy = it->second.Transformix->RunWithLoadedTransform( argMap );
+          it->second.Transformix->ReleaseResources();
+          it->second.LastRequest = requestNumber;
+        }
+        else
+        {
+          if( it != cache.end() ) { cache.erase( it ); }
+
+          /** Note the files before reading them, so a later change is detected. */
+          std::vector< std::string > fileNames;
+          std::vector< long >        modifiedTimes;
+          GetTransformChain( transformParameterFileName, fileNames, modifiedTimes );
+
+          TransformixMainPointer transformix = TransformixMainType::New();
+          returndummy = transformix->Run( argMap );
+          transformix->ReleaseResources();
+
+          /** Keep the transform, and forget the least recently used one if needed. */
+          if( returndummy == 0 )
+          {
+            if( cache.size() >= maximumNumberOfTransforms )
+            {
+              CacheType::iterator oldest = cache.begin();
+              for( CacheType::iterator cit = cache.begin(); cit != cache.end(); ++cit )
+              {
+                if( cit->second.LastRequest < oldest->second.LastRequest ) { oldest = cit; }
+              }
+              cache.erase( oldest );
+            }
+            CachedTransformixType & entry = cache[ transformParameterFileName ];
+            entry.Transformix   = transformix;
+            entry.FileNames     = fileNames;
+            entry.ModifiedTimes = modifiedTimes;
+            entry.LastRequest   = requestNumber;
+          }
+        }
+      }
+      catch( itk::ExceptionObject & excp )
+      {
+        xl::xout[ "error" ] << excp << std::endl;
+        returndummy = 1;
+      }
+      catch( std::exception & excp )
+      {
+        xl::xout[ "error" ] << "ERROR: " << excp.what() << std::endl;
+        returndummy = 1;
+      }
+
+      timer.Stop();
+      elxout << "Request " << requestNumber << " took "
+             << ConvertSecondsToDHMS( timer.GetMean(), 3 ) << ".\n" << std::endl;
+    }
+
+    /** Reply. */
+    if( returndummy == 0 )
+    {
+      replyStream << "OK" << std::endl;
+    }
+    else
+    {
+      xl::xout[ "error" ] << "Errors occurred in request " << requestNumber << std::endl;
+      replyStream << "ERROR " << returndummy << std::endl;
+    }
+
+  } // end while
+
+  elxout << "transformix service served " << requestNumber << " requests." << std::endl;
+
+  /** Release the transforms before the components are unloaded. */
+  cache.clear();
+  std::cout.rdbuf( coutBuffer );
+
+  return 0;
+
+} // end RunService()
 
 
 /**
@@ -257,19 +680,42 @@ PrintHelp( void )
 
   /** Optional arguments. */
   std::cout << "Optional extra commands:\n";
-  std::cout << "  -in       input image to deform\n";
+  std::cout << "  -in       input image to deform; use \"-in0\", \"-in1\", etc. to deform several\n"
+            << "            images with one evaluation of the transform, which are written to\n"
+            << "            \"result.<i>.<format>\"\n";
+  std::cout << "  -inlist   text file with an input image per line, or a directory with input\n"
+            << "            images, which are deformed like with \"-in0\", \"-in1\", etc.\n";
   std::cout << "  -def      file containing input-image points; the point are transformed\n"
-            << "            according to the specified transform-parameter file\n";
+            << "            according to the specified transform-parameter file; the points of a\n"
+            << "            binary point file are written to \"outputpoints.bin\"\n";
   std::cout << "            use \"-def all\" to transform all points from the input-image, which\n"
             << "            effectively generates a deformation field.\n";
   std::cout << "  -jac      use \"-jac all\" to generate an image with the determinant of the\n"
             << "            spatial Jacobian\n";
   std::cout << "  -jacmat   use \"-jacmat all\" to generate an image with the spatial Jacobian\n"
             << "            matrix at each voxel\n";
+  std::cout << "  -inv      use \"-inv all\" to generate the deformation field of the inverse\n"
+            << "            transform, computed directly by fixed-point iteration\n";
   std::cout << "  -priority set the process priority to high, abovenormal, normal (default),\n"
             << "            belownormal, or idle (Windows only option)\n";
   std::cout << "  -threads  set the maximum number of threads of transformix\n";
-  std::cout << "\nAt least one of the options \"-in\", \"-def\", \"-jac\", or \"-jacmat\" should be given.\n"
+  std::cout << "\nAt least one of the options \"-in\", \"-def\", \"-jac\", \"-jacmat\", or \"-inv\"\n"
+            << "should be given.\n"
+            << std::endl;
+
+  /** The service mode. */
+  std::cout << "Call transformix as a service with:\n";
+  std::cout << "  transformix -service stdin -out <log directory> [-maxtransforms <n>]\n"
+            << "or with \"-service <request file>\" instead of \"-service stdin\".\n"
+            << "Each line of the standard input, or of the request file, is then a request with\n"
+            << "the arguments of a transformix run, such as \"-tp tp.txt -def points.txt -out out/\";\n"
+            << "arguments with spaces can be double quoted. For each request, \"OK\" or\n"
+            << "\"ERROR <code>\" is written to the standard output; all other output goes to the\n"
+            << "standard error and the log file. The transforms of the last <n> (default 16,\n"
+            << "at least 1) transform-parameter files are kept in memory, and are read again\n"
+            << "only when the file, or a file of its initial transforms, is modified.\n"
+            << "Other arguments, such as \"-threads\", are the defaults of the requests.\n"
+            << "The service stops at the end of the input, or at a line \"exit\".\n"
             << std::endl;
 
   /** The parameter file. */
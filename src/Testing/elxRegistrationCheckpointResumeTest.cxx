@@ -0,0 +1,293 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "elxRegistrationCheckpoint.h"
+#include "StandardGradientDescent/itkStandardGradientDescentOptimizer.h"
+#include "itkSingleValuedCostFunction.h"
+#include "itkCommand.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+//-------------------------------------------------------------------------------------
+// This test interrupts a StandardGradientDescentOptimizer in the middle of a
+// resolution: after an iteration a RegistrationCheckpoint is written to file, as
+// elastix does every CheckpointInterval iterations, and the optimization is stopped.
+// A new optimizer is resumed from that file, restoring the optimizer state in the
+// same way as elx::StandardGradientDescent. It should follow exactly the same path
+// as an optimizer that was not interrupted.
+
+typedef elastix::RegistrationCheckpoint CheckpointType;
+
+/** f(x) = sum_i (i+1) (x_i - 1)^2 */
+class QuadraticCostFunction : public itk::SingleValuedCostFunction
+{
+public:
+
+  typedef QuadraticCostFunction         Self;
+  typedef itk::SingleValuedCostFunction Superclass;
+  typedef itk::SmartPointer< Self >     Pointer;
+  itkNewMacro( Self );
+
+  virtual unsigned int GetNumberOfParameters( void ) const { return 3; }
+
+  virtual MeasureType GetValue( const ParametersType & parameters ) const
+  {
+    MeasureType value = 0.0;
+    for( unsigned int i = 0; i < parameters.GetSize(); ++i )
+    {
+      value += ( i + 1.0 ) * ( parameters[ i ] - 1.0 ) * ( parameters[ i ] - 1.0 );
+    }
+    return value;
+  }
+
+
+  virtual void GetDerivative( const ParametersType & parameters,
+    DerivativeType & derivative ) const
+  {
+    derivative.SetSize( parameters.GetSize() );
+    for( unsigned int i = 0; i < parameters.GetSize(); ++i )
+    {
+      derivative[ i ] = 2.0 * ( i + 1.0 ) * ( parameters[ i ] - 1.0 );
+    }
+  }
+
+
+};
+
+/** The optimizer with the checkpoint state of elx::StandardGradientDescent. */
+class ResumableOptimizer : public itk::StandardGradientDescentOptimizer
+{
+public:
+
+  typedef ResumableOptimizer                     Self;
+  typedef itk::StandardGradientDescentOptimizer Superclass;
+  typedef itk::SmartPointer< Self >              Pointer;
+  itkNewMacro( Self );
+
+  /** Write the state, as elx::StandardGradientDescent::WriteCheckpointState(). */
+  void WriteState( std::ostream & os ) const
+  {
+    CheckpointType::WriteValue( os, static_cast< unsigned long long >( this->m_CurrentIteration ) );
+    CheckpointType::WriteValue( os, this->m_CurrentTime );
+    CheckpointType::WriteValue( os, this->GetParam_a() );
+    CheckpointType::WriteValue( os, this->GetParam_A() );
+    CheckpointType::WriteValue( os, this->GetParam_alpha() );
+    itk::Array< double > plateauValues, plateauGradients;
+    this->GetPlateauHistory( plateauValues, plateauGradients );
+    CheckpointType::WriteVector( os, plateauValues );
+    CheckpointType::WriteVector( os, plateauGradients );
+  }
+
+
+  /** Restore the state, as elx::StandardGradientDescent::ResumeOptimization(). */
+  virtual void ResumeOptimization( void )
+  {
+    if( !this->m_State.empty() )
+    {
+      std::istringstream is( this->m_State, std::ios::in | std::ios::binary );
+      this->m_State.clear();
+      unsigned long long iteration = 0;
+      double             currentTime, a, A, alpha;
+      CheckpointType::ReadValue( is, iteration );
+      CheckpointType::ReadValue( is, currentTime );
+      CheckpointType::ReadValue( is, a );
+      CheckpointType::ReadValue( is, A );
+      CheckpointType::ReadValue( is, alpha );
+      itk::Array< double > plateauValues, plateauGradients;
+      CheckpointType::ReadVector( is, plateauValues );
+      CheckpointType::ReadVector( is, plateauGradients );
+
+      this->m_CurrentIteration = static_cast< unsigned long >( iteration );
+      this->m_CurrentTime      = currentTime;
+      this->SetParam_a( a );
+      this->SetParam_A( A );
+      this->SetParam_alpha( alpha );
+      this->SetPlateauHistory( plateauValues, plateauGradients );
+
+      /** Complete the iteration in which the checkpoint was written. */
+      this->UpdateCurrentTime();
+      this->m_CurrentIteration++;
+      if( this->m_CurrentIteration >= this->GetNumberOfIterations() )
+      {
+        this->m_StopCondition = MaximumNumberOfIterations;
+        this->StopOptimization();
+        return;
+      }
+      if( this->GetUsePlateauStopCriterion() && this->TestPlateau() )
+      {
+        this->m_StopCondition = MetricPlateau;
+        this->StopOptimization();
+        return;
+      }
+    }
+
+    this->Superclass::ResumeOptimization();
+  }
+
+
+  std::string m_State;
+};
+
+/** Writes a checkpoint after an iteration and stops, as if elastix was killed. */
+class InterruptCommand : public itk::Command
+{
+public:
+
+  typedef InterruptCommand          Self;
+  typedef itk::Command              Superclass;
+  typedef itk::SmartPointer< Self > Pointer;
+  itkNewMacro( Self );
+
+  virtual void Execute( itk::Object * caller, const itk::EventObject & event )
+  {
+    ResumableOptimizer * optimizer = dynamic_cast< ResumableOptimizer * >( caller );
+    if( !optimizer || !itk::IterationEvent().CheckEvent( &event )
+      || optimizer->GetCurrentIteration() != this->m_Iteration )
+    {
+      return;
+    }
+
+    CheckpointType checkpoint;
+    checkpoint.ResolutionLevel   = 0;
+    checkpoint.IterationCounter  = this->m_Iteration + 1;
+    checkpoint.CurrentParameters = optimizer->GetCurrentPosition();
+    checkpoint.OptimizerName     = "StandardGradientDescent";
+    std::ostringstream state( std::ios::out | std::ios::binary );
+    optimizer->WriteState( state );
+    checkpoint.OptimizerState = state.str();
+    checkpoint.Write( this->m_FileName );
+
+    optimizer->StopOptimization();
+  }
+
+
+  virtual void Execute( const itk::Object *, const itk::EventObject & ) {}
+
+  unsigned long m_Iteration;
+  std::string   m_FileName;
+};
+
+//-------------------------------------------------------------------------------------
+
+int
+main( int argc, char * argv[] )
+{
+  if( argc != 2 )
+  {
+    std::cerr << "ERROR: usage: " << argv[ 0 ] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string fileName = std::string( argv[ 1 ] ) + "/RegistrationCheckpointResumeTest.bin";
+
+  /** Some basic type definitions. */
+  typedef ResumableOptimizer::ParametersType ParametersType;
+
+  QuadraticCostFunction::Pointer costFunction = QuadraticCostFunction::New();
+  ParametersType                 initialPosition( costFunction->GetNumberOfParameters() );
+  initialPosition.Fill( 5.0 );
+
+  /** Run without interruption, interrupted after iteration 17, and resumed. */
+  ResumableOptimizer::Pointer optimizers[ 3 ];
+  for( unsigned int run = 0; run < 3; ++run )
+  {
+    ResumableOptimizer::Pointer optimizer = ResumableOptimizer::New();
+    optimizer->SetCostFunction( costFunction );
+    optimizer->SetNumberOfIterations( 60 );
+    optimizer->SetParam_a( 0.2 );
+    optimizer->SetParam_A( 10.0 );
+    optimizer->SetParam_alpha( 0.602 );
+    optimizer->SetUsePlateauStopCriterion( true );
+    optimizer->SetPlateauWindowSize( 10 );
+    optimizer->SetPlateauCheckInterval( 5 );
+    optimizer->SetPlateauTestThreshold( 0.0 );
+    optimizer->SetInitialPosition( initialPosition );
+
+    if( run == 1 )
+    {
+      InterruptCommand::Pointer command = InterruptCommand::New();
+      command->m_Iteration = 17;
+      command->m_FileName  = fileName;
+      optimizer->AddObserver( itk::IterationEvent(), command );
+    }
+    else if( run == 2 )
+    {
+      /** Elastix starts the interrupted resolution from the stored parameters. */
+      CheckpointType checkpoint;
+      try
+      {
+        checkpoint.Read( fileName );
+      }
+      catch( itk::ExceptionObject & excp )
+      {
+        std::cerr << excp << std::endl;
+        return EXIT_FAILURE;
+      }
+      optimizer->SetInitialPosition( checkpoint.CurrentParameters );
+      optimizer->m_State = checkpoint.OptimizerState;
+    }
+
+    try
+    {
+      optimizer->StartOptimization();
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      std::cerr << excp << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cerr << std::setprecision( 17 ) << "run " << run << ": " << optimizer->GetCurrentPosition()
+              << " after " << optimizer->GetCurrentIteration() << " iterations" << std::endl;
+    optimizers[ run ] = optimizer;
+  }
+
+  /** TEST: The interrupted run stopped in the middle. */
+  if( optimizers[ 1 ]->GetCurrentIteration() != 17
+    || optimizers[ 0 ]->GetCurrentIteration() <= 17 )
+  {
+    std::cerr << "ERROR: the optimization was not interrupted in the middle." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** TEST: The resumed run restored the time and the plateau history. */
+  itk::Array< double > values[ 2 ], gradients[ 2 ];
+  for( unsigned int run = 0; run < 2; ++run )
+  {
+    optimizers[ 2 * run ]->GetPlateauHistory( values[ run ], gradients[ run ] );
+  }
+  if( optimizers[ 2 ]->GetCurrentTime() != optimizers[ 0 ]->GetCurrentTime()
+    || values[ 1 ] != values[ 0 ] || gradients[ 1 ] != gradients[ 0 ] )
+  {
+    std::cerr << "ERROR: the optimizer state was not restored." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** TEST: The resumed run ends exactly where the uninterrupted run ends. */
+  if( optimizers[ 2 ]->GetCurrentIteration() != optimizers[ 0 ]->GetCurrentIteration()
+    || optimizers[ 2 ]->GetStopCondition() != optimizers[ 0 ]->GetStopCondition()
+    || optimizers[ 2 ]->GetCurrentPosition() != optimizers[ 0 ]->GetCurrentPosition() )
+  {
+    std::cerr << "ERROR: the resumed run differs from the uninterrupted run." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Return a value. */
+  return EXIT_SUCCESS;
+
+} // end main
@@ -0,0 +1,233 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+/** \file
+ \brief Write and read a RegistrationCheckpoint, and check that corrupt files are rejected.
+ */
+
+#include "elxRegistrationCheckpoint.h"
+#include "itkArray.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iterator>
+
+typedef elastix::RegistrationCheckpoint CheckpointType;
+typedef CheckpointType::ParametersType  ParametersType;
+
+//-------------------------------------------------------------------------------------
+
+/** Create a checkpoint with some recognizable content. */
+
+CheckpointType
+CreateCheckpoint( const double offset, const unsigned int numberOfCompletedLevels )
+{
+  CheckpointType checkpoint;
+  checkpoint.ElastixLevel     = 1;
+  checkpoint.ResolutionLevel  = numberOfCompletedLevels;
+  checkpoint.IterationCounter = 250;
+  for( unsigned int level = 0; level < numberOfCompletedLevels; ++level )
+  {
+    ParametersType parameters( 3 + level );
+    for( unsigned int i = 0; i < parameters.GetSize(); ++i )
+    {
+      parameters[ i ] = offset + 10.0 * level + 0.5 * i;
+    }
+    checkpoint.CompletedLevelParameters.push_back( parameters );
+  }
+  checkpoint.CurrentParameters.SetSize( 6 );
+  for( unsigned int i = 0; i < 6; ++i )
+  {
+    checkpoint.CurrentParameters[ i ] = offset - 0.25 * i;
+  }
+  checkpoint.OptimizerName = "StandardGradientDescent";
+
+  /** An optimizer state, written with the helpers of the class. */
+  std::ostringstream   state( std::ios::out | std::ios::binary );
+  itk::Array< double > vector( 4 );
+  vector.Fill( offset );
+  CheckpointType::WriteValue( state, 42ULL );
+  CheckpointType::WriteVector( state, vector );
+  checkpoint.OptimizerState = state.str();
+
+  return checkpoint;
+
+} // end CreateCheckpoint()
+
+//-------------------------------------------------------------------------------------
+
+/** Compare two checkpoints. */
+
+bool
+Equal( const CheckpointType & a, const CheckpointType & b )
+{
+  if( a.ElastixLevel != b.ElastixLevel
+    || a.ResolutionLevel != b.ResolutionLevel
+    || a.IterationCounter != b.IterationCounter
+    || a.CompletedLevelParameters.size() != b.CompletedLevelParameters.size()
+    || a.CurrentParameters != b.CurrentParameters
+    || a.OptimizerName != b.OptimizerName
+    || a.OptimizerState != b.OptimizerState )
+  {
+    return false;
+  }
+  for( unsigned int i = 0; i < a.CompletedLevelParameters.size(); ++i )
+  {
+    if( a.CompletedLevelParameters[ i ] != b.CompletedLevelParameters[ i ] )
+    {
+      return false;
+    }
+  }
+  return true;
+
+} // end Equal()
+
+//-------------------------------------------------------------------------------------
+
+/** Returns true if reading the file throws an itk::ExceptionObject. */
+
+bool
+ReadFails( const std::string & fileName )
+{
+  CheckpointType checkpoint;
+  try
+  {
+    checkpoint.Read( fileName );
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    std::cerr << "Expected error: " << excp.GetDescription() << std::endl;
+    return true;
+  }
+  return false;
+
+} // end ReadFails()
+
+//-------------------------------------------------------------------------------------
+
+int
+main( int argc, char * argv[] )
+{
+  if( argc != 2 )
+  {
+    std::cerr << "ERROR: usage: " << argv[ 0 ] << " outputDirectory" << std::endl;
+    return 1;
+  }
+  const std::string fileName = std::string( argv[ 1 ] ) + "/RegistrationCheckpointTest.bin";
+
+  try
+  {
+    /** Round trip. */
+    const CheckpointType first = CreateCheckpoint( 1.0, 2 );
+    first.Write( fileName );
+    CheckpointType read;
+    read.Read( fileName );
+    if( !Equal( first, read ) )
+    {
+      std::cerr << "ERROR: the checkpoint that was read differs from the one written." << std::endl;
+      return 1;
+    }
+
+    /** The optimizer state can be read with the helpers. */
+    std::istringstream   state( read.OptimizerState, std::ios::in | std::ios::binary );
+    unsigned long long   value = 0;
+    itk::Array< double > vector;
+    CheckpointType::ReadValue( state, value );
+    CheckpointType::ReadVector( state, vector );
+    if( value != 42ULL || vector.GetSize() != 4 || vector[ 3 ] != 1.0 )
+    {
+      std::cerr << "ERROR: the optimizer state was not read back correctly." << std::endl;
+      return 1;
+    }
+
+    /** Replacing an existing checkpoint, without leaving the temporary file. */
+    const CheckpointType second = CreateCheckpoint( -3.0, 3 );
+    second.Write( fileName );
+    read.Read( fileName );
+    if( !Equal( second, read ) )
+    {
+      std::cerr << "ERROR: the checkpoint was not replaced." << std::endl;
+      return 1;
+    }
+    std::ifstream temporary( ( fileName + ".tmp" ).c_str() );
+    if( temporary.is_open() )
+    {
+      std::cerr << "ERROR: the temporary checkpoint file was left behind." << std::endl;
+      return 1;
+    }
+  }
+  catch( itk::ExceptionObject & excp )
+  {
+    std::cerr << excp << std::endl;
+    return 1;
+  }
+
+  /** Read the file into memory, to create corrupt versions of it. */
+  std::ifstream input( fileName.c_str(), std::ios::in | std::ios::binary );
+  std::string   contents( ( std::istreambuf_iterator< char >( input ) ), std::istreambuf_iterator< char >() );
+  input.close();
+
+  /** A truncated file. */
+  const std::string corruptFileName = std::string( argv[ 1 ] ) + "/RegistrationCheckpointTestCorrupt.bin";
+  {
+    std::ofstream output( corruptFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+    output.write( contents.data(), static_cast< std::streamsize >( contents.size() - 5 ) );
+  }
+  if( !ReadFails( corruptFileName ) )
+  {
+    std::cerr << "ERROR: a truncated checkpoint was accepted." << std::endl;
+    return 1;
+  }
+
+  /** A huge number of completed levels, directly after the header of
+   * magic string, version, elastix level, resolution and iteration.
+   */
+  {
+    const std::size_t offset = 8 + 4 * sizeof( unsigned int );
+    std::string       corrupt( contents );
+    const unsigned int numberOfLevels = 0x7fffffff;
+    corrupt.replace( offset, sizeof( unsigned int ),
+      reinterpret_cast< const char * >( &numberOfLevels ), sizeof( unsigned int ) );
+    std::ofstream output( corruptFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+    output.write( corrupt.data(), static_cast< std::streamsize >( corrupt.size() ) );
+  }
+  if( !ReadFails( corruptFileName ) )
+  {
+    std::cerr << "ERROR: a checkpoint with a corrupt number of levels was accepted." << std::endl;
+    return 1;
+  }
+
+  /** A huge vector size in the first parameter vector. */
+  {
+    const std::size_t        offset = 8 + 5 * sizeof( unsigned int );
+    std::string              corrupt( contents );
+    const unsigned long long size = 1ULL << 40;
+    corrupt.replace( offset, sizeof( unsigned long long ),
+      reinterpret_cast< const char * >( &size ), sizeof( unsigned long long ) );
+    std::ofstream output( corruptFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+    output.write( corrupt.data(), static_cast< std::streamsize >( corrupt.size() ) );
+  }
+  if( !ReadFails( corruptFileName ) )
+  {
+    std::cerr << "ERROR: a checkpoint with a corrupt vector size was accepted." << std::endl;
+    return 1;
+  }
+
+  return 0;
+
+} // end main
@@ -0,0 +1,161 @@
+import sys
+import os
+import os.path
+from optparse import OptionParser
+
+#-------------------------------------------------------------------------------
+# Read the metric values and iteration times of all resolutions of the last
+# elastix level, from the files IterationInfo.<level>.R<resolution>.txt.
+# Returns the file names, and per resolution a list of metric values and a
+# list of iteration times.
+def readIterationInfo( directory ):
+    # Find the IterationInfo files of the last elastix level
+    files = {}
+    for i in os.listdir( directory ):
+        if not i.startswith( "IterationInfo." ):
+            continue
+        fileNameParts = i.split( "." )
+        elastixLevel = int( fileNameParts[1] )
+        resolutionLevel = int( fileNameParts[2].lstrip('R') )
+        files.setdefault( elastixLevel, {} )[ resolutionLevel ] = i
+
+    if len( files ) == 0:
+        return ( [], [], [] )
+    resolutions = files[ max( files.keys() ) ]
+
+    fileNames = []
+    metricValues = []
+    iterationTimes = []
+    for resolutionLevel in sorted( resolutions.keys() ):
+        fileName = resolutions[ resolutionLevel ]
+        f = open( os.path.join( directory, fileName ) )
+        lineList = f.readlines()
+        f.close()
+
+        # The first line contains the headers
+        headers = lineList[ 0 ].rstrip( "\n" ).split( "\t" )
+        metricColumn = headers.index( "2:Metric" )
+        timeColumn = headers.index( "Time[ms]" )
+
+        metric = []
+        times = []
+        for line in lineList[ 1: ]:
+            values = line.rstrip( "\n" ).split( "\t" )
+            if len( values ) <= max( metricColumn, timeColumn ):
+                continue
+            metric.append( float( values[ metricColumn ] ) )
+            times.append( float( values[ timeColumn ] ) )
+
+        fileNames.append( fileName )
+        metricValues.append( metric )
+        iterationTimes.append( times )
+
+    return ( fileNames, metricValues, iterationTimes )
+
+#-------------------------------------------------------------------------------
+# Smooth the (stochastic) metric values with a running mean
+def runningMean( values, window ):
+    means = []
+    total = 0.0
+    for i in range( len( values ) ):
+        total += values[ i ]
+        if i >= window:
+            total -= values[ i - window ]
+        means.append( total / min( i + 1, window ) )
+    return means
+
+#-------------------------------------------------------------------------------
+# Find the first iteration at which the smoothed metric reaches the target
+def iterationsToTarget( means, target ):
+    for i in range( len( means ) ):
+        if means[ i ] <= target:
+            return i + 1
+    return -1
+
+#-------------------------------------------------------------------------------
+# the main function
+def main():
+    # usage, parse parameters
+    usage = "usage: %prog [options] arg"
+    parser = OptionParser( usage )
+
+    # option to debug and verbose
+    parser.add_option( "-v", "--verbose",
+        action="store_true", dest="verbose" )
+
+    # options to control files
+    parser.add_option( "-d", "--directory", dest="directory", help="elastix output directory" )
+    parser.add_option( "-b", "--baseline", dest="baseline", help="elastix output directory of the reference run" )
+    parser.add_option( "-w", "--window", dest="window", type="int", default=10,
+        help="number of iterations over which the metric is averaged" )
+    parser.add_option( "-t", "--tolerance", dest="tolerance", type="float", default=0.01,
+        help="the target may be missed by this fraction of its absolute value" )
+    parser.add_option( "-r", "--maxratio", dest="maxratio", type="float", default=1.0,
+        help="maximum ratio of the time of the test run and the reference run" )
+
+    (options, args) = parser.parse_args()
+
+    # Check if option -b and -d are given
+    if options.baseline == None :
+        parser.error( "The option baseline directory (-b) should be given" )
+    if options.directory == None :
+        parser.error( "The option directory (-d) should be given" )
+
+    ( baselineFiles, baselineMetric, baselineTimes ) = readIterationInfo( options.baseline )
+    ( testFiles, testMetric, testTimes ) = readIterationInfo( options.directory )
+
+    # Sanity check
+    if len( baselineMetric ) == 0 or len( testMetric ) == 0 \
+        or len( baselineMetric[ -1 ] ) == 0 or len( testMetric[ -1 ] ) == 0:
+        print( "ERROR: no IterationInfo files found in '" + options.baseline
+            + "' or '" + options.directory + "'" )
+        return 1
+    if len( baselineMetric ) != len( testMetric ):
+        print( "ERROR: the runs have a different number of resolutions: "
+            + str( len( baselineMetric ) ) + " and " + str( len( testMetric ) ) )
+        return 1
+
+    print( "Comparing the convergence in " + ", ".join( testFiles )
+        + " with " + ", ".join( baselineFiles ) )
+
+    # The metric values of different resolutions are not comparable, so the
+    # target is the final (smoothed) metric value of the last resolution of
+    # the reference run. The earlier resolutions count in full.
+    baselineMeans = runningMean( baselineMetric[ -1 ], options.window )
+    testMeans = runningMean( testMetric[ -1 ], options.window )
+    target = baselineMeans[ -1 ] + options.tolerance * abs( baselineMeans[ -1 ] )
+
+    baselineIterations = iterationsToTarget( baselineMeans, target )
+    testIterations = iterationsToTarget( testMeans, target )
+
+    baselineTotalIterations = sum( [ len( m ) for m in baselineMetric[ :-1 ] ] ) + baselineIterations
+    baselineTotalTime = sum( [ sum( t ) for t in baselineTimes[ :-1 ] ] ) \
+        + sum( baselineTimes[ -1 ][ :baselineIterations ] )
+
+    print( "Target metric value: " + str( target ) )
+    print( "Reference: " + str( baselineTotalIterations ) + " iterations, "
+        + str( baselineTotalTime ) + " ms" )
+    if testIterations == -1:
+        print( "FAILURE: the target was not reached in " + str( len( testMetric[ -1 ] ) )
+            + " iterations of the last resolution, final metric value " + str( testMeans[ -1 ] ) )
+        return 1
+
+    testTotalIterations = sum( [ len( m ) for m in testMetric[ :-1 ] ] ) + testIterations
+    testTotalTime = sum( [ sum( t ) for t in testTimes[ :-1 ] ] ) \
+        + sum( testTimes[ -1 ][ :testIterations ] )
+    print( "Test: " + str( testTotalIterations ) + " iterations, "
+        + str( testTotalTime ) + " ms" )
+
+    # Pass when the target is reached within the allowed time
+    if testTotalTime <= options.maxratio * baselineTotalTime:
+        print( "SUCCESS: the target was reached within " + str( options.maxratio )
+            + " times the time of the reference" )
+        return 0
+    else:
+        print( "FAILURE: the target was reached, but took more than " + str( options.maxratio )
+            + " times the time of the reference" )
+        return 1
+
+#-------------------------------------------------------------------------------
+if __name__ == '__main__':
+    sys.exit(main())
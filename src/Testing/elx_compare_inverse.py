@@ -0,0 +1,114 @@
+import sys, subprocess
+import os
+import os.path
+import math
+from optparse import OptionParser
+
+#-------------------------------------------------------------------------------
+# Transform the points in pointsFileName, and return the output points
+def transformPoints( pointsFileName, tpFileName, directory ):
+  outputPointsFileName = os.path.join( directory, "outputpoints.txt" );
+  if os.path.exists( outputPointsFileName ) : os.remove( outputPointsFileName );
+  subprocess.call( [ "transformix", "-def", pointsFileName, "-out", directory, "-tp", tpFileName ],
+    stdout=subprocess.PIPE );
+  if not os.path.exists( outputPointsFileName ) :
+    return [];
+
+  # Parse file to extract only the column with the output points
+  points = [];
+  f = open( outputPointsFileName, 'r' );
+  for line in f :
+    point = line.strip().split(';')[4].strip().strip( "OutputPoint = [ " ).rstrip( " ]" );
+    points.append( [ float(x) for x in point.split() ] );
+  f.close();
+  return points;
+
+#-------------------------------------------------------------------------------
+# Write points in the transformix input format
+def writePoints( points, pointsFileName ):
+  f = open( pointsFileName, 'w' );
+  f.write( "point\n" + str( len( points ) ) + "\n" );
+  for point in points :
+    f.write( " ".join( [ "{0:.6f}".format( x ) for x in point ] ) + "\n" );
+  f.close();
+
+#-------------------------------------------------------------------------------
+# the main function
+def main():
+  # usage, parse parameters
+  usage = "usage: %prog [options] arg";
+  parser = OptionParser( usage );
+
+  # option to debug and verbose
+  parser.add_option( "-v", "--verbose", action="store_true", dest="verbose" );
+
+  # options to control files
+  parser.add_option( "-d", "--directory", dest="directory", help="transformix output directory" );
+  parser.add_option( "-f", "--fixedlandmarks", dest="flm", help="fixed image landmarks" );
+  parser.add_option( "-t", "--forwardtp", dest="ftp", help="forward transform parameter file" );
+  parser.add_option( "-m", "--maximum", dest="maximum", type="float", default=0.5,
+    help="maximum mean distance in mm" );
+
+  (options, args) = parser.parse_args();
+
+  # Check if option -d and -f and -t are given
+  if options.directory == None :
+    parser.error( "The option directory (-d) should be given" );
+  if options.flm == None :
+    parser.error( "The option fixed landmarks (-f) should be given" );
+  if options.ftp == None :
+    parser.error( "The option forward transform parameter file (-t) should be given" );
+
+  # The inverse is written by "transformix -inv all" with WriteInverseBSplineTransform
+  itpFileName = os.path.join( options.directory, "TransformParameters.inverse.txt" );
+  if not os.path.exists( itpFileName ) :
+    print( "ERROR: the file " + itpFileName + " does not exist" );
+    return 1;
+
+  # Make sure the first path is the elastix binary directory from this build
+  _path = os.path.join( options.directory, "..", "..", "bin" ); # bin dir on Linux
+  _path += os.pathsep + os.path.join( options.directory, "..", "..", "bin", "Release" ); # bin dir on Windows
+  _path += os.pathsep + os.getenv('PATH');
+  os.environ['PATH'] = _path;
+
+  # Read the fixed image landmarks
+  f = open( options.flm, 'r' );
+  lines = f.readlines();
+  f.close();
+  landmarks = [ [ float(x) for x in line.split() ] for line in lines[ 2: ] if line.strip() ];
+
+  # Map the landmarks forward, and back with the inverse
+  print( "Transforming fixed image landmarks using " + options.ftp );
+  forwardPoints = transformPoints( options.flm, options.ftp, options.directory );
+  forwardPointsFileName = os.path.join( options.directory, "forwardpoints.txt" );
+  writePoints( forwardPoints, forwardPointsFileName );
+  print( "Transforming them back using " + itpFileName );
+  backPoints = transformPoints( forwardPointsFileName, itpFileName, options.directory );
+  if len( backPoints ) != len( landmarks ) :
+    print( "ERROR: transformix did not transform all landmarks" );
+    return 1;
+
+  # Compute the distance between the landmarks and their round trip
+  distances = [];
+  for point1, point2 in zip( landmarks, backPoints ) :
+    diffSquared = [ (m - n) * (m - n) for m, n in zip( point1, point2 ) ];
+    distances.append( math.sqrt( sum( diffSquared ) ) );
+
+  distances.sort();
+  maxDistance  = "{0:.3f}".format( distances[ -1 ] );
+  meanDistance = "{0:.3f}".format( sum( distances ) / float( len( distances ) ) );
+
+  # Report
+  print( "The distance between the landmarks and inverse(forward(landmarks)) is:" );
+  print( "max   | mean" );
+  print( maxDistance + " | " + meanDistance );
+  if float( meanDistance ) < options.maximum :
+    print( "SUCCESS: mean distance is lower than " + str( options.maximum ) + " mm" );
+    return 0;
+  else :
+    print( "FAILURE: mean distance is higher than " + str( options.maximum ) + " mm" );
+    return 1;
+
+#-------------------------------------------------------------------------------
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "CMAEvolutionStrategy/itkCMAEvolutionStrategyOptimizer.h"
+#include "itkSingleValuedCostFunction.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <iostream>
+#include <iomanip>
+
+//-------------------------------------------------------------------------------------
+// This test runs the CMAEvolutionStrategyOptimizer twice with the same seed on an
+// anisotropic quadratic, with its minimum at (1, 2, 3, 4). Both runs should follow
+// exactly the same path, and should find the minimum.
+
+/** The anisotropic quadratic. The optimizer only uses its value. */
+class QuadraticCostFunction : public itk::SingleValuedCostFunction
+{
+public:
+
+  typedef QuadraticCostFunction         Self;
+  typedef itk::SingleValuedCostFunction Superclass;
+  typedef itk::SmartPointer< Self >     Pointer;
+  itkNewMacro( Self );
+
+  virtual unsigned int GetNumberOfParameters( void ) const { return 4; }
+
+  virtual MeasureType GetValue( const ParametersType & parameters ) const
+  {
+    MeasureType value = 0.0;
+    for( unsigned int i = 0; i < parameters.GetSize(); ++i )
+    {
+      const double d = parameters[ i ] - static_cast< double >( i + 1 );
+      value += static_cast< double >( 1 << ( 2 * i ) ) * d * d;
+    }
+    return value;
+  }
+
+
+  virtual void GetDerivative( const ParametersType &, DerivativeType & ) const
+  {
+    itkExceptionMacro( << "The derivative is not used by the CMAEvolutionStrategyOptimizer." );
+  }
+
+
+};
+
+//-------------------------------------------------------------------------------------
+
+int
+main( void )
+{
+  /** Some basic type definitions. */
+  typedef itk::CMAEvolutionStrategyOptimizer OptimizerType;
+  typedef OptimizerType::ParametersType      ParametersType;
+  typedef OptimizerType::MeasureType         MeasureType;
+
+  QuadraticCostFunction::Pointer costFunction = QuadraticCostFunction::New();
+  ParametersType                 initialPosition( costFunction->GetNumberOfParameters() );
+  initialPosition.Fill( 0.0 );
+
+  /** Run the optimizer twice with the same seed. */
+  ParametersType positions[ 2 ];
+  MeasureType    values[ 2 ];
+  unsigned long  iterations[ 2 ];
+  for( unsigned int run = 0; run < 2; ++run )
+  {
+    itk::Statistics::MersenneTwisterRandomVariateGenerator::GetInstance()->SetSeed( 121212 );
+
+    OptimizerType::Pointer optimizer = OptimizerType::New();
+    optimizer->SetCostFunction( costFunction );
+    optimizer->SetInitialPosition( initialPosition );
+    optimizer->SetMaximumNumberOfIterations( 300 );
+    optimizer->SetPopulationSize( 12 );
+    optimizer->SetNumberOfParents( 6 );
+    optimizer->SetInitialSigma( 1.0 );
+    optimizer->SetUseCovarianceMatrixAdaptation( true );
+    optimizer->SetPositionToleranceMin( 1e-10 );
+    optimizer->SetPositionToleranceMax( 1e-6 );
+    optimizer->SetValueTolerance( 1e-14 );
+
+    try
+    {
+      optimizer->StartOptimization();
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      std::cerr << excp << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    positions[ run ]  = optimizer->GetCurrentPosition();
+    values[ run ]     = optimizer->GetCurrentValue();
+    iterations[ run ] = optimizer->GetCurrentIteration();
+    std::cerr << std::setprecision( 17 ) << "run " << run << ": " << positions[ run ]
+              << " value " << values[ run ] << " iterations " << iterations[ run ] << std::endl;
+  }
+
+  /** TEST: Both runs are identical. */
+  if( iterations[ 0 ] != iterations[ 1 ]
+    || values[ 0 ] != values[ 1 ]
+    || positions[ 0 ] != positions[ 1 ] )
+  {
+    std::cerr << "ERROR: two runs with the same seed differ." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** TEST: The minimum is found. */
+  for( unsigned int i = 0; i < positions[ 0 ].GetSize(); ++i )
+  {
+    if( vcl_abs( positions[ 0 ][ i ] - static_cast< double >( i + 1 ) ) > 1e-3 )
+    {
+      std::cerr << "ERROR: the optimizer did not converge to the minimum." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  /** Return a value. */
+  return EXIT_SUCCESS;
+
+} // end main
@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkComputeJacobianTerms.h"
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkImage.h"
+
+#include <iostream>
+
+//-------------------------------------------------------------------------------------
+// This test checks that the multi-threaded ComputeJacobianTerms gives the same
+// TrC, TrCC, maxJJ and maxJCJ as the single-threaded computation, for a 3D
+// B-spline transform, with and without scales.
+
+int
+main( void )
+{
+  /** Some basic type definitions. */
+  const unsigned int Dimension   = 3;
+  const unsigned int SplineOrder = 3;
+  const double       tolerance   = 1e-10; // the allowable relative difference
+
+  typedef itk::Image< float, Dimension >                      ImageType;
+  typedef itk::AdvancedTransform< double, Dimension, Dimension > TransformType;
+  typedef itk::AdvancedBSplineDeformableTransform<
+    double, Dimension, SplineOrder >                          BSplineTransformType;
+  typedef itk::ComputeJacobianTerms< ImageType, TransformType > ComputeJacobianTermsType;
+  typedef BSplineTransformType::ParametersType                ParametersType;
+  typedef ComputeJacobianTermsType::ScalesType                ScalesType;
+
+  /** Create a fixed image. Only its geometry is used. */
+  ImageType::SizeType imageSize;
+  imageSize.Fill( 30 );
+  ImageType::IndexType imageIndex;
+  imageIndex.Fill( 0 );
+  ImageType::RegionType imageRegion( imageIndex, imageSize );
+  ImageType::Pointer    image = ImageType::New();
+  image->SetRegions( imageRegion );
+  image->Allocate();
+  image->FillBuffer( 1.0f );
+
+  /** Create a B-spline transform that covers the image. */
+  BSplineTransformType::RegionType::SizeType gridSize;
+  gridSize.Fill( 8 );
+  BSplineTransformType::RegionType::IndexType gridIndex;
+  gridIndex.Fill( 0 );
+  BSplineTransformType::RegionType gridRegion( gridIndex, gridSize );
+  BSplineTransformType::SpacingType gridSpacing;
+  gridSpacing.Fill( 6.0 );
+  BSplineTransformType::OriginType gridOrigin;
+  gridOrigin.Fill( -6.0 );
+  BSplineTransformType::DirectionType gridDirection;
+  gridDirection.SetIdentity();
+
+  BSplineTransformType::Pointer transform = BSplineTransformType::New();
+  transform->SetGridOrigin( gridOrigin );
+  transform->SetGridSpacing( gridSpacing );
+  transform->SetGridRegion( gridRegion );
+  transform->SetGridDirection( gridDirection );
+  ParametersType parameters( transform->GetNumberOfParameters() );
+  for( unsigned int i = 0; i < parameters.GetSize(); ++i )
+  {
+    parameters[ i ] = vcl_sin( 0.7 * i );
+  }
+  transform->SetParameters( parameters );
+
+  ScalesType scales( transform->GetNumberOfParameters() );
+  for( unsigned int i = 0; i < scales.GetSize(); ++i )
+  {
+    scales[ i ] = 1.0 + 0.5 * vcl_cos( 0.3 * i );
+  }
+
+  for( unsigned int useScales = 0; useScales < 2; ++useScales )
+  {
+    /** Compute the terms with one thread, and with several threads. */
+    double terms[ 2 ][ 4 ];
+    for( unsigned int run = 0; run < 2; ++run )
+    {
+      ComputeJacobianTermsType::Pointer computeJacobianTerms = ComputeJacobianTermsType::New();
+      computeJacobianTerms->SetFixedImage( image );
+      computeJacobianTerms->SetFixedImageRegion( imageRegion );
+      computeJacobianTerms->SetTransform( transform );
+      computeJacobianTerms->SetMaxBandCovSize( 192 );
+      computeJacobianTerms->SetNumberOfBandStructureSamples( 10 );
+      computeJacobianTerms->SetNumberOfJacobianMeasurements( 5000 );
+      computeJacobianTerms->SetScales( scales );
+      computeJacobianTerms->SetUseScales( useScales != 0 );
+      computeJacobianTerms->SetNumberOfThreads( run == 0 ? 1 : 4 );
+
+      try
+      {
+        computeJacobianTerms->Compute(
+          terms[ run ][ 0 ], terms[ run ][ 1 ], terms[ run ][ 2 ], terms[ run ][ 3 ] );
+      }
+      catch( itk::ExceptionObject & excp )
+      {
+        std::cerr << excp << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    /** TEST: Compare the multi-threaded with the single-threaded terms. */
+    const char * names[ 4 ] = { "TrC", "TrCC", "maxJJ", "maxJCJ" };
+    for( unsigned int k = 0; k < 4; ++k )
+    {
+      std::cerr << names[ k ] << ( useScales ? " (scaled)" : "" )
+                << ": " << terms[ 0 ][ k ] << " (1 thread), "
+                << terms[ 1 ][ k ] << " (4 threads)" << std::endl;
+      const double difference = vnl_math_abs( terms[ 1 ][ k ] - terms[ 0 ][ k ] );
+      if( terms[ 0 ][ k ] <= 0.0 || difference > tolerance * vnl_math_abs( terms[ 0 ][ k ] ) )
+      {
+        std::cerr << "ERROR: the multi-threaded " << names[ k ]
+                  << " differs from the single-threaded one." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  /** Return a value. */
+  return EXIT_SUCCESS;
+
+} // end main
@@ -0,0 +1,132 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "FullSearch/itkFullSearchOptimizer.h"
+#include "itkSingleValuedCostFunction.h"
+
+#include <iostream>
+#include <algorithm>
+
+//-------------------------------------------------------------------------------------
+// This test compares the hierarchical search of the FullSearchOptimizer with a scan
+// of the full grid. The cost function has a global minimum and a shallower local
+// minimum in the first two parameters, so the refinement has to select the right
+// coarse cell. The hierarchical search should find the same grid point, with fewer
+// evaluations.
+
+/** Two quadratic basins in the first two parameters; the third is ignored. */
+class TwoBasinCostFunction : public itk::SingleValuedCostFunction
+{
+public:
+
+  typedef TwoBasinCostFunction          Self;
+  typedef itk::SingleValuedCostFunction Superclass;
+  typedef itk::SmartPointer< Self >     Pointer;
+  itkNewMacro( Self );
+
+  virtual unsigned int GetNumberOfParameters( void ) const { return 3; }
+
+  virtual MeasureType GetValue( const ParametersType & p ) const
+  {
+    const double global = ( p[ 0 ] - 1.3 ) * ( p[ 0 ] - 1.3 )
+      + 2.0 * ( p[ 1 ] + 0.7 ) * ( p[ 1 ] + 0.7 );
+    const double local = 0.5 + ( p[ 0 ] + 2.1 ) * ( p[ 0 ] + 2.1 )
+      + ( p[ 1 ] - 2.4 ) * ( p[ 1 ] - 2.4 );
+    return std::min( global, local );
+  }
+
+
+  virtual void GetDerivative( const ParametersType &, DerivativeType & ) const
+  {
+    itkExceptionMacro( << "The derivative is not used by the FullSearchOptimizer." );
+  }
+
+
+};
+
+//-------------------------------------------------------------------------------------
+
+int
+main( void )
+{
+  /** Some basic type definitions. */
+  typedef itk::FullSearchOptimizer      OptimizerType;
+  typedef OptimizerType::ParametersType ParametersType;
+
+  TwoBasinCostFunction::Pointer costFunction = TwoBasinCostFunction::New();
+  ParametersType                initialPosition( costFunction->GetNumberOfParameters() );
+  initialPosition.Fill( 0.5 );
+
+  /** Search the full grid, and hierarchically with a coarse grid factor of 4. */
+  OptimizerType::Pointer full    = OptimizerType::New();
+  OptimizerType::Pointer refined = OptimizerType::New();
+  for( unsigned int run = 0; run < 2; ++run )
+  {
+    OptimizerType * optimizer = run == 0 ? full.GetPointer() : refined.GetPointer();
+    optimizer->SetCostFunction( costFunction );
+    optimizer->SetInitialPosition( initialPosition );
+    optimizer->SetMinimize( true );
+    optimizer->AddSearchDimension( 0, -4.0, 4.0, 0.1 );
+    optimizer->AddSearchDimension( 1, -3.0, 3.0, 0.1 );
+    optimizer->SetCoarseGridFactor( run == 0 ? 1 : 4 );
+    optimizer->SetNumberOfRefinedCells( 4 );
+
+    try
+    {
+      optimizer->StartOptimization();
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      std::cerr << excp << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cerr << ( run == 0 ? "full grid:    " : "hierarchical: " )
+              << "best point " << optimizer->GetBestPointInSearchSpace()
+              << " value " << optimizer->GetBestValue()
+              << " evaluations " << optimizer->GetNumberOfEvaluations() << std::endl;
+  }
+
+  /** TEST: The full scan evaluates every grid point. */
+  if( full->GetNumberOfEvaluations() != full->GetNumberOfIterations()
+    || full->GetNumberOfSavedEvaluations() != 0 )
+  {
+    std::cerr << "ERROR: the full search did not evaluate every grid point." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** TEST: The hierarchical search finds the same optimum. */
+  if( refined->GetBestIndexInSearchSpace() != full->GetBestIndexInSearchSpace()
+    || refined->GetBestValue() != full->GetBestValue() )
+  {
+    std::cerr << "ERROR: the hierarchical search found another optimum." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** TEST: The hierarchical search saves evaluations. */
+  if( refined->GetNumberOfSavedEvaluations() == 0
+    || refined->GetNumberOfEvaluations() + refined->GetNumberOfSavedEvaluations()
+    != refined->GetNumberOfIterations() )
+  {
+    std::cerr << "ERROR: the hierarchical search did not save evaluations." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Return a value. */
+  return EXIT_SUCCESS;
+
+} // end main
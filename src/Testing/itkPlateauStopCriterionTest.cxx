@@ -0,0 +1,153 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "StandardGradientDescent/itkGradientDescentOptimizer2.h"
+#include "itkSingleValuedCostFunction.h"
+
+#include <iostream>
+
+//-------------------------------------------------------------------------------------
+// This test checks the plateau stop criterion of the GradientDescentOptimizer2.
+// A quadratic is minimized in a single step, after which the value stays zero, so
+// the optimizer should stop on the plateau. Its plateau history should survive a
+// round trip, as done for a checkpoint. A linear function keeps decreasing at a
+// constant rate, so the optimizer should run all iterations.
+
+/** f(x) = sum_i (x_i - 1)^2, or f(x) = -sum_i x_i when m_Linear is set. */
+class PlateauCostFunction : public itk::SingleValuedCostFunction
+{
+public:
+
+  typedef PlateauCostFunction           Self;
+  typedef itk::SingleValuedCostFunction Superclass;
+  typedef itk::SmartPointer< Self >     Pointer;
+  itkNewMacro( Self );
+
+  PlateauCostFunction() : m_Linear( false ) {}
+
+  virtual unsigned int GetNumberOfParameters( void ) const { return 2; }
+
+  virtual MeasureType GetValue( const ParametersType & parameters ) const
+  {
+    MeasureType value = 0.0;
+    for( unsigned int i = 0; i < parameters.GetSize(); ++i )
+    {
+      value += this->m_Linear
+        ? -parameters[ i ] : ( parameters[ i ] - 1.0 ) * ( parameters[ i ] - 1.0 );
+    }
+    return value;
+  }
+
+
+  virtual void GetDerivative( const ParametersType & parameters,
+    DerivativeType & derivative ) const
+  {
+    derivative.SetSize( parameters.GetSize() );
+    for( unsigned int i = 0; i < parameters.GetSize(); ++i )
+    {
+      derivative[ i ] = this->m_Linear ? -1.0 : 2.0 * ( parameters[ i ] - 1.0 );
+    }
+  }
+
+
+  bool m_Linear;
+};
+
+//-------------------------------------------------------------------------------------
+
+int
+main( void )
+{
+  /** Some basic type definitions. */
+  typedef itk::GradientDescentOptimizer2 OptimizerType;
+  typedef OptimizerType::ParametersType  ParametersType;
+  typedef itk::Array< double >           HistoryType;
+
+  PlateauCostFunction::Pointer costFunction = PlateauCostFunction::New();
+  ParametersType               initialPosition( costFunction->GetNumberOfParameters() );
+  initialPosition.Fill( 5.0 );
+
+  /** Minimize the quadratic, and then the linear function. */
+  OptimizerType::Pointer optimizers[ 2 ];
+  for( unsigned int linear = 0; linear < 2; ++linear )
+  {
+    costFunction->m_Linear = linear != 0;
+
+    OptimizerType::Pointer optimizer = OptimizerType::New();
+    optimizer->SetCostFunction( costFunction );
+    optimizer->SetInitialPosition( initialPosition );
+    optimizer->SetLearningRate( 0.5 ); // reaches the minimum of the quadratic in one step
+    optimizer->SetNumberOfIterations( 1000 );
+    optimizer->SetUsePlateauStopCriterion( true );
+    optimizer->SetPlateauWindowSize( 10 );
+    optimizer->SetPlateauCheckInterval( 5 );
+    optimizer->SetPlateauTestThreshold( 2.0 );
+
+    try
+    {
+      optimizer->StartOptimization();
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      std::cerr << excp << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cerr << ( linear ? "linear: " : "quadratic: " )
+              << "stopped after " << optimizer->GetCurrentIteration()
+              << " iterations, condition " << optimizer->GetStopCondition() << std::endl;
+    optimizers[ linear ] = optimizer;
+  }
+
+  /** TEST: The quadratic stops on the plateau, soon after the window is full. */
+  if( optimizers[ 0 ]->GetStopCondition() != OptimizerType::MetricPlateau
+    || optimizers[ 0 ]->GetCurrentIteration() > 20 )
+  {
+    std::cerr << "ERROR: the plateau was not detected." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** TEST: The plateau history can be restored, e.g. from a checkpoint. */
+  HistoryType values, gradients;
+  optimizers[ 0 ]->GetPlateauHistory( values, gradients );
+  if( values.GetSize() != 10 || gradients.GetSize() != 10 )
+  {
+    std::cerr << "ERROR: the plateau history has the wrong length." << std::endl;
+    return EXIT_FAILURE;
+  }
+  OptimizerType::Pointer restored = OptimizerType::New();
+  restored->SetPlateauWindowSize( 10 );
+  restored->SetPlateauHistory( values, gradients );
+  HistoryType restoredValues, restoredGradients;
+  restored->GetPlateauHistory( restoredValues, restoredGradients );
+  if( restoredValues != values || restoredGradients != gradients )
+  {
+    std::cerr << "ERROR: the plateau history was not restored." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** TEST: The linear function keeps improving, so all iterations are run. */
+  if( optimizers[ 1 ]->GetStopCondition() != OptimizerType::MaximumNumberOfIterations )
+  {
+    std::cerr << "ERROR: a plateau was detected while the value still decreases." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Return a value. */
+  return EXIT_SUCCESS;
+
+} // end main
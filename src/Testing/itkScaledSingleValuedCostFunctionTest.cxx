@@ -0,0 +1,212 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkScaledSingleValuedCostFunction.h"
+#include "QuasiNewtonLBFGS/itkQuasiNewtonLBFGSOptimizer.h"
+#include "itkMoreThuenteLineSearchOptimizer.h"
+
+#include <iostream>
+#include <vector>
+
+//-------------------------------------------------------------------------------------
+// This test counts the evaluations of a cost function behind the evaluation cache of
+// the ScaledSingleValuedCostFunction. With the cache, a repeated evaluation at the
+// same parameters should not call the cost function, until the entry is dropped or
+// the cache is invalidated. Without the cache every evaluation should call it. The
+// QuasiNewtonLBFGSOptimizer should find the same minimum with and without the cache,
+// and the cache should account for every evaluation that it saved.
+
+/** f(x) = sum_i (i+1) (x_i - 1)^4 + (x_i - 1)^2, which counts its evaluations. */
+class CountingCostFunction : public itk::SingleValuedCostFunction
+{
+public:
+
+  typedef CountingCostFunction          Self;
+  typedef itk::SingleValuedCostFunction Superclass;
+  typedef itk::SmartPointer< Self >     Pointer;
+  itkNewMacro( Self );
+
+  CountingCostFunction() : m_NumberOfCalls( 0 ) {}
+
+  virtual unsigned int GetNumberOfParameters( void ) const { return 4; }
+
+  virtual MeasureType GetValue( const ParametersType & parameters ) const
+  {
+    MeasureType    value;
+    DerivativeType derivative;
+    this->GetValueAndDerivative( parameters, value, derivative );
+    return value;
+  }
+
+
+  virtual void GetDerivative( const ParametersType & parameters,
+    DerivativeType & derivative ) const
+  {
+    MeasureType value;
+    this->GetValueAndDerivative( parameters, value, derivative );
+  }
+
+
+  virtual void GetValueAndDerivative( const ParametersType & parameters,
+    MeasureType & value, DerivativeType & derivative ) const
+  {
+    ++this->m_NumberOfCalls;
+    value = 0.0;
+    derivative.SetSize( parameters.GetSize() );
+    for( unsigned int i = 0; i < parameters.GetSize(); ++i )
+    {
+      const double d = parameters[ i ] - 1.0;
+      value         += ( i + 1.0 ) * d * d * d * d + d * d;
+      derivative[ i ] = 4.0 * ( i + 1.0 ) * d * d * d + 2.0 * d;
+    }
+  }
+
+
+  mutable unsigned long m_NumberOfCalls;
+};
+
+//-------------------------------------------------------------------------------------
+
+int
+main( void )
+{
+  /** Some basic type definitions. */
+  typedef itk::ScaledSingleValuedCostFunction  ScaledCostFunctionType;
+  typedef ScaledCostFunctionType::ParametersType ParametersType;
+  typedef ScaledCostFunctionType::DerivativeType DerivativeType;
+  typedef ScaledCostFunctionType::MeasureType    MeasureType;
+  typedef itk::QuasiNewtonLBFGSOptimizer       OptimizerType;
+  typedef itk::MoreThuenteLineSearchOptimizer  LineSearchOptimizerType;
+
+  CountingCostFunction::Pointer   costFunction       = CountingCostFunction::New();
+  ScaledCostFunctionType::Pointer scaledCostFunction = ScaledCostFunctionType::New();
+  scaledCostFunction->SetUnscaledCostFunction( costFunction );
+
+  /** Five positions, one more than the default cache size. */
+  std::vector< ParametersType > positions( 5, ParametersType( costFunction->GetNumberOfParameters() ) );
+  for( unsigned int p = 0; p < positions.size(); ++p )
+  {
+    positions[ p ].Fill( 0.5 * p );
+  }
+  MeasureType    value;
+  DerivativeType derivative;
+
+  /** TEST: The cache is disabled by default, so every evaluation is computed. */
+  scaledCostFunction->GetValueAndDerivative( positions[ 0 ], value, derivative );
+  scaledCostFunction->GetValueAndDerivative( positions[ 0 ], value, derivative );
+  scaledCostFunction->GetValue( positions[ 0 ] );
+  if( scaledCostFunction->GetUseEvaluationCache() || costFunction->m_NumberOfCalls != 3 )
+  {
+    std::cerr << "ERROR: without the cache, 3 evaluations gave "
+              << costFunction->m_NumberOfCalls << " calls." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** TEST: With the cache, the value and derivative at the same position are reused. */
+  scaledCostFunction->SetUseEvaluationCache( true );
+  costFunction->m_NumberOfCalls = 0;
+  scaledCostFunction->GetValueAndDerivative( positions[ 0 ], value, derivative );
+  scaledCostFunction->GetValueAndDerivative( positions[ 0 ], value, derivative );
+  scaledCostFunction->GetValue( positions[ 0 ] );
+  scaledCostFunction->GetDerivative( positions[ 0 ], derivative );
+  if( costFunction->m_NumberOfCalls != 1
+    || scaledCostFunction->GetNumberOfEvaluations() != 1
+    || scaledCostFunction->GetNumberOfSavedEvaluations() != 3 )
+  {
+    std::cerr << "ERROR: with the cache, 4 evaluations at one position gave "
+              << costFunction->m_NumberOfCalls << " calls." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** TEST: The oldest position is dropped when the cache is full. */
+  for( unsigned int p = 1; p < positions.size(); ++p )
+  {
+    scaledCostFunction->GetValueAndDerivative( positions[ p ], value, derivative );
+  }
+  scaledCostFunction->GetValueAndDerivative( positions[ 4 ], value, derivative );
+  scaledCostFunction->GetValueAndDerivative( positions[ 0 ], value, derivative );
+  if( costFunction->m_NumberOfCalls != 6 )
+  {
+    std::cerr << "ERROR: the full cache gave " << costFunction->m_NumberOfCalls
+              << " instead of 6 calls." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** TEST: An invalidated cache is not used. */
+  scaledCostFunction->InvalidateEvaluationCache();
+  scaledCostFunction->GetValueAndDerivative( positions[ 0 ], value, derivative );
+  if( costFunction->m_NumberOfCalls != 7 )
+  {
+    std::cerr << "ERROR: the invalidated cache was used." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Minimize without and with the cache. */
+  ParametersType initialPosition( costFunction->GetNumberOfParameters() );
+  initialPosition.Fill( 3.0 );
+  ParametersType finalPositions[ 2 ];
+  unsigned long  numberOfCalls[ 2 ];
+  for( unsigned int useCache = 0; useCache < 2; ++useCache )
+  {
+    LineSearchOptimizerType::Pointer lineSearchOptimizer = LineSearchOptimizerType::New();
+    OptimizerType::Pointer           optimizer           = OptimizerType::New();
+    optimizer->SetCostFunction( costFunction );
+    optimizer->SetLineSearchOptimizer( lineSearchOptimizer );
+    optimizer->SetInitialPosition( initialPosition );
+    optimizer->SetMaximumNumberOfIterations( 100 );
+    optimizer->SetGradientMagnitudeTolerance( 1e-8 );
+    optimizer->SetMemory( 3 );
+    optimizer->SetUseEvaluationCache( useCache != 0 );
+
+    costFunction->m_NumberOfCalls = 0;
+    try
+    {
+      optimizer->StartOptimization();
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      std::cerr << excp << std::endl;
+      return EXIT_FAILURE;
+    }
+    finalPositions[ useCache ] = optimizer->GetCurrentPosition();
+    numberOfCalls[ useCache ]  = costFunction->m_NumberOfCalls;
+
+    const ScaledCostFunctionType * cache = optimizer->GetScaledCostFunction();
+    std::cerr << ( useCache ? "with cache: " : "without cache: " )
+              << finalPositions[ useCache ] << ", " << numberOfCalls[ useCache ] << " calls, "
+              << cache->GetNumberOfSavedEvaluations() << " saved" << std::endl;
+
+    /** TEST: Every evaluation either called the cost function or was saved. */
+    if( useCache && ( cache->GetNumberOfEvaluations() != numberOfCalls[ 1 ]
+      || numberOfCalls[ 1 ] + cache->GetNumberOfSavedEvaluations() != numberOfCalls[ 0 ] ) )
+    {
+      std::cerr << "ERROR: the cache does not account for all evaluations." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  /** TEST: The cache does not change the result. */
+  if( finalPositions[ 1 ] != finalPositions[ 0 ] )
+  {
+    std::cerr << "ERROR: the cache changed the result of the optimization." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Return a value. */
+  return EXIT_SUCCESS;
+
+} // end main
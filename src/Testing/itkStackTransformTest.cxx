@@ -0,0 +1,175 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkStackTransform.h"
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkCyclicBSplineDeformableTransform.h"
+
+#include <iostream>
+#include <vector>
+
+//-------------------------------------------------------------------------------------
+// This test checks that StackTransform::TransformPointInAllSubTransforms() maps a point
+// to the same points as TransformPoint() of each sub transform, and as TransformPoint()
+// of the stack transform itself. This is checked for B-spline sub transforms, which
+// share the interpolation weights, including a point outside the B-spline support
+// region, and for cyclic B-spline sub transforms, which can not share the weights.
+
+int
+main( void )
+{
+  /** Some basic type definitions. */
+  const unsigned int Dimension    = 3;
+  const unsigned int SubDimension = Dimension - 1;
+  const unsigned int SplineOrder  = 3;
+  const unsigned int NumberOfSubTransforms = 5;
+  const double       tolerance    = 1e-10; // the allowable distance
+
+  typedef itk::StackTransform< double, Dimension, Dimension > StackTransformType;
+  typedef itk::AdvancedBSplineDeformableTransform<
+    double, SubDimension, SplineOrder >                       BSplineTransformType;
+  typedef itk::CyclicBSplineDeformableTransform<
+    double, SubDimension, SplineOrder >                       CyclicTransformType;
+  typedef StackTransformType::SubTransformType                SubTransformType;
+  typedef StackTransformType::SubTransformInputPointType      SubInputPointType;
+  typedef StackTransformType::SubTransformOutputPointType     SubOutputPointType;
+  typedef StackTransformType::InputPointType                  InputPointType;
+  typedef StackTransformType::OutputPointType                 OutputPointType;
+  typedef StackTransformType::ParametersType                  ParametersType;
+  typedef BSplineTransformType::RegionType                    RegionType;
+
+  /** The B-spline grid of the sub transforms, with control points
+   * from -10 to 60 in both dimensions.
+   */
+  RegionType::SizeType gridSize;
+  gridSize.Fill( 8 );
+  RegionType::IndexType gridIndex;
+  gridIndex.Fill( 0 );
+  RegionType gridRegion( gridIndex, gridSize );
+  BSplineTransformType::SpacingType gridSpacing;
+  gridSpacing.Fill( 10.0 );
+  BSplineTransformType::OriginType gridOrigin;
+  gridOrigin.Fill( -10.0 );
+  BSplineTransformType::DirectionType gridDirection;
+  gridDirection.SetIdentity();
+
+  /** Some spatial points, of which the last one lies outside the
+   * B-spline support region.
+   */
+  std::vector< SubInputPointType > points( 3 );
+  points[ 0 ][ 0 ] = 12.3;   points[ 0 ][ 1 ] = 27.9;
+  points[ 1 ][ 0 ] = 3.1;    points[ 1 ][ 1 ] = 44.2;
+  points[ 2 ][ 0 ] = 200.0;  points[ 2 ][ 1 ] = -100.0;
+
+  for( unsigned int cyclic = 0; cyclic < 2; ++cyclic )
+  {
+    const char * name = cyclic ? "cyclic B-spline" : "B-spline";
+
+    /** Create the sub transform and the stack transform. */
+    BSplineTransformType::Pointer subTransform;
+    if( cyclic ) { subTransform = CyclicTransformType::New(); }
+    else { subTransform = BSplineTransformType::New(); }
+    subTransform->SetGridOrigin( gridOrigin );
+    subTransform->SetGridSpacing( gridSpacing );
+    subTransform->SetGridRegion( gridRegion );
+    subTransform->SetGridDirection( gridDirection );
+    ParametersType subParameters( subTransform->GetNumberOfParameters() );
+    subParameters.Fill( 0.0 );
+    subTransform->SetParameters( subParameters );
+
+    StackTransformType::Pointer stack = StackTransformType::New();
+    stack->SetNumberOfSubTransforms( NumberOfSubTransforms );
+    stack->SetStackOrigin( -1.0 );
+    stack->SetStackSpacing( 2.0 );
+    stack->SetAllSubTransforms( subTransform );
+
+    /** Give each sub transform other coefficients. */
+    ParametersType parameters( stack->GetNumberOfParameters() );
+    for( unsigned int i = 0; i < parameters.GetSize(); ++i )
+    {
+      parameters[ i ] = 3.0 * vcl_sin( 0.37 * i ) + vcl_cos( 1.3 * i );
+    }
+    stack->SetParameters( parameters );
+
+    for( unsigned int p = 0; p < points.size(); ++p )
+    {
+      std::vector< SubOutputPointType > opprs;
+      try
+      {
+        stack->TransformPointInAllSubTransforms( points[ p ], opprs );
+      }
+      catch( itk::ExceptionObject & excp )
+      {
+        std::cerr << excp << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      if( opprs.size() != NumberOfSubTransforms )
+      {
+        std::cerr << "ERROR: " << opprs.size() << " points were returned for "
+                  << NumberOfSubTransforms << " " << name << " sub transforms." << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      for( unsigned int t = 0; t < NumberOfSubTransforms; ++t )
+      {
+        /** TEST: Compare with TransformPoint() of the sub transform. */
+        const SubTransformType * sub = stack->GetSubTransform( t ).GetPointer();
+        const SubOutputPointType expected = sub->TransformPoint( points[ p ] );
+        if( expected.EuclideanDistanceTo( opprs[ t ] ) > tolerance )
+        {
+          std::cerr << "ERROR: " << name << " sub transform " << t << " maps point "
+                    << points[ p ] << " to " << expected << ", but "
+                    << "TransformPointInAllSubTransforms() gives " << opprs[ t ] << std::endl;
+          return EXIT_FAILURE;
+        }
+
+        /** TEST: Compare with TransformPoint() of the stack transform,
+         * as done by AdvancedImageToImageMetric::TransformPointsOverLastDimension().
+         */
+        InputPointType ipp;
+        ipp[ 0 ] = points[ p ][ 0 ];
+        ipp[ 1 ] = points[ p ][ 1 ];
+        ipp[ 2 ] = stack->GetStackOrigin() + t * stack->GetStackSpacing();
+        const OutputPointType opp = stack->TransformPoint( ipp );
+        if( stack->GetSubTransformIndex( ipp ) != t
+          || vnl_math_abs( opp[ 0 ] - opprs[ t ][ 0 ] ) > tolerance
+          || vnl_math_abs( opp[ 1 ] - opprs[ t ][ 1 ] ) > tolerance
+          || opp[ 2 ] != ipp[ 2 ] )
+        {
+          std::cerr << "ERROR: the " << name << " stack transform maps point "
+                    << ipp << " to " << opp << ", but "
+                    << "TransformPointInAllSubTransforms() gives " << opprs[ t ] << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      /** TEST: The point outside the support region is not displaced. */
+      if( p == 2 && !cyclic
+        && opprs[ 0 ].EuclideanDistanceTo( points[ p ] ) > tolerance )
+      {
+        std::cerr << "ERROR: point " << points[ p ] << " outside the support region "
+                  << "is mapped to " << opprs[ 0 ] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  /** Return a value. */
+  return EXIT_SUCCESS;
+
+} // end main
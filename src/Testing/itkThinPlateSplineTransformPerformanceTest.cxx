@@ -22,6 +22,7 @@
 #include "itkTimeProbe.h"
 #include "itkTimeProbesCollectorBase.h"
 
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 
@@ -85,6 +86,26 @@ public:
   }
 
 
+  /** Set random deformation coefficients without an affine part. Used to
+   * test the evaluation for landmark sets that are too large to solve.
+   */
+  void SetRandomDeformationCoefficientsPublic( const TScalarType & range )
+  {
+    const unsigned long numberOfLandmarks = this->m_SourceLandmarks->GetNumberOfPoints();
+    this->m_DMatrix.set_size( NDimensions, numberOfLandmarks );
+    for( unsigned long lnd = 0; lnd < numberOfLandmarks; ++lnd )
+    {
+      for( unsigned int dim = 0; dim < NDimensions; ++dim )
+      {
+        this->m_DMatrix( dim, lnd ) = vnl_sample_uniform( -range, range );
+      }
+    }
+    this->m_AMatrix.fill( 0.0 );
+    this->m_BVector.fill( 0.0 );
+    this->m_WMatrixComputed = true;
+  }
+
+
 };
 
 // end helper class
@@ -104,13 +125,27 @@ main( int argc, char * argv[] )
   const unsigned long maxTestedLandmarksForSVD = 401;
   const ScalarType    tolerance                = 1e-8; // for double
 
+  /** Parameters of the test with large landmark sets. */
+  const unsigned long maxComparedLandmarks = 1000;  // compare with coupled solve
+  const unsigned long maxSolvedLandmarks   = 10000; // dense decoupled solve
+  const unsigned long numberOfTestPoints   = 1000;
+  const double        farFieldThreshold    = 0.2;
+  const double        farFieldTolerance    = 1e-3;  // for the interpolating spline
+  unsigned long       maxLargeLandmarks    = 1000;
+
   /** Check. */
-  if( argc != 3 )
+  if( argc < 3 || argc > 4 )
   {
     std::cerr << "ERROR: You should specify a text file with the thin plate spline "
-              << "source (fixed image) landmarks." << std::endl;
+              << "source (fixed image) landmarks, an output directory, and "
+              << "optionally the maximum number of landmarks (1000, 10000 or 100000) "
+              << "for the large landmark set test." << std::endl;
     return 1;
   }
+  if( argc == 4 )
+  {
+    maxLargeLandmarks = std::atol( argv[ 3 ] );
+  }
 
   /** Other typedefs. */
   typedef itk::KernelTransformPublic<
@@ -369,6 +404,170 @@ main( int argc, char * argv[] )
 
   } // end loop
 
+  /** Test the decoupled solve and the far-field approximation for large
+   * landmark sets. The landmarks from the file are supplemented with random
+   * points in their bounding box. The target landmarks are obtained by a
+   * smooth displacement. Up to maxSolvedLandmarks the landmark system is
+   * solved; for larger sets, random deformation coefficients are used, which
+   * only tests the evaluation of the transform.
+   */
+  std::vector< unsigned long > largeNumberOfLandmarks;
+  for( unsigned long n = 1000; n <= maxLargeLandmarks && n <= 100000; n *= 10 )
+  {
+    largeNumberOfLandmarks.push_back( n );
+  }
+
+  PointType lower = ( *sourceLandmarks->GetPoints() )[ 0 ];
+  PointType upper = lower;
+  for( unsigned long j = 1; j < sourceLandmarks->GetNumberOfPoints(); j++ )
+  {
+    const PointType & tmp = ( *sourceLandmarks->GetPoints() )[ j ];
+    for( unsigned int dim = 0; dim < Dimension; dim++ )
+    {
+      lower[ dim ] = std::min( lower[ dim ], tmp[ dim ] );
+      upper[ dim ] = std::max( upper[ dim ], tmp[ dim ] );
+    }
+  }
+
+  vnl_sample_reseed( 1031 );
+  std::vector< PointType > testPoints( numberOfTestPoints );
+  for( unsigned long j = 0; j < numberOfTestPoints; j++ )
+  {
+    for( unsigned int dim = 0; dim < Dimension; dim++ )
+    {
+      testPoints[ j ][ dim ] = vnl_sample_uniform( lower[ dim ], upper[ dim ] );
+    }
+  }
+
+  for( std::size_t i = 0; i < largeNumberOfLandmarks.size(); i++ )
+  {
+    itk::TimeProbesCollectorBase timeCollector;
+
+    const unsigned long numberOfLandmarks = largeNumberOfLandmarks[ i ];
+    std::cerr << "----------------------------------------\n";
+    std::cerr << "Large landmark set, number of landmarks: "
+              << numberOfLandmarks << std::endl;
+
+    /** Create source and target landmarks. */
+    PointsContainerPointer sourcePoints = PointsContainerType::New();
+    PointsContainerPointer targetPoints = PointsContainerType::New();
+    for( unsigned long j = 0; j < numberOfLandmarks; j++ )
+    {
+      PointType source;
+      if( j < sourceLandmarks->GetNumberOfPoints() )
+      {
+        source = ( *sourceLandmarks->GetPoints() )[ j ];
+      }
+      else
+      {
+        for( unsigned int dim = 0; dim < Dimension; dim++ )
+        {
+          source[ dim ] = vnl_sample_uniform( lower[ dim ], upper[ dim ] );
+        }
+      }
+      PointType target = source;
+      for( unsigned int dim = 0; dim < Dimension; dim++ )
+      {
+        target[ dim ] += 2.0 * vcl_sin( source[ ( dim + 1 ) % Dimension ] / 20.0 );
+      }
+      sourcePoints->push_back( source );
+      targetPoints->push_back( target );
+    }
+    PointSetType::Pointer sourceSet = PointSetType::New();
+    PointSetType::Pointer targetSet = PointSetType::New();
+    sourceSet->SetPoints( sourcePoints );
+    targetSet->SetPoints( targetPoints );
+
+    /** Setup with the decoupled solve. */
+    TransformType::Pointer fastTransform = TransformType::New();
+    fastTransform->SetStiffness( 0.0 );
+    fastTransform->SetMatrixInversionMethod( "QR" );
+    fastTransform->SetDecoupledSolve( true );
+    fastTransform->SetPrecomputeLInverse( false );
+    const bool solved = numberOfLandmarks <= maxSolvedLandmarks;
+    if( solved )
+    {
+      timeCollector.Start( "SetupDecoupled" );
+      fastTransform->SetSourceLandmarks( sourceSet );
+      fastTransform->SetTargetLandmarks( targetSet );
+      timeCollector.Stop( "SetupDecoupled" );
+    }
+    else
+    {
+      std::cerr << "Solving the landmark system: too large, "
+                << "using random deformation coefficients" << std::endl;
+      fastTransform->SetSourceLandmarks( sourceSet );
+      fastTransform->SetRandomDeformationCoefficientsPublic( 1e-3 );
+    }
+
+    /** Exact evaluation. */
+    std::vector< PointType > exactPoints( numberOfTestPoints );
+    timeCollector.Start( "TransformPointExact" );
+    for( unsigned long j = 0; j < numberOfTestPoints; j++ )
+    {
+      exactPoints[ j ] = fastTransform->TransformPoint( testPoints[ j ] );
+    }
+    timeCollector.Stop( "TransformPointExact" );
+
+    /** Compare with the coupled solve. */
+    if( numberOfLandmarks <= maxComparedLandmarks )
+    {
+      TransformType::Pointer fullTransform = TransformType::New();
+      fullTransform->SetStiffness( 0.0 );
+      fullTransform->SetMatrixInversionMethod( "QR" );
+      fullTransform->SetPrecomputeLInverse( false );
+      timeCollector.Start( "SetupCoupled" );
+      fullTransform->SetSourceLandmarks( sourceSet );
+      fullTransform->SetTargetLandmarks( targetSet );
+      timeCollector.Stop( "SetupCoupled" );
+
+      double maxDiff = 0.0;
+      for( unsigned long j = 0; j < numberOfTestPoints; j++ )
+      {
+        const PointType full = fullTransform->TransformPoint( testPoints[ j ] );
+        maxDiff = std::max( maxDiff, full.EuclideanDistanceTo( exactPoints[ j ] ) );
+      }
+      std::cerr << "Maximum difference of decoupled and coupled solve: "
+                << maxDiff << std::endl;
+      if( maxDiff > 1e-4 )
+      {
+        std::cerr << "ERROR: decoupled solve differs from coupled solve: "
+                  << maxDiff << std::endl;
+        return 1;
+      }
+    }
+
+    /** Far-field approximation. */
+    timeCollector.Start( "BuildFarFieldTree" );
+    fastTransform->SetFarFieldThreshold( farFieldThreshold );
+    timeCollector.Stop( "BuildFarFieldTree" );
+
+    double maxError = 0.0, maxDisplacement = 0.0;
+    timeCollector.Start( "TransformPointFarField" );
+    for( unsigned long j = 0; j < numberOfTestPoints; j++ )
+    {
+      const PointType approx = fastTransform->TransformPoint( testPoints[ j ] );
+      maxError        = std::max( maxError, approx.EuclideanDistanceTo( exactPoints[ j ] ) );
+      maxDisplacement = std::max( maxDisplacement,
+        testPoints[ j ].EuclideanDistanceTo( exactPoints[ j ] ) );
+    }
+    timeCollector.Stop( "TransformPointFarField" );
+
+    std::cerr << "Far-field threshold: " << farFieldThreshold
+              << ", maximum error: " << maxError
+              << ", maximum displacement: " << maxDisplacement << std::endl;
+    if( solved && maxError > farFieldTolerance * ( upper - lower ).GetNorm() )
+    {
+      std::cerr << "ERROR: far-field approximation error too big: "
+                << maxError << std::endl;
+      return 1;
+    }
+
+    timeCollector.Report();
+    std::cout << std::endl;
+
+  } // end loop large landmark sets
+
   /** Return a value. */
   return 0;
 
@@ -0,0 +1,149 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkUpsampleBSplineParametersFilter.h"
+#include "itkImage.h"
+#include "itkArray.h"
+
+#include <iostream>
+#include <algorithm>
+
+//-------------------------------------------------------------------------------------
+// This test compares the dyadic refinement of the UpsampleBSplineParametersFilter
+// with the generic resample and decomposition path, for a 2D third order B-spline
+// grid whose spacing is halved. The dyadic path treats the grid as zero outside,
+// while the generic path mirrors it, so only the interior coefficients are compared.
+// The dyadic path should only be used when it is switched on.
+
+int
+main( void )
+{
+  /** Some basic type definitions. */
+  const unsigned int Dimension   = 2;
+  const unsigned int SplineOrder = 3;
+  const double       tolerance   = 1e-5; // the allowable difference
+  const long         margin      = 6;    // the border width that is not compared
+
+  typedef itk::Array< double >                       ParametersType;
+  typedef itk::Image< double, Dimension >            ImageType;
+  typedef itk::UpsampleBSplineParametersFilter<
+    ParametersType, ImageType >                      FilterType;
+  typedef ImageType::RegionType                      RegionType;
+
+  /** The current grid, and the required grid with half the spacing and
+   * coinciding control points.
+   */
+  RegionType::SizeType currentSize, requiredSize;
+  currentSize.Fill( 24 );
+  requiredSize.Fill( 2 * 24 - 1 );
+  RegionType::IndexType index;
+  index.Fill( 0 );
+  RegionType currentRegion( index, currentSize );
+  RegionType requiredRegion( index, requiredSize );
+
+  ImageType::SpacingType currentSpacing, requiredSpacing;
+  currentSpacing.Fill( 2.0 );
+  requiredSpacing.Fill( 1.0 );
+  ImageType::PointType origin;
+  origin.Fill( -3.0 );
+  ImageType::DirectionType direction;
+  direction.SetIdentity();
+
+  /** Some coefficients, for both dimensions. */
+  const unsigned long numberOfCoefficients = currentRegion.GetNumberOfPixels();
+  ParametersType      parameters( numberOfCoefficients * Dimension );
+  for( unsigned int i = 0; i < parameters.GetSize(); ++i )
+  {
+    parameters[ i ] = vcl_sin( 1.7 * i ) + 0.5 * vcl_cos( 0.3 * i );
+  }
+
+  /** Upsample with the generic path and with the dyadic path. */
+  ParametersType resampledParameters, refinedParameters;
+  for( unsigned int useDyadic = 0; useDyadic < 2; ++useDyadic )
+  {
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetCurrentGridOrigin( origin );
+    filter->SetCurrentGridSpacing( currentSpacing );
+    filter->SetCurrentGridRegion( currentRegion );
+    filter->SetCurrentGridDirection( direction );
+    filter->SetRequiredGridOrigin( origin );
+    filter->SetRequiredGridSpacing( requiredSpacing );
+    filter->SetRequiredGridRegion( requiredRegion );
+    filter->SetRequiredGridDirection( direction );
+    filter->SetBSplineOrder( SplineOrder );
+    filter->SetNumberOfThreads( 2 );
+    if( useDyadic ) { filter->SetUseDyadicRefinement( true ); }
+
+    try
+    {
+      filter->UpsampleParameters( parameters,
+        useDyadic ? refinedParameters : resampledParameters );
+    }
+    catch( itk::ExceptionObject & excp )
+    {
+      std::cerr << excp << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    /** TEST: The dyadic path is opt-in. */
+    if( filter->GetUsedDyadicRefinement() != static_cast< bool >( useDyadic ) )
+    {
+      std::cerr << "ERROR: the dyadic refinement was "
+                << ( useDyadic ? "not " : "" ) << "used." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if( refinedParameters.GetSize() != resampledParameters.GetSize()
+    || refinedParameters.GetSize() != requiredRegion.GetNumberOfPixels() * Dimension )
+  {
+    std::cerr << "ERROR: the upsampled parameters have the wrong size." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** TEST: Compare the interior coefficients. */
+  const long    n          = static_cast< long >( requiredSize[ 0 ] );
+  const long    m          = static_cast< long >( requiredSize[ 1 ] );
+  double        maxError   = 0.0;
+  unsigned long nrCompared = 0;
+  for( unsigned int d = 0; d < Dimension; ++d )
+  {
+    for( long j = margin; j < m - margin; ++j )
+    {
+      for( long i = margin; i < n - margin; ++i )
+      {
+        const unsigned long k = d * n * m + j * n + i;
+        maxError = std::max( maxError,
+          vnl_math_abs( refinedParameters[ k ] - resampledParameters[ k ] ) );
+        ++nrCompared;
+      }
+    }
+  }
+
+  std::cerr << "The largest difference of " << nrCompared
+            << " interior coefficients is " << maxError << std::endl;
+  if( maxError > tolerance )
+  {
+    std::cerr << "ERROR: the dyadic refinement differs from the resampled "
+              << "coefficients in the interior of the grid." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Return a value. */
+  return EXIT_SUCCESS;
+
+} // end main